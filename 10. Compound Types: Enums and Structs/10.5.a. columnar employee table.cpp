@@ -0,0 +1,741 @@
+#include <iostream>
+#include <vector>
+#include <span>
+#include <new>              // ::operator new, std::align_val_t
+#include <limits>
+#include <algorithm>        // std::min, std::max
+#include <utility>          // std::exchange
+#include <thread>
+#include <atomic>
+#include <bit>              // std::popcount, std::countr_zero
+#include <cstring>          // std::memcpy, std::memset
+#include <cstdint>
+#include <cstddef>          // std::size_t
+#include <type_traits>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+// 10.5 defines an Employee as { id, age, wage }, and a std::vector<Employee> stores them one
+// after the other: id age wage id age wage id age wage...
+
+// that "array of structs" (AoS) layout is great when we work with one employee at a time.
+// but an analytical query like "the average wage of everyone between 30 and 40" only needs
+// the ages and the wages. the memory system doesn't know that: it loads whole 64 byte cache
+// lines, so the ids come along for free... and take up a quarter of the bandwidth.
+
+// a columnar table ("struct of arrays") stores every field in its own array:
+    // ids:   id id id id id ...
+    // ages:  age age age age ...
+    // wages: wage wage wage ...
+// a query reads only the columns it needs, and each column is a plain array of one type,
+// which is exactly what SIMD instructions want.
+
+// queries are built from two kinds of primitives:
+    // - filters, which turn a predicate on one column into a SELECTION BITMAP (bit i says
+    //   whether row i passed). bitmaps of different filters are combined with & and |.
+    // - aggregates, which compute count/sum/min/max over the rows selected by a bitmap.
+// and big tables are split into "morsels" of 64k rows, which threads grab one at a time
+// until none are left (morsel-driven parallelism), so a slow thread never holds up the rest.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ Employee, from 10.5 ]============
+---------------------------------------------------------------------------------------*/
+
+struct Employee
+{
+    int id {};
+    int age {};
+    double wage {};
+};
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                   ============[ columns and selections ]============
+---------------------------------------------------------------------------------------*/
+
+namespace columnar
+{
+    // a growable array that starts on a cache line, and whose capacity is a whole number of
+    // cache lines. the unused tail is zeroed, so SIMD loops may read a full vector past the end.
+    template <typename T>
+    class Column
+    {
+    private:
+        static constexpr std::size_t s_alignment{ 64 };
+        static constexpr std::size_t s_perLine{ s_alignment / sizeof(T) };
+
+        T* m_data{ nullptr };
+        std::size_t m_size{ 0 };
+        std::size_t m_capacity{ 0 };
+
+        void reallocate(std::size_t capacity)
+        {
+            capacity = (capacity + s_perLine - 1) / s_perLine * s_perLine;
+            auto data{ static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t{ s_alignment })) };
+            if (m_size > 0)
+                std::memcpy(data, m_data, m_size * sizeof(T));
+            std::memset(static_cast<void*>(data + m_size), 0, (capacity - m_size) * sizeof(T));
+
+            ::operator delete(m_data, std::align_val_t{ s_alignment });
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+    public:
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        Column() = default;
+        Column(const Column&) = delete;
+        Column& operator=(const Column&) = delete;
+
+        Column(Column&& other) noexcept
+            : m_data{ std::exchange(other.m_data, nullptr) }
+            , m_size{ std::exchange(other.m_size, 0) }
+            , m_capacity{ std::exchange(other.m_capacity, 0) }
+        {
+        }
+
+        ~Column()
+        {
+            ::operator delete(m_data, std::align_val_t{ s_alignment });
+        }
+
+        void reserve(std::size_t capacity)
+        {
+            if (capacity > m_capacity)
+                reallocate(capacity);
+        }
+
+        void push_back(T value)
+        {
+            if (m_size == m_capacity)
+                reallocate(std::max<std::size_t>(m_capacity * 2, s_perLine * 16));
+            m_data[m_size++] = value;
+        }
+
+        std::size_t size() const { return m_size; }
+        const T* data() const { return m_data; }
+        T& operator[](std::size_t i) { return m_data[i]; }
+        const T& operator[](std::size_t i) const { return m_data[i]; }
+
+        std::span<const T> span() const { return { m_data, m_size }; }
+    };
+
+    // bit i of word i / 64 is set when row i is selected. bits past the last row are always 0.
+    class Selection
+    {
+    private:
+        std::vector<std::uint64_t> m_words{};
+        std::size_t m_rows{ 0 };
+
+    public:
+        Selection() = default;
+
+        explicit Selection(std::size_t rows)
+            : m_words((rows + 63) / 64, 0)
+            , m_rows{ rows }
+        {
+        }
+
+        // reuses the storage (for morsels, which all have the same size)
+        void resize(std::size_t rows)
+        {
+            m_words.assign((rows + 63) / 64, 0);
+            m_rows = rows;
+        }
+
+        std::size_t rows() const { return m_rows; }
+        std::span<std::uint64_t> words() { return m_words; }
+        std::span<const std::uint64_t> words() const { return m_words; }
+
+        bool test(std::size_t row) const { return (m_words[row / 64] >> (row % 64)) & 1; }
+
+        std::size_t count() const
+        {
+            std::size_t total{ 0 };
+            for (std::uint64_t word : m_words)
+                total += static_cast<std::size_t>(std::popcount(word));
+            return total;
+        }
+
+        Selection& operator&=(const Selection& other)
+        {
+            for (std::size_t i{ 0 }; i < m_words.size(); ++i)
+                m_words[i] &= other.m_words[i];
+            return *this;
+        }
+
+        Selection& operator|=(const Selection& other)
+        {
+            for (std::size_t i{ 0 }; i < m_words.size(); ++i)
+                m_words[i] |= other.m_words[i];
+            return *this;
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                          ============[ filters ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - selectBetween(column, low, high) sets the bits of the rows with low <= value <= high.
+    (every comparison is a special case of it: "age > 60" is between 61 and INT_MAX.)
+
+  - with SSE2, 4 ints are compared at once, and movemask turns the 4 results into 4 bits.
+    16 of those make one 64 bit word of the selection, without a single branch.
+
+  - select(column, predicate) is the general version for any predicate. it is branchless too
+    (the bits are shifted in), which lets the compiler vectorize it for simple predicates.
+*/
+
+namespace columnar
+{
+    inline void selectBetween(std::span<const std::int32_t> column, std::int32_t low, std::int32_t high, Selection& out)
+    {
+        out.resize(column.size());
+        std::span<std::uint64_t> words{ out.words() };
+        const std::size_t fullWords{ column.size() / 64 };
+
+#if defined(__SSE2__)
+        const __m128i lows{ _mm_set1_epi32(low) };
+        const __m128i highs{ _mm_set1_epi32(high) };
+
+        for (std::size_t w{ 0 }; w < fullWords; ++w)
+        {
+            const std::int32_t* values{ column.data() + w * 64 };
+            std::uint64_t word{ 0 };
+            for (std::size_t i{ 0 }; i < 64; i += 4)
+            {
+                __m128i chunk{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)) };
+                __m128i outside{ _mm_or_si128(_mm_cmplt_epi32(chunk, lows), _mm_cmpgt_epi32(chunk, highs)) };
+                std::uint64_t bits{ static_cast<std::uint64_t>(~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xf) };
+                word |= bits << i;
+            }
+            words[w] = word;
+        }
+#else
+        for (std::size_t w{ 0 }; w < fullWords; ++w)
+        {
+            std::uint64_t word{ 0 };
+            for (std::size_t i{ 0 }; i < 64; ++i)
+            {
+                std::int32_t value{ column[w * 64 + i] };
+                word |= static_cast<std::uint64_t>(low <= value && value <= high) << i;
+            }
+            words[w] = word;
+        }
+#endif
+
+        for (std::size_t row{ fullWords * 64 }; row < column.size(); ++row)
+        {
+            std::int32_t value{ column[row] };
+            words[row / 64] |= static_cast<std::uint64_t>(low <= value && value <= high) << (row % 64);
+        }
+    }
+
+    template <typename T, typename Predicate>
+    void select(std::span<const T> column, Predicate predicate, Selection& out)
+    {
+        out.resize(column.size());
+        std::span<std::uint64_t> words{ out.words() };
+        for (std::size_t row{ 0 }; row < column.size(); row += 64)
+        {
+            std::size_t count{ std::min<std::size_t>(64, column.size() - row) };
+            std::uint64_t word{ 0 };
+            for (std::size_t i{ 0 }; i < count; ++i)
+                word |= static_cast<std::uint64_t>(predicate(column[row + i]) ? 1 : 0) << i;
+            words[row / 64] = word;
+        }
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ aggregates ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - aggregate(column, selection) looks at the selection 64 rows at a time:
+        all 64 selected     a plain SIMD loop over the 64 values
+        none selected       skipped
+        a few selected      visit just the set bits (countr_zero, then clear the lowest bit)
+        many selected       SIMD over all 64 values, with every pair of bits turned into a
+                            mask that zeroes out the unselected values (and for min/max,
+                            replaces them with +inf/-inf)
+*/
+
+namespace columnar
+{
+    struct Aggregate
+    {
+        std::size_t count{ 0 };
+        double sum{ 0.0 };
+        double min{ std::numeric_limits<double>::infinity() };
+        double max{ -std::numeric_limits<double>::infinity() };
+
+        double average() const { return count ? sum / static_cast<double>(count) : 0.0; }
+
+        Aggregate& operator+=(const Aggregate& other)
+        {
+            count += other.count;
+            sum += other.sum;
+            min = std::min(min, other.min);
+            max = std::max(max, other.max);
+            return *this;
+        }
+    };
+
+    namespace detail
+    {
+        inline void addSparse(const double* values, std::uint64_t word, Aggregate& result)
+        {
+            for (; word != 0; word &= word - 1)
+            {
+                double value{ values[std::countr_zero(word)] };
+                result.sum += value;
+                result.min = std::min(result.min, value);
+                result.max = std::max(result.max, value);
+            }
+        }
+
+#if defined(__SSE2__)
+        struct Accumulators
+        {
+            __m128d sum{ _mm_setzero_pd() };
+            __m128d min{ _mm_set1_pd(std::numeric_limits<double>::infinity()) };
+            __m128d max{ _mm_set1_pd(-std::numeric_limits<double>::infinity()) };
+
+            void addInto(Aggregate& result) const
+            {
+                alignas(16) double lanes[2];
+                _mm_store_pd(lanes, sum);
+                result.sum += lanes[0] + lanes[1];
+                _mm_store_pd(lanes, min);
+                result.min = std::min({ result.min, lanes[0], lanes[1] });
+                _mm_store_pd(lanes, max);
+                result.max = std::max({ result.max, lanes[0], lanes[1] });
+            }
+        };
+
+        inline void addDense(const double* values, Accumulators& acc)
+        {
+            for (std::size_t i{ 0 }; i < 64; i += 2)
+            {
+                __m128d chunk{ _mm_loadu_pd(values + i) };
+                acc.sum = _mm_add_pd(acc.sum, chunk);
+                acc.min = _mm_min_pd(acc.min, chunk);
+                acc.max = _mm_max_pd(acc.max, chunk);
+            }
+        }
+
+        inline void addMasked(const double* values, std::uint64_t word, Accumulators& acc)
+        {
+            const __m128d positive{ _mm_set1_pd(std::numeric_limits<double>::infinity()) };
+            const __m128d negative{ _mm_set1_pd(-std::numeric_limits<double>::infinity()) };
+
+            for (std::size_t i{ 0 }; i < 64; i += 2)
+            {
+                std::uint64_t bits{ word >> i };
+                __m128d mask{ _mm_castsi128_pd(_mm_set_epi64x(-static_cast<std::int64_t>((bits >> 1) & 1),
+                                                              -static_cast<std::int64_t>(bits & 1))) };
+                __m128d chunk{ _mm_loadu_pd(values + i) };
+
+                acc.sum = _mm_add_pd(acc.sum, _mm_and_pd(mask, chunk));
+                acc.min = _mm_min_pd(acc.min, _mm_or_pd(_mm_and_pd(mask, chunk), _mm_andnot_pd(mask, positive)));
+                acc.max = _mm_max_pd(acc.max, _mm_or_pd(_mm_and_pd(mask, chunk), _mm_andnot_pd(mask, negative)));
+            }
+        }
+#endif
+    }
+
+    // count/sum/min/max of the selected values. a word is read as 64 whole values only when all
+    // 64 of its rows exist; a last, partial word only reads its selected rows.
+    inline Aggregate aggregate(std::span<const double> values, const Selection& selection)
+    {
+        Aggregate result{};
+        std::span<const std::uint64_t> words{ selection.words() };
+
+#if defined(__SSE2__)
+        detail::Accumulators acc{};
+        for (std::size_t w{ 0 }; w < words.size(); ++w)
+        {
+            std::uint64_t word{ words[w] };
+            const double* block{ values.data() + w * 64 };
+            int selected{ std::popcount(word) };
+            result.count += static_cast<std::size_t>(selected);
+
+            if (selected == 64)
+                detail::addDense(block, acc);
+            else if (selected >= 16 && (w + 1) * 64 <= values.size())
+                detail::addMasked(block, word, acc);
+            else if (selected > 0)
+                detail::addSparse(block, word, result);
+        }
+        acc.addInto(result);
+#else
+        for (std::size_t w{ 0 }; w < words.size(); ++w)
+        {
+            result.count += static_cast<std::size_t>(std::popcount(words[w]));
+            detail::addSparse(values.data() + w * 64, words[w], result);
+        }
+#endif
+        return result;
+    }
+
+    // everything, no selection
+    inline Aggregate aggregate(std::span<const double> values)
+    {
+        Aggregate result{};
+        result.count = values.size();
+
+#if defined(__SSE2__)
+        detail::Accumulators acc{};
+        std::size_t i{ 0 };
+        for (; i + 64 <= values.size(); i += 64)
+            detail::addDense(values.data() + i, acc);
+        acc.addInto(result);
+#else
+        std::size_t i{ 0 };
+#endif
+        for (; i < values.size(); ++i)
+        {
+            result.sum += values[i];
+            result.min = std::min(result.min, values[i]);
+            result.max = std::max(result.max, values[i]);
+        }
+        return result;
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                    ============[ the table, and morsels ]============
+---------------------------------------------------------------------------------------*/
+
+namespace columnar
+{
+    class EmployeeTable
+    {
+    private:
+        Column<std::int32_t> m_ids{};
+        Column<std::int32_t> m_ages{};
+        Column<double> m_wages{};
+
+    public:
+        void reserve(std::size_t rows)
+        {
+            m_ids.reserve(rows);
+            m_ages.reserve(rows);
+            m_wages.reserve(rows);
+        }
+
+        void push_back(const Employee& employee)
+        {
+            m_ids.push_back(employee.id);
+            m_ages.push_back(employee.age);
+            m_wages.push_back(employee.wage);
+        }
+
+        std::size_t size() const { return m_ids.size(); }
+
+        Employee operator[](std::size_t row) const { return { m_ids[row], m_ages[row], m_wages[row] }; }
+
+        std::span<const std::int32_t> ids() const { return m_ids.span(); }
+        std::span<const std::int32_t> ages() const { return m_ages.span(); }
+        std::span<const double> wages() const { return m_wages.span(); }
+    };
+
+    // 64k rows: a morsel of one int column and one double column is 768 KiB, which fits in L2
+    constexpr std::size_t g_morselRows{ 1 << 16 };
+
+    // calls fn(begin, end, selection) for every morsel of [rows] on [threads] threads, and adds
+    // up the Aggregates it returns. every thread has its own Selection to reuse.
+    template <typename Fn>
+    Aggregate morselScan(std::size_t rows, unsigned threads, Fn fn)
+    {
+        std::atomic<std::size_t> nextMorsel{ 0 };
+        std::vector<Aggregate> partial(std::max(threads, 1u));
+
+        auto work{ [&](unsigned t) {
+            Selection selection{};
+            for (std::size_t begin{ nextMorsel.fetch_add(g_morselRows) }; begin < rows; begin = nextMorsel.fetch_add(g_morselRows))
+                partial[t] += fn(begin, std::min(begin + g_morselRows, rows), selection);
+        } };
+
+        if (threads <= 1)
+            work(0);
+        else
+        {
+            std::vector<std::jthread> workers{};
+            for (unsigned t{ 0 }; t < threads; ++t)
+                workers.emplace_back(work, t);
+        }
+
+        Aggregate total{};
+        for (const Aggregate& part : partial)
+            total += part;
+        return total;
+    }
+
+    // count/sum/min/max/average of the wages of everyone aged [youngest, oldest]
+    inline Aggregate wagesByAge(const EmployeeTable& table, std::int32_t youngest, std::int32_t oldest, unsigned threads = 1)
+    {
+        return morselScan(table.size(), threads, [&](std::size_t begin, std::size_t end, Selection& selection) {
+            selectBetween(table.ages().subspan(begin, end - begin), youngest, oldest, selection);
+            return aggregate(table.wages().subspan(begin, end - begin), selection);
+        });
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ example ]============
+---------------------------------------------------------------------------------------*/
+
+namespace example
+{
+    void main()
+    {
+        columnar::EmployeeTable table{};
+        table.push_back({ 14, 32, 24.15 });
+        table.push_back({ 15, 32, 40000.0 });
+        table.push_back({ 16, 25, 30000.0 });
+        table.push_back({ 17, 51, 52000.0 });
+
+        columnar::Aggregate thirties{ columnar::wagesByAge(table, 30, 39) };
+        std::cout << thirties.count << " employees in their thirties, average wage " << thirties.average()
+                  << " (from " << thirties.min << " to " << thirties.max << ")\n";
+
+        // combining two filters: in their twenties or thirties, AND earning at least 30000
+        columnar::Selection young{}, wellPaid{};
+        columnar::selectBetween(table.ages(), 20, 39, young);
+        columnar::select(table.wages(), [](double wage) { return wage >= 30'000.0; }, wellPaid);
+        young &= wellPaid;
+
+        std::cout << "young and well paid:";
+        for (std::size_t row{ 0 }; row < table.size(); ++row)
+        {
+            if (young.test(row))
+                std::cout << " #" << table[row].id;
+        }
+        std::cout << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <random>
+#include <cmath>        // std::abs
+
+namespace checks
+{
+    void main()
+    {
+        std::mt19937_64 mt{ 38 };
+        std::vector<Employee> employees{};
+        columnar::EmployeeTable table{};
+
+        for (int i{ 0 }; i < 300'001; ++i)      // not a multiple of 64, or of a morsel
+        {
+            Employee employee{ i, static_cast<int>(18 + mt() % 50), static_cast<double>(mt() % 100'000) / 4.0 };
+            employees.push_back(employee);
+            table.push_back(employee);
+        }
+
+        int failures{ 0 };
+        for (auto [low, high] : { std::pair{ 30, 39 }, std::pair{ 18, 67 }, std::pair{ 0, 10 }, std::pair{ 40, 40 }, std::pair{ 20, 60 } })
+        {
+            columnar::Aggregate expected{};
+            for (const Employee& employee : employees)
+            {
+                if (low <= employee.age && employee.age <= high)
+                {
+                    ++expected.count;
+                    expected.sum += employee.wage;
+                    expected.min = std::min(expected.min, employee.wage);
+                    expected.max = std::max(expected.max, employee.wage);
+                }
+            }
+
+            for (unsigned threads : { 1u, 3u })
+            {
+                columnar::Aggregate result{ columnar::wagesByAge(table, low, high, threads) };
+                failures += result.count != expected.count || result.min != expected.min || result.max != expected.max;
+                failures += std::abs(result.sum - expected.sum) > 1e-9 * std::abs(expected.sum);
+            }
+        }
+
+        columnar::Selection byPredicate{}, byRange{};
+        columnar::select(table.ages(), [](std::int32_t age) { return 30 <= age && age <= 39; }, byPredicate);
+        columnar::selectBetween(table.ages(), 30, 39, byRange);
+        failures += !std::equal(byPredicate.words().begin(), byPredicate.words().end(), byRange.words().begin());
+
+        columnar::Aggregate all{ columnar::aggregate(table.wages()) };
+        double expectedSum{ 0 };
+        for (const Employee& employee : employees)
+            expectedSum += employee.wage;
+        failures += all.count != employees.size() || std::abs(all.sum - expectedSum) > 1e-9 * expectedSum;
+
+        // a reserved capacity that isn't a multiple of 64, with most of the last word selected
+        for (std::size_t rows : { 100, 20, 127, 129 })
+        {
+            columnar::EmployeeTable small{};
+            small.reserve(rows);
+            for (std::size_t i{ 0 }; i < rows; ++i)
+                small.push_back({ static_cast<int>(i), 30, 1.0 + static_cast<double>(i) });
+            columnar::Aggregate result{ columnar::wagesByAge(small, 30, 39) };
+            failures += result.count != rows || result.min != 1.0 || result.max != static_cast<double>(rows);
+            failures += result.sum != static_cast<double>(rows * (rows + 1) / 2);
+        }
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// 20 million employees: the same three queries over a std::vector<Employee> and over the table
+
+#include <chrono>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_rows{ 20'000'000 };
+
+    void main()
+    {
+        std::mt19937_64 mt{ 39 };
+        std::vector<Employee> employees(g_rows);
+        columnar::EmployeeTable table{};
+        table.reserve(g_rows);
+        for (std::size_t i{ 0 }; i < g_rows; ++i)
+        {
+            employees[i] = { static_cast<int>(i), static_cast<int>(18 + mt() % 50), static_cast<double>(mt() % 100'000) };
+            table.push_back(employees[i]);
+        }
+
+        std::cout << "(" << g_rows << " rows, " << std::thread::hardware_concurrency() << " hardware threads)\n";
+
+        // 1. average wage of everyone aged 30 to 39
+        Timer t;
+        double sum{ 0 };
+        std::size_t count{ 0 };
+        for (const Employee& employee : employees)
+        {
+            if (30 <= employee.age && employee.age <= 39)
+            {
+                sum += employee.wage;
+                ++count;
+            }
+        }
+        double aosTime{ t.elapsed() };
+
+        t.reset();
+        columnar::Aggregate one{ columnar::wagesByAge(table, 30, 39, 1) };
+        double columnTime{ t.elapsed() };
+
+        t.reset();
+        columnar::Aggregate four{ columnar::wagesByAge(table, 30, 39, 4) };
+        double columnThreadsTime{ t.elapsed() };
+
+        std::cout << "avg wage, age 30-39 : vector<Employee> " << aosTime * 1e3 << " ms, columns " << columnTime * 1e3
+                  << " ms, columns x4 threads " << columnThreadsTime * 1e3 << " ms"
+                  << (one.count != count || four.count != count || sum == 0 ? " ?" : "") << '\n';
+
+        // 2. how many are over 60 (one int column)
+        t.reset();
+        count = 0;
+        for (const Employee& employee : employees)
+            count += employee.age > 60;
+        aosTime = t.elapsed();
+
+        t.reset();
+        columnar::Selection selection{};
+        columnar::selectBetween(table.ages(), 61, std::numeric_limits<std::int32_t>::max(), selection);
+        std::size_t columnCount{ selection.count() };
+        columnTime = t.elapsed();
+
+        std::cout << "count age > 60      : vector<Employee> " << aosTime * 1e3 << " ms, columns " << columnTime * 1e3
+                  << " ms" << (columnCount != count ? " ?" : "") << '\n';
+
+        // 3. total, min and max wage (one double column)
+        t.reset();
+        double minimum{ std::numeric_limits<double>::infinity() };
+        sum = 0;
+        for (const Employee& employee : employees)
+        {
+            sum += employee.wage;
+            minimum = std::min(minimum, employee.wage);
+        }
+        aosTime = t.elapsed();
+
+        t.reset();
+        columnar::Aggregate all{ columnar::aggregate(table.wages()) };
+        columnTime = t.elapsed();
+
+        std::cout << "sum/min of wages    : vector<Employee> " << aosTime * 1e3 << " ms, columns " << columnTime * 1e3
+                  << " ms" << (all.min != minimum ? " ?" : "") << '\n';
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    example::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
@@ -0,0 +1,1099 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <memory>           // std::unique_ptr
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>        // std::exception_ptr
+#include <system_error>
+#include <filesystem>
+#include <charconv>         // std::from_chars
+#include <limits>
+#include <algorithm>        // std::min, std::max
+#include <bit>              // std::countr_zero, std::popcount
+#include <cstring>          // std::memcpy, std::memchr, std::memrchr
+#include <cstdint>
+#include <cstddef>          // std::size_t
+#include <cerrno>
+#include <type_traits>
+
+#include <fcntl.h>          // ::open
+#include <unistd.h>         // ::read, ::close
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+// the quiz in 10.8 reads ONE Advertising record from the user. a real website would rather
+// have a log with one record per line, and a lot of lines:
+
+//      ads_shown,percentage_clicked,earning_per_click
+//      1200,3.5,0.27
+//      830,1.25,0.4
+//      ...
+
+// reading a multi-gigabyte file like that with std::getline + operator>> runs at maybe
+// 50-100 MB/s: every line is copied into a string, every field goes through a stream (with
+// its locale, sentry, error state...). this file aims for something more like 1 GB/s per
+// core. it doesn't get there everywhere: on a 2 GHz virtual machine parse() does about 0.35
+// to 0.55 GB/s (4-6 cycles per byte, see the benchmark), so 1 GB/s takes a fast desktop core.
+
+//  - the file is read in big chunks (4 MiB) with plain ::read(), straight into a buffer that
+//    is reused. chunks are cut after their last newline, and the partial line that's left
+//    over is moved to the front of the next chunk.
+//  - separators (',' and '\n') are found 64 bytes at a time with SSE2: compare against both,
+//    movemask, and we get a 64 bit mask with one bit per separator. the set bits are turned
+//    into a list of offsets, a few KiB of text at a time, and lines are read off that list
+//    without looking at each byte in a loop.
+//  - fields are parsed straight into typed columns (int, float, double). the plain "123" and
+//    "-4.56" forms of up to 8 characters are parsed 8 bytes at a time in a 64-bit integer
+//    (SWAR), with no branch per digit. anything else (exponents, long numbers, headers)
+//    falls back to a plain parser and std::from_chars, so the result is always exact.
+//  - the work is a pipeline of threads connected by BOUNDED queues:
+//        reader  --chunks-->  parsers (N threads, N <= hardware threads)  --columns-->  aggregator
+//    bounded, so a fast reader can't run ahead and fill the memory; it blocks until a parser
+//    gives a chunk back. chunk buffers and column batches are recycled, not reallocated.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                    ============[ Advertising, from 10.8 ]============
+---------------------------------------------------------------------------------------*/
+
+struct Advertising
+{
+    int numberOfAdsShown {};
+    float percentageOfAdsClicked {};
+    double earningPerClick {};
+};
+
+// same formula as the quiz: multiply all 3 fields together
+double earnings(const Advertising& ad)
+{
+    return ad.numberOfAdsShown * ad.percentageOfAdsClicked * ad.earningPerClick;
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                       ============[ bounded queue ]============
+---------------------------------------------------------------------------------------*/
+
+namespace csv
+{
+    // a queue that holds at most [capacity] items. push() waits while it's full, pop() waits
+    // while it's empty. after close(), pop() drains what's left and then returns nullopt.
+    template <typename T>
+    class BoundedQueue
+    {
+    private:
+        std::deque<T> m_items{};
+        std::size_t m_capacity;
+        bool m_closed{ false };
+
+        std::mutex m_mutex{};
+        std::condition_variable m_notFull{};
+        std::condition_variable m_notEmpty{};
+
+    public:
+        explicit BoundedQueue(std::size_t capacity)
+            : m_capacity{ std::max<std::size_t>(capacity, 1) }
+        {
+        }
+
+        void push(T item)
+        {
+            std::unique_lock lock{ m_mutex };
+            m_notFull.wait(lock, [&] { return m_items.size() < m_capacity || m_closed; });
+            m_items.push_back(std::move(item));
+            m_notEmpty.notify_one();
+        }
+
+        std::optional<T> pop()
+        {
+            std::unique_lock lock{ m_mutex };
+            m_notEmpty.wait(lock, [&] { return !m_items.empty() || m_closed; });
+            if (m_items.empty())
+                return std::nullopt;
+
+            T item{ std::move(m_items.front()) };
+            m_items.pop_front();
+            m_notFull.notify_one();
+            return item;
+        }
+
+        void close()
+        {
+            std::lock_guard lock{ m_mutex };
+            m_closed = true;
+            m_notEmpty.notify_all();
+            m_notFull.notify_all();
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ number parsing ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - parseInteger accepts an optional '-' and up to 10 digits, and checks for overflow.
+
+  - parseDecimal accepts an optional sign, digits, and an optional '.' with more digits. the
+    digits are collected into one integer m, with k digits after the point, and the value
+    is m / 10^k. when m and 10^k are both exactly representable (m < 2^53 and k <= 22 for
+    double, m < 2^24 and k <= 10 for float) that single division is correctly rounded, so
+    it gives exactly what std::from_chars would. otherwise, we ask std::from_chars.
+*/
+
+namespace csv::detail
+{
+    inline bool parseInteger(const char* first, const char* last, std::int32_t& out)
+    {
+        bool negative{ first != last && *first == '-' };
+        first += negative;
+        if (first == last || last - first > 10)
+            return false;
+
+        std::int64_t value{ 0 };
+        for (; first != last; ++first)
+        {
+            unsigned digit{ static_cast<unsigned>(*first - '0') };
+            if (digit > 9)
+                return false;
+            value = value * 10 + digit;
+        }
+
+        value = negative ? -value : value;
+        if (value < std::numeric_limits<std::int32_t>::min() || value > std::numeric_limits<std::int32_t>::max())
+            return false;
+
+        out = static_cast<std::int32_t>(value);
+        return true;
+    }
+
+    template <typename T>
+    constexpr T g_powersOf10[]{
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    template <typename T>
+    bool parseDecimal(const char* first, const char* last, T& out)
+    {
+        constexpr std::uint64_t maxExactMantissa{ std::uint64_t{ 1 } << std::numeric_limits<T>::digits };
+        constexpr int maxExactPower{ std::is_same_v<T, float> ? 10 : 22 };
+
+        const char* begin{ first };
+        bool negative{ first != last && *first == '-' };
+        first += (first != last && (*first == '-' || *first == '+'));
+
+        std::uint64_t mantissa{ 0 };
+        int digits{ 0 };
+        int fractionDigits{ 0 };
+        bool seenPoint{ false };
+
+        for (; first != last; ++first)
+        {
+            unsigned digit{ static_cast<unsigned>(*first - '0') };
+            if (digit <= 9)
+            {
+                if (++digits > 19)
+                    break;
+                mantissa = mantissa * 10 + digit;
+                fractionDigits += seenPoint;
+            }
+            else if (*first == '.' && !seenPoint)
+                seenPoint = true;
+            else
+                break;
+        }
+
+        if (first == last && digits > 0 && mantissa <= maxExactMantissa && fractionDigits <= maxExactPower)
+        {
+            T value{ static_cast<T>(mantissa) / g_powersOf10<T>[fractionDigits] };
+            out = negative ? -value : value;
+            return true;
+        }
+
+        // the slow path: exponents, long mantissas... (from_chars doesn't take a leading '+')
+        begin += (begin != last && *begin == '+');
+        auto [end, error]{ std::from_chars(begin, last, out) };
+        return error == std::errc{} && end == last;
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                    ============[ finding separators ]============
+---------------------------------------------------------------------------------------*/
+
+namespace csv::detail
+{
+    // bit i is set when block[i] is ',' or '\n'
+    inline std::uint64_t separatorMask(const char* block)
+    {
+#if defined(__SSE2__)
+        const __m128i commas{ _mm_set1_epi8(',') };
+        const __m128i newlines{ _mm_set1_epi8('\n') };
+
+        std::uint64_t mask{ 0 };
+        for (int i{ 0 }; i < 64; i += 16)
+        {
+            __m128i bytes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i)) };
+            __m128i found{ _mm_or_si128(_mm_cmpeq_epi8(bytes, commas), _mm_cmpeq_epi8(bytes, newlines)) };
+            mask |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(found))) << i;
+        }
+        return mask;
+#else
+        std::uint64_t mask{ 0 };
+        for (int i{ 0 }; i < 64; ++i)
+            mask |= static_cast<std::uint64_t>(block[i] == ',' || block[i] == '\n') << i;
+        return mask;
+#endif
+    }
+
+    // writes the offsets of the separators in [data, data + size) to [offsets], in order, and
+    // returns how many there are. [offsets] needs room for size + 64 of them: the set bits are
+    // written out 8 at a time without looking at how many there really are (the extra ones are
+    // garbage that the next block overwrites), which saves a hard to predict branch per bit.
+    inline std::size_t findSeparators(const char* data, std::size_t size, std::uint32_t* offsets)
+    {
+        std::size_t count{ 0 };
+        for (std::size_t base{ 0 }; base < size; base += 64)
+        {
+            std::uint64_t mask{};
+            if (base + 64 <= size)
+                mask = separatorMask(data + base);
+            else
+            {
+                // the last partial block is copied out so that we never read past the end
+                char tail[64]{};
+                std::memcpy(tail, data + base, size - base);
+                mask = separatorMask(tail) & (~std::uint64_t{ 0 } >> (64 - (size - base)));
+            }
+
+            const int found{ std::popcount(mask) };
+            std::uint32_t* out{ offsets + count };
+            for (int i{ 0 }; i < found; i += 8)
+            {
+                for (int j{ 0 }; j < 8; ++j)
+                {
+                    out[i + j] = static_cast<std::uint32_t>(base) + static_cast<std::uint32_t>(std::countr_zero(mask));
+                    mask &= mask - 1;
+                }
+            }
+            count += static_cast<std::size_t>(found);
+        }
+        return count;
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ 8 digits at a time ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - a field of up to 8 bytes is loaded as ONE 64-bit integer and shifted up, so that its
+    first character is in the top byte and the bytes after the field fall out: "123" is
+    read as "123,4.56" and becomes "\0\0\0\0\0123". the checks and the conversion then work
+    on all the bytes at once (SWAR, "SIMD within a register"), instead of a loop with a
+    branch per digit.
+
+  - subtracting "00000000" (shifted the same way) gives one digit value per byte. a byte
+    that wasn't '0'..'9' ends up >= 10 (or borrows and ends up >= 0x80), and adding 0x76 to
+    a byte >= 10 sets its top bit: one test for all 8 bytes.
+
+  - three multiplications combine the digits pairwise: 8 digits -> 4 two-digit numbers ->
+    2 four-digit numbers -> 1 eight-digit number.
+
+  - for a decimal, the '.' is located with the "find a zero byte" trick on value ^ "........"
+    and cut out, and the digits after it say which power of ten to divide by (exactly, as in
+    parseDecimal). fields that don't fit these rules go to parseInteger/parseDecimal.
+*/
+
+namespace csv::detail
+{
+    constexpr std::uint64_t g_ones{ 0x01'01'01'01'01'01'01'01 };
+
+    // the [count] bytes at p (count in 1..8), in the top bytes of the result. p[0, 8) must be
+    // readable.
+    inline std::uint64_t loadTop(const char* p, int count)
+    {
+        std::uint64_t value;
+        std::memcpy(&value, p, 8);      // little endian: p[0] is the lowest byte
+        return value << (8 * (8 - count));
+    }
+
+    // [value] holds [count] characters in its top bytes (count in 1..8) and zeros below them.
+    // if they're all '0'..'9', writes the number they make to [out]
+    inline bool topDigits(std::uint64_t value, int count, std::uint32_t& out)
+    {
+        std::uint64_t digits{ value - ((0x30 * g_ones) << (8 * (8 - count))) };
+        if (((digits | (digits + 0x76 * g_ones)) & (0x80 * g_ones)) != 0)
+            return false;
+
+        digits = (digits * 2561) >> 8;                                          // pairs
+        digits = ((digits & 0x00FF00FF00FF00FF) * 6553601) >> 16;              // fours
+        out = static_cast<std::uint32_t>(((digits & 0x0000FFFF0000FFFF) * 42949672960001) >> 32);
+        return true;
+    }
+
+    // p[0, length) is "-?[0-9]{1,8}". p[0, 8) must be readable.
+    inline bool parseIntegerFast(const char* p, int length, std::int32_t& out)
+    {
+        bool negative{ *p == '-' };
+        int count{ length - negative };
+        std::uint32_t magnitude{};
+        if (count < 1 || count > 8 || !topDigits(loadTop(p + negative, count), count, magnitude))
+            return false;
+
+        out = negative ? -static_cast<std::int32_t>(magnitude) : static_cast<std::int32_t>(magnitude);
+        return true;
+    }
+
+    // p[0, length) is "-?[0-9.]{1,8}" with at most one '.' and at least one digit, and the
+    // digits fit the exact division. p[0, 8) must be readable.
+    template <typename T>
+    bool parseDecimalFast(const char* p, int length, T& out)
+    {
+        constexpr std::uint64_t maxExactMantissa{ std::uint64_t{ 1 } << std::numeric_limits<T>::digits };
+
+        bool negative{ *p == '-' };
+        int count{ length - negative };
+        if (count < 1 || count > 8)
+            return false;
+        std::uint64_t value{ loadTop(p + negative, count) };
+
+        // the first '.' in the field, if any: a zero byte in value ^ "........" (the zeros
+        // under the field don't match)
+        std::uint64_t dots{ value ^ (0x2E * g_ones) };
+        dots = (dots - g_ones) & ~dots & (0x80 * g_ones);
+
+        int fractionDigits{ 0 };
+        if (dots != 0)
+        {
+            // the bytes under the '.' move up one byte to take its place
+            int point{ std::countr_zero(dots) / 8 };
+            std::uint64_t below{ (std::uint64_t{ 1 } << (8 * point)) - 1 };
+            value = (value & (~below << 8)) | ((value & below) << 8);
+            fractionDigits = 7 - point;
+            if (--count == 0)
+                return false;
+        }
+
+        std::uint32_t mantissa{};
+        if (!topDigits(value, count, mantissa) || mantissa > maxExactMantissa)
+            return false;
+
+        T result{ static_cast<T>(mantissa) / g_powersOf10<T>[fractionDigits] };
+        out = negative ? -result : result;
+        return true;
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ typed columns ]============
+---------------------------------------------------------------------------------------*/
+
+namespace csv
+{
+    // a batch of parsed Advertising records, one column per field
+    struct AdvertisingColumns
+    {
+        std::vector<std::int32_t> adsShown{};
+        std::vector<float> percentageClicked{};
+        std::vector<double> earningPerClick{};
+        std::size_t rejected{ 0 };          // lines that didn't have 3 valid fields
+
+        std::size_t size() const { return adsShown.size(); }
+
+        void clear()
+        {
+            adsShown.clear();
+            percentageClicked.clear();
+            earningPerClick.clear();
+            rejected = 0;
+        }
+
+        Advertising operator[](std::size_t row) const
+        {
+            return { adsShown[row], percentageClicked[row], earningPerClick[row] };
+        }
+    };
+
+    // one line, the slow way: any field syntax parseInteger/parseDecimal take, "\r\n", empty
+    // lines. [first, last) doesn't include the '\n'.
+    inline void parseLine(const char* first, const char* last, AdvertisingColumns& out)
+    {
+        last -= (last != first && last[-1] == '\r');
+        if (first == last)
+            return;     // an empty line isn't an error
+
+        Advertising row{};
+        const char* fields[4]{ first };
+        int count{ 1 };
+        for (const char* p{ first }; p != last && count < 4; ++p)
+        {
+            if (*p == ',')
+                fields[count++] = p + 1;
+        }
+
+        bool valid{ count == 3
+                    && detail::parseInteger(fields[0], fields[1] - 1, row.numberOfAdsShown)
+                    && detail::parseDecimal(fields[1], fields[2] - 1, row.percentageOfAdsClicked)
+                    && detail::parseDecimal(fields[2], last, row.earningPerClick) };
+        if (valid)
+        {
+            out.adsShown.push_back(row.numberOfAdsShown);
+            out.percentageClicked.push_back(row.percentageOfAdsClicked);
+            out.earningPerClick.push_back(row.earningPerClick);
+        }
+        else
+            ++out.rejected;
+    }
+
+    // parses whole lines from [text] and appends them to [out]. the last line doesn't need a
+    // '\n'. a "\r\n" line ending is fine, and so are empty lines. a line whose first field
+    // isn't a number (a header) is counted as rejected, like any other malformed line.
+    //
+    // the text is done in slices of a few KiB: first all the separators of the slice are
+    // listed, then the lines are read off that list. the usual line is ',' ',' '\n' and three
+    // short fields for the SWAR parsers; those rows go to small local columns (no capacity
+    // check per row) that are appended to [out] once per slice. anything else (a header,
+    // long or unusual numbers, the last few bytes of the text) is handed to parseLine().
+    inline void parse(std::string_view text, AdvertisingColumns& out)
+    {
+        constexpr std::size_t sliceSize{ 4096 };
+        constexpr std::size_t maxRows{ sliceSize / 3 + 1 };     // a row takes 3 separators
+
+        std::uint32_t offsets[sliceSize + 64];
+        std::int32_t adsShown[maxRows];
+        float percentageClicked[maxRows];
+        double earningPerClick[maxRows];
+        std::size_t rows{ 0 };
+
+        const char* data{ text.data() };
+        const std::size_t size{ text.size() };
+        std::size_t line{ 0 };          // start of the current line
+
+        auto flushRows{ [&] {
+            out.adsShown.insert(out.adsShown.end(), adsShown, adsShown + rows);
+            out.percentageClicked.insert(out.percentageClicked.end(), percentageClicked, percentageClicked + rows);
+            out.earningPerClick.insert(out.earningPerClick.end(), earningPerClick, earningPerClick + rows);
+            rows = 0;
+        } };
+
+        // the slow way, up to the end of the line
+        auto slowLine{ [&] {
+            flushRows();
+            auto found{ static_cast<const char*>(std::memchr(data + line, '\n', size - line)) };
+            std::size_t end{ found ? static_cast<std::size_t>(found - data) : size };
+            parseLine(data + line, data + end, out);
+            line = end + 1;
+        } };
+
+        while (line < size)
+        {
+            const std::size_t slice{ line };
+            const std::size_t sliceEnd{ std::min(size, slice + sliceSize) };
+            const std::size_t count{ detail::findSeparators(data + slice, sliceEnd - slice, offsets) };
+
+            std::size_t k{ 0 };
+            while (k + 3 <= count)
+            {
+                const std::size_t comma1{ slice + offsets[k] };
+                const std::size_t comma2{ slice + offsets[k + 1] };
+                const std::size_t newline{ slice + offsets[k + 2] };
+                const std::size_t end{ newline - (data[newline - 1] == '\r') };
+
+                // the fields are read 8 bytes at a time, so the line has to end 8 bytes before
+                // the text. (& instead of && for one branch instead of three.)
+                if (newline + 8 <= size && ((data[comma1] == ',') & (data[comma2] == ',') & (data[newline] == '\n'))
+                    && detail::parseIntegerFast(data + line, static_cast<int>(comma1 - line), adsShown[rows])
+                    && detail::parseDecimalFast(data + comma1 + 1, static_cast<int>(comma2 - comma1 - 1), percentageClicked[rows])
+                    && detail::parseDecimalFast(data + comma2 + 1, static_cast<int>(end - comma2 - 1), earningPerClick[rows]))
+                {
+                    ++rows;
+                    line = newline + 1;
+                    k += 3;
+                    continue;
+                }
+
+                slowLine();
+                while (k < count && slice + offsets[k] < line)
+                    ++k;
+            }
+
+            // what's left of the slice is the start of a line that continues in the next one.
+            // at the end of the text, or when a line doesn't even fit in a slice, there is no
+            // next one: finish it the slow way.
+            if (sliceEnd == size)
+            {
+                while (line < size)
+                    slowLine();
+            }
+            else if (line == slice)
+                slowLine();
+            flushRows();
+        }
+    }
+
+    struct Summary
+    {
+        std::size_t rows{ 0 };
+        std::size_t rejected{ 0 };
+        std::int64_t adsShown{ 0 };
+        double earnings{ 0.0 };
+        double bestEarnings{ 0.0 };
+
+        void add(const AdvertisingColumns& columns)
+        {
+            rows += columns.size();
+            rejected += columns.rejected;
+            for (std::size_t i{ 0 }; i < columns.size(); ++i)
+            {
+                double earned{ columns.adsShown[i] * columns.percentageClicked[i] * columns.earningPerClick[i] };
+                adsShown += columns.adsShown[i];
+                earnings += earned;
+                bestEarnings = std::max(bestEarnings, earned);
+            }
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ pipeline ]============
+---------------------------------------------------------------------------------------*/
+
+namespace csv
+{
+    namespace detail
+    {
+        [[noreturn]] inline void throwErrno(const std::string& what)
+        {
+            throw std::system_error{ errno, std::generic_category(), what };
+        }
+
+        struct Chunk
+        {
+            std::vector<char> bytes{};
+            std::size_t size{ 0 };
+        };
+    }
+
+    inline unsigned hardwareThreads()
+    {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    struct PipelineOptions
+    {
+        std::size_t chunkSize{ 4 << 20 };
+        unsigned parsers{ hardwareThreads() };  // at most one per hardware thread, see ingest()
+        std::size_t chunksInFlight{ 0 };        // 0 means 2 per parser
+    };
+
+    // streams [path] through reader -> parsers -> aggregator. onBatch(const AdvertisingColumns&)
+    // is called on the aggregating (calling) thread for every parsed batch, in no particular
+    // order. a line longer than chunkSize can't be split, so it throws std::length_error.
+    //
+    // parsing is the only stage that needs a whole core, so more parsers than hardware
+    // threads would only take turns on the same cores, with twice the chunks in flight for
+    // each one (more memory, fewer cache hits). options.parsers is capped to that.
+    template <typename OnBatch>
+    Summary ingest(const std::filesystem::path& path, PipelineOptions options, OnBatch&& onBatch)
+    {
+        int fd{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+        if (fd < 0)
+            detail::throwErrno("open " + path.string());
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+        using ChunkPtr = std::unique_ptr<detail::Chunk>;
+        using BatchPtr = std::unique_ptr<AdvertisingColumns>;
+
+        const unsigned parsers{ std::clamp(options.parsers, 1u, hardwareThreads()) };
+        const std::size_t inFlight{ options.chunksInFlight ? options.chunksInFlight : 2 * std::size_t{ parsers } };
+
+        // the free queues hold every buffer there is, so they never block on push
+        BoundedQueue<ChunkPtr> freeChunks{ inFlight };
+        BoundedQueue<ChunkPtr> fullChunks{ inFlight };
+        BoundedQueue<BatchPtr> freeBatches{ inFlight };
+        BoundedQueue<BatchPtr> fullBatches{ inFlight };
+        for (std::size_t i{ 0 }; i < inFlight; ++i)
+        {
+            auto chunk{ std::make_unique<detail::Chunk>() };
+            chunk->bytes.resize(options.chunkSize);
+            freeChunks.push(std::move(chunk));
+            freeBatches.push(std::make_unique<AdvertisingColumns>());
+        }
+
+        std::exception_ptr readError{};
+        std::atomic<unsigned> parsersLeft{ parsers };
+
+        std::jthread reader{ [&] {
+            try
+            {
+                std::vector<char> carry{};
+                bool done{ false };
+                while (!done)
+                {
+                    std::optional<ChunkPtr> free{ freeChunks.pop() };
+                    if (!free)
+                        break;      // closed by the aggregator
+                    ChunkPtr chunk{ std::move(*free) };
+                    if (carry.size() == chunk->bytes.size())
+                        throw std::length_error{ "csv: line longer than the chunk size" };
+
+                    std::copy(carry.begin(), carry.end(), chunk->bytes.begin());
+                    std::size_t filled{ carry.size() };
+                    while (filled < chunk->bytes.size())
+                    {
+                        ssize_t got{ ::read(fd, chunk->bytes.data() + filled, chunk->bytes.size() - filled) };
+                        if (got < 0 && errno == EINTR)
+                            continue;
+                        if (got < 0)
+                            detail::throwErrno("read " + path.string());
+                        if (got == 0)
+                        {
+                            done = true;
+                            break;
+                        }
+                        filled += static_cast<std::size_t>(got);
+                    }
+
+                    // at the end of the file the whole rest is one chunk, otherwise cut after the last '\n'
+                    std::size_t cut{ filled };
+                    if (!done)
+                    {
+                        auto newline{ static_cast<const char*>(::memrchr(chunk->bytes.data(), '\n', filled)) };
+                        cut = newline ? static_cast<std::size_t>(newline - chunk->bytes.data()) + 1 : 0;
+                    }
+                    carry.assign(chunk->bytes.data() + cut, chunk->bytes.data() + filled);
+                    chunk->size = cut;
+
+                    if (cut > 0)
+                        fullChunks.push(std::move(chunk));
+                    else
+                        freeChunks.push(std::move(chunk));
+                }
+            }
+            catch (...)
+            {
+                readError = std::current_exception();
+            }
+            fullChunks.close();
+        } };
+
+        std::vector<std::jthread> workers{};
+        for (unsigned i{ 0 }; i < parsers; ++i)
+        {
+            workers.emplace_back([&] {
+                while (std::optional<ChunkPtr> chunk{ fullChunks.pop() })
+                {
+                    std::optional<BatchPtr> free{ freeBatches.pop() };
+                    if (!free)
+                        break;
+                    BatchPtr batch{ std::move(*free) };
+                    batch->clear();
+                    parse({ (*chunk)->bytes.data(), (*chunk)->size }, *batch);
+
+                    freeChunks.push(std::move(*chunk));
+                    fullBatches.push(std::move(batch));
+                }
+                if (--parsersLeft == 0)
+                    fullBatches.close();
+            });
+        }
+
+        // the aggregator is the calling thread. if onBatch throws, the queues are closed so
+        // that the other stages stop instead of waiting for us forever.
+        Summary summary{};
+        try
+        {
+            while (std::optional<BatchPtr> batch{ fullBatches.pop() })
+            {
+                summary.add(**batch);
+                onBatch(static_cast<const AdvertisingColumns&>(**batch));
+                freeBatches.push(std::move(*batch));
+            }
+        }
+        catch (...)
+        {
+            for (auto* queue : { &freeChunks, &fullChunks })
+                queue->close();
+            for (auto* queue : { &freeBatches, &fullBatches })
+                queue->close();
+            reader.join();
+            workers.clear();
+            ::close(fd);
+            throw;
+        }
+
+        reader.join();
+        workers.clear();
+        ::close(fd);
+
+        if (readError)
+            std::rethrow_exception(readError);
+        return summary;
+    }
+
+    inline Summary ingest(const std::filesystem::path& path, PipelineOptions options = {})
+    {
+        return ingest(path, options, [](const AdvertisingColumns&) {});
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ example and checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <cmath>            // std::abs
+
+namespace example
+{
+    void main()
+    {
+        csv::AdvertisingColumns columns{};
+        csv::parse("ads_shown,percentage_clicked,earning_per_click\n"
+                   "1200,3.5,0.27\n"
+                   "830,1.25,0.4\r\n"
+                   "\n"
+                   "oops,1,1\n"
+                   "15,1e1,-2.5", columns);
+
+        std::cout << columns.size() << " records, " << columns.rejected << " rejected lines\n";
+        for (std::size_t i{ 0 }; i < columns.size(); ++i)
+        {
+            Advertising ad{ columns[i] };
+            std::cout << "  " << ad.numberOfAdsShown << " ads, " << ad.percentageOfAdsClicked << " %, "
+                      << ad.earningPerClick << " per click: $ " << earnings(ad) << '\n';
+        }
+    }
+}
+
+namespace checks
+{
+    // the slow and obviously right way
+    std::vector<Advertising> readWithStreams(const std::string& text)
+    {
+        std::vector<Advertising> ads{};
+        std::istringstream in{ text };
+        for (std::string line{}; std::getline(in, line);)
+        {
+            std::istringstream fields{ line };
+            Advertising ad{};
+            char comma1{}, comma2{};
+            if (fields >> ad.numberOfAdsShown >> comma1 >> ad.percentageOfAdsClicked >> comma2 >> ad.earningPerClick)
+                ads.push_back(ad);
+        }
+        return ads;
+    }
+
+    std::string randomCsv(std::size_t rows, std::mt19937_64& mt)
+    {
+        std::string text{ "ads_shown,percentage_clicked,earning_per_click\n" };
+        for (std::size_t i{ 0 }; i < rows; ++i)
+        {
+            text += std::to_string(mt() % 100'000);
+            text += ',';
+            text += std::to_string(mt() % 100) + '.' + std::to_string(mt() % 100);
+            text += ',';
+            // every few rows, a number that needs the from_chars path
+            if (mt() % 16 == 0)
+                text += std::to_string(mt() % 1000) + "e-3";
+            else
+                text += std::to_string(mt() % 10) + '.' + std::to_string(mt() % 1'000'000'000'000ULL);
+            text += '\n';
+        }
+        return text;
+    }
+
+    void main()
+    {
+        int failures{ 0 };
+
+        // the fast decimal path against from_chars
+        std::mt19937_64 mt{ 39 };
+        for (int i{ 0 }; i < 200'000; ++i)
+        {
+            std::string text{ std::to_string(mt() % 10'000'000) + '.' + std::to_string(mt() % 100'000'000) };
+            double fast{}, exact{};
+            float fastFloat{}, exactFloat{};
+            csv::detail::parseDecimal(text.data(), text.data() + text.size(), fast);
+            csv::detail::parseDecimal(text.data(), text.data() + text.size(), fastFloat);
+            std::from_chars(text.data(), text.data() + text.size(), exact);
+            std::from_chars(text.data(), text.data() + text.size(), exactFloat);
+            failures += fast != exact || fastFloat != exactFloat;
+        }
+
+        // the SWAR parsers against the plain ones, on short random tokens: when the fast one
+        // takes a token, the plain one has to take it too, with the same value
+        constexpr std::string_view alphabet{ "0123456789012345678901234567890123456789..--+e," };
+        for (int i{ 0 }; i < 1'000'000; ++i)
+        {
+            char token[16]{};
+            int length{ static_cast<int>(mt() % 10) };
+            for (int j{ 0 }; j < length; ++j)
+                token[j] = alphabet[mt() % alphabet.size()];
+            for (int j{ length }; j < 16; ++j)
+                token[j] = alphabet[mt() % alphabet.size()];     // junk after the token
+
+            std::int32_t fastInteger{}, plainInteger{};
+            float fastFloat{}, plainFloat{};
+            double fastDouble{}, plainDouble{};
+            if (csv::detail::parseIntegerFast(token, length, fastInteger))
+                failures += !csv::detail::parseInteger(token, token + length, plainInteger) || fastInteger != plainInteger;
+            if (csv::detail::parseDecimalFast(token, length, fastFloat))
+                failures += !csv::detail::parseDecimal(token, token + length, plainFloat) || fastFloat != plainFloat;
+            if (csv::detail::parseDecimalFast(token, length, fastDouble))
+                failures += !csv::detail::parseDecimal(token, token + length, plainDouble) || fastDouble != plainDouble;
+        }
+
+        std::int32_t integer{};
+        failures += !csv::detail::parseIntegerFast("-1234567,", 8, integer) || integer != -1234567;
+        failures += !csv::detail::parseIntegerFast("12345678,", 8, integer) || integer != 12345678;
+        failures += csv::detail::parseIntegerFast("123456789", 9, integer);
+        failures += csv::detail::parseIntegerFast("-,123456", 1, integer);
+        failures += csv::detail::parseIntegerFast("1/345678", 3, integer);
+        double decimal{};
+        failures += !csv::detail::parseDecimalFast(".5,45678", 2, decimal) || decimal != 0.5;
+        failures += !csv::detail::parseDecimalFast("-7.,45678", 3, decimal) || decimal != -7.0;
+        failures += !csv::detail::parseDecimalFast("1234.567", 8, decimal) || decimal != 1234.567;
+        failures += csv::detail::parseDecimalFast(".,345678", 1, decimal);
+        failures += csv::detail::parseDecimalFast("1.2.3,78", 5, decimal);
+
+        failures += !csv::detail::parseInteger("-2147483648", "-2147483648" + 11, integer) || integer != -2147483648;
+        failures += csv::detail::parseInteger("2147483648", "2147483648" + 10, integer);
+        failures += csv::detail::parseInteger("12a", "12a" + 3, integer);
+
+        // parse() against the stream version
+        std::string text{ randomCsv(50'000, mt) };
+        std::vector<Advertising> expected{ readWithStreams(text) };
+        csv::AdvertisingColumns columns{};
+        csv::parse(text, columns);
+        failures += columns.size() != expected.size() || columns.rejected != 1;
+        for (std::size_t i{ 0 }; i < std::min(columns.size(), expected.size()); ++i)
+        {
+            Advertising ad{ columns[i] };
+            failures += ad.numberOfAdsShown != expected[i].numberOfAdsShown
+                     || ad.percentageOfAdsClicked != expected[i].percentageOfAdsClicked
+                     || ad.earningPerClick != expected[i].earningPerClick;
+        }
+
+        // parse() against parseLine() on every line, on messy text: the fast path has to give
+        // up on everything it doesn't handle exactly like parseLine()
+        constexpr std::string_view fields[]{ "1", "-42", "+7", "12345678", "123456789", "3.25", "-0.5", ".5", "7.",
+                                             "1e3", "99999999", "16777217", "0.000001", "", "x", "1.2.3", "--1" };
+        for (int round{ 0 }; round < 200; ++round)
+        {
+            std::string messy{};
+            std::vector<std::string> lines{};
+            for (int i{ 0 }; i < 50; ++i)
+            {
+                std::string line{};
+                int count{ mt() % 8 == 0 ? static_cast<int>(mt() % 5) : 3 };
+                for (int j{ 0 }; j < count; ++j)
+                    line += std::string{ j ? "," : "" } + std::string{ fields[mt() % std::size(fields)] };
+                if (mt() % 8 == 0)
+                    line += '\r';
+                lines.push_back(line);
+                messy += line + '\n';
+            }
+            if (mt() % 2 == 0)
+                messy.pop_back();       // no newline at the very end
+
+            // (copied to a buffer of exactly the right size, so that the sanitizers see reads past the end)
+            std::vector<char> exact(messy.begin(), messy.end());
+            csv::AdvertisingColumns fast{}, slow{};
+            csv::parse({ exact.data(), exact.size() }, fast);
+            for (const std::string& line : lines)
+                csv::parseLine(line.data(), line.data() + line.size(), slow);
+
+            failures += fast.size() != slow.size() || fast.rejected != slow.rejected;
+            for (std::size_t i{ 0 }; i < std::min(fast.size(), slow.size()); ++i)
+            {
+                failures += fast.adsShown[i] != slow.adsShown[i] || fast.percentageClicked[i] != slow.percentageClicked[i]
+                         || fast.earningPerClick[i] != slow.earningPerClick[i];
+            }
+        }
+
+        // the whole pipeline, with chunks small enough to cut lines all over the place, and a
+        // file that doesn't end with a newline
+        auto path{ std::filesystem::temp_directory_path() / "advertising_checks.csv" };
+        {
+            std::ofstream file{ path, std::ios::binary };
+            file << text << "7,1.5,2";
+        }
+
+        csv::Summary reference{};
+        {
+            csv::AdvertisingColumns all{};
+            csv::parse(text + "7,1.5,2", all);
+            reference.add(all);
+        }
+
+        for (unsigned parsers : { 1u, 3u })
+        {
+            std::size_t batches{ 0 };
+            csv::Summary summary{ csv::ingest(path, { 4096, parsers, 0 }, [&](const csv::AdvertisingColumns&) { ++batches; }) };
+            failures += summary.rows != reference.rows || summary.rejected != reference.rejected
+                     || summary.adsShown != reference.adsShown || summary.bestEarnings != reference.bestEarnings
+                     || std::abs(summary.earnings - reference.earnings) > 1e-9 * reference.earnings || batches < 100;
+        }
+
+        // a line that doesn't fit in a chunk
+        try
+        {
+            csv::ingest(path, { 16, 2, 0 });
+            ++failures;
+        }
+        catch (const std::length_error&)
+        {
+        }
+
+        std::filesystem::remove(path);
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+#include <chrono>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    // a "simple numeric CSV": small integers and two-decimal numbers
+    std::string numericCsv(std::size_t bytes)
+    {
+        std::mt19937_64 mt{ 1 };
+        std::string text{};
+        text.reserve(bytes + 64);
+        while (text.size() < bytes)
+        {
+            text += std::to_string(mt() % 10'000);
+            text += ',';
+            text += std::to_string(mt() % 100) + '.' + std::to_string(10 + mt() % 90);
+            text += ',';
+            text += std::to_string(mt() % 10) + '.' + std::to_string(10 + mt() % 90);
+            text += '\n';
+        }
+        return text;
+    }
+
+    void main()
+    {
+        constexpr std::size_t megabytes{ 256 };
+        std::string text{ numericCsv(megabytes << 20) };
+        double gigabytes{ static_cast<double>(text.size()) / 1e9 };
+
+        auto path{ std::filesystem::temp_directory_path() / "advertising_benchmark.csv" };
+        {
+            std::ofstream file{ path, std::ios::binary };
+            file << text;
+        }
+
+        std::cout << "(" << megabytes << " MiB of CSV, " << csv::hardwareThreads() << " hardware threads)\n";
+
+        // getline + stringstream, on a 1/16th of it, because it's slow
+        Timer t;
+        std::size_t streamRows{ checks::readWithStreams(text.substr(0, text.size() / 16)).size() };
+        double streamSpeed{ gigabytes / 16 / t.elapsed() };
+
+        // just parse(), from memory, on one core. the first run pays for faulting in the
+        // columns' memory, the pipeline reuses its batches, so the second run is the one timed
+        csv::AdvertisingColumns columns{};
+        csv::parse(text, columns);
+        columns.clear();
+        t.reset();
+        csv::parse(text, columns);
+        double parseSpeed{ gigabytes / t.elapsed() };
+
+        std::cout << "getline + stringstream  : " << streamSpeed << " GB/s (" << streamRows << " rows)\n";
+        std::cout << "parse(), one core       : " << parseSpeed << " GB/s (" << columns.size() << " rows)\n";
+
+        // the whole pipeline, from the file (which is likely in the page cache by now)
+        // (ingest() doesn't use more parsers than there are hardware threads)
+        for (unsigned parsers{ 1 }; parsers <= csv::hardwareThreads(); parsers *= 2)
+        {
+            t.reset();
+            csv::Summary summary{ csv::ingest(path, { 4 << 20, parsers, 0 }) };
+            double seconds{ t.elapsed() };
+            std::cout << "pipeline, " << parsers << " parser(s)    : " << gigabytes / seconds << " GB/s ("
+                      << summary.rows << " rows, $ " << summary.earnings << ")\n";
+        }
+
+        std::filesystem::remove(path);
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    example::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
@@ -0,0 +1,736 @@
+// [ Description ]
+/*---------------------------------------------------------------------------------------
+    Triad<T> from quiz_3, stored "struct of arrays": every member in its own array,
+    behind an interface that still looks like a vector of Triads.
+---------------------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <vector>
+#include <tuple>
+#include <span>
+#include <utility>          // std::index_sequence, std::declval
+#include <type_traits>
+#include <algorithm>        // std::sort
+#include <numeric>          // std::iota
+#include <functional>       // std::less
+#include <cstddef>          // std::size_t
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+// std::vector<Triad<float>> stores  first second third first second third ...
+// which is perfect when we use whole Triads, and wasteful when a hot loop only reads the
+// .second of every Triad: two thirds of every cache line we load are thrown away, and the
+// values we want are 12 bytes apart, so they can't be loaded into a SIMD register at once.
+
+// the usual fix is to rewrite the data by hand as three vectors, and then keep them in sync
+// by hand everywhere (push_back into all three, erase from all three, sort all three the
+// same way...). SoaVector<Record> does that once, for any simple aggregate:
+
+//      SoaVector<Triad<float>> triads{};
+//      triads.push_back({ 1.0f, 2.0f, 3.0f });
+//      triads[0].second = 5.0f;                    // v[i] is a Triad<float&>, a proxy
+//      std::span<float> seconds{ triads.column<1>() };
+
+//  - the members of Record are found with structured bindings (like `auto& [a, b, c]{ t };`),
+//    after counting them by trying to brace-initialize Record with 1, 2, 3... values.
+//    that works for aggregates of up to 8 members (no arrays or bit-fields), and for
+//    std::tuple and std::pair.
+//  - the proxy reference is Record with every template argument turned into a reference:
+//    Triad<float> gives Triad<float&>, std::pair<int, double> gives std::pair<int&, double&>.
+//    for records that aren't templates that can't work, so the proxy is a std::tuple<F&...>.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ Triad, from quiz_3 ]============
+---------------------------------------------------------------------------------------*/
+
+template <typename T>
+struct Triad
+{
+    T first {};
+    T second {};
+    T third {};
+};
+
+// for C++17
+template <typename T>
+Triad(T, T, T) -> Triad<T>;
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                   ============[ members of an aggregate ]============
+---------------------------------------------------------------------------------------*/
+
+namespace soa::detail
+{
+    // converts to anything, so Record{ AnyField{}, AnyField{} } compiles iff Record has (at least) 2 members
+    struct AnyField
+    {
+        template <typename T>
+        operator T() const;
+    };
+
+    template <typename Record, std::size_t... I>
+    constexpr bool bracesWith(std::index_sequence<I...>)
+    {
+        return requires { Record{ (void(I), AnyField{})... }; };
+    }
+
+    template <typename Record>
+    constexpr std::size_t memberCount()
+    {
+        if constexpr (requires { std::tuple_size<Record>::value; })
+            return std::tuple_size_v<Record>;
+        else
+        {
+            std::size_t count{ 0 };
+            [&]<std::size_t... N>(std::index_sequence<N...>) {
+                ((bracesWith<Record>(std::make_index_sequence<N + 1>{}) ? count = N + 1 : count), ...);
+            }(std::make_index_sequence<8>{});
+            return count;
+        }
+    }
+
+    // a std::tuple of references to the members of [record]
+    template <typename Record>
+    constexpr auto tie(Record& record)
+    {
+        constexpr std::size_t count{ memberCount<std::remove_const_t<Record>>() };
+        static_assert(count >= 1 && count <= 8, "SoaVector: Record must be an aggregate with 1 to 8 members");
+
+        // clang-format off
+        if constexpr (count == 1) { auto& [a] = record; return std::tie(a); }
+        else if constexpr (count == 2) { auto& [a, b] = record; return std::tie(a, b); }
+        else if constexpr (count == 3) { auto& [a, b, c] = record; return std::tie(a, b, c); }
+        else if constexpr (count == 4) { auto& [a, b, c, d] = record; return std::tie(a, b, c, d); }
+        else if constexpr (count == 5) { auto& [a, b, c, d, e] = record; return std::tie(a, b, c, d, e); }
+        else if constexpr (count == 6) { auto& [a, b, c, d, e, f] = record; return std::tie(a, b, c, d, e, f); }
+        else if constexpr (count == 7) { auto& [a, b, c, d, e, f, g] = record; return std::tie(a, b, c, d, e, f, g); }
+        else { auto& [a, b, c, d, e, f, g, h] = record; return std::tie(a, b, c, d, e, f, g, h); }
+        // clang-format on
+    }
+
+    template <typename Tuple>
+    struct Decayed;
+
+    template <typename... Refs>
+    struct Decayed<std::tuple<Refs...>>
+    {
+        using type = std::tuple<std::remove_cvref_t<Refs>...>;
+    };
+
+    // std::tuple<F...> of the member types
+    template <typename Record>
+    using Members = typename Decayed<decltype(tie(std::declval<Record&>()))>::type;
+
+    // Record<Args&...> if that's brace-constructible from the member references and all of its
+    // members are references, else a tuple of them
+    template <typename Record, typename Qualify>
+    struct Rebind
+    {
+        using type = void;
+    };
+
+    template <template <typename...> class Template, typename... Args, typename Qualify>
+    struct Rebind<Template<Args...>, Qualify>
+    {
+        using type = Template<typename Qualify::template apply<Args>...>;
+    };
+
+    struct AsReference
+    {
+        template <typename T>
+        using apply = T&;
+    };
+
+    struct AsConstReference
+    {
+        template <typename T>
+        using apply = const T&;
+    };
+
+    template <typename Proxy, typename Tuple>
+    constexpr bool bracesFrom{ false };
+
+    template <typename Proxy, typename... Refs>
+    constexpr bool bracesFrom<Proxy, std::tuple<Refs...>>{ requires(Refs... refs) { Proxy{ refs... }; } };
+
+    template <typename... M>
+    using AllReferences = std::bool_constant<(std::is_reference_v<M> && ...)>;
+
+    // whether every one of the [Count] members of [proxy] is declared as a reference. a template
+    // like `template <typename T> struct Priced { T item; double price; }` rebinds to
+    // Priced<int&>, whose price would be a copy, and writing to it would do nothing
+    template <std::size_t Count, typename Proxy>
+    auto referenceMembers(Proxy& proxy)
+    {
+        // clang-format off
+        if constexpr (Count == 1) { auto& [a] = proxy; return AllReferences<decltype(a)>{}; }
+        else if constexpr (Count == 2) { auto& [a, b] = proxy; return AllReferences<decltype(a), decltype(b)>{}; }
+        else if constexpr (Count == 3) { auto& [a, b, c] = proxy; return AllReferences<decltype(a), decltype(b), decltype(c)>{}; }
+        else if constexpr (Count == 4) { auto& [a, b, c, d] = proxy; return AllReferences<decltype(a), decltype(b), decltype(c), decltype(d)>{}; }
+        else if constexpr (Count == 5) { auto& [a, b, c, d, e] = proxy; return AllReferences<decltype(a), decltype(b), decltype(c), decltype(d), decltype(e)>{}; }
+        else if constexpr (Count == 6) { auto& [a, b, c, d, e, f] = proxy; return AllReferences<decltype(a), decltype(b), decltype(c), decltype(d), decltype(e), decltype(f)>{}; }
+        else if constexpr (Count == 7) { auto& [a, b, c, d, e, f, g] = proxy; return AllReferences<decltype(a), decltype(b), decltype(c), decltype(d), decltype(e), decltype(f), decltype(g)>{}; }
+        else { auto& [a, b, c, d, e, f, g, h] = proxy; return AllReferences<decltype(a), decltype(b), decltype(c), decltype(d), decltype(e), decltype(f), decltype(g), decltype(h)>{}; }
+        // clang-format on
+    }
+
+    // only looked at when the proxy can be built at all (a void one can't be decomposed)
+    template <typename Proxy, typename Refs, bool = bracesFrom<Proxy, Refs>>
+    constexpr bool usableProxy{ false };
+
+    template <typename Proxy, typename Refs>
+    constexpr bool usableProxy<Proxy, Refs, true>{ decltype(referenceMembers<std::tuple_size_v<Refs>>(std::declval<Proxy&>()))::value };
+
+    template <typename Record, typename Qualify, typename Refs>
+    using ProxyFor = std::conditional_t<usableProxy<typename Rebind<Record, Qualify>::type, Refs>,
+                                        typename Rebind<Record, Qualify>::type, Refs>;
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                          ============[ SoaVector ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - operator[] returns a proxy that refers into the columns: `v[i].first = 5` writes to the
+    first column. the proxy can't be assigned a whole Record at once (a struct of references
+    can't be re-seated), use set(i, record) for that, and get(i) to copy one out.
+
+  - column<I>() is the I-th member of every record as one contiguous std::span, for loops
+    (and SIMD kernels) that only need that member.
+
+  - sort() sorts a permutation of the indices, then moves every column through it once, so
+    each column is only touched once no matter how many comparisons were made. like std::sort,
+    it's not stable. sortBy<I>() compares column I directly, which is a lot cheaper than
+    building proxies for every comparison.
+*/
+
+namespace soa
+{
+    template <typename Record>
+    class SoaVector
+    {
+    private:
+        using Members = detail::Members<Record>;
+        static constexpr std::size_t s_members{ std::tuple_size_v<Members> };
+
+        template <typename Tuple>
+        struct ColumnsOf;
+
+        template <typename... Fields>
+        struct ColumnsOf<std::tuple<Fields...>>
+        {
+            using type = std::tuple<std::vector<Fields>...>;
+            using references = std::tuple<Fields&...>;
+            using constReferences = std::tuple<const Fields&...>;
+        };
+
+        using Columns = typename ColumnsOf<Members>::type;
+
+        Columns m_columns{};
+
+        template <typename Fn>
+        void forEachColumn(Fn&& fn)
+        {
+            std::apply([&](auto&... column) { (fn(column), ...); }, m_columns);
+        }
+
+    public:
+        using value_type = Record;
+        using reference = detail::ProxyFor<Record, detail::AsReference, typename ColumnsOf<Members>::references>;
+        using const_reference = detail::ProxyFor<Record, detail::AsConstReference, typename ColumnsOf<Members>::constReferences>;
+
+        template <std::size_t I>
+        using member_type = std::tuple_element_t<I, Members>;
+
+        std::size_t size() const { return std::get<0>(m_columns).size(); }
+        bool empty() const { return size() == 0; }
+
+        void reserve(std::size_t capacity)
+        {
+            forEachColumn([&](auto& column) { column.reserve(capacity); });
+        }
+
+        void clear()
+        {
+            forEachColumn([](auto& column) { column.clear(); });
+        }
+
+        void push_back(const Record& record)
+        {
+            Record copy{ record };
+            std::apply([&](auto&... member) {
+                std::apply([&](auto&... column) { (column.push_back(std::move(member)), ...); }, m_columns);
+            }, detail::tie(copy));
+        }
+
+        reference operator[](std::size_t index)
+        {
+            return std::apply([&](auto&... column) { return reference{ column[index]... }; }, m_columns);
+        }
+
+        const_reference operator[](std::size_t index) const
+        {
+            return std::apply([&](const auto&... column) { return const_reference{ column[index]... }; }, m_columns);
+        }
+
+        Record get(std::size_t index) const
+        {
+            Record record{};
+            std::apply([&](auto&... member) {
+                std::apply([&](const auto&... column) { ((member = column[index]), ...); }, m_columns);
+            }, detail::tie(record));
+            return record;
+        }
+
+        void set(std::size_t index, const Record& record)
+        {
+            Record copy{ record };
+            std::apply([&](auto&... member) {
+                std::apply([&](auto&... column) { ((column[index] = std::move(member)), ...); }, m_columns);
+            }, detail::tie(copy));
+        }
+
+        template <std::size_t I>
+        std::span<member_type<I>> column() { return std::get<I>(m_columns); }
+
+        template <std::size_t I>
+        std::span<const member_type<I>> column() const { return std::get<I>(m_columns); }
+
+        void erase(std::size_t index)
+        {
+            forEachColumn([&](auto& column) { column.erase(column.begin() + static_cast<std::ptrdiff_t>(index)); });
+        }
+
+        // erases every record for which predicate(const_reference) is true, returns how many
+        template <typename Predicate>
+        std::size_t eraseIf(Predicate predicate)
+        {
+            std::vector<char> keep(size());
+            for (std::size_t i{ 0 }; i < size(); ++i)
+                keep[i] = !predicate(std::as_const(*this)[i]);
+
+            std::size_t kept{ 0 };
+            forEachColumn([&](auto& column) {
+                kept = 0;
+                for (std::size_t i{ 0 }; i < column.size(); ++i)
+                {
+                    if (!keep[i])
+                        continue;
+                    if (kept != i)          // no self-moves, they're allowed to empty a std::string
+                        column[kept] = std::move(column[i]);
+                    ++kept;
+                }
+                column.resize(kept);
+            });
+            return keep.size() - kept;
+        }
+
+        // sorts by comparing const_references
+        template <typename Compare>
+        void sort(Compare compare)
+        {
+            std::vector<std::size_t> order(size());
+            std::iota(order.begin(), order.end(), std::size_t{ 0 });
+            std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                return compare(std::as_const(*this)[a], std::as_const(*this)[b]);
+            });
+            permute(order);
+        }
+
+        // sorts by column I
+        template <std::size_t I, typename Compare = std::less<>>
+        void sortBy(Compare compare = {})
+        {
+            const auto& key{ std::get<I>(m_columns) };
+            std::vector<std::size_t> order(size());
+
+            if constexpr (std::is_trivially_copyable_v<member_type<I>>)
+            {
+                // sorting (key, index) pairs keeps the comparisons in cache, instead of
+                // looking up key[index] all over the column for every one of them
+                std::vector<std::pair<member_type<I>, std::size_t>> keyed(size());
+                for (std::size_t i{ 0 }; i < size(); ++i)
+                    keyed[i] = { key[i], i };
+                std::sort(keyed.begin(), keyed.end(), [&](const auto& a, const auto& b) { return compare(a.first, b.first); });
+                for (std::size_t i{ 0 }; i < size(); ++i)
+                    order[i] = keyed[i].second;
+            }
+            else
+            {
+                std::iota(order.begin(), order.end(), std::size_t{ 0 });
+                std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return compare(key[a], key[b]); });
+            }
+            permute(order);
+        }
+
+    private:
+        // afterwards, record i is what record order[i] was
+        void permute(const std::vector<std::size_t>& order)
+        {
+            forEachColumn([&](auto& column) {
+                std::remove_reference_t<decltype(column)> sorted{};
+                sorted.reserve(column.size());
+                for (std::size_t from : order)
+                    sorted.push_back(std::move(column[from]));
+                column.swap(sorted);
+            });
+        }
+
+    public:
+        template <bool Const>
+        class Iterator
+        {
+        private:
+            using Vector = std::conditional_t<Const, const SoaVector, SoaVector>;
+
+            Vector* m_vector{ nullptr };
+            std::size_t m_index{ 0 };
+
+        public:
+            // *it is a proxy made on the fly, not a reference to a Record that exists somewhere,
+            // so this can only be an input iterator (a forward iterator's operator* has to
+            // return a real reference)
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Record;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<Const, typename SoaVector::const_reference, typename SoaVector::reference>;
+
+            Iterator() = default;
+            Iterator(Vector* vector, std::size_t index)
+                : m_vector{ vector }
+                , m_index{ index }
+            {
+            }
+
+            reference operator*() const { return (*m_vector)[m_index]; }
+
+            Iterator& operator++()
+            {
+                ++m_index;
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator old{ *this };
+                ++m_index;
+                return old;
+            }
+
+            friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_index == b.m_index; }
+        };
+
+        Iterator<false> begin() { return { this, 0 }; }
+        Iterator<false> end() { return { this, size() }; }
+        Iterator<true> begin() const { return { this, 0 }; }
+        Iterator<true> end() const { return { this, size() }; }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ example ]============
+---------------------------------------------------------------------------------------*/
+
+template <typename T>
+void print(Triad<T> t)
+{
+    std::cout << '[' << t.first << ", " << t.second << ", " << t.third << "]\n";
+}
+
+namespace example
+{
+    struct Employee
+    {
+        int id {};
+        int age {};
+        double wage {};
+    };
+
+    void main()
+    {
+        soa::SoaVector<Triad<int>> triads{};
+        triads.push_back({ 1, 2, 3 });
+        triads.push_back({ 7, 8, 9 });
+        triads.push_back({ 4, 5, 6 });
+
+        triads[2].second = 50;                      // writes into the second column
+        triads.sortBy<0>();
+
+        for (auto triad : triads)                   // triad is a Triad<int&>
+            std::cout << '[' << triad.first << ", " << triad.second << ", " << triad.third << "] ";
+        std::cout << '\n';
+
+        print(triads.get(1));
+        std::cout << "seconds:";
+        for (int second : triads.column<1>())
+            std::cout << ' ' << second;
+        std::cout << '\n';
+
+        // a record that isn't a template gets a std::tuple of references instead
+        soa::SoaVector<Employee> employees{};
+        employees.push_back({ 14, 32, 24.15 });
+        employees.push_back({ 15, 28, 18.27 });
+        auto [id, age, wage]{ employees[1] };
+        wage *= 2;
+        std::cout << "employee " << id << " (" << age << ") now earns " << employees.column<2>()[1] << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <random>
+#include <string>
+#include <iterator>
+
+namespace checks
+{
+    // only the first member depends on T: Priced<int&> would copy the price
+    template <typename T>
+    struct Priced
+    {
+        T item;
+        double price;
+    };
+
+    static_assert(std::is_same_v<soa::SoaVector<Priced<int>>::reference, std::tuple<int&, double&>>);
+    static_assert(std::is_same_v<soa::SoaVector<Triad<float>>::reference, Triad<float&>>);
+    static_assert(std::is_same_v<soa::SoaVector<std::pair<int, double>>::reference, std::pair<int&, double&>>);
+    static_assert(std::is_same_v<soa::SoaVector<example::Employee>::reference, std::tuple<int&, int&, double&>>);
+
+    // the iterators are input iterators to the standard algorithms. (the C++20 std::input_iterator
+    // concept wants more: a common reference between Triad<int&> and Triad<int>&, which the
+    // standard only provides for std::pair and std::tuple, and only from C++23 on)
+    using TriadIterator = decltype(std::declval<soa::SoaVector<Triad<int>>&>().begin());
+    using ConstTriadIterator = decltype(std::declval<const soa::SoaVector<Triad<int>>&>().begin());
+    static_assert(std::is_same_v<std::iterator_traits<TriadIterator>::iterator_category, std::input_iterator_tag>);
+    static_assert(std::is_same_v<std::iterator_traits<TriadIterator>::reference, Triad<int&>>);
+    static_assert(std::is_same_v<std::iterator_traits<ConstTriadIterator>::reference, Triad<const int&>>);
+    static_assert(std::input_or_output_iterator<TriadIterator> && std::sentinel_for<TriadIterator, TriadIterator>);
+
+    void main()
+    {
+        std::mt19937 mt{ 40 };
+        std::vector<Triad<std::string>> expected{};
+        soa::SoaVector<Triad<std::string>> actual{};
+
+        for (int i{ 0 }; i < 2000; ++i)
+        {
+            Triad<std::string> triad{ std::to_string(mt() % 500), std::to_string(i), std::to_string(mt()) };
+            expected.push_back(triad);
+            actual.push_back(triad);
+        }
+
+        auto same{ [&] {
+            if (expected.size() != actual.size())
+                return false;
+            for (std::size_t i{ 0 }; i < expected.size(); ++i)
+            {
+                Triad<std::string> triad{ actual.get(i) };
+                if (triad.first != expected[i].first || triad.second != expected[i].second || triad.third != expected[i].third)
+                    return false;
+            }
+            return true;
+        } };
+
+        int failures{ 0 };
+        failures += !same();
+
+        for (int i{ 0 }; i < 100; ++i)
+        {
+            std::size_t index{ mt() % expected.size() };
+            expected.erase(expected.begin() + static_cast<std::ptrdiff_t>(index));
+            actual.erase(index);
+        }
+        failures += !same();
+
+        std::erase_if(expected, [](const Triad<std::string>& t) { return t.third.back() == '7'; });
+        actual.eraseIf([](const auto& t) { return t.third.back() == '7'; });
+        failures += !same();
+
+        // sortBy<0> isn't stable, so the checks sort by (first, second), which is unique
+        auto byFirstThenSecond{ [](const auto& a, const auto& b) {
+            return std::tie(a.first, a.second) < std::tie(b.first, b.second);
+        } };
+        std::sort(expected.begin(), expected.end(), byFirstThenSecond);
+        actual.sort(byFirstThenSecond);
+        failures += !same();
+
+        actual[3].third = "changed";
+        expected[3].third = "changed";
+        actual.set(5, { "a", "b", "c" });
+        expected[5] = { "a", "b", "c" };
+        failures += !same();
+
+        // sortBy on a trivially copyable column (unique keys, so the order is the same)
+        soa::SoaVector<Triad<int>> numbers{};
+        for (int i{ 0 }; i < 1000; ++i)
+            numbers.push_back({ i, (i * 7919) % 1000, -i });
+        numbers.sortBy<1>(std::greater<>{});
+        for (std::size_t i{ 0 }; i < numbers.size(); ++i)
+            failures += numbers[i].second != 999 - static_cast<int>(i) || (numbers[i].first * 7919) % 1000 != numbers[i].second
+                     || numbers[i].third != -numbers[i].first;
+
+        // through the iterators, with a standard algorithm and with the postfix ++
+        failures += std::count_if(numbers.begin(), numbers.end(), [](Triad<int&> t) { return t.first % 2 == 0; }) != 500;
+        auto it{ numbers.begin() };
+        failures += (*it++).second != 999 || (*it).second != 998;
+
+        soa::SoaVector<Priced<int>> prices{};
+        prices.push_back({ 1, 2.5 });
+        auto [item, price]{ prices[0] };
+        item = 7;
+        price = 9.75;
+        failures += prices.get(0).item != 7 || prices.get(0).price != 9.75;
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// 10 million Triad<float>: scanning one member with std::vector<Triad<float>> and with the
+// columns of a SoaVector (through the proxies, through the span, and with an SSE2 kernel)
+
+#include <chrono>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    // the kind of kernel column spans are for: 4 floats at a time (and 4 partial sums)
+    float sum(std::span<const float> values)
+    {
+        std::size_t i{ 0 };
+        float total{ 0.0f };
+#if defined(__SSE2__)
+        __m128 a{ _mm_setzero_ps() }, b{ _mm_setzero_ps() }, c{ _mm_setzero_ps() }, d{ _mm_setzero_ps() };
+        for (; i + 16 <= values.size(); i += 16)
+        {
+            a = _mm_add_ps(a, _mm_loadu_ps(values.data() + i));
+            b = _mm_add_ps(b, _mm_loadu_ps(values.data() + i + 4));
+            c = _mm_add_ps(c, _mm_loadu_ps(values.data() + i + 8));
+            d = _mm_add_ps(d, _mm_loadu_ps(values.data() + i + 12));
+        }
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, _mm_add_ps(_mm_add_ps(a, b), _mm_add_ps(c, d)));
+        total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+        for (; i < values.size(); ++i)
+            total += values[i];
+        return total;
+    }
+
+    constexpr std::size_t g_count{ 10'000'000 };
+    constexpr int g_repeats{ 5 };
+
+    template <typename Fn>
+    double perElement(Fn fn)
+    {
+        Timer t;
+        for (int r{ 0 }; r < g_repeats; ++r)
+            fn();
+        return t.elapsed() / g_repeats / g_count * 1e9;
+    }
+
+    void main()
+    {
+        std::mt19937 mt{ 1 };
+        std::uniform_real_distribution<float> dist{ 0.0f, 1.0f };
+
+        std::vector<Triad<float>> aos{};
+        soa::SoaVector<Triad<float>> soa{};
+        aos.reserve(g_count);
+        soa.reserve(g_count);
+        for (std::size_t i{ 0 }; i < g_count; ++i)
+        {
+            Triad<float> triad{ dist(mt), dist(mt), dist(mt) };
+            aos.push_back(triad);
+            soa.push_back(triad);
+        }
+
+        volatile float sink{};
+        std::cout << "(" << g_count << " Triad<float>, ns per element)\n";
+
+        // 1. sum of .second (the floating point sum can't be reordered, so only the
+        //    hand-written kernel gets SIMD)
+        double aosTime{ perElement([&] { float s{ 0 }; for (const auto& t : aos) s += t.second; sink = s; }) };
+        double proxyTime{ perElement([&] { float s{ 0 }; for (std::size_t i{ 0 }; i < soa.size(); ++i) s += soa[i].second; sink = s; }) };
+        double spanTime{ perElement([&] { float s{ 0 }; for (float v : soa.column<1>()) s += v; sink = s; }) };
+        double simdTime{ perElement([&] { sink = sum(soa.column<1>()); }) };
+
+        std::cout << "sum of .second : vector<Triad> " << aosTime << ", proxies " << proxyTime
+                  << ", span " << spanTime << ", span + SSE2 " << simdTime << '\n';
+
+        // 2. scale .first in place (this one the compiler can vectorize on its own)
+        aosTime = perElement([&] { for (auto& t : aos) t.first *= 1.0001f; });
+        spanTime = perElement([&] { for (float& v : soa.column<0>()) v *= 1.0001f; });
+        std::cout << "scale .first   : vector<Triad> " << aosTime << ", span " << spanTime << '\n';
+
+        // 3. sorting by .third moves whole records around in both cases
+        Timer t;
+        std::sort(aos.begin(), aos.end(), [](const auto& a, const auto& b) { return a.third < b.third; });
+        aosTime = t.elapsed() / g_count * 1e9;
+        t.reset();
+        soa.sortBy<2>();
+        double soaTime{ t.elapsed() / g_count * 1e9 };
+        std::cout << "sort by .third : vector<Triad> " << aosTime << ", sortBy<2> " << soaTime
+                  << (aos[g_count / 2].third != soa[g_count / 2].third ? " ?" : "") << '\n';
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    example::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
@@ -0,0 +1,543 @@
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>      // std::size_t
+
+
+// in 11.19 we wrote containsNut() which searches a string for a single literal using
+// std::string_view::find. that's fine for one pattern, but what if we want to know whether a
+// string contains ANY of thousands of patterns?
+
+// the naive way is to loop over every pattern and call find() for each one. the cost of that
+// grows linearly with the number of patterns: 10000 patterns means 10000 scans of the same
+// string.
+
+// the Aho-Corasick algorithm solves this by building an automaton (a trie of all patterns plus
+// "failure links") once, and then scanning the text only ONCE, no matter how many patterns
+// there are.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+           ============[ the trie, failure links, and output links ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - every pattern is inserted into a trie. each node (state) represents a prefix of one or
+    more patterns.
+
+  - the failure link of a state points to the state representing the longest proper suffix
+    of the current prefix that is also a prefix in the trie.
+    when we can't follow an edge for the next character, we follow failure links until we
+    can (or until we reach the root).
+
+  - the output link of a state points to the nearest state along the failure chain where a
+    pattern ends. this lets us report every match without walking the whole failure chain.
+*/
+
+
+
+
+/*---------------------------------------------------------------------------------------
+               ============[ the double-array transition table ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - a trie node with a std::map (or a 256 element array) of children is either slow (pointer
+    chasing) or huge (256 * 4 bytes per node).
+
+  - a double-array stores all edges in two flat arrays, [base] and [check]:
+        the edge (s --c--> t) exists  iff  t = base[s] + c  and  check[t] == s
+
+  - a transition is one addition and one comparison against memory that is laid out
+    contiguously, which is much friendlier to the cache.
+
+  - building it means finding, for every state, a [base] where all of its children land on
+    slots that are still free. we do this once, at construction time.
+*/
+
+namespace aho_corasick
+{
+    enum class CaseMode
+    {
+        sensitive,
+        insensitive,
+    };
+
+    class AhoCorasick
+    {
+    private:
+        static constexpr std::int32_t s_root{ 0 };
+        static constexpr std::int32_t s_noState{ -1 };
+        static constexpr int s_alphabetSize{ 257 };     // bytes are mapped to codes 1..256
+
+        std::vector<std::int32_t> m_base{};
+        std::vector<std::int32_t> m_check{};
+        std::vector<std::int32_t> m_fail{};
+        std::vector<std::int32_t> m_outputLink{};       // nearest state on the failure chain with a pattern
+        std::vector<std::int32_t> m_patternAt{};        // pattern id ending at this state (or -1)
+        std::vector<std::uint8_t> m_matches{};          // 1 if a pattern ends here or on the failure chain
+        std::vector<std::size_t> m_patternLengths{};
+        std::array<std::uint8_t, 256> m_fold{};
+        std::size_t m_stateCount{};
+        CaseMode m_caseMode{};
+
+        int code(char ch) const
+        {
+            return m_fold[static_cast<unsigned char>(ch)] + 1;
+        }
+
+        std::int32_t next(std::int32_t state, int c) const
+        {
+            while (true)
+            {
+                std::int32_t t{ m_base[static_cast<std::size_t>(state)] + c };
+                if (m_check[static_cast<std::size_t>(t)] == state)
+                    return t;
+                if (state == s_root)
+                    return s_root;
+                state = m_fail[static_cast<std::size_t>(state)];
+            }
+        }
+
+        void build(const std::vector<std::string_view>& patterns);
+
+    public:
+        explicit AhoCorasick(const std::vector<std::string_view>& patterns, CaseMode caseMode = CaseMode::sensitive)
+            : m_caseMode{ caseMode }
+        {
+            for (std::size_t i{ 0 }; i < m_fold.size(); ++i)
+            {
+                auto ch{ static_cast<std::uint8_t>(i) };
+                if (caseMode == CaseMode::insensitive && ch >= 'A' && ch <= 'Z')
+                    ch = static_cast<std::uint8_t>(ch - 'A' + 'a');
+                m_fold[i] = ch;
+            }
+
+            build(patterns);
+        }
+
+        std::size_t patternCount() const { return m_patternLengths.size(); }
+        std::size_t stateCount() const { return m_stateCount; }
+        CaseMode caseMode() const { return m_caseMode; }
+
+        // returns true as soon as any pattern is found in text
+        bool containsAny(std::string_view text) const
+        {
+            std::int32_t state{ s_root };
+            for (char ch : text)
+            {
+                state = next(state, code(ch));
+                if (m_matches[static_cast<std::size_t>(state)])
+                    return true;
+            }
+            return false;
+        }
+
+        // calls fn(patternId, position) for every match, where position is the index of the
+        // first character of the match in text
+        template <typename Fn>
+        void forEachMatch(std::string_view text, Fn&& fn) const
+        {
+            std::int32_t state{ s_root };
+            for (std::size_t i{ 0 }; i < text.size(); ++i)
+            {
+                state = next(state, code(text[i]));
+
+                for (std::int32_t out{ m_matches[static_cast<std::size_t>(state)] ? state : s_noState };
+                     out != s_noState;
+                     out = m_outputLink[static_cast<std::size_t>(out)])
+                {
+                    auto id{ m_patternAt[static_cast<std::size_t>(out)] };
+                    if (id != s_noState)
+                        fn(static_cast<std::size_t>(id), i + 1 - m_patternLengths[static_cast<std::size_t>(id)]);
+                }
+            }
+        }
+
+        std::size_t countMatches(std::string_view text) const
+        {
+            std::size_t count{ 0 };
+            forEachMatch(text, [&count](std::size_t, std::size_t) { ++count; });
+            return count;
+        }
+
+        // a cheap, copyable callable that can be passed to std::find_if, std::count_if, etc.
+        // the algorithms take predicates by value, so we only copy a pointer to the automaton,
+        // never the automaton itself.
+        class Predicate
+        {
+        private:
+            const AhoCorasick* m_automaton{};
+
+        public:
+            explicit Predicate(const AhoCorasick& automaton)
+                : m_automaton{ &automaton }
+            {
+            }
+
+            bool operator()(std::string_view text) const
+            {
+                return m_automaton->containsAny(text);
+            }
+        };
+
+        Predicate predicate() const
+        {
+            return Predicate{ *this };
+        }
+    };
+
+
+    void AhoCorasick::build(const std::vector<std::string_view>& patterns)
+    {
+        // 1. build an ordinary trie, children kept as sorted (code, child) lists
+        struct Node
+        {
+            std::vector<std::pair<int, std::int32_t>> children{};
+            std::int32_t patternId{ s_noState };
+        };
+
+        std::vector<Node> trie(1);
+        m_patternLengths.reserve(patterns.size());
+
+        for (std::size_t id{ 0 }; id < patterns.size(); ++id)
+        {
+            std::int32_t state{ s_root };
+            for (char ch : patterns[id])
+            {
+                int c{ code(ch) };
+                auto& children{ trie[static_cast<std::size_t>(state)].children };
+                auto found{ std::lower_bound(children.begin(), children.end(), c,
+                                             [](const auto& edge, int value) { return edge.first < value; }) };
+
+                if (found != children.end() && found->first == c)
+                    state = found->second;
+                else
+                {
+                    auto child{ static_cast<std::int32_t>(trie.size()) };
+                    children.insert(found, { c, child });
+                    trie.emplace_back();
+                    state = child;
+                }
+            }
+
+            // duplicate patterns keep the first id
+            if (trie[static_cast<std::size_t>(state)].patternId == s_noState)
+                trie[static_cast<std::size_t>(state)].patternId = static_cast<std::int32_t>(id);
+            m_patternLengths.push_back(patterns[id].size());
+        }
+
+        // 2. lay the trie out in the double-array, in breadth-first order.
+        //    trie states get renumbered to their double-array slot.
+        std::vector<std::int32_t> slotOf(trie.size(), s_noState);
+        slotOf[0] = s_root;
+
+        m_check.assign(s_alphabetSize + 1, s_noState);
+        m_base.assign(s_alphabetSize + 1, 0);
+        m_check[s_root] = s_root;       // the root occupies slot 0 but is never a child
+
+        std::size_t firstFree{ 1 };
+        std::vector<std::int32_t> queue{ 0 };
+
+        for (std::size_t head{ 0 }; head < queue.size(); ++head)
+        {
+            const auto& node{ trie[static_cast<std::size_t>(queue[head])] };
+            auto slot{ slotOf[static_cast<std::size_t>(queue[head])] };
+
+            if (node.children.empty())
+                continue;
+
+            while (firstFree < m_check.size() && m_check[firstFree] != s_noState)
+                ++firstFree;
+
+            // find a base so that base + c is free for every child code c
+            auto firstCode{ node.children.front().first };
+            std::size_t position{ std::max(firstFree, static_cast<std::size_t>(firstCode) + 1) };
+            std::int32_t base{};
+
+            while (true)
+            {
+                base = static_cast<std::int32_t>(position) - firstCode;
+
+                auto needed{ static_cast<std::size_t>(base + node.children.back().first) + 1 };
+                if (needed + s_alphabetSize > m_check.size())
+                {
+                    m_check.resize(needed + s_alphabetSize, s_noState);
+                    m_base.resize(needed + s_alphabetSize, 0);
+                }
+
+                bool fits{ std::all_of(node.children.begin(), node.children.end(), [&](const auto& edge) {
+                    return m_check[static_cast<std::size_t>(base + edge.first)] == s_noState;
+                }) };
+
+                if (fits)
+                    break;
+
+                do
+                    ++position;
+                while (position < m_check.size() && m_check[position] != s_noState);
+            }
+
+            m_base[static_cast<std::size_t>(slot)] = base;
+            for (const auto& [c, child] : node.children)
+            {
+                auto childSlot{ base + c };
+                m_check[static_cast<std::size_t>(childSlot)] = slot;
+                slotOf[static_cast<std::size_t>(child)] = childSlot;
+                queue.push_back(child);
+            }
+        }
+
+        m_stateCount = queue.size();
+
+        // every lookup does base[s] + c with c <= 256 followed by check[..], so make sure the
+        // arrays are always long enough that we never need a bounds check while matching
+        std::size_t size{ m_check.size() + s_alphabetSize };
+        m_check.resize(size, s_noState);
+        m_base.resize(size, 0);
+        m_base.shrink_to_fit();
+        m_check.shrink_to_fit();
+
+        // 3. compute failure and output links, again in breadth-first order so that the
+        //    failure target of a state is always finished before the state itself
+        m_fail.assign(size, s_root);
+        m_outputLink.assign(size, s_noState);
+        m_patternAt.assign(size, s_noState);
+        m_matches.assign(size, 0);
+
+        // every state's own pattern first: a failure target can be at the same depth as the
+        // state that links to it, and so not dequeued yet when its outputs are copied
+        for (std::int32_t trieState : queue)
+        {
+            auto slot{ static_cast<std::size_t>(slotOf[static_cast<std::size_t>(trieState)]) };
+            m_patternAt[slot] = trie[static_cast<std::size_t>(trieState)].patternId;
+            m_matches[slot] = (m_patternAt[slot] != s_noState);
+        }
+
+        for (std::int32_t trieState : queue)
+        {
+            const auto& node{ trie[static_cast<std::size_t>(trieState)] };
+            auto slot{ static_cast<std::size_t>(slotOf[static_cast<std::size_t>(trieState)]) };
+
+            for (const auto& [c, child] : node.children)
+            {
+                auto childSlot{ static_cast<std::size_t>(slotOf[static_cast<std::size_t>(child)]) };
+
+                std::int32_t fail{ s_root };
+                if (slot != s_root)
+                    fail = next(m_fail[slot], c);
+
+                m_fail[childSlot] = fail;
+                auto failSlot{ static_cast<std::size_t>(fail) };
+                m_outputLink[childSlot] = (m_patternAt[failSlot] != s_noState) ? fail : m_outputLink[failSlot];
+                m_matches[childSlot] |= m_matches[failSlot];
+            }
+        }
+    }
+
+
+    void main()
+    {
+        std::array<std::string_view, 6> arr{ "apple", "banana", "Walnut", "lemon", "peanut", "hazelnuts" };
+
+        // a single pattern behaves just like containsNut()
+        AhoCorasick nut{ { "nut" } };
+        auto found{ std::find_if(arr.begin(), arr.end(), nut.predicate()) };
+        std::cout << "First nut: " << *found << '\n';
+
+        // many patterns at once, ignoring case
+        AhoCorasick fruits{ { "nut", "APPLE", "lemon" }, CaseMode::insensitive };
+        std::cout << "Counted " << std::count_if(arr.begin(), arr.end(), fruits.predicate()) << " match(es)\n";
+
+        // reporting every match with its position
+        AhoCorasick overlapping{ { "he", "she", "his", "hers" } };
+        overlapping.forEachMatch("ushers", [](std::size_t id, std::size_t position) {
+            std::cout << "pattern " << id << " at " << position << '\n';
+        });
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+// every match against a brute force search. a small alphabet makes patterns that are suffixes
+// of each other (the failure and output links) common.
+
+#include <random>
+#include <utility>      // std::pair
+
+namespace checks
+{
+    using Match = std::pair<std::size_t, std::size_t>;      // (pattern id, position)
+
+    std::vector<Match> allMatches(const aho_corasick::AhoCorasick& automaton, std::string_view text)
+    {
+        std::vector<Match> matches{};
+        automaton.forEachMatch(text, [&](std::size_t id, std::size_t position) { matches.emplace_back(id, position); });
+        std::sort(matches.begin(), matches.end());
+        return matches;
+    }
+
+    std::vector<Match> bruteForce(const std::vector<std::string_view>& patterns, std::string_view text)
+    {
+        std::vector<Match> matches{};
+        for (std::size_t id{ 0 }; id < patterns.size(); ++id)
+        {
+            // duplicates report the first id only
+            if (std::find(patterns.begin(), patterns.begin() + static_cast<std::ptrdiff_t>(id), patterns[id]) != patterns.begin() + static_cast<std::ptrdiff_t>(id))
+                continue;
+            for (std::size_t position{ 0 }; position + patterns[id].size() <= text.size(); ++position)
+            {
+                if (text.substr(position, patterns[id].size()) == patterns[id])
+                    matches.emplace_back(id, position);
+            }
+        }
+        std::sort(matches.begin(), matches.end());
+        return matches;
+    }
+
+    void main()
+    {
+        int failures{ 0 };
+
+        // a pattern that ends on a failure target at the same depth
+        failures += !aho_corasick::AhoCorasick{ { "abc", "b" } }.containsAny("abx");
+        failures += allMatches(aho_corasick::AhoCorasick{ { "ab", "b" } }, "ab") != std::vector<Match>{ { 0, 0 }, { 1, 1 } };
+
+        std::mt19937 mt{ 26 };
+        auto word{ [&](std::size_t minLength, std::size_t maxLength) {
+            std::string w(minLength + mt() % (maxLength - minLength + 1), ' ');
+            for (char& ch : w)
+                ch = static_cast<char>('a' + mt() % 3);
+            return w;
+        } };
+
+        for (int round{ 0 }; round < 2000; ++round)
+        {
+            std::vector<std::string> storage{};
+            for (std::size_t i{ 0 }, n{ 1 + mt() % 6 }; i < n; ++i)
+                storage.push_back(word(1, 4));
+            std::vector<std::string_view> patterns(storage.begin(), storage.end());
+            std::string text{ word(0, 30) };
+
+            aho_corasick::AhoCorasick automaton{ patterns };
+            auto expected{ bruteForce(patterns, text) };
+            failures += allMatches(automaton, text) != expected;
+            failures += automaton.containsAny(text) != !expected.empty();
+        }
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+              ============[ benchmark: 1 to 10000 patterns ]============
+---------------------------------------------------------------------------------------*/
+
+// the naive approach does one find() per pattern, so its cost grows with the number of
+// patterns. Aho-Corasick scans every record exactly once, so its cost stays (roughly) flat.
+
+#include <chrono>
+#include <random>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    std::string randomWord(std::mt19937& mt, std::size_t minLength, std::size_t maxLength)
+    {
+        std::uniform_int_distribution<std::size_t> length{ minLength, maxLength };
+        std::uniform_int_distribution<int> letter{ 'a', 'z' };
+
+        std::string word(length(mt), ' ');
+        for (char& ch : word)
+            ch = static_cast<char>(letter(mt));
+        return word;
+    }
+
+    void main()
+    {
+        constexpr std::size_t recordCount{ 2000 };
+        std::mt19937 mt{ 42 };
+
+        std::vector<std::string> records{};
+        for (std::size_t i{ 0 }; i < recordCount; ++i)
+            records.push_back(randomWord(mt, 32, 96));
+
+        for (std::size_t patternCount : { 1, 10, 100, 1000, 10000 })
+        {
+            std::vector<std::string> patternStorage{};
+            for (std::size_t i{ 0 }; i < patternCount; ++i)
+                patternStorage.push_back(randomWord(mt, 3, 6));
+            std::vector<std::string_view> patterns(patternStorage.begin(), patternStorage.end());
+
+            Timer t;
+            auto naive{ std::count_if(records.begin(), records.end(), [&patterns](std::string_view record) {
+                return std::any_of(patterns.begin(), patterns.end(), [record](std::string_view pattern) {
+                    return record.find(pattern) != std::string_view::npos;
+                });
+            }) };
+            double naiveTime{ t.elapsed() };
+
+            t.reset();
+            aho_corasick::AhoCorasick automaton{ patterns };
+            double buildTime{ t.elapsed() };
+
+            t.reset();
+            auto fast{ std::count_if(records.begin(), records.end(), automaton.predicate()) };
+            double fastTime{ t.elapsed() };
+
+            std::cout << "patterns: " << patternCount
+                      << "\tstates: " << automaton.stateCount()
+                      << "\tnaive: " << naiveTime << " s"
+                      << "\tbuild: " << buildTime << " s"
+                      << "\taho-corasick: " << fastTime << " s"
+                      << (naive == fast ? "" : "\t(MISMATCH!)") << '\n';
+        }
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    aho_corasick::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
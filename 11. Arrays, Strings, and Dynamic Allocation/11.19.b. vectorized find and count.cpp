@@ -0,0 +1,882 @@
+#include <iostream>
+#include <algorithm>
+#include <ranges>
+#include <iterator>
+#include <span>
+#include <vector>
+#include <array>
+#include <concepts>
+#include <type_traits>
+#include <utility>          // std::forward
+#include <bit>              // std::countr_zero, std::popcount
+#include <cstdint>
+#include <cstddef>          // std::size_t
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+#if defined(__SSE4_2__)
+    #include <nmmintrin.h>  // _mm_cmpgt_epi64
+#endif
+
+
+// std::find and std::count in 11.19 look at one element at a time: load it, compare it,
+// branch. for a column of a million ints that's a million iterations, each doing a few
+// percent of what the CPU could.
+
+// with SSE2, one instruction compares 16 bytes at once: 16 chars, 8 shorts, 4 ints or floats,
+// 2 doubles. _mm_movemask_epi8 then squeezes the comparison into a 16 bit integer (one bit per
+// byte), where countr_zero gives the first match and popcount the number of matches.
+
+// in this file we write find, find_if, find_first_of, count, count_if, min_element,
+// max_element and mismatch that:
+    // - take a range, like std::ranges::find, and return the same thing
+    // - use SSE2 when the range is contiguous (an array, a std::vector, a std::span...) of
+    //   ints, chars or floating point numbers, and the value has the same type as the elements
+    // - fall back to the std::ranges algorithm for everything else, so calling them is always
+    //   correct, just not always faster
+// find_if and count_if can't look inside an arbitrary lambda, so the predicates that can be
+// vectorized are spelled out: lessThan(x), greaterThan(x), equalTo(x), notEqualTo(x) and
+// between(low, high). any other predicate works too, without SIMD.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                  ============[ 16 bytes, whatever the type ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  Ops<T> is the same small set of operations for every element type:
+    load(p), broadcast(x)           a vector of T
+    equal(a, b), less(a, b)         a mask vector: all 1s in the lanes where it's true
+    isNaN(a)                        a mask, always 0 for ints
+  SSE2 only compares SIGNED ints, so unsigned ones are compared with their top bit flipped
+  (which maps 0..2^n-1 onto -2^(n-1)..2^(n-1)-1 in order), and there's no 64 bit comparison
+  at all before SSE4.2, so it's put together from 32 bit ones.
+*/
+
+namespace simd_scan
+{
+    namespace detail
+    {
+        template <typename T>
+        concept Vectorizable = (std::integral<T> && !std::same_as<T, bool>) || std::same_as<T, float> || std::same_as<T, double>;
+
+#if defined(__SSE2__)
+        inline __m128i blend(__m128i mask, __m128i a, __m128i b)
+        {
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+
+        template <typename T>
+        struct Ops;
+
+        template <std::integral T>
+        struct Ops<T>
+        {
+            using Vec = __m128i;
+
+            static Vec load(const T* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+            static Vec broadcast(T x)
+            {
+                if constexpr (sizeof(T) == 1)
+                    return _mm_set1_epi8(static_cast<char>(x));
+                else if constexpr (sizeof(T) == 2)
+                    return _mm_set1_epi16(static_cast<short>(x));
+                else if constexpr (sizeof(T) == 4)
+                    return _mm_set1_epi32(static_cast<int>(x));
+                else
+                    return _mm_set1_epi64x(static_cast<long long>(x));
+            }
+
+            static __m128i equal(Vec a, Vec b)
+            {
+                if constexpr (sizeof(T) == 1)
+                    return _mm_cmpeq_epi8(a, b);
+                else if constexpr (sizeof(T) == 2)
+                    return _mm_cmpeq_epi16(a, b);
+                else if constexpr (sizeof(T) == 4)
+                    return _mm_cmpeq_epi32(a, b);
+                else
+                {
+                    // both halves equal
+                    __m128i halves{ _mm_cmpeq_epi32(a, b) };
+                    return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+                }
+            }
+
+            static __m128i signedGreater(Vec a, Vec b)
+            {
+                if constexpr (sizeof(T) == 1)
+                    return _mm_cmpgt_epi8(a, b);
+                else if constexpr (sizeof(T) == 2)
+                    return _mm_cmpgt_epi16(a, b);
+                else if constexpr (sizeof(T) == 4)
+                    return _mm_cmpgt_epi32(a, b);
+                else
+                {
+#if defined(__SSE4_2__)
+                    return _mm_cmpgt_epi64(a, b);
+#else
+                    // the high halves decide, unless they're equal: then the borrow of the 64 bit
+                    // b - a (set when low(a) > low(b), unsigned) ends up in the high half
+                    __m128i result{ _mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_sub_epi64(b, a)) };
+                    result = _mm_or_si128(result, _mm_cmpgt_epi32(a, b));
+                    return _mm_shuffle_epi32(result, _MM_SHUFFLE(3, 3, 1, 1));
+#endif
+                }
+            }
+
+            static __m128i less(Vec a, Vec b)
+            {
+                if constexpr (std::is_signed_v<T>)
+                    return signedGreater(b, a);
+                else
+                {
+                    Vec flip{ broadcast(static_cast<T>(T{ 1 } << (8 * sizeof(T) - 1))) };
+                    return signedGreater(_mm_xor_si128(b, flip), _mm_xor_si128(a, flip));
+                }
+            }
+
+            static __m128i isNaN(Vec) { return _mm_setzero_si128(); }
+            static Vec min(Vec a, Vec b) { return blend(less(a, b), a, b); }
+            static Vec max(Vec a, Vec b) { return blend(less(b, a), a, b); }
+            static void store(T* p, Vec a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a); }
+        };
+
+        template <>
+        struct Ops<float>
+        {
+            using Vec = __m128;
+
+            static Vec load(const float* p) { return _mm_loadu_ps(p); }
+            static Vec broadcast(float x) { return _mm_set1_ps(x); }
+            static __m128i equal(Vec a, Vec b) { return _mm_castps_si128(_mm_cmpeq_ps(a, b)); }
+            static __m128i less(Vec a, Vec b) { return _mm_castps_si128(_mm_cmplt_ps(a, b)); }
+            static __m128i isNaN(Vec a) { return _mm_castps_si128(_mm_cmpunord_ps(a, a)); }
+            static Vec min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+            static Vec max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+            static void store(float* p, Vec a) { _mm_storeu_ps(p, a); }
+        };
+
+        template <>
+        struct Ops<double>
+        {
+            using Vec = __m128d;
+
+            static Vec load(const double* p) { return _mm_loadu_pd(p); }
+            static Vec broadcast(double x) { return _mm_set1_pd(x); }
+            static __m128i equal(Vec a, Vec b) { return _mm_castpd_si128(_mm_cmpeq_pd(a, b)); }
+            static __m128i less(Vec a, Vec b) { return _mm_castpd_si128(_mm_cmplt_pd(a, b)); }
+            static __m128i isNaN(Vec a) { return _mm_castpd_si128(_mm_cmpunord_pd(a, a)); }
+            static Vec min(Vec a, Vec b) { return _mm_min_pd(a, b); }
+            static Vec max(Vec a, Vec b) { return _mm_max_pd(a, b); }
+            static void store(double* p, Vec a) { _mm_storeu_pd(p, a); }
+        };
+
+        // one bit per byte; a lane of T is sizeof(T) bits
+        inline unsigned bits(__m128i mask)
+        {
+            return static_cast<unsigned>(_mm_movemask_epi8(mask));
+        }
+#endif
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ predicates ]============
+---------------------------------------------------------------------------------------*/
+
+// every predicate is an ordinary callable (so it works with the std algorithms too), plus a
+// mask() for 16 bytes at a time
+
+namespace simd_scan
+{
+    template <typename T>
+    struct LessThan
+    {
+        T value{};
+        bool operator()(const T& x) const { return x < value; }
+#if defined(__SSE2__)
+        template <typename Ops, typename Vec>
+        __m128i mask(Vec x, Vec value_, Vec) const { return Ops::less(x, value_); }
+#endif
+    };
+
+    template <typename T>
+    struct GreaterThan
+    {
+        T value{};
+        bool operator()(const T& x) const { return value < x; }
+#if defined(__SSE2__)
+        template <typename Ops, typename Vec>
+        __m128i mask(Vec x, Vec value_, Vec) const { return Ops::less(value_, x); }
+#endif
+    };
+
+    template <typename T>
+    struct EqualTo
+    {
+        T value{};
+        bool operator()(const T& x) const { return x == value; }
+#if defined(__SSE2__)
+        template <typename Ops, typename Vec>
+        __m128i mask(Vec x, Vec value_, Vec) const { return Ops::equal(x, value_); }
+#endif
+    };
+
+    template <typename T>
+    struct NotEqualTo
+    {
+        T value{};
+        bool operator()(const T& x) const { return x != value; }
+#if defined(__SSE2__)
+        template <typename Ops, typename Vec>
+        __m128i mask(Vec x, Vec value_, Vec) const { return _mm_xor_si128(Ops::equal(x, value_), _mm_set1_epi32(-1)); }
+#endif
+    };
+
+    // low <= x <= high
+    template <typename T>
+    struct Between
+    {
+        T low{};
+        T high{};
+        bool operator()(const T& x) const { return low <= x && x <= high; }
+#if defined(__SSE2__)
+        // for a NaN both comparisons are false, so it has to be excluded on its own
+        template <typename Ops, typename Vec>
+        __m128i mask(Vec x, Vec low_, Vec high_) const
+        {
+            __m128i outside{ _mm_or_si128(Ops::less(x, low_), Ops::less(high_, x)) };
+            return _mm_andnot_si128(_mm_or_si128(outside, Ops::isNaN(x)), _mm_set1_epi32(-1));
+        }
+#endif
+    };
+
+    template <typename T> LessThan<T> lessThan(T value) { return { value }; }
+    template <typename T> GreaterThan<T> greaterThan(T value) { return { value }; }
+    template <typename T> EqualTo<T> equalTo(T value) { return { value }; }
+    template <typename T> NotEqualTo<T> notEqualTo(T value) { return { value }; }
+    template <typename T> Between<T> between(T low, T high) { return { low, high }; }
+
+    namespace detail
+    {
+        // the values a predicate compares against, broadcast once before the loop
+        template <typename T> std::array<T, 2> compareValues(const LessThan<T>& p) { return { p.value, p.value }; }
+        template <typename T> std::array<T, 2> compareValues(const GreaterThan<T>& p) { return { p.value, p.value }; }
+        template <typename T> std::array<T, 2> compareValues(const EqualTo<T>& p) { return { p.value, p.value }; }
+        template <typename T> std::array<T, 2> compareValues(const NotEqualTo<T>& p) { return { p.value, p.value }; }
+        template <typename T> std::array<T, 2> compareValues(const Between<T>& p) { return { p.low, p.high }; }
+
+        template <typename Predicate, typename T>
+        concept Comparison = std::same_as<Predicate, LessThan<T>> || std::same_as<Predicate, GreaterThan<T>>
+                          || std::same_as<Predicate, EqualTo<T>> || std::same_as<Predicate, NotEqualTo<T>>
+                          || std::same_as<Predicate, Between<T>>;
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                        ============[ the kernels ]============
+---------------------------------------------------------------------------------------*/
+
+// on a pointer and a size, returning indices. the main loops go 64 bytes (4 vectors) at a
+// time, and only look at the masks once per 64 bytes; the last few elements are done one by one
+
+#if defined(__SSE2__)
+namespace simd_scan::detail
+{
+    template <typename T, typename Predicate>
+    std::size_t findIf(const T* data, std::size_t size, const Predicate& predicate)
+    {
+        using O = Ops<T>;
+        constexpr std::size_t lanes{ 16 / sizeof(T) };
+        const auto [first, second]{ compareValues(predicate) };
+        const auto low{ O::broadcast(first) };
+        const auto high{ O::broadcast(second) };
+
+        std::size_t i{ 0 };
+        for (; i + 4 * lanes <= size; i += 4 * lanes)
+        {
+            __m128i m0{ predicate.template mask<O>(O::load(data + i), low, high) };
+            __m128i m1{ predicate.template mask<O>(O::load(data + i + lanes), low, high) };
+            __m128i m2{ predicate.template mask<O>(O::load(data + i + 2 * lanes), low, high) };
+            __m128i m3{ predicate.template mask<O>(O::load(data + i + 3 * lanes), low, high) };
+            if (bits(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))) != 0)
+            {
+                // which one: 64 bits, one per byte of the 64
+                std::uint64_t all{ bits(m0) | (std::uint64_t{ bits(m1) } << 16) | (std::uint64_t{ bits(m2) } << 32) | (std::uint64_t{ bits(m3) } << 48) };
+                return i + static_cast<std::size_t>(std::countr_zero(all)) / sizeof(T);
+            }
+        }
+        for (; i + lanes <= size; i += lanes)
+        {
+            unsigned mask{ bits(predicate.template mask<O>(O::load(data + i), low, high)) };
+            if (mask != 0)
+                return i + static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(T);
+        }
+        for (; i < size; ++i)
+        {
+            if (predicate(data[i]))
+                return i;
+        }
+        return size;
+    }
+
+    template <typename T, typename Predicate>
+    std::size_t countIf(const T* data, std::size_t size, const Predicate& predicate)
+    {
+        using O = Ops<T>;
+        constexpr std::size_t lanes{ 16 / sizeof(T) };
+        const auto [first, second]{ compareValues(predicate) };
+        const auto low{ O::broadcast(first) };
+        const auto high{ O::broadcast(second) };
+
+        // counted in bits (sizeof(T) per matching lane), divided once at the end
+        std::size_t bitCount{ 0 };
+        std::size_t i{ 0 };
+        for (; i + 2 * lanes <= size; i += 2 * lanes)
+        {
+            unsigned both{ bits(predicate.template mask<O>(O::load(data + i), low, high))
+                           | (bits(predicate.template mask<O>(O::load(data + i + lanes), low, high)) << 16) };
+            bitCount += static_cast<std::size_t>(std::popcount(both));
+        }
+        std::size_t count{ bitCount / sizeof(T) };
+        for (; i < size; ++i)
+            count += predicate(data[i]);
+        return count;
+    }
+
+    // any of up to 16 needles: one comparison per needle per vector
+    template <typename T>
+    std::size_t findFirstOf(const T* data, std::size_t size, std::span<const T> needles)
+    {
+        using O = Ops<T>;
+        constexpr std::size_t lanes{ 16 / sizeof(T) };
+        typename O::Vec wanted[16];
+        for (std::size_t n{ 0 }; n < needles.size(); ++n)
+            wanted[n] = O::broadcast(needles[n]);
+
+        std::size_t i{ 0 };
+        for (; i + lanes <= size; i += lanes)
+        {
+            auto x{ O::load(data + i) };
+            __m128i any{ _mm_setzero_si128() };
+            for (std::size_t n{ 0 }; n < needles.size(); ++n)
+                any = _mm_or_si128(any, O::equal(x, wanted[n]));
+            unsigned mask{ bits(any) };
+            if (mask != 0)
+                return i + static_cast<std::size_t>(std::countr_zero(mask)) / sizeof(T);
+        }
+        for (; i < size; ++i)
+        {
+            if (std::ranges::find(needles, data[i]) != needles.end())
+                return i;
+        }
+        return size;
+    }
+
+    // the index of the first element that's smallest (Less) or largest, or size when it can't
+    // tell because of a NaN (then the caller falls back to std::min_element's rules)
+    template <bool Largest, typename T>
+    std::size_t extremeElement(const T* data, std::size_t size, bool& sawNaN)
+    {
+        using O = Ops<T>;
+        constexpr std::size_t lanes{ 16 / sizeof(T) };
+        sawNaN = false;
+        if (size < 2 * lanes)
+        {
+            std::size_t best{ 0 };
+            for (std::size_t i{ 1 }; i < size; ++i)
+            {
+                if (Largest ? data[best] < data[i] : data[i] < data[best])
+                    best = i;
+                sawNaN |= data[i] != data[i];
+            }
+            sawNaN |= size > 0 && data[0] != data[0];
+            return best;
+        }
+
+        // pass 1: the extreme value, two accumulators so that the min/max chains overlap
+        auto a{ O::load(data) };
+        auto b{ O::load(data + lanes) };
+        __m128i nan{ _mm_or_si128(O::isNaN(a), O::isNaN(b)) };
+        std::size_t i{ 2 * lanes };
+        for (; i + 2 * lanes <= size; i += 2 * lanes)
+        {
+            auto x{ O::load(data + i) };
+            auto y{ O::load(data + i + lanes) };
+            nan = _mm_or_si128(nan, _mm_or_si128(O::isNaN(x), O::isNaN(y)));
+            a = Largest ? O::max(a, x) : O::min(a, x);
+            b = Largest ? O::max(b, y) : O::min(b, y);
+        }
+        if (bits(nan) != 0)
+        {
+            sawNaN = true;
+            return size;
+        }
+
+        T values[lanes];
+        O::store(values, Largest ? O::max(a, b) : O::min(a, b));
+        T best{ values[0] };
+        for (std::size_t k{ 1 }; k < lanes; ++k)
+            best = Largest ? std::max(best, values[k]) : std::min(best, values[k]);
+        for (; i < size; ++i)
+        {
+            sawNaN |= data[i] != data[i];
+            best = Largest ? std::max(best, data[i]) : std::min(best, data[i]);
+        }
+        if (sawNaN)
+            return size;
+
+        // pass 2: where it is first (for floats, -0.0 == 0.0, so that's the first zero of either sign)
+        return findIf(data, size, EqualTo<T>{ best });
+    }
+
+    template <typename T>
+    std::size_t mismatch(const T* a, const T* b, std::size_t size)
+    {
+        using O = Ops<T>;
+        constexpr std::size_t lanes{ 16 / sizeof(T) };
+
+        std::size_t i{ 0 };
+        for (; i + 4 * lanes <= size; i += 4 * lanes)
+        {
+            __m128i e0{ O::equal(O::load(a + i), O::load(b + i)) };
+            __m128i e1{ O::equal(O::load(a + i + lanes), O::load(b + i + lanes)) };
+            __m128i e2{ O::equal(O::load(a + i + 2 * lanes), O::load(b + i + 2 * lanes)) };
+            __m128i e3{ O::equal(O::load(a + i + 3 * lanes), O::load(b + i + 3 * lanes)) };
+            if (bits(_mm_and_si128(_mm_and_si128(e0, e1), _mm_and_si128(e2, e3))) != 0xFFFF)
+            {
+                std::uint64_t equal{ bits(e0) | (std::uint64_t{ bits(e1) } << 16) | (std::uint64_t{ bits(e2) } << 32) | (std::uint64_t{ bits(e3) } << 48) };
+                return i + static_cast<std::size_t>(std::countr_one(equal)) / sizeof(T);
+            }
+        }
+        for (; i < size; ++i)
+        {
+            if (!(a[i] == b[i]))
+                return i;
+        }
+        return size;
+    }
+}
+#else
+namespace simd_scan::detail
+{
+    // only declared: without SSE2 nothing is Scannable, so these are never called
+    template <typename T, typename Predicate> std::size_t findIf(const T* data, std::size_t size, const Predicate& predicate);
+    template <typename T, typename Predicate> std::size_t countIf(const T* data, std::size_t size, const Predicate& predicate);
+    template <typename T> std::size_t findFirstOf(const T* data, std::size_t size, std::span<const T> needles);
+    template <bool Largest, typename T> std::size_t extremeElement(const T* data, std::size_t size, bool& sawNaN);
+    template <typename T> std::size_t mismatch(const T* a, const T* b, std::size_t size);
+}
+#endif
+
+
+
+
+/*---------------------------------------------------------------------------------------
+               ============[ the algorithms, with fallbacks ]============
+---------------------------------------------------------------------------------------*/
+
+namespace simd_scan
+{
+    namespace detail
+    {
+        // a range we can hand to the kernels as a pointer and a size
+        template <typename Range>
+        concept Scannable =
+#if defined(__SSE2__)
+            std::ranges::contiguous_range<Range> && std::ranges::sized_range<Range>
+            && Vectorizable<std::remove_cv_t<std::ranges::range_value_t<Range>>>;
+#else
+            false;
+#endif
+
+        template <typename Range>
+        using Element = std::remove_cv_t<std::ranges::range_value_t<Range>>;
+
+        // the iterator, or std::ranges::dangling if it points into a temporary that owns its
+        // elements -- the same thing the std::ranges algorithms return
+        template <typename Range>
+        std::ranges::borrowed_iterator_t<Range> borrowed(std::ranges::iterator_t<Range> iterator)
+        {
+            if constexpr (std::ranges::borrowed_range<Range>)
+                return iterator;
+            else
+                return {};
+        }
+
+        template <typename Range>
+        std::ranges::borrowed_iterator_t<Range> at(Range&& range, std::size_t index)
+        {
+            return borrowed<Range>(std::ranges::begin(range) + static_cast<std::ranges::range_difference_t<Range>>(index));
+        }
+    }
+
+    template <std::ranges::forward_range Range, typename Predicate>
+    auto findIf(Range&& range, Predicate predicate)
+    {
+        if constexpr (detail::Scannable<Range> && detail::Comparison<Predicate, detail::Element<Range>>)
+            return detail::at(std::forward<Range>(range), detail::findIf(std::ranges::data(range), std::ranges::size(range), predicate));
+        else
+            return std::ranges::find_if(std::forward<Range>(range), predicate);
+    }
+
+    template <std::ranges::forward_range Range, typename T>
+    auto find(Range&& range, const T& value)
+    {
+        if constexpr (detail::Scannable<Range> && std::same_as<T, detail::Element<Range>>)
+            return findIf(std::forward<Range>(range), equalTo(value));
+        else
+            return std::ranges::find(std::forward<Range>(range), value);
+    }
+
+    template <std::ranges::forward_range Range, typename Predicate>
+    auto countIf(Range&& range, Predicate predicate)
+    {
+        if constexpr (detail::Scannable<Range> && detail::Comparison<Predicate, detail::Element<Range>>)
+            return static_cast<std::ranges::range_difference_t<Range>>(detail::countIf(std::ranges::data(range), std::ranges::size(range), predicate));
+        else
+            return std::ranges::count_if(range, predicate);
+    }
+
+    template <std::ranges::forward_range Range, typename T>
+    auto count(Range&& range, const T& value)
+    {
+        if constexpr (detail::Scannable<Range> && std::same_as<T, detail::Element<Range>>)
+            return countIf(range, equalTo(value));
+        else
+            return std::ranges::count(range, value);
+    }
+
+    // the first element that's equal to any of the needles
+    template <std::ranges::forward_range Range, std::ranges::forward_range Needles>
+    auto findFirstOf(Range&& range, Needles&& needles)
+    {
+        if constexpr (detail::Scannable<Range> && detail::Scannable<Needles> && std::same_as<detail::Element<Range>, detail::Element<Needles>>)
+        {
+            std::span<const detail::Element<Range>> wanted{ std::ranges::data(needles), std::ranges::size(needles) };
+            if (!wanted.empty() && wanted.size() <= 16)
+                return detail::at(std::forward<Range>(range), detail::findFirstOf(std::ranges::data(range), std::ranges::size(range), wanted));
+        }
+        return std::ranges::find_first_of(std::forward<Range>(range), needles);
+    }
+
+    template <std::ranges::forward_range Range>
+    auto minElement(Range&& range)
+    {
+        if constexpr (detail::Scannable<Range>)
+        {
+            bool sawNaN{};
+            std::size_t index{ detail::extremeElement<false>(std::ranges::data(range), std::ranges::size(range), sawNaN) };
+            if (!sawNaN)
+                return detail::at(std::forward<Range>(range), index);
+        }
+        return std::ranges::min_element(std::forward<Range>(range));
+    }
+
+    template <std::ranges::forward_range Range>
+    auto maxElement(Range&& range)
+    {
+        if constexpr (detail::Scannable<Range>)
+        {
+            bool sawNaN{};
+            std::size_t index{ detail::extremeElement<true>(std::ranges::data(range), std::ranges::size(range), sawNaN) };
+            if (!sawNaN)
+                return detail::at(std::forward<Range>(range), index);
+        }
+        return std::ranges::max_element(std::forward<Range>(range));
+    }
+
+    // like std::ranges::mismatch: the first position where the two ranges differ
+    // (libstdc++ 12's std::ranges::mismatch forgets the dangling for temporaries, so we add it)
+    template <std::ranges::forward_range Range1, std::ranges::forward_range Range2>
+    auto mismatch(Range1&& range1, Range2&& range2)
+    {
+        using Result = std::ranges::mismatch_result<std::ranges::borrowed_iterator_t<Range1>, std::ranges::borrowed_iterator_t<Range2>>;
+
+        if constexpr (detail::Scannable<Range1> && detail::Scannable<Range2> && std::same_as<detail::Element<Range1>, detail::Element<Range2>>)
+        {
+            std::size_t size{ std::min<std::size_t>(std::ranges::size(range1), std::ranges::size(range2)) };
+            std::size_t index{ detail::mismatch(std::ranges::data(range1), std::ranges::data(range2), size) };
+            return Result{ detail::at(std::forward<Range1>(range1), index), detail::at(std::forward<Range2>(range2), index) };
+        }
+        else
+        {
+            auto [in1, in2]{ std::ranges::mismatch(range1, range2) };
+            return Result{ detail::borrowed<Range1>(in1), detail::borrowed<Range2>(in2) };
+        }
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ 11.19 again ]============
+---------------------------------------------------------------------------------------*/
+
+#include <string_view>
+
+namespace using_std_find
+{
+    void main()
+    {
+        std::array arr{ 13, 90, 99, 5, 40, 80 };
+
+        int search{ 99 };
+        int replace{ 98 };
+
+        auto found{ simd_scan::find(arr, search) };
+        if (found == arr.end())
+            std::cout << "Could not find " << search << '\n';
+        else
+            *found = replace;
+
+        for (int i : arr)
+            std::cout << i << ' ';
+        std::cout << '\n';
+    }
+}
+
+namespace using_std_count_and_count_if
+{
+    bool containsNut(std::string_view str)
+    {
+        return (str.find("nut") != std::string_view::npos);
+    }
+
+    void main()
+    {
+        // strings: not vectorizable, so this is std::ranges::count_if
+        std::array<std::string_view, 5> arr{ "apple", "banana", "walnut", "lemon", "peanut" };
+        std::cout << "Counted " << simd_scan::countIf(arr, containsNut) << " nut(s)\n";
+
+        // a column of prices
+        std::vector<float> prices{ 3.5f, 12.0f, 7.25f, 99.0f, 0.5f, 15.0f, 8.0f, 42.0f, 10.0f, 11.0f };
+        std::cout << simd_scan::countIf(prices, simd_scan::between(5.0f, 15.0f)) << " prices between 5 and 15, "
+                  << "the cheapest is " << *simd_scan::minElement(prices) << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <random>
+#include <limits>
+#include <cmath>            // std::nan
+
+namespace checks
+{
+    // every algorithm against std::ranges, at every alignment and every length up to 200, with
+    // few distinct values (so that there are matches), the extremes of the type, and NaNs
+    template <typename T>
+    int checkType(std::mt19937& mt)
+    {
+        int failures{ 0 };
+        std::vector<T> pool{ T{ 0 }, T{ 1 }, T{ 2 }, std::numeric_limits<T>::min(), std::numeric_limits<T>::max(),
+                             std::numeric_limits<T>::lowest(), static_cast<T>(std::numeric_limits<T>::max() / 2 + 1) };
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            pool.push_back(T{ -0.0 });
+            pool.push_back(std::numeric_limits<T>::infinity());
+        }
+        else if constexpr (std::is_signed_v<T>)
+            pool.push_back(T{ -1 });
+
+        for (int round{ 0 }; round < 600; ++round)
+        {
+            std::size_t offset{ mt() % 4 };
+            std::size_t size{ mt() % 200 };
+            std::vector<T> storage(offset + size);
+            for (auto& x : storage)
+                x = pool[mt() % pool.size()];
+            if (std::is_floating_point_v<T> && round % 10 == 0 && size > 0)
+                storage[offset + mt() % size] = std::numeric_limits<T>::quiet_NaN();
+            std::span<const T> data{ storage.data() + offset, size };
+
+            T value{ pool[mt() % pool.size()] };
+            T other{ pool[mt() % pool.size()] };
+            T low{ std::min(value, other) };
+            T high{ std::max(value, other) };
+
+            failures += simd_scan::find(data, value) != std::ranges::find(data, value);
+            failures += simd_scan::count(data, value) != std::ranges::count(data, value);
+            failures += simd_scan::findIf(data, simd_scan::lessThan(value)) != std::ranges::find_if(data, [&](T x) { return x < value; });
+            failures += simd_scan::countIf(data, simd_scan::greaterThan(value)) != std::ranges::count_if(data, [&](T x) { return x > value; });
+            failures += simd_scan::countIf(data, simd_scan::notEqualTo(value)) != std::ranges::count_if(data, [&](T x) { return x != value; });
+            failures += simd_scan::countIf(data, simd_scan::between(low, high)) != std::ranges::count_if(data, [&](T x) { return low <= x && x <= high; });
+            failures += simd_scan::minElement(data) != std::ranges::min_element(data);
+            failures += simd_scan::maxElement(data) != std::ranges::max_element(data);
+
+            std::array needles{ value, other, T{ 2 } };
+            failures += simd_scan::findFirstOf(data, needles) != std::ranges::find_first_of(data, needles);
+
+            std::vector<T> copy(data.begin(), data.end());
+            if (!copy.empty() && round % 2 == 0)
+                copy[mt() % copy.size()] = pool[mt() % pool.size()];
+            failures += simd_scan::mismatch(data, copy).in1 != std::ranges::mismatch(data, copy).in1;
+        }
+        return failures;
+    }
+
+    void main()
+    {
+        std::mt19937 mt{ 48 };
+        int failures{ 0 };
+        failures += checkType<std::int8_t>(mt) + checkType<std::uint8_t>(mt) + checkType<char>(mt);
+        failures += checkType<std::int16_t>(mt) + checkType<std::uint16_t>(mt);
+        failures += checkType<std::int32_t>(mt) + checkType<std::uint32_t>(mt);
+        failures += checkType<std::int64_t>(mt) + checkType<std::uint64_t>(mt);
+        failures += checkType<float>(mt) + checkType<double>(mt);
+
+        // a value of another type, and a lambda: both fall back to std::ranges
+        std::vector<int> ints{ 1, 2, 300 };
+        failures += simd_scan::find(ints, 300L) != ints.begin() + 2;
+        failures += simd_scan::countIf(ints, [](int x) { return x % 2 == 0; }) != 2;
+
+        // a temporary vector gives std::ranges::dangling, like std::ranges does, on both paths;
+        // a span doesn't own its elements, so its iterators are fine
+        using Dangling = std::ranges::dangling;
+        static_assert(std::same_as<decltype(simd_scan::find(std::vector<int>{ 1, 2 }, 2)), Dangling>);
+        static_assert(std::same_as<decltype(simd_scan::find(std::vector<int>{ 1, 2 }, 2L)), Dangling>);
+        static_assert(std::same_as<decltype(simd_scan::findIf(std::vector<int>{ 1, 2 }, simd_scan::lessThan(2))), Dangling>);
+        static_assert(std::same_as<decltype(simd_scan::findFirstOf(std::vector<int>{ 1, 2 }, ints)), Dangling>);
+        static_assert(std::same_as<decltype(simd_scan::minElement(std::vector<int>{ 1, 2 })), Dangling>);
+        static_assert(std::same_as<decltype(simd_scan::maxElement(std::vector<float>{ 1, 2 })), Dangling>);
+        static_assert(std::same_as<decltype(simd_scan::mismatch(std::vector<int>{ 1, 2 }, ints)),
+                                   std::ranges::mismatch_result<Dangling, std::vector<int>::iterator>>);
+        static_assert(std::same_as<decltype(simd_scan::mismatch(std::vector<long>{ 1, 2 }, std::vector<long>{ 1 })),
+                                   std::ranges::mismatch_result<Dangling, Dangling>>);
+        static_assert(std::same_as<decltype(simd_scan::find(std::span<int>{ ints }, 2)), std::span<int>::iterator>);
+        std::span<int> view{ ints };
+        failures += simd_scan::find(std::span<int>{ view }, 300) != view.begin() + 2;
+        failures += simd_scan::maxElement(std::span<int>{ view }) != view.begin() + 2;
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// GB/s over a column of 16M values (64 MiB of int32 or float, 16 MiB of int8), repeated;
+// find looks for a value that's only in the last element, so it scans everything
+
+#include <chrono>
+#include <iomanip>          // std::setw
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_size{ 1 << 24 };
+    constexpr int g_repeats{ 5 };
+
+    template <typename T>
+    void run(const char* name)
+    {
+        std::mt19937 mt{ 6 };
+        std::vector<T> column(g_size);
+        for (auto& x : column)
+            x = static_cast<T>(mt() % 100);
+        column.back() = static_cast<T>(101);
+        auto copy{ column };
+        copy.back() = static_cast<T>(102);
+
+        long long checksum{ 0 };
+        auto rate{ [&](auto algorithm) {
+            Timer t;
+            for (int r{ 0 }; r < g_repeats; ++r)
+                checksum += static_cast<long long>(algorithm());
+            return static_cast<double>(g_size * sizeof(T)) * g_repeats / t.elapsed() / 1e9;
+        } };
+        auto line{ [&](const char* what, double standard, double vectorized) {
+            std::cout << "    " << std::left << std::setw(20) << what << std::right << std::setw(8) << standard
+                      << std::setw(8) << vectorized << '\n';
+        } };
+
+        std::cout << name << " (GB/s: std::ranges, simd_scan)\n";
+        T needle{ static_cast<T>(101) };
+        T low{ static_cast<T>(10) };
+        T high{ static_cast<T>(20) };
+        std::array<T, 3> needles{ static_cast<T>(101), static_cast<T>(103), static_cast<T>(104) };
+
+        line("find", rate([&] { return std::ranges::find(column, needle) - column.begin(); }),
+                     rate([&] { return simd_scan::find(column, needle) - column.begin(); }));
+        line("find_first_of (3)", rate([&] { return std::ranges::find_first_of(column, needles) - column.begin(); }),
+                                  rate([&] { return simd_scan::findFirstOf(column, needles) - column.begin(); }));
+        line("count", rate([&] { return std::ranges::count(column, low); }),
+                      rate([&] { return simd_scan::count(column, low); }));
+        line("count_if between", rate([&] { return std::ranges::count_if(column, [&](T x) { return low <= x && x <= high; }); }),
+                                 rate([&] { return simd_scan::countIf(column, simd_scan::between(low, high)); }));
+        line("min_element", rate([&] { return std::ranges::min_element(column) - column.begin(); }),
+                            rate([&] { return simd_scan::minElement(column) - column.begin(); }));
+        line("max_element", rate([&] { return std::ranges::max_element(column) - column.begin(); }),
+                            rate([&] { return simd_scan::maxElement(column) - column.begin(); }));
+        line("mismatch", rate([&] { return std::ranges::mismatch(column, copy).in1 - column.begin(); }),
+                         rate([&] { return simd_scan::mismatch(column, copy).in1 - column.begin(); }));
+
+        if (checksum == 0)
+            std::cout << "    (?)\n";
+    }
+
+    void main()
+    {
+        std::cout << std::fixed << std::setprecision(2);
+        run<std::int8_t>("int8");
+        run<std::int32_t>("int32");
+        run<float>("float");
+        run<double>("double");
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    using_std_find::main();
+    using_std_count_and_count_if::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
@@ -0,0 +1,843 @@
+#include <iostream>
+#include <algorithm>
+#include <ranges>
+#include <iterator>
+#include <functional>       // std::function, std::invoke, std::plus, std::identity
+#include <vector>
+#include <deque>
+#include <array>
+#include <memory>           // std::unique_ptr
+#include <optional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstddef>          // std::size_t
+
+
+// every algorithm in 11.19 runs on one thread. C++17 added execution policies for that
+// (std::for_each(std::execution::par, ...)), but libstdc++ implements them on top of TBB, a
+// library we'd have to ship along. so here are for_each, transform, reduce, transform_reduce,
+// inclusive/exclusive scan, count_if and partition, on our own thread pool.
+
+// - the input is cut into CHUNKS. their size depends only on the size of the input (not on the
+//   number of threads): at least 4096 elements, and at most 256 chunks. the grain can also be
+//   given explicitly, for elements that are expensive to process.
+// - two SCHEDULES for the chunks:
+//     blocks    every thread gets one contiguous run of chunks, decided up front. the least
+//               overhead, when every element costs the same
+//     stealing  the range of chunks is split in half again and again; one half is left in the
+//               thread's queue while the thread goes on with the other, and idle threads STEAL
+//               the halves left behind. when some elements cost much more than others (an
+//               irregular predicate), the threads that finish early take over the rest
+// - every thread has a queue of its own (a deque): it pushes and pops at the back, while thieves
+//   take from the front, where the biggest pieces of work are.
+// - a parallel reduction adds the elements in a different order than a sequential one. for
+//   floating point numbers that changes the result a little, and with stealing it could change
+//   from run to run. with deterministic = true, every chunk's sum is kept and they're added up
+//   in order at the end, so the result only depends on the input (and the grain).
+// - the functions passed in are called from several threads at once, so just like with
+//   std::execution::par, they must not touch shared state without synchronization.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                   ============[ a work-stealing thread pool ]============
+---------------------------------------------------------------------------------------*/
+
+namespace parallel
+{
+    class ThreadPool
+    {
+    private:
+        struct Queue
+        {
+            std::mutex mutex{};
+            std::deque<std::function<void()>> tasks{};
+        };
+
+        // queue 0 belongs to the threads outside the pool, the others to the workers
+        std::vector<std::unique_ptr<Queue>> m_queues{};
+        std::atomic<std::size_t> m_queued{ 0 };
+        std::mutex m_sleepMutex{};
+        std::condition_variable m_wake{};
+        bool m_stopping{ false };
+        std::vector<std::jthread> m_workers{};
+
+        static inline thread_local const ThreadPool* t_pool{ nullptr };
+        static inline thread_local std::size_t t_queue{ 0 };
+
+        std::size_t ownQueue() const { return t_pool == this ? t_queue : 0; }
+
+        bool tryRun(std::size_t own)
+        {
+            std::function<void()> task{};
+            {
+                // our own newest task first: its data is probably still in the cache
+                Queue& queue{ *m_queues[own] };
+                std::lock_guard lock{ queue.mutex };
+                if (!queue.tasks.empty())
+                {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                    --m_queued;
+                }
+            }
+            for (std::size_t k{ 1 }; !task && k < m_queues.size(); ++k)
+            {
+                // someone else's oldest
+                Queue& victim{ *m_queues[(own + k) % m_queues.size()] };
+                std::lock_guard lock{ victim.mutex };
+                if (!victim.tasks.empty())
+                {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    --m_queued;
+                }
+            }
+            if (!task)
+                return false;
+
+            task();
+            return true;
+        }
+
+        void work(std::size_t queue)
+        {
+            t_pool = this;
+            t_queue = queue;
+            while (true)
+            {
+                if (tryRun(queue))
+                    continue;
+
+                std::unique_lock lock{ m_sleepMutex };
+                m_wake.wait(lock, [&] { return m_stopping || m_queued > 0; });
+                if (m_stopping && m_queued == 0)
+                    return;
+            }
+        }
+
+    public:
+        // one queue per thread. the caller is one of the [threads]: it gets queue 0 (shared with
+        // any other thread outside the pool), and we only start workers for queues 1 and up
+        explicit ThreadPool(unsigned threads)
+        {
+            for (unsigned i{ 0 }; i < std::max(threads, 1u); ++i)
+                m_queues.push_back(std::make_unique<Queue>());
+            for (unsigned i{ 1 }; i < threads; ++i)
+                m_workers.emplace_back([this, i] { work(i); });
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard lock{ m_sleepMutex };
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+            m_workers.clear();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned threads() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+        // into the queue of the calling thread
+        void submit(std::function<void()> task)
+        {
+            {
+                Queue& queue{ *m_queues[ownQueue()] };
+                std::lock_guard lock{ queue.mutex };
+                queue.tasks.push_back(std::move(task));
+                ++m_queued;
+            }
+
+            // (a worker checks m_queued while holding m_sleepMutex, so it can't miss this)
+            {
+                std::lock_guard lock{ m_sleepMutex };
+            }
+            m_wake.notify_one();
+        }
+
+        // runs one task on the calling thread (its own or a stolen one), if there is one
+        bool runOne()
+        {
+            return tryRun(ownQueue());
+        }
+    };
+
+    // counts the tasks started through it, so that wait() knows when they're all done. a task
+    // can start more tasks in the same group (the stealing schedule splits its range that way),
+    // and none of them may throw.
+    class TaskGroup
+    {
+    private:
+        ThreadPool& m_pool;
+        std::size_t m_pending{ 0 };
+        std::mutex m_mutex{};
+        std::condition_variable m_done{};
+
+    public:
+        explicit TaskGroup(ThreadPool& pool)
+            : m_pool{ pool }
+        {
+        }
+
+        ~TaskGroup() { wait(); }
+
+        template <typename Fn>
+        void run(Fn fn)
+        {
+            {
+                std::lock_guard lock{ m_mutex };
+                ++m_pending;
+            }
+
+            // the task reaches into the group after fn() returns, so the count goes to zero and
+            // the notification goes out under m_mutex: wait() can't see 0 (and let the group go
+            // out of scope) until the task is done with it
+            m_pool.submit([this, fn = std::move(fn)] {
+                fn();
+                std::lock_guard lock{ m_mutex };
+                if (--m_pending == 0)
+                    m_done.notify_all();
+            });
+        }
+
+        // the waiting thread runs (or steals) tasks too: in a pool of 1 thread it's the only one
+        // there is. finding nothing to take doesn't mean we're done: the unfinished tasks are
+        // running on other threads, and may still split off work. so it only sleeps for a
+        // moment before looking again
+        void wait()
+        {
+            while (true)
+            {
+                {
+                    std::lock_guard lock{ m_mutex };
+                    if (m_pending == 0)
+                        return;
+                }
+                if (!m_pool.runOne())
+                {
+                    std::unique_lock lock{ m_mutex };
+                    m_done.wait_for(lock, std::chrono::microseconds{ 100 }, [&] { return m_pending == 0; });
+                }
+            }
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                            ============[ chunks ]============
+---------------------------------------------------------------------------------------*/
+
+namespace parallel
+{
+    enum class Schedule
+    {
+        blocks,
+        stealing,
+    };
+
+    struct Options
+    {
+        Schedule schedule{ Schedule::stealing };
+        std::size_t grain{ 0 };         // elements per chunk, 0: chosen from the size
+        bool deterministic{ false };    // reductions: add up the chunks in order
+    };
+
+    namespace detail
+    {
+        inline constexpr std::size_t g_minGrain{ 4096 };
+        inline constexpr std::size_t g_maxChunks{ 256 };
+
+        struct Chunks
+        {
+            std::size_t size{};
+            std::size_t grain{};
+
+            Chunks(std::size_t size_, const Options& options)
+                : size{ size_ }
+                , grain{ options.grain != 0 ? options.grain : std::max(g_minGrain, (size_ + g_maxChunks - 1) / g_maxChunks) }
+            {
+            }
+
+            std::size_t count() const { return (size + grain - 1) / grain; }
+            std::size_t begin(std::size_t chunk) const { return chunk * grain; }
+            std::size_t end(std::size_t chunk) const { return std::min(size, (chunk + 1) * grain); }
+        };
+
+        // fn(begin, end, chunk) for every chunk, and waits
+        template <typename Fn>
+        void forEachChunk(ThreadPool& pool, const Chunks& chunks, Schedule schedule, Fn& fn)
+        {
+            const std::size_t count{ chunks.count() };
+            if (count <= 1 || pool.threads() == 1)
+            {
+                for (std::size_t c{ 0 }; c < count; ++c)
+                    fn(chunks.begin(c), chunks.end(c), c);
+                return;
+            }
+
+            TaskGroup group{ pool };
+            if (schedule == Schedule::blocks)
+            {
+                const std::size_t runs{ std::min<std::size_t>(pool.threads(), count) };
+                for (std::size_t r{ 0 }; r < runs; ++r)
+                {
+                    group.run([&, r] {
+                        for (std::size_t c{ r * count / runs }; c < (r + 1) * count / runs; ++c)
+                            fn(chunks.begin(c), chunks.end(c), c);
+                    });
+                }
+                group.wait();
+            }
+            else
+            {
+                // leave the right half for thieves, go on with the left one, until one chunk is left
+                auto split{ [&](auto& self, std::size_t first, std::size_t last) -> void {
+                    while (last - first > 1)
+                    {
+                        std::size_t middle{ first + (last - first) / 2 };
+                        group.run([&self, middle, last] { self(self, middle, last); });
+                        last = middle;
+                    }
+                    fn(chunks.begin(first), chunks.end(first), first);
+                } };
+                split(split, 0, count);
+                group.wait();   // while split still exists
+            }
+        }
+
+        template <typename Range>
+        concept Indexable = std::ranges::random_access_range<Range> && std::ranges::sized_range<Range>;
+
+        template <std::random_access_iterator It>
+        It at(It first, std::size_t index)
+        {
+            return first + static_cast<std::iter_difference_t<It>>(index);
+        }
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                          ============[ algorithms ]============
+---------------------------------------------------------------------------------------*/
+
+namespace parallel
+{
+    template <detail::Indexable Range, typename Fn>
+    void forEach(ThreadPool& pool, Range&& range, Fn fn, Options options = {})
+    {
+        auto first{ std::ranges::begin(range) };
+        auto body{ [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t i{ begin }; i < end; ++i)
+                std::invoke(fn, *detail::at(first, i));
+        } };
+        detail::forEachChunk(pool, detail::Chunks{ std::ranges::size(range), options }, options.schedule, body);
+    }
+
+    // [out] may be the beginning of the input itself
+    template <detail::Indexable Range, std::random_access_iterator Out, typename Fn>
+    Out transform(ThreadPool& pool, Range&& range, Out out, Fn fn, Options options = {})
+    {
+        auto first{ std::ranges::begin(range) };
+        auto body{ [&](std::size_t begin, std::size_t end, std::size_t) {
+            for (std::size_t i{ begin }; i < end; ++i)
+                *detail::at(out, i) = std::invoke(fn, *detail::at(first, i));
+        } };
+        detail::forEachChunk(pool, detail::Chunks{ std::ranges::size(range), options }, options.schedule, body);
+        return detail::at(out, std::ranges::size(range));
+    }
+
+    // [reduce] must be associative; like std::reduce, the elements may be combined in any order
+    // (unless options.deterministic), so it should be commutative too
+    template <detail::Indexable Range, typename T, typename Reduce, typename Transform>
+    T transformReduce(ThreadPool& pool, Range&& range, T init, Reduce reduce, Transform transform, Options options = {})
+    {
+        const detail::Chunks chunks{ std::ranges::size(range), options };
+        if (chunks.size == 0)
+            return init;
+
+        auto first{ std::ranges::begin(range) };
+        auto chunkValue{ [&](std::size_t begin, std::size_t end) {
+            T value{ static_cast<T>(std::invoke(transform, *detail::at(first, begin))) };
+            for (std::size_t i{ begin + 1 }; i < end; ++i)
+                value = std::invoke(reduce, std::move(value), std::invoke(transform, *detail::at(first, i)));
+            return value;
+        } };
+
+        if (options.deterministic)
+        {
+            std::vector<std::optional<T>> partials(chunks.count());
+            auto body{ [&](std::size_t begin, std::size_t end, std::size_t c) { partials[c] = chunkValue(begin, end); } };
+            detail::forEachChunk(pool, chunks, options.schedule, body);
+
+            for (auto& partial : partials)
+                init = std::invoke(reduce, std::move(init), std::move(*partial));
+            return init;
+        }
+
+        // in the order the chunks finish
+        std::optional<T> total{};
+        std::mutex mutex{};
+        auto body{ [&](std::size_t begin, std::size_t end, std::size_t) {
+            T value{ chunkValue(begin, end) };
+            std::lock_guard lock{ mutex };
+            if (total)
+                total = std::invoke(reduce, std::move(*total), std::move(value));
+            else
+                total = std::move(value);
+        } };
+        detail::forEachChunk(pool, chunks, options.schedule, body);
+        return std::invoke(reduce, std::move(init), std::move(*total));
+    }
+
+    template <detail::Indexable Range, typename T, typename Reduce = std::plus<>>
+    T reduce(ThreadPool& pool, Range&& range, T init, Reduce reduce = {}, Options options = {})
+    {
+        return transformReduce(pool, range, std::move(init), reduce, std::identity{}, options);
+    }
+
+    template <detail::Indexable Range, typename Predicate>
+    std::size_t countIf(ThreadPool& pool, Range&& range, Predicate predicate, Options options = {})
+    {
+        auto one{ [&](const auto& x) -> std::size_t { return std::invoke(predicate, x) ? 1 : 0; } };
+        return transformReduce(pool, range, std::size_t{ 0 }, std::plus<>{}, one, options);
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                        ============[ scans, partition ]============
+---------------------------------------------------------------------------------------*/
+
+// a scan can't just hand out chunks: every output depends on everything before it. so:
+    // 1. every chunk is reduced on its own (in parallel)
+    // 2. a sequential scan over those sums gives every chunk the total of the chunks before it
+    // 3. every chunk is scanned again, starting from that total (in parallel)
+// which reads the input twice, but does the same number of [op]s per element as a sequential
+// scan, spread over all the threads. partition uses the same steps with counts: how many
+// elements of every chunk go to the front, and so where each of them goes.
+
+namespace parallel
+{
+    namespace detail
+    {
+        // step 1: the reduction of every chunk
+        template <typename T, typename It, typename Op>
+        std::vector<std::optional<T>> chunkSums(ThreadPool& pool, It first, const Chunks& chunks, Op& op, Schedule schedule)
+        {
+            std::vector<std::optional<T>> sums(chunks.count());
+            auto body{ [&](std::size_t begin, std::size_t end, std::size_t c) {
+                T sum{ *at(first, begin) };
+                for (std::size_t i{ begin + 1 }; i < end; ++i)
+                    sum = std::invoke(op, std::move(sum), *at(first, i));
+                sums[c] = std::move(sum);
+            } };
+            forEachChunk(pool, chunks, schedule, body);
+            return sums;
+        }
+
+        inline bool sequential(ThreadPool& pool, const Chunks& chunks)
+        {
+            return chunks.count() <= 1 || pool.threads() == 1;
+        }
+    }
+
+    // out[i] = in[0] op in[1] op ... op in[i]; [out] may be the beginning of the input
+    template <detail::Indexable Range, std::random_access_iterator Out, typename Op = std::plus<>>
+    Out inclusiveScan(ThreadPool& pool, Range&& range, Out out, Op op = {}, Options options = {})
+    {
+        using T = std::ranges::range_value_t<Range>;
+
+        auto first{ std::ranges::begin(range) };
+        const detail::Chunks chunks{ std::ranges::size(range), options };
+        auto scanChunk{ [&](std::size_t begin, std::size_t end, const std::optional<T>& before) {
+            if (begin == end)
+                return;
+            T sum{ before ? std::invoke(op, *before, *detail::at(first, begin)) : T{ *detail::at(first, begin) } };
+            *detail::at(out, begin) = sum;
+            for (std::size_t i{ begin + 1 }; i < end; ++i)
+            {
+                sum = std::invoke(op, std::move(sum), *detail::at(first, i));
+                *detail::at(out, i) = sum;
+            }
+        } };
+
+        if (detail::sequential(pool, chunks))
+            scanChunk(0, chunks.size, std::nullopt);
+        else
+        {
+            std::vector<std::optional<T>> before{ detail::chunkSums<T>(pool, first, chunks, op, options.schedule) };
+            // step 2: shift the sums right by one, scanning them as we go
+            std::optional<T> running{};
+            for (auto& sum : before)
+            {
+                std::optional<T> next{ running ? std::invoke(op, *running, *sum) : *sum };
+                sum = std::move(running);
+                running = std::move(next);
+            }
+
+            auto body{ [&](std::size_t begin, std::size_t end, std::size_t c) { scanChunk(begin, end, before[c]); } };
+            detail::forEachChunk(pool, chunks, options.schedule, body);
+        }
+        return detail::at(out, chunks.size);
+    }
+
+    // out[i] = init op in[0] op ... op in[i - 1]; [out] may be the beginning of the input
+    template <detail::Indexable Range, std::random_access_iterator Out, typename T, typename Op = std::plus<>>
+    Out exclusiveScan(ThreadPool& pool, Range&& range, Out out, T init, Op op = {}, Options options = {})
+    {
+        auto first{ std::ranges::begin(range) };
+        const detail::Chunks chunks{ std::ranges::size(range), options };
+        auto scanChunk{ [&](std::size_t begin, std::size_t end, T sum) {
+            for (std::size_t i{ begin }; i < end; ++i)
+            {
+                T next{ std::invoke(op, sum, *detail::at(first, i)) };   // before overwriting it
+                *detail::at(out, i) = std::move(sum);
+                sum = std::move(next);
+            }
+        } };
+
+        if (detail::sequential(pool, chunks))
+            scanChunk(0, chunks.size, std::move(init));
+        else
+        {
+            std::vector<std::optional<T>> before{ detail::chunkSums<T>(pool, first, chunks, op, options.schedule) };
+            T running{ std::move(init) };
+            for (auto& sum : before)
+            {
+                T next{ std::invoke(op, running, std::move(*sum)) };
+                sum = std::move(running);
+                running = std::move(next);
+            }
+
+            auto body{ [&](std::size_t begin, std::size_t end, std::size_t c) { scanChunk(begin, end, *before[c]); } };
+            detail::forEachChunk(pool, chunks, options.schedule, body);
+        }
+        return detail::at(out, chunks.size);
+    }
+
+    // the elements that satisfy [predicate] first, in their original order, then the others, also
+    // in order (so it's std::stable_partition). returns where the second group starts.
+    // the predicate is called once per element; the elements are moved through a buffer
+    template <detail::Indexable Range, typename Predicate>
+        requires std::default_initializable<std::ranges::range_value_t<Range>>
+    auto partition(ThreadPool& pool, Range&& range, Predicate predicate, Options options = {})
+    {
+        using T = std::ranges::range_value_t<Range>;
+
+        auto first{ std::ranges::begin(range) };
+        const detail::Chunks chunks{ std::ranges::size(range), options };
+        if (detail::sequential(pool, chunks))
+            return std::ranges::stable_partition(range, predicate).begin();
+
+        // 1. remember the answers, and count them per chunk
+        std::vector<unsigned char> selected(chunks.size);
+        std::vector<std::size_t> front(chunks.count());
+        auto decide{ [&](std::size_t begin, std::size_t end, std::size_t c) {
+            std::size_t count{ 0 };
+            for (std::size_t i{ begin }; i < end; ++i)
+            {
+                selected[i] = std::invoke(predicate, *detail::at(first, i)) ? 1 : 0;
+                count += selected[i];
+            }
+            front[c] = count;
+        } };
+        detail::forEachChunk(pool, chunks, options.schedule, decide);
+
+        // 2. where every chunk's elements go: front[c] becomes the first free slot in the front
+        std::size_t selectedCount{ 0 };
+        for (auto& count : front)
+        {
+            std::size_t next{ selectedCount + count };
+            count = selectedCount;
+            selectedCount = next;
+        }
+
+        // 3. move them there: elements before chunk c that went to the back = begin(c) - front[c]
+        std::vector<T> buffer(chunks.size);
+        auto scatter{ [&](std::size_t begin, std::size_t end, std::size_t c) {
+            std::size_t toFront{ front[c] };
+            std::size_t toBack{ selectedCount + begin - front[c] };
+            for (std::size_t i{ begin }; i < end; ++i)
+                buffer[selected[i] ? toFront++ : toBack++] = std::move(*detail::at(first, i));
+        } };
+        detail::forEachChunk(pool, chunks, options.schedule, scatter);
+
+        // 4. and back
+        auto copyBack{ [&](std::size_t begin, std::size_t end, std::size_t) {
+            std::move(buffer.begin() + static_cast<std::ptrdiff_t>(begin), buffer.begin() + static_cast<std::ptrdiff_t>(end), detail::at(first, begin));
+        } };
+        detail::forEachChunk(pool, chunks, Schedule::blocks, copyBack);
+
+        return detail::at(first, selectedCount);
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ 11.19 again ]============
+---------------------------------------------------------------------------------------*/
+
+namespace using_std_for_each
+{
+    void doubleNumber(int& i)
+    {
+        i *= 2;
+    }
+
+    void main()
+    {
+        parallel::ThreadPool pool{ 4 };
+        std::array arr{ 1, 2, 3, 4 };
+
+        // 4 elements is one chunk, so this one runs on the calling thread
+        parallel::forEach(pool, arr, doubleNumber);
+
+        for (int i : arr)
+            std::cout << i << ' ';
+        std::cout << '\n';
+    }
+}
+
+namespace ranges
+{
+    void main()
+    {
+        parallel::ThreadPool pool{ 4 };
+        std::vector<int> values(100'000);
+        parallel::transform(pool, std::views::iota(0, 100'000), values.begin(), [](int i) { return i % 7; });
+
+        std::cout << "sum: " << parallel::reduce(pool, values, 0LL) << ", "
+                  << "multiples of 3: " << parallel::countIf(pool, values, [](int x) { return x % 3 == 0; }) << '\n';
+
+        parallel::inclusiveScan(pool, values, values.begin());
+        std::cout << "running total at the end: " << values.back() << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <numeric>          // std::reduce, std::inclusive_scan, std::exclusive_scan
+#include <random>
+#include <string>
+
+namespace checks
+{
+    void main()
+    {
+        std::mt19937 mt{ 49 };
+        int failures{ 0 };
+
+        for (unsigned threads : { 1u, 2u, 4u })
+        {
+            parallel::ThreadPool pool{ threads };
+            for (auto schedule : { parallel::Schedule::blocks, parallel::Schedule::stealing })
+            {
+                for (std::size_t size : std::array<std::size_t, 7>{ 0, 1, 7, 4096, 4097, 100'000, 1'234'567 })
+                {
+                    // a small grain too, so that even the small inputs have many chunks
+                    for (std::size_t grain : std::array<std::size_t, 2>{ 0, 3 })
+                    {
+                        if (grain == 3 && size > 100'000)
+                            continue;
+                        parallel::Options options{ schedule, grain };
+
+                        std::vector<long long> values(size);
+                        for (auto& x : values)
+                            x = static_cast<long long>(mt() % 1000) - 500;
+
+                        auto doubled{ values };
+                        parallel::forEach(pool, doubled, [](long long& x) { x *= 2; }, options);
+                        auto expected{ values };
+                        std::ranges::for_each(expected, [](long long& x) { x *= 2; });
+                        failures += doubled != expected;
+
+                        std::vector<std::string> text(size);
+                        parallel::transform(pool, values, text.begin(), [](long long x) { return std::to_string(x); }, options);
+                        failures += !std::ranges::equal(text, values, {}, [](const std::string& s) { return std::stoll(s); });
+
+                        failures += parallel::reduce(pool, values, 10LL, std::plus<>{}, options) != std::reduce(values.begin(), values.end(), 10LL);
+                        failures += parallel::transformReduce(pool, values, 0LL, std::plus<>{}, [](long long x) { return x * x; }, options)
+                                    != std::transform_reduce(values.begin(), values.end(), 0LL, std::plus<>{}, [](long long x) { return x * x; });
+                        auto negative{ [](long long x) { return x < 0; } };
+                        failures += parallel::countIf(pool, values, negative, options) != static_cast<std::size_t>(std::ranges::count_if(values, negative));
+
+                        std::vector<long long> scanned(size);
+                        std::vector<long long> reference(size);
+                        parallel::inclusiveScan(pool, values, scanned.begin(), std::plus<>{}, options);
+                        std::inclusive_scan(values.begin(), values.end(), reference.begin());
+                        failures += scanned != reference;
+                        parallel::exclusiveScan(pool, values, scanned.begin(), 5LL, std::plus<>{}, options);
+                        std::exclusive_scan(values.begin(), values.end(), reference.begin(), 5LL);
+                        failures += scanned != reference;
+
+                        // in place
+                        auto inPlace{ values };
+                        parallel::inclusiveScan(pool, inPlace, inPlace.begin(), std::plus<>{}, options);
+                        std::inclusive_scan(values.begin(), values.end(), reference.begin());
+                        failures += inPlace != reference;
+
+                        auto partitioned{ values };
+                        auto middle{ parallel::partition(pool, partitioned, negative, options) };
+                        auto stable{ values };
+                        auto stableMiddle{ std::ranges::stable_partition(stable, negative).begin() };
+                        failures += partitioned != stable || (middle - partitioned.begin()) != (stableMiddle - stable.begin());
+                    }
+                }
+            }
+        }
+
+        // deterministic: the same double, bit for bit, whatever the threads and the schedule
+        std::vector<double> values(2'000'000);
+        for (auto& x : values)
+            x = std::uniform_real_distribution{ -1e6, 1e6 }(mt);
+        parallel::ThreadPool one{ 1 };
+        const double expected{ parallel::reduce(one, values, 0.0, std::plus<>{}, { .deterministic = true }) };
+        for (unsigned threads : { 2u, 3u, 4u })
+        {
+            parallel::ThreadPool pool{ threads };
+            for (int repeat{ 0 }; repeat < 5; ++repeat)
+            {
+                failures += parallel::reduce(pool, values, 0.0, std::plus<>{}, { .schedule = parallel::Schedule::stealing, .deterministic = true }) != expected;
+                failures += parallel::reduce(pool, values, 0.0, std::plus<>{}, { .schedule = parallel::Schedule::blocks, .deterministic = true }) != expected;
+            }
+        }
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// 16M doubles, every algorithm sequential (std::) against the pool with every core.
+// "irregular count_if" spends ~100x longer on the elements of the first 1/16 of the input,
+// where blocks leaves one thread with all of it and stealing spreads it out.
+
+#include <iomanip>          // std::setw
+#include <cmath>            // std::sqrt
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    bool irregular(double x)
+    {
+        if (x >= 1.0 / 16)
+            return std::sqrt(x) > 0.5;
+        double y{ x };
+        for (int i{ 0 }; i < 100; ++i)
+            y = std::sqrt(y + 1.0);
+        return y > 1.6;
+    }
+
+    void main()
+    {
+        const unsigned cores{ std::max(std::thread::hardware_concurrency(), 1u) };
+        parallel::ThreadPool pool{ cores };
+        std::cout << "benchmark: " << cores << " thread(s), ms: std (sequential), blocks, stealing\n";
+
+        constexpr std::size_t size{ 1 << 24 };
+        std::vector<double> values(size);
+        for (std::size_t i{ 0 }; i < size; ++i)
+            values[i] = static_cast<double>(i) / size;
+        std::vector<double> out(size);
+        double sink{ 0 };
+
+        auto ms{ [&](auto run) {
+            Timer t;
+            run();
+            return t.elapsed() * 1000;
+        } };
+        auto line{ [&](const char* name, auto sequential, auto parallelRun) {
+            std::cout << "    " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(9) << ms(sequential)
+                      << std::setw(9) << ms([&] { parallelRun(parallel::Options{ .schedule = parallel::Schedule::blocks }); })
+                      << std::setw(9) << ms([&] { parallelRun(parallel::Options{ .schedule = parallel::Schedule::stealing }); }) << '\n';
+        } };
+
+        line("for_each sqrt",
+             [&] { std::ranges::for_each(out, [](double& x) { x = std::sqrt(x + 1.0); }); },
+             [&](parallel::Options o) { parallel::forEach(pool, out, [](double& x) { x = std::sqrt(x + 1.0); }, o); });
+        line("transform",
+             [&] { std::ranges::transform(values, out.begin(), [](double x) { return x * 3 + 1; }); },
+             [&](parallel::Options o) { parallel::transform(pool, values, out.begin(), [](double x) { return x * 3 + 1; }, o); });
+        line("reduce",
+             [&] { sink += std::reduce(values.begin(), values.end(), 0.0); },
+             [&](parallel::Options o) { sink += parallel::reduce(pool, values, 0.0, std::plus<>{}, o); });
+        line("reduce deterministic",
+             [&] { sink += std::reduce(values.begin(), values.end(), 0.0); },
+             [&](parallel::Options o) { o.deterministic = true; sink += parallel::reduce(pool, values, 0.0, std::plus<>{}, o); });
+        line("inclusive_scan",
+             [&] { std::inclusive_scan(values.begin(), values.end(), out.begin()); },
+             [&](parallel::Options o) { parallel::inclusiveScan(pool, values, out.begin(), std::plus<>{}, o); });
+        line("irregular count_if",
+             [&] { sink += static_cast<double>(std::ranges::count_if(values, irregular)); },
+             [&](parallel::Options o) { sink += static_cast<double>(parallel::countIf(pool, values, irregular, o)); });
+        line("partition",
+             [&] { out = values; std::ranges::stable_partition(out, [](double x) { return x > 0.5; }); },
+             [&](parallel::Options o) { out = values; parallel::partition(pool, out, [](double x) { return x > 0.5; }, o); });
+
+        if (sink == 0)
+            std::cout << "    (?)\n";
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    using_std_for_each::main();
+    ranges::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
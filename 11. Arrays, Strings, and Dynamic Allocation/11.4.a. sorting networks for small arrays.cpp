@@ -0,0 +1,623 @@
+#include <iostream>
+#include <iomanip>          // std::setw
+#include <array>
+#include <vector>
+#include <span>
+#include <utility>          // std::pair, std::index_sequence
+#include <algorithm>        // std::min, std::max, std::sort
+#include <functional>       // std::less
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>          // std::size_t
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+    #include <xmmintrin.h>  // _MM_TRANSPOSE4_PS
+#endif
+#if defined(__SSE4_1__)
+    #include <smmintrin.h>  // _mm_min_epi32, _mm_max_epi32
+#endif
+
+
+// 11.4 sorts a 5 element array with selection sort. for tiny arrays that we sort over and
+// over (a median filter sorts a 3x3 or 5x5 window per pixel, a top-k merge sorts k
+// candidates per step), the comparisons themselves are the problem: which one comes next
+// depends on the data, and a mispredicted branch costs more than the whole comparison.
+
+// a SORTING NETWORK is a FIXED list of compare-exchanges (i, j): "put the smaller of a[i] and
+// a[j] into a[i], the larger into a[j]". the list doesn't depend on the data at all, so:
+//  - with the size known at compile time, it unrolls into straight-line code,
+//  - a compare-exchange of numbers is just a min and a max (no branch),
+//  - and with SIMD, one min/max sorts 4 arrays at once: put array k in lane k of every
+//    register (a transpose), run the network on registers, and transpose back.
+
+// the networks:
+//  - for N <= 8, the best known (also proven optimal) ones for 4, 6 and 8 elements. a network
+//    for fewer elements is the same network with every comparator that touches an element
+//    past the end removed (think of those elements as +infinity: they never move). that
+//    gives the optimal 1, 3, 5, 9, 12, 16 and 19 comparators for N = 2..8.
+//  - for larger N, Batcher's odd-even merge sort, generated at compile time for the next
+//    power of two and pruned the same way. not optimal (63 comparators for 16 where 60 is
+//    the best known) but close, and the same for every N up to 32.
+//  - a network sorts everything if it sorts every sequence of 0s and 1s (the 0-1 principle),
+//    so the small networks are checked at compile time, and all of them up to 20 at runtime.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                   ============[ compile-time networks ]============
+---------------------------------------------------------------------------------------*/
+
+namespace sorting_network
+{
+    using Comparator = std::pair<std::uint8_t, std::uint8_t>;
+
+    namespace detail
+    {
+        // best known networks, that are then pruned for smaller sizes
+        constexpr Comparator g_network4[]{ { 0, 2 }, { 1, 3 }, { 0, 1 }, { 2, 3 }, { 1, 2 } };
+
+        constexpr Comparator g_network6[]{
+            { 0, 5 }, { 1, 3 }, { 2, 4 }, { 1, 2 }, { 3, 4 }, { 0, 3 },
+            { 2, 5 }, { 0, 1 }, { 2, 3 }, { 4, 5 }, { 1, 2 }, { 3, 4 },
+        };
+
+        constexpr Comparator g_network8[]{
+            { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 }, { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }, { 0, 1 }, { 2, 3 },
+            { 4, 5 }, { 6, 7 }, { 2, 4 }, { 3, 5 }, { 1, 4 }, { 3, 6 }, { 1, 2 }, { 3, 4 }, { 5, 6 },
+        };
+
+        // calls emit(i, j) for every comparator of the network for n elements
+        template <typename Emit>
+        constexpr void generate(std::size_t n, Emit emit)
+        {
+            auto pruned{ [&](std::span<const Comparator> network) {
+                for (auto [i, j] : network)
+                {
+                    if (j < n)
+                        emit(i, j);
+                }
+            } };
+
+            if (n <= 4)
+                pruned(g_network4);
+            else if (n <= 6)
+                pruned(g_network6);
+            else if (n <= 8)
+                pruned(g_network8);
+            else
+            {
+                // Batcher's odd-even merge sort, for the next power of two
+                std::size_t size{ 1 };
+                while (size < n)
+                    size *= 2;
+
+                for (std::size_t p{ 1 }; p < size; p *= 2)
+                {
+                    for (std::size_t k{ p }; k >= 1; k /= 2)
+                    {
+                        for (std::size_t j{ k % p }; j + k < size; j += 2 * k)
+                        {
+                            for (std::size_t i{ 0 }; i < std::min(k, size - j - k); ++i)
+                            {
+                                if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < n)
+                                    emit(i + j, i + j + k);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        constexpr std::size_t comparatorCount(std::size_t n)
+        {
+            std::size_t count{ 0 };
+            generate(n, [&](std::size_t, std::size_t) { ++count; });
+            return count;
+        }
+
+        template <std::size_t N>
+        constexpr auto makeNetwork()
+        {
+            static_assert(N <= 32, "sorting networks are for small arrays");
+            std::array<Comparator, comparatorCount(N)> network{};
+            std::size_t next{ 0 };
+            generate(N, [&](std::size_t i, std::size_t j) {
+                network[next++] = { static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(j) };
+            });
+            return network;
+        }
+
+        // the 0-1 principle: run every N bit pattern through the network, and check that it
+        // comes out sorted (all the 0s, then all the 1s)
+        template <std::size_t N>
+        constexpr bool sortsAllZeroOnePatterns()
+        {
+            constexpr auto network{ makeNetwork<N>() };
+            for (std::uint32_t bits{ 0 }; bits < (std::uint32_t{ 1 } << N); ++bits)
+            {
+                std::uint32_t value{ bits };
+                for (auto [i, j] : network)
+                {
+                    std::uint32_t a{ (value >> i) & 1 };
+                    std::uint32_t b{ (value >> j) & 1 };
+                    value &= ~((std::uint32_t{ 1 } << i) | (std::uint32_t{ 1 } << j));
+                    value |= ((a & b) << i) | ((a | b) << j);
+                }
+
+                // sorted means: no 1 below a 0, i.e. the value is 1...10...0 (the 1s in the high bits)
+                std::uint32_t ones{ value };
+                std::uint32_t lowestOne{ ones & (~ones + 1) };
+                if (ones != 0 && ((ones + lowestOne) & ((std::uint32_t{ 1 } << N) - 1)) != 0)
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    template <std::size_t N>
+    constexpr auto g_network{ detail::makeNetwork<N>() };
+
+    static_assert(g_network<5>.size() == 9 && g_network<7>.size() == 16 && g_network<16>.size() == 63);
+    static_assert(detail::sortsAllZeroOnePatterns<4>() && detail::sortsAllZeroOnePatterns<5>()
+                  && detail::sortsAllZeroOnePatterns<6>() && detail::sortsAllZeroOnePatterns<7>()
+                  && detail::sortsAllZeroOnePatterns<8>() && detail::sortsAllZeroOnePatterns<9>());
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                   ============[ sorting one array ]============
+---------------------------------------------------------------------------------------*/
+
+namespace sorting_network
+{
+    namespace detail
+    {
+        template <typename T, typename Compare>
+        constexpr bool g_minMax{ std::is_arithmetic_v<T> && (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>) };
+
+        // numbers with std::less: no branch. floats as a min and a max (minss/maxss), ints as one
+        // compare and two selects (cmov; gcc turns std::min/std::max of ints into branches here).
+        // anything else: a compare and a conditional swap
+        template <typename T, typename Compare>
+        inline void compareExchange(T& a, T& b, Compare& compare)
+        {
+            if constexpr (g_minMax<T, Compare> && std::is_floating_point_v<T>)
+            {
+                // on a tie, min(a, b) is a and max(b, a) is b: -0.0 and +0.0 compare equal, and
+                // with min(a, b) and max(a, b), both would be a copy of a
+                T low{ std::min(a, b) };
+                T high{ std::max(b, a) };
+                a = low;
+                b = high;
+            }
+            else if constexpr (g_minMax<T, Compare>)
+            {
+                bool swapped{ b < a };
+                T low{ swapped ? b : a };
+                T high{ swapped ? a : b };
+                a = low;
+                b = high;
+            }
+            else if (compare(b, a))
+            {
+                using std::swap;
+                swap(a, b);
+            }
+        }
+    }
+
+    template <typename T, std::size_t N, typename Compare = std::less<>>
+    void sort(std::array<T, N>& array, Compare compare = {})
+    {
+        auto run{ [&]<std::size_t... I>(std::array<T, N>& values, std::index_sequence<I...>) {
+            (detail::compareExchange(values[g_network<N>[I].first], values[g_network<N>[I].second], compare), ...);
+        } };
+
+        if constexpr (N <= 1)
+            return;
+        else if constexpr (std::is_arithmetic_v<T>)
+        {
+            // a local copy of numbers is what lets the compiler keep them in registers
+            std::array<T, N> values{ array };
+            run(values, std::make_index_sequence<g_network<N>.size()>{});
+            array = values;
+        }
+        else
+            run(array, std::make_index_sequence<g_network<N>.size()>{});
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+               ============[ sorting 4 arrays at once, SSE2 ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  sortEach(arrays) sorts every std::array<float, N> (or int32) in the span. 4 arrays are
+  loaded at a time, transposed so that register i holds element i of all 4, sorted by the
+  network with _mm_min_ps/_mm_max_ps (_mm_min_epi32/_mm_max_epi32 with SSE4.1, a compare and
+  a blend with plain SSE2), transposed back and stored. the arrays left over are sorted one
+  by one. floats must not be NaN: min/max don't order NaNs.
+*/
+
+namespace sorting_network
+{
+#if defined(__SSE2__)
+    namespace detail
+    {
+        // on a tie _mm_min_ps and _mm_max_ps both return their second operand, so they get the
+        // operands in opposite orders: one of a pair of equal -0.0 and +0.0 ends up in each lane
+        inline void minMax(__m128& a, __m128& b)
+        {
+            __m128 low{ _mm_min_ps(a, b) };
+            b = _mm_max_ps(b, a);
+            a = low;
+        }
+
+        inline void minMax(__m128i& a, __m128i& b)
+        {
+#if defined(__SSE4_1__)
+            __m128i low{ _mm_min_epi32(a, b) };
+            b = _mm_max_epi32(a, b);
+            a = low;
+#else
+            __m128i greater{ _mm_cmpgt_epi32(a, b) };
+            __m128i low{ _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a)) };
+            b = _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+            a = low;
+#endif
+        }
+
+        // the transposes shuffle floats; ints just go along bit for bit
+        template <typename T>
+        struct Lanes;
+
+        template <>
+        struct Lanes<float>
+        {
+            using Register = __m128;
+        };
+
+        template <>
+        struct Lanes<std::int32_t>
+        {
+            using Register = __m128i;
+        };
+
+        inline __m128 toFloats(__m128 value) { return value; }
+        inline __m128 toFloats(__m128i value) { return _mm_castsi128_ps(value); }
+
+        inline void fromFloats(__m128 value, __m128& lane) { lane = value; }
+        inline void fromFloats(__m128 value, __m128i& lane) { lane = _mm_castps_si128(value); }
+
+        // element i of the 4 arrays -> lanes[i], with 4x4 transposes for every 4 columns
+        template <typename T, std::size_t N>
+        void transposeIn(const std::array<T, N>* arrays, typename Lanes<T>::Register (&lanes)[N])
+        {
+            std::size_t i{ 0 };
+            for (; i + 4 <= N; i += 4)
+            {
+                __m128 row0{ _mm_loadu_ps(reinterpret_cast<const float*>(arrays[0].data() + i)) };
+                __m128 row1{ _mm_loadu_ps(reinterpret_cast<const float*>(arrays[1].data() + i)) };
+                __m128 row2{ _mm_loadu_ps(reinterpret_cast<const float*>(arrays[2].data() + i)) };
+                __m128 row3{ _mm_loadu_ps(reinterpret_cast<const float*>(arrays[3].data() + i)) };
+                _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+                fromFloats(row0, lanes[i]);
+                fromFloats(row1, lanes[i + 1]);
+                fromFloats(row2, lanes[i + 2]);
+                fromFloats(row3, lanes[i + 3]);
+            }
+            for (; i < N; ++i)
+            {
+                alignas(16) T column[4]{ arrays[0][i], arrays[1][i], arrays[2][i], arrays[3][i] };
+                fromFloats(_mm_load_ps(reinterpret_cast<const float*>(column)), lanes[i]);
+            }
+        }
+
+        template <typename T, std::size_t N>
+        void transposeOut(const typename Lanes<T>::Register (&lanes)[N], std::array<T, N>* arrays)
+        {
+            std::size_t i{ 0 };
+            for (; i + 4 <= N; i += 4)
+            {
+                __m128 row0{ toFloats(lanes[i]) };
+                __m128 row1{ toFloats(lanes[i + 1]) };
+                __m128 row2{ toFloats(lanes[i + 2]) };
+                __m128 row3{ toFloats(lanes[i + 3]) };
+                _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+                _mm_storeu_ps(reinterpret_cast<float*>(arrays[0].data() + i), row0);
+                _mm_storeu_ps(reinterpret_cast<float*>(arrays[1].data() + i), row1);
+                _mm_storeu_ps(reinterpret_cast<float*>(arrays[2].data() + i), row2);
+                _mm_storeu_ps(reinterpret_cast<float*>(arrays[3].data() + i), row3);
+            }
+            for (; i < N; ++i)
+            {
+                alignas(16) T column[4];
+                _mm_store_ps(reinterpret_cast<float*>(column), toFloats(lanes[i]));
+                for (std::size_t k{ 0 }; k < 4; ++k)
+                    arrays[k][i] = column[k];
+            }
+        }
+    }
+#endif
+
+    template <typename T, std::size_t N>
+        requires std::is_same_v<T, float> || std::is_same_v<T, std::int32_t>
+    void sortEach(std::span<std::array<T, N>> arrays)
+    {
+        std::size_t next{ 0 };
+
+#if defined(__SSE2__)
+        if constexpr (N > 1)
+        {
+            for (; next + 4 <= arrays.size(); next += 4)
+            {
+                typename detail::Lanes<T>::Register lanes[N];
+                detail::transposeIn<T, N>(arrays.data() + next, lanes);
+                [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    (detail::minMax(lanes[g_network<N>[I].first], lanes[g_network<N>[I].second]), ...);
+                }(std::make_index_sequence<g_network<N>.size()>{});
+                detail::transposeOut<T, N>(lanes, arrays.data() + next);
+            }
+        }
+#endif
+
+        for (; next < arrays.size(); ++next)
+            sort(arrays[next]);
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ example ]============
+---------------------------------------------------------------------------------------*/
+
+namespace example
+{
+    void main()
+    {
+        // the array from 11.4
+        std::array array{ 30, 50, 20, 10, 40 };
+        sorting_network::sort(array);
+        for (int value : array)
+            std::cout << value << ' ';
+        std::cout << '\n';
+
+        std::cout << "the network for 5:";
+        for (auto [i, j] : sorting_network::g_network<5>)
+            std::cout << " (" << +i << ',' << +j << ')';
+        std::cout << '\n';
+
+        // median of every 3x3 window of a tiny "image", 4 windows at a time
+        std::vector<std::array<float, 9>> windows{
+            { 9, 1, 8, 2, 7, 3, 6, 4, 5 }, { 1, 1, 1, 9, 9, 9, 5, 5, 5 }, { 0, 0, 0, 0, 1, 0, 0, 0, 0 },
+            { 3, 1, 2, 6, 5, 4, 9, 8, 7 }, { 2, 2, 2, 2, 2, 2, 2, 2, 2 },
+        };
+        sorting_network::sortEach(std::span{ windows });
+        std::cout << "medians:";
+        for (const auto& window : windows)
+            std::cout << ' ' << window[4];
+        std::cout << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <random>
+#include <string>
+#include <cmath>            // std::signbit
+
+namespace checks
+{
+    // the 0-1 principle at runtime, for the sizes too big for the compiler to try every pattern
+    template <std::size_t N>
+    bool sortsAllZeroOnePatterns()
+    {
+        for (std::uint32_t bits{ 0 }; bits < (std::uint32_t{ 1 } << N); ++bits)
+        {
+            std::array<std::uint8_t, N> values{};
+            for (std::size_t i{ 0 }; i < N; ++i)
+                values[i] = (bits >> i) & 1;
+            sorting_network::sort(values);
+            if (!std::is_sorted(values.begin(), values.end()))
+                return false;
+        }
+        return true;
+    }
+
+    template <std::size_t N>
+    int checkSize(std::mt19937& mt)
+    {
+        int failures{ 0 };
+        if constexpr (N <= 20)
+            failures += !sortsAllZeroOnePatterns<N>();
+
+        std::vector<std::array<float, N>> floats(103);
+        std::vector<std::array<std::int32_t, N>> ints(103);
+        for (std::size_t k{ 0 }; k < floats.size(); ++k)
+        {
+            for (std::size_t i{ 0 }; i < N; ++i)
+            {
+                floats[k][i] = static_cast<float>(static_cast<int>(mt() % 2001) - 1000) / 8.0f;
+                if (k % 2 == 0 && mt() % 3 == 0)
+                    floats[k][i] = (mt() % 2 == 0) ? -0.0f : 0.0f;
+                ints[k][i] = static_cast<std::int32_t>(mt());
+            }
+        }
+
+        auto expectedFloats{ floats };
+        auto expectedInts{ ints };
+        for (auto& array : expectedFloats)
+            std::sort(array.begin(), array.end());
+        for (auto& array : expectedInts)
+            std::sort(array.begin(), array.end());
+
+        auto scalarInts{ ints };
+        for (auto& array : scalarInts)
+            sorting_network::sort(array);
+        auto scalarFloats{ floats };
+        for (auto& array : scalarFloats)
+            sorting_network::sort(array);
+
+        // -0.0 == +0.0, so == can't tell whether a zero was duplicated: count the negative ones
+        auto negativeZeros{ [](const std::vector<std::array<float, N>>& arrays) {
+            std::vector<std::size_t> counts{};
+            for (const auto& array : arrays)
+                counts.push_back(static_cast<std::size_t>(std::ranges::count_if(array, [](float x) { return x == 0.0f && std::signbit(x); })));
+            return counts;
+        } };
+        const auto expectedZeros{ negativeZeros(floats) };
+
+        sorting_network::sortEach(std::span{ floats });
+        sorting_network::sortEach(std::span{ ints });
+        failures += floats != expectedFloats || ints != expectedInts || scalarInts != expectedInts || scalarFloats != expectedFloats;
+        failures += negativeZeros(floats) != expectedZeros || negativeZeros(scalarFloats) != expectedZeros;
+
+        // a type that isn't a number, with a comparison that isn't std::less
+        std::array<std::string, N> words{};
+        for (auto& word : words)
+            word = std::to_string(mt() % 100);
+        sorting_network::sort(words, std::greater<>{});
+        failures += !std::is_sorted(words.begin(), words.end(), std::greater<>{});
+
+        return failures;
+    }
+
+    void main()
+    {
+        std::mt19937 mt{ 43 };
+        int failures{ 0 };
+        [&]<std::size_t... N>(std::index_sequence<N...>) {
+            ((failures += checkSize<N + 1>(mt)), ...);
+        }(std::make_index_sequence<32>{});
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// ns per array, sorting 200000 arrays of N random values each, for N = 2..32, with insertion
+// sort, std::sort, the network on one array at a time, and the network on 4 arrays at a time
+
+#include <chrono>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_arrays{ 200'000 };
+
+    template <typename T, std::size_t N>
+    void insertionSort(std::array<T, N>& array)
+    {
+        for (std::size_t i{ 1 }; i < N; ++i)
+        {
+            T value{ array[i] };
+            std::size_t j{ i };
+            for (; j > 0 && value < array[j - 1]; --j)
+                array[j] = array[j - 1];
+            array[j] = value;
+        }
+    }
+
+    template <typename T, std::size_t N>
+    void row(std::mt19937& mt)
+    {
+        std::vector<std::array<T, N>> original(g_arrays);
+        for (auto& array : original)
+        {
+            for (T& value : array)
+                value = static_cast<T>(static_cast<std::int32_t>(mt() % 2'000'001) - 1'000'000);
+        }
+
+        auto time{ [&](auto sortAll) {
+            auto arrays{ original };
+            Timer t;
+            sortAll(arrays);
+            double nanoseconds{ t.elapsed() / g_arrays * 1e9 };
+            for (const auto& array : arrays)
+            {
+                if (!std::is_sorted(array.begin(), array.end()))
+                    return -1.0;
+            }
+            return nanoseconds;
+        } };
+
+        std::cout << std::setw(4) << N
+                  << std::setw(12) << time([](auto& arrays) { for (auto& a : arrays) insertionSort(a); })
+                  << std::setw(12) << time([](auto& arrays) { for (auto& a : arrays) std::sort(a.begin(), a.end()); })
+                  << std::setw(12) << time([](auto& arrays) { for (auto& a : arrays) sorting_network::sort(a); })
+                  << std::setw(12) << time([](auto& arrays) { sorting_network::sortEach(std::span{ arrays }); })
+                  << '\n';
+    }
+
+    template <typename T>
+    void table(const char* name)
+    {
+        std::mt19937 mt{ 1 };
+        std::cout << name << ", ns per array\n"
+                  << std::setw(4) << "N" << std::setw(12) << "insertion" << std::setw(12) << "std::sort"
+                  << std::setw(12) << "network" << std::setw(12) << "network x4" << '\n';
+        [&]<std::size_t... N>(std::index_sequence<N...>) {
+            (row<T, N + 2>(mt), ...);
+        }(std::make_index_sequence<31>{});
+    }
+
+    void main()
+    {
+        std::cout << std::fixed << std::setprecision(1);
+        table<std::int32_t>("int32");
+        table<float>("float");
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    example::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
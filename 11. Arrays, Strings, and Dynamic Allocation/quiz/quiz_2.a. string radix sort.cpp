@@ -0,0 +1,599 @@
+#include <iostream>
+#include <vector>
+#include <span>
+#include <string>
+#include <string_view>
+#include <algorithm>        // std::sort, std::min
+#include <functional>       // std::invoke
+#include <type_traits>
+#include <utility>          // std::move, std::swap
+#include <bit>              // std::bit_width
+#include <cstdint>
+#include <cstddef>          // std::size_t
+
+
+// [ description ]
+/*---------------------------------------------------------------------------------------
+    quiz_2 sorts its Students by grade with std::ranges::sort and compareGradeGreater. sort
+    them by name instead, and every comparison is a string comparison: it follows two
+    pointers to two heap buffers and compares them byte by byte, over and over again, from
+    the first byte. with a lot of names sharing long prefixes ("Mar" in Maria, Mark,
+    Martin, Martinez...) most of that work is re-comparing bytes that are already known to
+    be equal.
+
+    here we write a string sort that never looks at the same byte twice (well, almost):
+        - MSD RADIX first: with more than 65536 records, one counting sort pass on the first
+          2 bytes of the key spreads them over 65536 buckets, each sorted on its own.
+        - MULTIKEY QUICKSORT: a 3-way quicksort on one "character" of the key at a time.
+          the smaller and larger parts are sorted on the same character again; the equal
+          part moves on to the next one, so a shared prefix is compared only once.
+        - the "character" is 8 bytes of the key, loaded big endian into a uint64 (so that
+          comparing two uint64s is comparing the 8 bytes in order) and CACHED next to the
+          record's index. partitioning only touches this small array, not the strings; we
+          only go back to the strings once per 8 bytes of depth.
+        - buckets of 32 or fewer records are finished with std::sort (on the cached prefix,
+          and then on the rest of the string), and so are the ranges where the pivots keep
+          coming out bad, like introsort does.
+        - the records are sorted by a projection, like std::ranges::sort(students, {},
+          &Student::firstName), and moved into their place once at the end.
+    like std::sort, it isn't stable: records with the same key end up in any order.
+---------------------------------------------------------------------------------------*/
+
+namespace string_sort
+{
+    namespace detail
+    {
+        struct Entry
+        {
+            std::uint64_t prefix{};     // 8 bytes of the key at the current depth, zero padded
+            std::size_t index{};        // which record
+        };
+
+        constexpr std::size_t s_smallBucket{ 32 };
+        constexpr std::size_t s_radixBits{ 16 };
+        constexpr std::size_t s_radixThreshold{ std::size_t{ 1 } << s_radixBits };
+
+        inline std::uint64_t loadPrefix(std::string_view key, std::size_t depth)
+        {
+            std::uint64_t prefix{ 0 };
+            if (key.size() >= depth + 8)
+            {
+                // a fixed count, so the compiler turns it into one load and a byte swap
+                for (std::size_t i{ 0 }; i < 8; ++i)
+                    prefix = (prefix << 8) | static_cast<unsigned char>(key[depth + i]);
+                return prefix;
+            }
+
+            std::size_t end{ std::min(key.size(), depth + 8) };
+            std::size_t i{ depth };
+            for (; i < end; ++i)
+                prefix = (prefix << 8) | static_cast<unsigned char>(key[i]);
+            for (; i < depth + 8; ++i)
+                prefix <<= 8;
+            return prefix;
+        }
+
+        class Sorter
+        {
+        private:
+            const std::vector<std::string_view>& m_keys;
+
+            void reload(Entry* begin, Entry* end, std::size_t depth) const
+            {
+                for (Entry* entry{ begin }; entry != end; ++entry)
+                    entry->prefix = loadPrefix(m_keys[entry->index], depth);
+            }
+
+            // strings that end before depth + 8 have nothing left to compare: their padded prefix
+            // is the same, so they differ only by length ("ab" < "ab\0")
+            bool finished(const Entry& entry, std::size_t depth) const
+            {
+                return m_keys[entry.index].size() <= depth + 8;
+            }
+
+            void smallSort(Entry* begin, Entry* end, std::size_t depth) const
+            {
+                std::sort(begin, end, [&](const Entry& a, const Entry& b) {
+                    if (a.prefix != b.prefix)
+                        return a.prefix < b.prefix;
+
+                    std::string_view keyA{ m_keys[a.index] };
+                    std::string_view keyB{ m_keys[b.index] };
+                    std::size_t from{ depth + 8 };
+                    if (keyA.size() <= from || keyB.size() <= from)
+                        return keyA.size() < keyB.size();
+                    return keyA.substr(from) < keyB.substr(from);
+                });
+            }
+
+            // [budget] is how many more levels of recursion we allow. median of 3 usually splits
+            // well, but some inputs make it pick a bad pivot every time: then this would recurse
+            // once per record (and overflow the stack) and take quadratic time. like std::sort's
+            // introsort, we give up on quicksort when the budget runs out and finish the range
+            // with std::sort, which compares the rest of the keys itself. the equal part is
+            // sorted in the loop, not by recursion, so keys with long common prefixes don't use
+            // up the budget.
+            void sort(Entry* begin, Entry* end, std::size_t depth, int budget) const
+            {
+                while (static_cast<std::size_t>(end - begin) > s_smallBucket && budget > 0)
+                {
+                    // median of 3 prefixes as the pivot
+                    std::uint64_t a{ begin->prefix };
+                    std::uint64_t b{ begin[(end - begin) / 2].prefix };
+                    std::uint64_t c{ end[-1].prefix };
+                    std::uint64_t pivot{ std::max(std::min(a, b), std::min(std::max(a, b), c)) };
+
+                    // 3-way partition: [begin, less) < pivot, [less, greater) == pivot, [greater, end) > pivot
+                    Entry* less{ begin };
+                    Entry* greater{ end };
+                    for (Entry* entry{ begin }; entry < greater;)
+                    {
+                        if (entry->prefix < pivot)
+                            std::swap(*entry++, *less++);
+                        else if (entry->prefix > pivot)
+                            std::swap(*entry, *--greater);
+                        else
+                            ++entry;
+                    }
+
+                    sort(begin, less, depth, budget - 1);
+                    sort(greater, end, depth, budget - 1);
+
+                    // the equal part: the finished strings go first, shortest first, and the rest
+                    // continue 8 bytes deeper
+                    Entry* unfinished{ std::partition(less, greater, [&](const Entry& entry) { return finished(entry, depth); }) };
+                    std::sort(less, unfinished, [&](const Entry& x, const Entry& y) {
+                        return m_keys[x.index].size() < m_keys[y.index].size();
+                    });
+
+                    begin = unfinished;
+                    end = greater;
+                    depth += 8;
+                    reload(begin, end, depth);
+                }
+
+                smallSort(begin, end, depth);
+            }
+
+        public:
+            explicit Sorter(const std::vector<std::string_view>& keys)
+                : m_keys{ keys }
+            {
+            }
+
+            void sort(Entry* begin, Entry* end) const
+            {
+                auto size{ static_cast<std::size_t>(end - begin) };
+                sort(begin, end, 0, 2 * static_cast<int>(std::bit_width(size)));
+            }
+        };
+    }
+
+    // sorts records by the string that projection(record) returns. the projection has to
+    // return a reference to a string that lives in the record (or a string_view of one),
+    // like &Student::firstName, not a temporary string
+    template <typename T, typename Projection>
+    void sortByString(std::span<T> records, Projection projection)
+    {
+        using Key = std::invoke_result_t<Projection&, T&>;
+        static_assert(std::is_lvalue_reference_v<Key> || std::is_same_v<std::remove_cvref_t<Key>, std::string_view>,
+                      "the projection must not return a temporary string");
+
+        std::vector<std::string_view> keys(records.size());
+        std::vector<detail::Entry> entries(records.size());
+        for (std::size_t i{ 0 }; i < records.size(); ++i)
+        {
+            keys[i] = std::invoke(projection, records[i]);
+            entries[i] = { detail::loadPrefix(keys[i], 0), i };
+        }
+
+        detail::Sorter sorter{ keys };
+        if (entries.size() <= detail::s_radixThreshold)
+            sorter.sort(entries.data(), entries.data() + entries.size());
+        else
+        {
+            // MSD radix: one counting sort pass on the first 2 bytes, then every bucket on its own
+            constexpr std::size_t shift{ 64 - detail::s_radixBits };
+            std::vector<std::size_t> bucketBegin(detail::s_radixThreshold + 1);
+            for (const auto& entry : entries)
+                ++bucketBegin[(entry.prefix >> shift) + 1];
+            for (std::size_t bucket{ 1 }; bucket < bucketBegin.size(); ++bucket)
+                bucketBegin[bucket] += bucketBegin[bucket - 1];
+
+            std::vector<detail::Entry> scattered(entries.size());
+            std::vector<std::size_t> next(bucketBegin.begin(), bucketBegin.end() - 1);
+            for (const auto& entry : entries)
+                scattered[next[entry.prefix >> shift]++] = entry;
+            entries.swap(scattered);
+
+            for (std::size_t bucket{ 0 }; bucket < detail::s_radixThreshold; ++bucket)
+                sorter.sort(entries.data() + bucketBegin[bucket], entries.data() + bucketBegin[bucket + 1]);
+        }
+
+        // the keys point into the records, so we're done with them before the records move
+        std::vector<T> sorted;
+        sorted.reserve(records.size());
+        for (const auto& entry : entries)
+            sorted.push_back(std::move(records[entry.index]));
+        std::move(sorted.begin(), sorted.end(), records.begin());
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                 ============[ the quiz, sorted by name ]============
+---------------------------------------------------------------------------------------*/
+
+namespace quiz_2
+{
+    struct Student
+    {
+        std::string firstName{};       // no whitespace
+        int grade{};                   // in 0-100 scale
+    };
+
+    void main()
+    {
+        std::vector<Student> students{
+            { "Martin", 78 }, { "Maria", 91 }, { "Mark", 64 }, { "Alex", 85 }, { "Marianne", 70 },
+            { "Mar", 99 }, { "Alexander", 59 }, { "Maria", 88 }, { "Zoe", 95 },
+        };
+
+        string_sort::sortByString(std::span{ students }, &Student::firstName);
+
+        for (auto& student : students)
+        {
+            std::cout << student.firstName
+                      << " got a grade of "
+                      << student.grade << '\n';
+        }
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ names ]============
+---------------------------------------------------------------------------------------*/
+
+// names the way they show up in real data: a few very common ones, a long tail of rare ones
+// (a Zipf distribution over a list of common first names and surnames), many long shared
+// prefixes, and the same name many times over
+
+#include <random>
+#include <array>
+#include <cctype>           // std::tolower
+
+namespace names
+{
+    constexpr std::array<std::string_view, 48> g_firstNames{
+        "James", "Mary", "Robert", "Patricia", "John", "Jennifer", "Michael", "Linda", "David", "Elizabeth",
+        "William", "Barbara", "Richard", "Susan", "Joseph", "Jessica", "Thomas", "Sarah", "Charles", "Karen",
+        "Christopher", "Lisa", "Daniel", "Nancy", "Matthew", "Betty", "Anthony", "Margaret", "Mark", "Sandra",
+        "Donald", "Ashley", "Steven", "Kimberly", "Paul", "Emily", "Andrew", "Donna", "Joshua", "Michelle",
+        "Maria", "Marianne", "Martin", "Marc", "Christian", "Christina", "Christine", "Alexander",
+    };
+
+    constexpr std::array<std::string_view, 40> g_surnames{
+        "Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Miller", "Davis", "Rodriguez", "Martinez",
+        "Hernandez", "Lopez", "Gonzalez", "Wilson", "Anderson", "Thomas", "Taylor", "Moore", "Jackson", "Martin",
+        "Lee", "Perez", "Thompson", "White", "Harris", "Sanchez", "Clark", "Ramirez", "Lewis", "Robinson",
+        "Walker", "Young", "Allen", "King", "Wright", "Scott", "Torres", "Nguyen", "Hill", "Flores",
+    };
+
+    // picks index i with probability proportional to 1 / (i + 1)
+    class Zipf
+    {
+    private:
+        std::vector<double> m_cumulative{};
+
+    public:
+        explicit Zipf(std::size_t count)
+        {
+            double sum{ 0.0 };
+            for (std::size_t i{ 0 }; i < count; ++i)
+            {
+                sum += 1.0 / static_cast<double>(i + 1);
+                m_cumulative.push_back(sum);
+            }
+        }
+
+        std::size_t operator()(std::mt19937& mt) const
+        {
+            double x{ std::uniform_real_distribution{ 0.0, m_cumulative.back() }(mt) };
+            return static_cast<std::size_t>(std::lower_bound(m_cumulative.begin(), m_cumulative.end() - 1, x) - m_cumulative.begin());
+        }
+    };
+
+    enum class Kind
+    {
+        firstName,      // "Maria"
+        fullName,       // "Martinez, Maria 17" (17: to tell the Maria Martinezes apart)
+        email,          // "maria.martinez17@students.example.edu"
+    };
+
+    std::string make(Kind kind, std::mt19937& mt, const Zipf& firstZipf, const Zipf& surnameZipf)
+    {
+        std::string_view first{ g_firstNames[firstZipf(mt)] };
+        std::string_view surname{ g_surnames[surnameZipf(mt)] };
+        std::string number{ std::to_string(mt() % 100) };
+
+        switch (kind)
+        {
+        case Kind::firstName:
+            return std::string{ first };
+        case Kind::fullName:
+            return std::string{ surname } + ", " + std::string{ first } + ' ' + number;
+        case Kind::email:
+        {
+            std::string email{ std::string{ first } + '.' + std::string{ surname } + number + "@students.example.edu" };
+            for (char& c : email)
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            return email;
+        }
+        }
+        return {};
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+namespace checks
+{
+    struct Record
+    {
+        std::string key{};
+        int id{};
+    };
+
+    // against std::stable_sort, comparing keys only (both sorts may order equal keys differently)
+    bool sortsLikeStdSort(std::vector<Record> records)
+    {
+        auto expected{ records };
+        std::stable_sort(expected.begin(), expected.end(), [](const Record& a, const Record& b) { return a.key < b.key; });
+
+        // the projection can also return a string_view
+        string_sort::sortByString(std::span{ records }, [](const Record& record) { return std::string_view{ record.key }; });
+
+        if (records.size() != expected.size())
+            return false;
+        for (std::size_t i{ 0 }; i < records.size(); ++i)
+        {
+            if (records[i].key != expected[i].key)
+                return false;
+        }
+
+        // and it's a permutation: every id is still there once
+        std::vector<int> ids;
+        for (const auto& record : records)
+            ids.push_back(record.id);
+        std::sort(ids.begin(), ids.end());
+        for (std::size_t i{ 0 }; i < ids.size(); ++i)
+        {
+            if (ids[i] != static_cast<int>(i))
+                return false;
+        }
+        return true;
+    }
+
+    // keys that make the median of 3 pick the second smallest key as the pivot every time, so
+    // that every partition only splits off one or two records. they're made like McIlroy's
+    // "killer adversary" for quicksort: we run the same partitioning on record numbers whose
+    // values aren't decided yet ("gas", larger than anything decided), and decide two of the
+    // three pivot candidates as the smallest values still free whenever they're looked at.
+    std::vector<std::string> quicksortKiller(std::size_t count)
+    {
+        constexpr std::uint64_t gas{ ~std::uint64_t{ 0 } };
+        std::vector<std::uint64_t> value(count, gas);
+        std::uint64_t nextSolid{ 0 };
+
+        std::vector<std::size_t> order(count);
+        for (std::size_t i{ 0 }; i < count; ++i)
+            order[i] = i;
+
+        // the same loop as Sorter::sort, with a stack of ranges instead of the recursion
+        std::vector<std::pair<std::size_t, std::size_t>> ranges{ { 0, count } };
+        while (!ranges.empty())
+        {
+            auto [begin, end]{ ranges.back() };
+            ranges.pop_back();
+            if (end - begin <= string_sort::detail::s_smallBucket)
+                continue;
+
+            for (std::size_t candidate : { begin, begin + (end - begin) / 2 })
+            {
+                if (value[order[candidate]] == gas)
+                    value[order[candidate]] = nextSolid++;
+            }
+            std::uint64_t a{ value[order[begin]] };
+            std::uint64_t b{ value[order[begin + (end - begin) / 2]] };
+            std::uint64_t c{ value[order[end - 1]] };
+            std::uint64_t pivot{ std::max(std::min(a, b), std::min(std::max(a, b), c)) };
+
+            std::size_t less{ begin };
+            std::size_t greater{ end };
+            for (std::size_t entry{ begin }; entry < greater;)
+            {
+                if (value[order[entry]] < pivot)
+                    std::swap(order[entry++], order[less++]);
+                else if (value[order[entry]] > pivot)
+                    std::swap(order[entry], order[--greater]);
+                else
+                    ++entry;
+            }
+            ranges.push_back({ begin, less });
+            ranges.push_back({ greater, end });
+        }
+
+        // the keys are 8 bytes, big endian, so that the prefixes are the values. the first 2
+        // bytes are 0, so with more than 65536 keys the radix pass puts them all in one bucket
+        // (in the same order)
+        std::vector<std::string> keys(count);
+        for (std::size_t i{ 0 }; i < count; ++i)
+        {
+            std::uint64_t key{ value[i] == gas ? nextSolid++ : value[i] };
+            for (int byte{ 7 }; byte >= 0; --byte)
+                keys[i] += static_cast<char>(key >> (byte * 8));
+        }
+        return keys;
+    }
+
+    void main()
+    {
+        std::mt19937 mt{ 44 };
+        int failures{ 0 };
+
+        auto withIds{ [](std::vector<std::string> keys) {
+            std::vector<Record> records;
+            for (int id{ 0 }; auto& key : keys)
+                records.push_back({ std::move(key), id++ });
+            return records;
+        } };
+
+        // nothing, one, all equal, prefixes of each other, embedded zeros and bytes >= 0x80
+        failures += !sortsLikeStdSort({});
+        failures += !sortsLikeStdSort(withIds({ "only" }));
+        failures += !sortsLikeStdSort(withIds(std::vector<std::string>(100, "same old name")));
+        {
+            std::vector<std::string> keys;
+            for (int i{ 0 }; i < 200; ++i)
+                keys.push_back(std::string(static_cast<std::size_t>(i % 40), 'a'));
+            keys.push_back(std::string{ "aaaaaaaa\0", 9 });
+            keys.push_back(std::string{ "aaaaaaaa\0\0", 10 });
+            keys.push_back(std::string{ "\xff\xfe" });
+            keys.push_back(std::string{ "\x80" });
+            keys.push_back("");
+            std::shuffle(keys.begin(), keys.end(), mt);
+            failures += !sortsLikeStdSort(withIds(keys));
+        }
+
+        // random bytes of random lengths, and the three kinds of names
+        for (int round{ 0 }; round < 20; ++round)
+        {
+            std::vector<std::string> keys(1 + mt() % 3000);
+            for (auto& key : keys)
+            {
+                key.resize(mt() % 24);
+                for (char& c : key)
+                    c = static_cast<char>('a' + mt() % 3);
+            }
+            failures += !sortsLikeStdSort(withIds(keys));
+        }
+
+        names::Zipf firstZipf{ names::g_firstNames.size() };
+        names::Zipf surnameZipf{ names::g_surnames.size() };
+        for (auto kind : { names::Kind::firstName, names::Kind::fullName, names::Kind::email })
+        {
+            // more than 65536, so that the radix pass runs too
+            std::vector<std::string> keys(100'000);
+            for (auto& key : keys)
+                key = names::make(kind, mt, firstZipf, surnameZipf);
+            failures += !sortsLikeStdSort(withIds(keys));
+        }
+
+        // bad pivots every time: without a limit, that's one level of recursion per 2 records
+        failures += !sortsLikeStdSort(withIds(quicksortKiller(1'000)));
+        failures += !sortsLikeStdSort(withIds(quicksortKiller(20'000)));
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// 1'000'000 Students for each kind of name, sorted by std::ranges::sort and
+// std::ranges::stable_sort with the name as projection, and by sortByString
+
+#include <chrono>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_students{ 1'000'000 };
+
+    void run(const char* name, names::Kind kind)
+    {
+        using quiz_2::Student;
+
+        std::mt19937 mt{ 2 };
+        names::Zipf firstZipf{ names::g_firstNames.size() };
+        names::Zipf surnameZipf{ names::g_surnames.size() };
+
+        std::vector<Student> original(g_students);
+        for (auto& student : original)
+            student = { names::make(kind, mt, firstZipf, surnameZipf), static_cast<int>(mt() % 101) };
+
+        std::cout << name << ":\n";
+
+        auto students{ original };
+        Timer t;
+        std::ranges::sort(students, {}, &Student::firstName);
+        std::cout << "    std::ranges::sort        : " << t.elapsed() << " s\n";
+
+        students = original;
+        t.reset();
+        std::ranges::stable_sort(students, {}, &Student::firstName);
+        std::cout << "    std::ranges::stable_sort : " << t.elapsed() << " s\n";
+
+        students = original;
+        t.reset();
+        string_sort::sortByString(std::span{ students }, &Student::firstName);
+        std::cout << "    sortByString             : " << t.elapsed() << " s\n";
+
+        if (!std::ranges::is_sorted(students, {}, &Student::firstName))
+            std::cout << "    (not sorted!)\n";
+    }
+
+    void main()
+    {
+        run("first names (\"Maria\")", names::Kind::firstName);
+        run("full names (\"Martinez, Maria 17\")", names::Kind::fullName);
+        run("emails (\"maria.martinez17@students.example.edu\")", names::Kind::email);
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    quiz_2::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
@@ -0,0 +1,557 @@
+#include <iostream>
+#include <array>
+#include <vector>
+#include <algorithm>        // std::min, std::max
+#include <string>
+#include <string_view>
+#include <charconv>         // std::to_chars
+#include <type_traits>
+#include <cstring>          // std::memcpy, std::memchr
+#include <cstddef>          // std::size_t
+#include <cerrno>
+
+#include <fcntl.h>          // open
+#include <unistd.h>         // write, close
+#include <sys/uio.h>        // writev, iovec
+#include <climits>          // IOV_MAX
+
+
+// [ description ]
+/*---------------------------------------------------------------------------------------
+    printCard() and printDeck() in quiz_6 (and writeAnswer() in the chapter 2 quiz) send
+    their output to std::cout one character or one number at a time. every one of those
+    operator<< calls goes through the stream's sentry, locale and formatting machinery.
+
+    that's not a problem for a card game, but it is for a program that writes hundreds of
+    megabytes of reports. here we write a small output writer that:
+        - collects output in a large buffer of its own and writes it with a single write()
+          system call straight to a file descriptor (no std::FILE, no std::streambuf)
+        - flushes according to an explicit policy: when the buffer is full, on every
+          newline, or only when we ask it to (the buffer grows until then)
+        - can batch big, already existing strings with writev() instead of copying them
+        - formats ints, chars and fixed-precision doubles with std::to_chars, directly
+          into the buffer
+---------------------------------------------------------------------------------------*/
+
+namespace fast_output
+{
+    enum class FlushPolicy
+    {
+        whenFull,       // flush only when the buffer can't hold the next write (the default)
+        onNewline,      // like a line-buffered terminal
+        manual,         // flush only on flush() (or destruction); the buffer grows as needed
+    };
+
+    // a fixed-precision double, like std::cout << std::fixed << std::setprecision(n) << value
+    struct Fixed
+    {
+        double value{};
+        int precision{ 2 };
+    };
+
+    class Writer
+    {
+    private:
+        static constexpr std::size_t s_maxNumberLength{ 32 };        // enough for any integer or shortest double
+        static constexpr std::size_t s_maxFixedIntegerDigits{ 310 };  // 1.8e308 has 309 digits before the point
+
+        int m_fd{ -1 };
+        bool m_ownsFd{ false };
+        bool m_bad{ false };
+        FlushPolicy m_policy{ FlushPolicy::whenFull };
+
+        std::vector<char> m_buffer{};
+        std::size_t m_size{ 0 };
+
+        // gather list for writev(): pieces of m_buffer interleaved with caller-owned strings
+        std::vector<iovec> m_pieces{};
+        std::size_t m_pieceStart{ 0 };       // start of the part of m_buffer not yet in m_pieces
+
+        std::size_t space() const { return m_buffer.size() - m_size; }
+
+        // writes all of [data, data+size), retrying on partial writes and interrupts
+        bool writeAll(const char* data, std::size_t size)
+        {
+            while (size > 0)
+            {
+                auto written{ ::write(m_fd, data, size) };
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                }
+                data += written;
+                size -= static_cast<std::size_t>(written);
+            }
+            return true;
+        }
+
+        bool writeAll(iovec* pieces, std::size_t count)
+        {
+            while (count > 0)
+            {
+                auto batch{ static_cast<int>(std::min<std::size_t>(count, IOV_MAX)) };
+                auto written{ ::writev(m_fd, pieces, batch) };
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                }
+
+                // skip what was written, which may end in the middle of a piece
+                auto remaining{ static_cast<std::size_t>(written) };
+                while (count > 0 && remaining >= pieces->iov_len)
+                {
+                    remaining -= pieces->iov_len;
+                    ++pieces;
+                    --count;
+                }
+                if (count > 0)
+                {
+                    pieces->iov_base = static_cast<char*>(pieces->iov_base) + remaining;
+                    pieces->iov_len -= remaining;
+                }
+            }
+            return true;
+        }
+
+        void closePiece()
+        {
+            if (m_size > m_pieceStart)
+                m_pieces.push_back({ m_buffer.data() + m_pieceStart, m_size - m_pieceStart });
+            m_pieceStart = m_size;
+        }
+
+        // makes room for at least size more bytes. the pieces that point into the buffer are
+        // moved along with it.
+        void grow(std::size_t size)
+        {
+            const char* oldData{ m_buffer.data() };
+            std::size_t oldSize{ m_buffer.size() };
+
+            m_buffer.resize(std::max(2 * oldSize, m_size + size));
+
+            for (auto& piece : m_pieces)
+            {
+                auto* base{ static_cast<const char*>(piece.iov_base) };
+                if (oldData <= base && base < oldData + oldSize)
+                    piece.iov_base = m_buffer.data() + (base - oldData);
+            }
+        }
+
+        // make sure at least size bytes are free, flushing (or, for the manual policy,
+        // growing) if needed. returns false if size is bigger than the whole buffer.
+        bool reserve(std::size_t size)
+        {
+            if (space() < size)
+            {
+                if (m_policy == FlushPolicy::manual)
+                    grow(size);
+                else
+                    flush();
+            }
+            return space() >= size;
+        }
+
+        void afterWrite(bool hasNewline)
+        {
+            if (hasNewline && m_policy == FlushPolicy::onNewline)
+                flush();
+        }
+
+    public:
+        static constexpr int s_stdout{ 1 };
+        static constexpr int s_stderr{ 2 };
+
+        explicit Writer(int fd = s_stdout, std::size_t bufferSize = 1 << 16, FlushPolicy policy = FlushPolicy::whenFull)
+            : m_fd{ fd }
+            , m_policy{ policy }
+            , m_buffer(std::max<std::size_t>(bufferSize, s_maxFixedIntegerDigits + 2 * s_maxNumberLength))
+        {
+        }
+
+        explicit Writer(const char* path, std::size_t bufferSize = 1 << 16, FlushPolicy policy = FlushPolicy::whenFull)
+            : m_fd{ ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) }
+            , m_ownsFd{ true }
+            , m_bad{ m_fd < 0 }
+            , m_policy{ policy }
+            , m_buffer(std::max<std::size_t>(bufferSize, s_maxFixedIntegerDigits + 2 * s_maxNumberLength))
+        {
+        }
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        ~Writer()
+        {
+            flush();
+            if (m_ownsFd && m_fd >= 0)
+                ::close(m_fd);
+        }
+
+        // like std::ostream::bad(): a write failed, and everything after it was dropped
+        bool bad() const { return m_bad; }
+
+        FlushPolicy flushPolicy() const { return m_policy; }
+        void setFlushPolicy(FlushPolicy policy) { m_policy = policy; }
+
+        void flush()
+        {
+            if (!m_bad)
+            {
+                if (m_pieces.empty())
+                    m_bad = !writeAll(m_buffer.data(), m_size);
+                else
+                {
+                    closePiece();
+                    m_bad = !writeAll(m_pieces.data(), m_pieces.size());
+                }
+            }
+
+            m_size = 0;
+            m_pieceStart = 0;
+            m_pieces.clear();
+        }
+
+        Writer& put(char ch)
+        {
+            reserve(1);
+            m_buffer[m_size++] = ch;
+
+            afterWrite(ch == '\n');
+            return *this;
+        }
+
+        // copies str into the buffer. strings bigger than half the buffer are written directly,
+        // together with whatever was already buffered, in a single writev() call (unless the
+        // policy is manual: then the buffer grows and they are copied like the rest).
+        Writer& put(std::string_view str)
+        {
+            if (str.size() > space() && str.size() > m_buffer.size() / 2 && m_policy != FlushPolicy::manual)
+            {
+                putRef(str);
+                flush();
+                return *this;
+            }
+
+            reserve(str.size());
+            std::memcpy(m_buffer.data() + m_size, str.data(), str.size());
+            m_size += str.size();
+
+            afterWrite(m_policy == FlushPolicy::onNewline && std::memchr(str.data(), '\n', str.size()));
+            return *this;
+        }
+
+        // does NOT copy str: it is written straight from the caller's memory with writev() on
+        // the next flush, so str must stay alive (and unchanged) until then.
+        // useful for big blocks of text that already exist somewhere, like a file we've read.
+        Writer& putRef(std::string_view str)
+        {
+            // writeAll() splits the list into IOV_MAX sized batches anyway; this only keeps it short
+            if (m_pieces.size() + 2 >= IOV_MAX && m_policy != FlushPolicy::manual)
+                flush();
+
+            closePiece();
+            m_pieces.push_back({ const_cast<char*>(str.data()), str.size() });
+
+            afterWrite(m_policy == FlushPolicy::onNewline && std::memchr(str.data(), '\n', str.size()));
+            return *this;
+        }
+
+        template <typename T>
+            requires std::is_integral_v<T>
+        Writer& putInt(T value)
+        {
+            reserve(s_maxNumberLength);
+            auto [end, ec]{ std::to_chars(m_buffer.data() + m_size, m_buffer.data() + m_buffer.size(), value) };
+            m_size = static_cast<std::size_t>(end - m_buffer.data());
+            return *this;
+        }
+
+        // the shortest text that reads back as exactly the same double
+        Writer& putDouble(double value)
+        {
+            reserve(s_maxNumberLength);
+            auto [end, ec]{ std::to_chars(m_buffer.data() + m_size, m_buffer.data() + m_buffer.size(), value) };
+            m_size = static_cast<std::size_t>(end - m_buffer.data());
+            return *this;
+        }
+
+        // a negative precision means the default of 6, as it does for std::cout and printf
+        // (and it must not reach the size computation below as a huge std::size_t)
+        Writer& putFixed(double value, int precision)
+        {
+            if (precision < 0)
+                precision = 6;
+
+            auto needed{ s_maxFixedIntegerDigits + static_cast<std::size_t>(precision) + 2 };
+
+            if (reserve(needed))
+            {
+                auto [end, ec]{ std::to_chars(m_buffer.data() + m_size, m_buffer.data() + m_buffer.size(),
+                                              value, std::chars_format::fixed, precision) };
+                m_size = static_cast<std::size_t>(end - m_buffer.data());
+            }
+            else    // a silly precision that doesn't fit in our buffer
+            {
+                std::string text(needed, '\0');
+                auto [end, ec]{ std::to_chars(text.data(), text.data() + text.size(),
+                                              value, std::chars_format::fixed, precision) };
+                text.resize(static_cast<std::size_t>(end - text.data()));
+                put(text);
+            }
+            return *this;
+        }
+    };
+
+    // operator<< so the writer reads like std::cout
+    inline Writer& operator<<(Writer& out, char ch) { return out.put(ch); }
+    inline Writer& operator<<(Writer& out, std::string_view str) { return out.put(str); }
+    inline Writer& operator<<(Writer& out, const char* str) { return out.put(std::string_view{ str }); }
+    inline Writer& operator<<(Writer& out, double value) { return out.putDouble(value); }
+    inline Writer& operator<<(Writer& out, Fixed fixed) { return out.putFixed(fixed.value, fixed.precision); }
+
+    template <typename T>
+        requires (std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>)
+    Writer& operator<<(Writer& out, T value)
+    {
+        return out.putInt(value);
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                  ============[ the quiz, using our writer ]============
+---------------------------------------------------------------------------------------*/
+
+namespace quiz_6
+{
+    enum class CardRank
+    {
+        rank_2, rank_3, rank_4, rank_5, rank_6, rank_7, rank_8, rank_9, rank_10,
+        rank_jack, rank_queen, rank_king, rank_ace,
+
+        max_ranks
+    };
+
+    enum class CardSuit
+    {
+        clubs, diamonds, hearts, spades,
+
+        max_suits
+    };
+
+    struct Card
+    {
+        CardRank rank {};
+        CardSuit suit {};
+    };
+
+    using deck_t = std::array<Card, (static_cast<std::size_t>(CardRank::max_ranks) * static_cast<std::size_t>(CardSuit::max_suits))>;
+
+    constexpr deck_t createDeck()
+    {
+        const int maxRank{ static_cast<int>(CardRank::max_ranks) };
+        const int maxSuit{ static_cast<int>(CardSuit::max_suits) };
+
+        deck_t deck {};
+
+        for (int suit{ 0 }; suit < maxSuit; ++suit)
+            for (int rank{ 0 }; rank < maxRank; ++rank)
+                deck[static_cast<std::size_t>(suit * maxRank + rank)] = { static_cast<CardRank>(rank), static_cast<CardSuit>(suit) };
+
+        return deck;
+    }
+
+    // instead of a switch with one operator<< per case, we look the codes up in a string
+    void printCard(fast_output::Writer& out, const Card& card)
+    {
+        constexpr std::string_view ranks{ "23456789TJQKA" };
+        constexpr std::string_view suits{ "CDHS" };
+
+        out << ranks[static_cast<std::size_t>(card.rank)] << suits[static_cast<std::size_t>(card.suit)];
+    }
+
+    void printDeck(fast_output::Writer& out, const deck_t& deck)
+    {
+        for (auto card : deck)
+        {
+            printCard(out, card);
+            out << ' ';
+        }
+        out << '\n';
+    }
+
+    // writeAnswer() from the chapter 2 quiz
+    void writeAnswer(fast_output::Writer& out, int answer)
+    {
+        out << "The answer is: " << answer << '\n';
+    }
+
+    void main()
+    {
+        // line-buffered, so our output interleaves properly with std::cout's
+        std::cout.flush();
+        fast_output::Writer out{ fast_output::Writer::s_stdout, 1 << 16, fast_output::FlushPolicy::onNewline };
+
+        printDeck(out, createDeck());
+        writeAnswer(out, 42);
+        out << "Pi is about " << fast_output::Fixed{ 3.14159265, 3 } << " (or " << 3.14159265 << ")\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                             ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+namespace checks
+{
+    // everything a nonblocking read can get from fd right now
+    std::string readAvailable(int fd)
+    {
+        std::string text{};
+        char chunk[4096];
+        for (ssize_t got{}; (got = ::read(fd, chunk, sizeof(chunk))) > 0;)
+            text.append(chunk, static_cast<std::size_t>(got));
+        return text;
+    }
+
+    void main()
+    {
+        int failures{ 0 };
+
+        int fds[2];
+        if (::pipe(fds) != 0)
+        {
+            std::cout << "checks: pipe() failed\n";
+            return;
+        }
+        ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+        {
+            // the manual policy: nothing may reach the pipe before flush(), whatever we write
+            fast_output::Writer out{ fds[1], 64, fast_output::FlushPolicy::manual };
+            std::string expected{};
+
+            const std::string big(3000, 'x');      // bigger than the whole buffer
+            for (int i{ 0 }; i < 200; ++i)
+            {
+                out << i << '\n';
+                expected += std::to_string(i) + '\n';
+            }
+            out << big;
+            out.putRef(big);
+            out << fast_output::Fixed{ 2.5, -1 } << ' ' << fast_output::Fixed{ 2.5, 1 } << '\n';
+            expected += big + big + "2.500000 2.5\n";
+
+            failures += !readAvailable(fds[0]).empty();
+
+            out.flush();
+            failures += readAvailable(fds[0]) != expected;
+            failures += out.bad();
+
+            // and after a flush, it's back to buffering
+            out << "more\n";
+            failures += !readAvailable(fds[0]).empty();
+        }
+        failures += readAvailable(fds[0]) != "more\n";     // the destructor flushes
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr int g_rows{ 1'000'000 };
+    constexpr const char* g_path{ "/dev/null" };
+
+    // a typical report line: an id, a code, and an amount
+    void streamReport()
+    {
+        std::ofstream out{ g_path };
+        out << std::fixed << std::setprecision(2);
+        for (int i{ 0 }; i < g_rows; ++i)
+            out << i << ',' << static_cast<char>('A' + i % 26) << ',' << i * 0.37 << '\n';
+    }
+
+    void writerReport(fast_output::FlushPolicy policy)
+    {
+        fast_output::Writer out{ g_path, 1 << 16, policy };
+        for (int i{ 0 }; i < g_rows; ++i)
+            out << i << ',' << static_cast<char>('A' + i % 26) << ',' << fast_output::Fixed{ i * 0.37, 2 } << '\n';
+    }
+
+    void main()
+    {
+        Timer t;
+        streamReport();
+        std::cout << "std::ofstream               : " << t.elapsed() << " s\n";
+
+        t.reset();
+        writerReport(fast_output::FlushPolicy::whenFull);
+        std::cout << "Writer (flush when full)    : " << t.elapsed() << " s\n";
+
+        t.reset();
+        writerReport(fast_output::FlushPolicy::onNewline);
+        std::cout << "Writer (flush every newline): " << t.elapsed() << " s\n";
+
+        t.reset();
+        writerReport(fast_output::FlushPolicy::manual);
+        std::cout << "Writer (flush once, at end) : " << t.elapsed() << " s\n";
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    quiz_6::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
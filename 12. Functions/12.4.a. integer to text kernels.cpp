@@ -0,0 +1,688 @@
+#include <iostream>
+#include <bit>              // std::countl_zero
+#include <concepts>
+#include <algorithm>        // std::max
+#include <array>
+#include <string>
+#include <type_traits>
+#include <cstring>          // std::memcpy
+#include <cstdint>
+#include <cstddef>          // std::size_t
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+// in 12.4 (quiz 3) we printed the binary representation of a number with a recursive
+// function: one call, one division and one std::cout << per bit.
+
+// that's a nice way to learn recursion, but converting integers to text is something a lot
+// of programs do billions of times (logs, CSV files, JSON...). in this file we write
+// conversion functions ("kernels") for base 2, 10 and 16 that:
+    // - write into a buffer the caller gives us, and return a pointer one past the last char
+    //   written (the same convention as std::to_chars)
+    // - never call the stream machinery
+    // - avoid branches that depend on the individual digits
+    // - work for every signed and unsigned integer type from 8 to 128 bits
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                  ============[ integer types from 8 to 128 bits ]============
+---------------------------------------------------------------------------------------*/
+
+// __int128 is a GCC/Clang extension. in strict -std=c++20 mode std::is_integral_v is false for
+// it (and std::make_unsigned doesn't work), so we write our own small set of traits.
+
+namespace int_text
+{
+    __extension__ using int128 = __int128;
+    __extension__ using uint128 = unsigned __int128;
+
+    template <typename T>
+    concept Integer = (std::is_integral_v<T> && !std::same_as<T, bool>)
+                   || std::same_as<T, int128> || std::same_as<T, uint128>;
+
+    template <typename T>
+    struct MakeUnsigned
+    {
+        using type = std::make_unsigned_t<T>;
+    };
+
+    template <> struct MakeUnsigned<int128>  { using type = uint128; };
+    template <> struct MakeUnsigned<uint128> { using type = uint128; };
+
+    template <typename T>
+    using unsigned_t = typename MakeUnsigned<T>::type;
+
+    template <typename T>
+    constexpr bool g_isSigned{ std::is_signed_v<T> || std::same_as<T, int128> };
+
+    // largest number of characters each conversion can write (including a '-')
+    template <Integer T> constexpr std::size_t g_maxBinaryLength{ sizeof(T) * 8 + 1 };
+    template <Integer T> constexpr std::size_t g_maxHexLength{ sizeof(T) * 2 + 1 };
+    template <Integer T> constexpr std::size_t g_maxDecimalLength{ sizeof(T) == 16 ? 40 : sizeof(T) * 3 + 1 };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ base 10 ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - counting digits: the number of bits in a value (64 - leading zeros, which is a single
+    lzcnt/bsr instruction) tells us the number of decimal digits within one.
+    bits * 1233 / 4096 is a cheap approximation of bits * log10(2), and one comparison with a
+    table of powers of 10 fixes it up.
+
+  - once we know how many digits there are, we write from the END of the number towards the
+    front, two digits at a time, using a table of the 100 two-digit strings "00" to "99".
+    that halves the number of (slow) divisions compared to one digit at a time.
+*/
+
+namespace int_text
+{
+    constexpr char g_digitPairs[]{
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899"
+    };
+
+    // the first entry is 0 (not 1) so that 0 is counted as one digit
+    constexpr std::uint64_t g_powersOf10[]{
+        0ULL, 10ULL, 100ULL, 1'000ULL, 10'000ULL, 100'000ULL, 1'000'000ULL, 10'000'000ULL,
+        100'000'000ULL, 1'000'000'000ULL, 10'000'000'000ULL, 100'000'000'000ULL,
+        1'000'000'000'000ULL, 10'000'000'000'000ULL, 100'000'000'000'000ULL,
+        1'000'000'000'000'000ULL, 10'000'000'000'000'000ULL, 100'000'000'000'000'000ULL,
+        1'000'000'000'000'000'000ULL, 10'000'000'000'000'000'000ULL,
+    };
+
+    inline int countDigits(std::uint64_t value)
+    {
+        int bits{ 64 - std::countl_zero(value | 1) };
+        int approximation{ (bits * 1233) >> 12 };
+        return approximation + (value >= g_powersOf10[approximation]);
+    }
+
+    // writes exactly [digits] digits of value ending at out + digits
+    inline void writeDigits(char* out, std::uint64_t value, int digits)
+    {
+        char* p{ out + digits };
+
+        while (value >= 100)
+        {
+            auto pair{ static_cast<std::size_t>(value % 100) * 2 };
+            value /= 100;
+            p -= 2;
+            std::memcpy(p, g_digitPairs + pair, 2);
+        }
+
+        if (value >= 10)
+        {
+            p -= 2;
+            std::memcpy(p, g_digitPairs + value * 2, 2);
+        }
+        else
+            *--p = static_cast<char>('0' + value);
+
+        // only reached when the caller asked for leading zeros (the 128-bit path)
+        while (p > out)
+            *--p = '0';
+    }
+
+    inline char* toDecimalUnsigned(char* out, std::uint64_t value)
+    {
+        int digits{ countDigits(value) };
+        writeDigits(out, value, digits);
+        return out + digits;
+    }
+
+    inline char* toDecimalUnsigned(char* out, uint128 value)
+    {
+        // a 128-bit value has at most 39 digits. we split it in pieces of 19 digits that each
+        // fit in a std::uint64_t, so only (at most) two 128-bit divisions are needed.
+        constexpr std::uint64_t tenTo19{ 10'000'000'000'000'000'000ULL };
+
+        if (value <= UINT64_MAX)
+            return toDecimalUnsigned(out, static_cast<std::uint64_t>(value));
+
+        auto low{ static_cast<std::uint64_t>(value % tenTo19) };
+        value /= tenTo19;
+
+        if (value <= UINT64_MAX)
+            out = toDecimalUnsigned(out, static_cast<std::uint64_t>(value));
+        else
+        {
+            auto middle{ static_cast<std::uint64_t>(value % tenTo19) };
+            out = toDecimalUnsigned(out, static_cast<std::uint64_t>(value / tenTo19));
+            writeDigits(out, middle, 19);
+            out += 19;
+        }
+
+        writeDigits(out, low, 19);
+        return out + 19;
+    }
+
+    template <Integer T>
+    char* toDecimal(char* out, T value)
+    {
+        using U = unsigned_t<T>;
+        auto magnitude{ static_cast<U>(value) };
+
+        if constexpr (g_isSigned<T>)
+        {
+            *out = '-';
+            bool negative{ value < 0 };
+            out += negative;
+            magnitude = negative ? static_cast<U>(U{ 0 } - magnitude) : magnitude;
+        }
+
+        if constexpr (sizeof(T) == 16)
+            return toDecimalUnsigned(out, static_cast<uint128>(magnitude));
+        else
+            return toDecimalUnsigned(out, static_cast<std::uint64_t>(magnitude));
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ base 2 ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - every bit becomes exactly one byte, '0' or '1'. with SSE2 we can turn 16 bits into 16
+    characters at once:
+        1. broadcast the high byte into the first 8 lanes and the low byte into the last 8
+        2. AND every lane with its own bit mask (0x80, 0x40, ..., 0x01)
+        3. compare with the mask: lanes where the bit was set become 0xFF
+        4. keep the lowest bit of each lane and add '0'
+
+  - like printBinaryFromInt() in 12.4, a signed value is printed as its two's complement bit
+    pattern (so -1 is all ones). leading zeros are dropped, and 0 is printed as "0".
+*/
+
+namespace int_text
+{
+    // writes exactly 16 characters for the 16 bits of value, most significant first
+    inline void expandBits16(char* out, std::uint16_t value)
+    {
+#if defined(__SSE2__)
+        const __m128i masks{ _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128) };
+
+        auto high{ static_cast<std::uint64_t>(value >> 8) * 0x0101010101010101ULL };
+        auto low{ static_cast<std::uint64_t>(value & 0xFF) * 0x0101010101010101ULL };
+
+        __m128i bytes{ _mm_set_epi64x(static_cast<long long>(low), static_cast<long long>(high)) };
+        __m128i set{ _mm_cmpeq_epi8(_mm_and_si128(bytes, masks), masks) };
+        __m128i chars{ _mm_add_epi8(_mm_and_si128(set, _mm_set1_epi8(1)), _mm_set1_epi8('0')) };
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);
+#else
+        for (int bit{ 0 }; bit < 16; ++bit)
+            out[bit] = static_cast<char>('0' + ((value >> (15 - bit)) & 1));
+#endif
+    }
+
+    template <Integer T>
+    char* toBinary(char* out, T value)
+    {
+        using U = unsigned_t<T>;
+        constexpr int bits{ sizeof(T) * 8 };
+        constexpr int groups{ (bits + 15) / 16 };
+
+        auto pattern{ static_cast<U>(value) };
+
+        // expand every 16-bit group into a scratch buffer, then copy the significant part
+        char scratch[groups * 16];
+        for (int group{ 0 }; group < groups; ++group)
+        {
+            int shift{ (groups - 1 - group) * 16 };
+            expandBits16(scratch + group * 16, static_cast<std::uint16_t>(shift < bits ? pattern >> shift : 0));
+        }
+
+        int length{ 1 };    // at least one digit, for 0
+        if constexpr (sizeof(T) == 16)
+        {
+            auto high{ static_cast<std::uint64_t>(pattern >> 64) };
+            auto low{ static_cast<std::uint64_t>(pattern) };
+            length = high ? 128 - std::countl_zero(high) : std::max(1, 64 - std::countl_zero(low));
+        }
+        else
+            length = std::max(1, 64 - std::countl_zero(static_cast<std::uint64_t>(pattern)));
+
+        std::memcpy(out, scratch + groups * 16 - length, static_cast<std::size_t>(length));
+        return out + length;
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ base 16 ]============
+---------------------------------------------------------------------------------------*/
+
+// one byte is exactly two hex digits, so the same two-character lookup table trick as base 10
+// works here, without any division at all: a shift and a mask per byte.
+
+
+namespace int_text
+{
+    constexpr auto g_hexPairs{ [] {
+        constexpr char digits[]{ "0123456789abcdef" };
+        std::array<char, 512> table{};
+        for (std::size_t i{ 0 }; i < 256; ++i)
+        {
+            table[i * 2] = digits[i >> 4];
+            table[i * 2 + 1] = digits[i & 0xF];
+        }
+        return table;
+    }() };
+
+    template <Integer T>
+    char* toHex(char* out, T value)
+    {
+        using U = unsigned_t<T>;
+        auto pattern{ static_cast<U>(value) };
+
+        int significantBits{};
+        if constexpr (sizeof(T) == 16)
+        {
+            auto high{ static_cast<std::uint64_t>(pattern >> 64) };
+            significantBits = high ? 128 - std::countl_zero(high) : 64 - std::countl_zero(static_cast<std::uint64_t>(pattern));
+        }
+        else
+            significantBits = 64 - std::countl_zero(static_cast<std::uint64_t>(pattern));
+
+        int digits{ std::max(1, (significantBits + 3) / 4) };
+        char* p{ out + digits };
+
+        // two digits per byte, from the end
+        for (int i{ digits }; i >= 2; i -= 2)
+        {
+            p -= 2;
+            std::memcpy(p, g_hexPairs.data() + static_cast<std::size_t>(pattern & 0xFF) * 2, 2);
+            pattern >>= 4;      // two shifts of 4 instead of one of 8: an 8-bit U can't be shifted by 8
+            pattern >>= 4;
+        }
+        if (digits % 2)
+            *--p = g_hexPairs[static_cast<std::size_t>(pattern & 0xF) * 2 + 1];
+
+        return out + digits;
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                 ============[ checking against std::to_chars ]============
+---------------------------------------------------------------------------------------*/
+
+#include <charconv>
+#include <random>
+#include <string_view>
+#include <limits>
+#include <vector>
+
+namespace checks
+{
+    using namespace int_text;
+
+    // the edge values of T: the digit count changes at every power of 10 and of 2, and the
+    // signed minimum is the one value whose magnitude doesn't fit in T
+    template <Integer T>
+    std::vector<T> edgeValues()
+    {
+        std::vector<T> values{ T{ 0 }, T{ 1 }, std::numeric_limits<T>::min(), static_cast<T>(std::numeric_limits<T>::min() + 1),
+                               std::numeric_limits<T>::max(), static_cast<T>(std::numeric_limits<T>::max() - 1) };
+        if constexpr (g_isSigned<T>)
+            values.push_back(T{ -1 });
+
+        unsigned_t<T> power{ 1 };
+        while (power <= static_cast<unsigned_t<T>>(std::numeric_limits<T>::max() / 10))
+        {
+            power *= 10;
+            for (int offset{ -1 }; offset <= 1; ++offset)
+            {
+                auto value{ static_cast<unsigned_t<T>>(power + offset) };
+                values.push_back(static_cast<T>(value));
+                if constexpr (g_isSigned<T>)
+                    values.push_back(static_cast<T>(unsigned_t<T>{ 0 } - value));
+            }
+        }
+        for (int bit{ 0 }; bit < static_cast<int>(sizeof(T) * 8); ++bit)
+            values.push_back(static_cast<T>(unsigned_t<T>{ 1 } << bit));
+
+        return values;
+    }
+
+    // a random value with a random number of significant bits, so that every length gets tested
+    template <Integer T>
+    T randomValue(std::mt19937_64& mt)
+    {
+        using U = unsigned_t<T>;
+        auto raw{ static_cast<U>(mt()) };
+        if constexpr (sizeof(T) == 16)
+            raw = raw << 64 | mt();
+
+        auto bits{ static_cast<int>(mt() % (sizeof(T) * 8)) + 1 };
+        return static_cast<T>(bits == static_cast<int>(sizeof(T) * 8) ? raw : raw & ((U{ 1 } << bits) - 1));
+    }
+
+    template <Integer T>
+    bool checkValue(T value)
+    {
+        char expected[g_maxBinaryLength<std::uint64_t> + 1]{};
+        char actual[g_maxBinaryLength<std::uint64_t> + 1]{};
+
+        auto compare{ [&](char* expectedEnd, char* actualEnd) {
+            return std::string_view(expected, static_cast<std::size_t>(expectedEnd - expected))
+                == std::string_view(actual, static_cast<std::size_t>(actualEnd - actual));
+        } };
+
+        // and the text reads back as the same value
+        auto roundTrip{ [&](char* end, auto original, int base) {
+            decltype(original) parsed{};
+            auto [ptr, error]{ std::from_chars(actual, end, parsed, base) };
+            return error == std::errc{} && ptr == end && parsed == original;
+        } };
+
+        using U = unsigned_t<T>;
+        char* end{ toDecimal(actual, value) };
+        bool ok{ compare(std::to_chars(std::begin(expected), std::end(expected), value).ptr, end) && roundTrip(end, value, 10) };
+
+        end = toHex(actual, value);
+        ok = ok && compare(std::to_chars(std::begin(expected), std::end(expected), static_cast<U>(value), 16).ptr, end)
+                && roundTrip(end, static_cast<U>(value), 16);
+
+        end = toBinary(actual, value);
+        ok = ok && compare(std::to_chars(std::begin(expected), std::end(expected), static_cast<U>(value), 2).ptr, end)
+                && roundTrip(end, static_cast<U>(value), 2);
+        return ok;
+    }
+
+    template <Integer T>
+    bool checkType(std::mt19937_64& mt)
+    {
+        bool ok{ true };
+        for (T value : edgeValues<T>())
+            ok = ok && checkValue(value);
+
+        for (int i{ 0 }; i < 100'000 && ok; ++i)
+            ok = checkValue(randomValue<T>(mt));
+        return ok;
+    }
+
+    // std::to_chars doesn't support 128-bit integers in strict mode, so for those we compare
+    // with the simplest possible conversion: one division per digit. (the benchmark uses it
+    // too, as what we'd write without thinking about speed.)
+    template <Integer T>
+    char* referenceToChars(char* out, T value, unsigned base = 10)
+    {
+        using U = unsigned_t<T>;
+        auto magnitude{ static_cast<U>(value) };
+        if (base == 10 && value < T{ 0 })
+        {
+            *out++ = '-';
+            magnitude = U{ 0 } - magnitude;
+        }
+
+        char* first{ out };
+        do
+        {
+            *out++ = "0123456789abcdef"[static_cast<int>(magnitude % base)];
+            magnitude /= base;
+        } while (magnitude != 0);
+
+        std::reverse(first, out);
+        return out;
+    }
+
+    // and the reverse, for the round trip (the text is known to be well formed)
+    template <Integer T>
+    T referenceFromChars(std::string_view text, unsigned base = 10)
+    {
+        using U = unsigned_t<T>;
+        bool negative{ !text.empty() && text[0] == '-' };
+        if (negative)
+            text.remove_prefix(1);
+
+        U magnitude{ 0 };
+        for (char ch : text)
+            magnitude = magnitude * base + static_cast<U>(ch <= '9' ? ch - '0' : ch - 'a' + 10);
+        return static_cast<T>(negative ? U{ 0 } - magnitude : magnitude);
+    }
+
+    template <Integer T>
+    bool checkValue128(T value)
+    {
+        char expected[g_maxBinaryLength<uint128>]{};
+        char actual[g_maxBinaryLength<uint128>]{};
+
+        using U = unsigned_t<T>;
+        auto check{ [&](char* expectedEnd, char* actualEnd, unsigned base) {
+            std::string_view text(actual, static_cast<std::size_t>(actualEnd - actual));
+            return std::string_view(expected, static_cast<std::size_t>(expectedEnd - expected)) == text
+                && (base == 10 ? referenceFromChars<T>(text) == value : referenceFromChars<U>(text, base) == static_cast<U>(value));
+        } };
+
+        return check(referenceToChars(expected, value), toDecimal(actual, value), 10)
+            && check(referenceToChars(expected, static_cast<U>(value), 16), toHex(actual, value), 16)
+            && check(referenceToChars(expected, static_cast<U>(value), 2), toBinary(actual, value), 2);
+    }
+
+    template <Integer T>
+    bool checkType128(std::mt19937_64& mt)
+    {
+        bool ok{ true };
+        for (T value : edgeValues<T>())
+            ok = ok && checkValue128(value);
+
+        for (int i{ 0 }; i < 100'000 && ok; ++i)
+            ok = checkValue128(randomValue<T>(mt));
+        return ok;
+    }
+
+    // and a few values written out by hand, so that we don't only trust the reference
+    bool check128()
+    {
+        char text[g_maxBinaryLength<uint128>]{};
+
+        uint128 max128{ ~uint128{ 0 } };
+        bool ok{ std::string_view(text, toDecimal(text, max128)) == "340282366920938463463374607431768211455" };
+
+        int128 min128{ static_cast<int128>(uint128{ 1 } << 127) };
+        ok = ok && std::string_view(text, toDecimal(text, min128)) == "-170141183460469231731687303715884105728";
+
+        uint128 tenTo20{ uint128{ 10'000'000'000'000'000'000ULL } * 10 };
+        ok = ok && std::string_view(text, toDecimal(text, tenTo20)) == "100000000000000000000";
+
+        ok = ok && std::string_view(text, toHex(text, max128)) == "ffffffffffffffffffffffffffffffff";
+        ok = ok && std::string_view(text, toBinary(text, uint128{ 1 } << 100)) == "1" + std::string(100, '0');
+        return ok;
+    }
+
+    void main()
+    {
+        std::mt19937_64 mt{ 42 };
+
+        std::cout << std::boolalpha;
+        std::cout << "int8    " << checkType<std::int8_t>(mt) << '\n';
+        std::cout << "uint8   " << checkType<std::uint8_t>(mt) << '\n';
+        std::cout << "int16   " << checkType<std::int16_t>(mt) << '\n';
+        std::cout << "uint16  " << checkType<std::uint16_t>(mt) << '\n';
+        std::cout << "int32   " << checkType<std::int32_t>(mt) << '\n';
+        std::cout << "uint32  " << checkType<std::uint32_t>(mt) << '\n';
+        std::cout << "int64   " << checkType<std::int64_t>(mt) << '\n';
+        std::cout << "uint64  " << checkType<std::uint64_t>(mt) << '\n';
+        std::cout << "int128  " << checkType128<int128>(mt) << '\n';
+        std::cout << "uint128 " << checkType128<uint128>(mt) << '\n';
+        std::cout << "128 bit " << check128() << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+             ============[ benchmark: std::to_chars and iostream ]============
+---------------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    // runs fn(out, value) for every value, writing into one big buffer
+    template <typename T, typename Fn>
+    double run(const std::vector<T>& values, std::vector<char>& buffer, Fn fn)
+    {
+        Timer t;
+        char* out{ buffer.data() };
+        for (auto value : values)
+        {
+            out = fn(out, value);
+            *out++ = '\n';
+        }
+        double time{ t.elapsed() };
+
+        // use the result so the compiler can't throw the work away
+        if (out == buffer.data())
+            std::cout << '?';
+        return time;
+    }
+
+    double runStream(const std::vector<std::uint64_t>& values, int base)
+    {
+        Timer t;
+        std::ostringstream out{};
+        out << (base == 16 ? std::hex : std::dec);
+        for (auto value : values)
+            out << value << '\n';
+        double time{ t.elapsed() };
+
+        if (out.str().empty())
+            std::cout << '?';
+        return time;
+    }
+
+    // the recursive function from 12.4, printing into a stream instead of std::cout
+    void printBinaryFromInt(std::ostream& out, std::uint64_t num)
+    {
+        if (num == 0) return;
+
+        printBinaryFromInt(out, num/2);
+        out << (num % 2);
+    }
+
+    void main()
+    {
+        constexpr std::size_t count{ 5'000'000 };
+
+        std::mt19937_64 mt{ 7 };
+        std::vector<std::uint64_t> values(count);
+        for (auto& value : values)
+            value = mt() >> (mt() % 64);        // mixed magnitudes, like real data
+
+        std::vector<char> buffer(count * 66);
+
+        std::cout << "decimal: std::to_chars " << run(values, buffer, [](char* out, std::uint64_t v) {
+                         return std::to_chars(out, out + 20, v).ptr; })
+                  << " s, int_text " << run(values, buffer, [](char* out, std::uint64_t v) {
+                         return int_text::toDecimal(out, v); })
+                  << " s, std::ostringstream " << runStream(values, 10) << " s\n";
+
+        std::cout << "hex    : std::to_chars " << run(values, buffer, [](char* out, std::uint64_t v) {
+                         return std::to_chars(out, out + 16, v, 16).ptr; })
+                  << " s, int_text " << run(values, buffer, [](char* out, std::uint64_t v) {
+                         return int_text::toHex(out, v); })
+                  << " s, std::ostringstream " << runStream(values, 16) << " s\n";
+
+        std::vector<std::uint64_t> fewer(values.begin(), values.begin() + count / 10);
+        Timer t;
+        std::ostringstream recursive{};
+        for (auto value : fewer)
+        {
+            printBinaryFromInt(recursive, value);
+            recursive << '\n';
+        }
+        double recursiveTime{ t.elapsed() * 10 };       // scaled to the full count
+
+        std::cout << "binary : std::to_chars " << run(values, buffer, [](char* out, std::uint64_t v) {
+                         return std::to_chars(out, out + 64, v, 2).ptr; })
+                  << " s, int_text " << run(values, buffer, [](char* out, std::uint64_t v) {
+                         return int_text::toBinary(out, v); })
+                  << " s, recursive (12.4) ~" << recursiveTime << " s\n";
+
+        // the narrowest and the widest types, where the digit counting and the 19 digit pieces matter
+        std::vector<std::uint32_t> values32(count);
+        for (auto& value : values32)
+            value = static_cast<std::uint32_t>(mt() >> (32 + mt() % 32));
+
+        std::cout << "uint32 : std::to_chars " << run(values32, buffer, [](char* out, std::uint32_t v) {
+                         return std::to_chars(out, out + 10, v).ptr; })
+                  << " s, int_text " << run(values32, buffer, [](char* out, std::uint32_t v) {
+                         return int_text::toDecimal(out, v); }) << " s\n";
+
+        // (std::to_chars doesn't take __int128 in strict mode, so we compare with a division per digit)
+        std::vector<int_text::int128> values128(count);
+        for (auto& value : values128)
+        {
+            auto raw{ static_cast<int_text::uint128>(mt()) << 64 | mt() };
+            value = static_cast<int_text::int128>(raw) >> (mt() % 128);
+        }
+
+        std::cout << "int128 : division loop " << run(values128, buffer, [](char* out, int_text::int128 v) {
+                         return checks::referenceToChars(out, v); })
+                  << " s, int_text " << run(values128, buffer, [](char* out, int_text::int128 v) {
+                         return int_text::toDecimal(out, v); }) << " s\n";
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
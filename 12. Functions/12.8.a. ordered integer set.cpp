@@ -0,0 +1,908 @@
+#include <iostream>
+#include <vector>
+#include <span>
+#include <optional>
+#include <concepts>         // std::integral
+#include <type_traits>      // std::make_unsigned_t
+#include <algorithm>        // std::min, std::copy, std::copy_backward
+#include <utility>          // std::pair
+#include <cstddef>          // std::size_t
+#include <cassert>
+
+
+// quiz_1 in 12.8 keeps the numbers of the game in an unsorted std::vector. a right guess is
+// found with std::ranges::find and removed with erase, both O(n), and a wrong guess scans all
+// the numbers with std::ranges::min_element to find the nearest one, O(n) again. with a dozen
+// numbers that's nothing; with millions of live values, every guess walks megabytes.
+
+// what the game really needs is an ordered set of integers that can answer "the nearest value
+// to x": that's the larger of the values <= x (the predecessor) or the smaller of the
+// values >= x (the successor), whichever is closer. IntegerSet is a B+tree of ints:
+    // - leaves hold up to 64 sorted values (256 bytes for ints), inner nodes up to 32 keys,
+    //   so a million values are 3 or 4 levels deep, and each level is a few cache lines
+    // - the leaves are linked both ways, so the successor or predecessor of a position is
+    //   at most one step to a neighbouring leaf
+    // - unlike the B+tree map in 14.9.c (which leaves empty leaves behind on erase), erase
+    //   here keeps the tree balanced: a node that drops below half full borrows a value from
+    //   a sibling, or is merged with it. every operation stays O(log n)
+    // - build() makes a tree from a sorted range in O(n), with the values spread evenly
+// a van Emde Boas tree would be O(log log U), but it needs memory for the whole universe of
+// values (or hashing, to make it sparse); squares up to 2^31 are very sparse.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                       ============[ IntegerSet ]============
+---------------------------------------------------------------------------------------*/
+
+namespace int_set
+{
+    template <std::integral T>
+    class IntegerSet
+    {
+    private:
+        static constexpr std::size_t s_leafCapacity{ 64 };
+        static constexpr std::size_t s_leafMinimum{ s_leafCapacity / 2 };
+        static constexpr std::size_t s_innerCapacity{ 32 };                    // keys; children are one more
+        static constexpr std::size_t s_innerMinimum{ s_innerCapacity / 2 - 1 };
+
+        struct Node
+        {
+            bool isLeaf{};
+            std::size_t count{ 0 };
+        };
+
+        struct Leaf : Node
+        {
+            T values[s_leafCapacity]{};
+            Leaf* prev{ nullptr };
+            Leaf* next{ nullptr };
+
+            Leaf() { this->isLeaf = true; }
+        };
+
+        // children[i] holds the values in [keys[i - 1], keys[i])
+        struct Inner : Node
+        {
+            T keys[s_innerCapacity]{};
+            Node* children[s_innerCapacity + 1]{};
+
+            Inner() { this->isLeaf = false; }
+        };
+
+        Node* m_root{ nullptr };
+        Leaf* m_first{ nullptr };
+        Leaf* m_last{ nullptr };
+        std::size_t m_size{ 0 };
+
+        // the number of values[0, count) that are < x (or <= x), without branching on them
+        template <bool OrEqual>
+        static std::size_t countLess(const T* values, std::size_t count, T x)
+        {
+            std::size_t result{ 0 };
+            for (std::size_t i{ 0 }; i < count; ++i)
+                result += OrEqual ? values[i] <= x : values[i] < x;
+            return result;
+        }
+
+        static void destroy(Node* node)
+        {
+            if (!node)
+                return;
+            if (node->isLeaf)
+                delete static_cast<Leaf*>(node);
+            else
+            {
+                auto inner{ static_cast<Inner*>(node) };
+                for (std::size_t i{ 0 }; i <= inner->count; ++i)
+                    destroy(inner->children[i]);
+                delete inner;
+            }
+        }
+
+        // the first value >= x, as (leaf, position). the position is leaf->count if x is past the
+        // end of the leaf x belongs to; the successor is then the first value of the next leaf
+        std::pair<Leaf*, std::size_t> lowerBound(T x) const
+        {
+            Node* node{ m_root };
+            while (!node->isLeaf)
+            {
+                auto inner{ static_cast<Inner*>(node) };
+                node = inner->children[countLess<true>(inner->keys, inner->count, x)];
+            }
+            auto leaf{ static_cast<Leaf*>(node) };
+            return { leaf, countLess<false>(leaf->values, leaf->count, x) };
+        }
+
+        void linkAfter(Leaf* leaf, Leaf* right)
+        {
+            right->prev = leaf;
+            right->next = leaf->next;
+            if (leaf->next)
+                leaf->next->prev = right;
+            else
+                m_last = right;
+            leaf->next = right;
+        }
+
+        void unlink(Leaf* leaf)
+        {
+            (leaf->prev ? leaf->prev->next : m_first) = leaf->next;
+            (leaf->next ? leaf->next->prev : m_last) = leaf->prev;
+        }
+
+        struct Split
+        {
+            T separator{};
+            Node* right{ nullptr };
+        };
+
+        // inserts x below node; fills in split if node had to be split in two
+        bool insertInto(Node* node, T x, Split& split)
+        {
+            if (node->isLeaf)
+            {
+                auto leaf{ static_cast<Leaf*>(node) };
+                std::size_t position{ countLess<false>(leaf->values, leaf->count, x) };
+                if (position < leaf->count && leaf->values[position] == x)
+                    return false;
+
+                if (leaf->count == s_leafCapacity)
+                {
+                    auto right{ new Leaf{} };
+                    std::size_t half{ s_leafCapacity / 2 };
+                    std::copy(leaf->values + half, leaf->values + s_leafCapacity, right->values);
+                    right->count = s_leafCapacity - half;
+                    leaf->count = half;
+                    linkAfter(leaf, right);
+                    split = { right->values[0], right };
+
+                    if (position > half)
+                    {
+                        leaf = right;
+                        position -= half;
+                    }
+                }
+
+                std::copy_backward(leaf->values + position, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+                leaf->values[position] = x;
+                ++leaf->count;
+                return true;
+            }
+
+            auto inner{ static_cast<Inner*>(node) };
+            std::size_t index{ countLess<true>(inner->keys, inner->count, x) };
+            Split childSplit{};
+            if (!insertInto(inner->children[index], x, childSplit))
+                return false;
+            if (!childSplit.right)
+                return true;
+
+            if (inner->count == s_innerCapacity)
+            {
+                // the middle key moves up, it isn't copied
+                auto right{ new Inner{} };
+                std::size_t half{ s_innerCapacity / 2 };
+                std::copy(inner->keys + half + 1, inner->keys + s_innerCapacity, right->keys);
+                std::copy(inner->children + half + 1, inner->children + s_innerCapacity + 1, right->children);
+                right->count = s_innerCapacity - half - 1;
+                split = { inner->keys[half], right };
+                inner->count = half;
+
+                if (index > half)
+                {
+                    inner = right;
+                    index -= half + 1;
+                }
+            }
+
+            std::copy_backward(inner->keys + index, inner->keys + inner->count, inner->keys + inner->count + 1);
+            std::copy_backward(inner->children + index + 1, inner->children + inner->count + 1, inner->children + inner->count + 2);
+            inner->keys[index] = childSplit.separator;
+            inner->children[index + 1] = childSplit.right;
+            ++inner->count;
+            return true;
+        }
+
+        // parent->children[index] has too few values or keys: borrow one from a sibling that can
+        // spare one, or else merge it with a sibling
+        void rebalance(Inner* parent, std::size_t index)
+        {
+            Node* child{ parent->children[index] };
+            Node* leftSibling{ index > 0 ? parent->children[index - 1] : nullptr };
+            Node* rightSibling{ index < parent->count ? parent->children[index + 1] : nullptr };
+            std::size_t minimum{ child->isLeaf ? s_leafMinimum : s_innerMinimum };
+
+            if (leftSibling && leftSibling->count > minimum)
+                borrowFromLeft(parent, index);
+            else if (rightSibling && rightSibling->count > minimum)
+                borrowFromRight(parent, index);
+            else if (leftSibling)
+                merge(parent, index - 1);
+            else
+                merge(parent, index);
+        }
+
+        void borrowFromLeft(Inner* parent, std::size_t index)
+        {
+            Node* child{ parent->children[index] };
+            Node* sibling{ parent->children[index - 1] };
+
+            if (child->isLeaf)
+            {
+                auto leaf{ static_cast<Leaf*>(child) };
+                auto left{ static_cast<Leaf*>(sibling) };
+                std::copy_backward(leaf->values, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+                leaf->values[0] = left->values[--left->count];
+                ++leaf->count;
+                parent->keys[index - 1] = leaf->values[0];
+            }
+            else
+            {
+                auto inner{ static_cast<Inner*>(child) };
+                auto left{ static_cast<Inner*>(sibling) };
+                std::copy_backward(inner->keys, inner->keys + inner->count, inner->keys + inner->count + 1);
+                std::copy_backward(inner->children, inner->children + inner->count + 1, inner->children + inner->count + 2);
+                inner->keys[0] = parent->keys[index - 1];
+                inner->children[0] = left->children[left->count];
+                ++inner->count;
+                parent->keys[index - 1] = left->keys[--left->count];
+            }
+        }
+
+        void borrowFromRight(Inner* parent, std::size_t index)
+        {
+            Node* child{ parent->children[index] };
+            Node* sibling{ parent->children[index + 1] };
+
+            if (child->isLeaf)
+            {
+                auto leaf{ static_cast<Leaf*>(child) };
+                auto right{ static_cast<Leaf*>(sibling) };
+                leaf->values[leaf->count++] = right->values[0];
+                std::copy(right->values + 1, right->values + right->count, right->values);
+                --right->count;
+                parent->keys[index] = right->values[0];
+            }
+            else
+            {
+                auto inner{ static_cast<Inner*>(child) };
+                auto right{ static_cast<Inner*>(sibling) };
+                inner->keys[inner->count] = parent->keys[index];
+                inner->children[inner->count + 1] = right->children[0];
+                ++inner->count;
+                parent->keys[index] = right->keys[0];
+                std::copy(right->keys + 1, right->keys + right->count, right->keys);
+                std::copy(right->children + 1, right->children + right->count + 1, right->children);
+                --right->count;
+            }
+        }
+
+        // moves children[index + 1] into children[index], and removes it from the parent
+        void merge(Inner* parent, std::size_t index)
+        {
+            Node* left{ parent->children[index] };
+            Node* right{ parent->children[index + 1] };
+
+            if (left->isLeaf)
+            {
+                auto leftLeaf{ static_cast<Leaf*>(left) };
+                auto rightLeaf{ static_cast<Leaf*>(right) };
+                std::copy(rightLeaf->values, rightLeaf->values + rightLeaf->count, leftLeaf->values + leftLeaf->count);
+                leftLeaf->count += rightLeaf->count;
+                unlink(rightLeaf);
+                delete rightLeaf;
+            }
+            else
+            {
+                auto leftInner{ static_cast<Inner*>(left) };
+                auto rightInner{ static_cast<Inner*>(right) };
+                leftInner->keys[leftInner->count] = parent->keys[index];
+                std::copy(rightInner->keys, rightInner->keys + rightInner->count, leftInner->keys + leftInner->count + 1);
+                std::copy(rightInner->children, rightInner->children + rightInner->count + 1, leftInner->children + leftInner->count + 1);
+                leftInner->count += rightInner->count + 1;
+                delete rightInner;
+            }
+
+            std::copy(parent->keys + index + 1, parent->keys + parent->count, parent->keys + index);
+            std::copy(parent->children + index + 2, parent->children + parent->count + 1, parent->children + index + 1);
+            --parent->count;
+        }
+
+        bool eraseFrom(Node* node, T x)
+        {
+            if (node->isLeaf)
+            {
+                auto leaf{ static_cast<Leaf*>(node) };
+                std::size_t position{ countLess<false>(leaf->values, leaf->count, x) };
+                if (position == leaf->count || leaf->values[position] != x)
+                    return false;
+                std::copy(leaf->values + position + 1, leaf->values + leaf->count, leaf->values + position);
+                --leaf->count;
+                return true;
+            }
+
+            auto inner{ static_cast<Inner*>(node) };
+            std::size_t index{ countLess<true>(inner->keys, inner->count, x) };
+            Node* child{ inner->children[index] };
+            if (!eraseFrom(child, x))
+                return false;
+
+            if (child->count < (child->isLeaf ? s_leafMinimum : s_innerMinimum))
+                rebalance(inner, index);
+            return true;
+        }
+
+        // builds one level of inner nodes over nodes, with the children spread evenly
+        static std::vector<Node*> buildLevel(const std::vector<Node*>& nodes, const std::vector<T>& lowest, std::vector<T>& parentLowest)
+        {
+            std::size_t maxChildren{ s_innerCapacity + 1 };
+            std::size_t parents{ (nodes.size() + maxChildren - 1) / maxChildren };
+            std::vector<Node*> level;
+            parentLowest.clear();
+
+            std::size_t next{ 0 };
+            for (std::size_t p{ 0 }; p < parents; ++p)
+            {
+                std::size_t children{ nodes.size() / parents + (p < nodes.size() % parents) };
+                auto inner{ new Inner{} };
+                for (std::size_t c{ 0 }; c < children; ++c)
+                {
+                    inner->children[c] = nodes[next + c];
+                    if (c > 0)
+                        inner->keys[c - 1] = lowest[next + c];
+                }
+                inner->count = children - 1;
+                parentLowest.push_back(lowest[next]);
+                level.push_back(inner);
+                next += children;
+            }
+            return level;
+        }
+
+    public:
+        IntegerSet()
+        {
+            clear();
+        }
+
+        IntegerSet(const IntegerSet&) = delete;
+        IntegerSet& operator=(const IntegerSet&) = delete;
+
+        ~IntegerSet()
+        {
+            destroy(m_root);
+        }
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        void clear()
+        {
+            destroy(m_root);
+            auto leaf{ new Leaf{} };
+            m_root = leaf;
+            m_first = leaf;
+            m_last = leaf;
+            m_size = 0;
+        }
+
+        bool contains(T x) const
+        {
+            auto [leaf, position]{ lowerBound(x) };
+            return position < leaf->count && leaf->values[position] == x;
+        }
+
+        bool insert(T x)
+        {
+            Split split{};
+            if (!insertInto(m_root, x, split))
+                return false;
+
+            if (split.right)
+            {
+                auto root{ new Inner{} };
+                root->keys[0] = split.separator;
+                root->children[0] = m_root;
+                root->children[1] = split.right;
+                root->count = 1;
+                m_root = root;
+            }
+            ++m_size;
+            return true;
+        }
+
+        bool erase(T x)
+        {
+            if (!eraseFrom(m_root, x))
+                return false;
+
+            // a root with a single child isn't needed anymore
+            if (!m_root->isLeaf && m_root->count == 0)
+            {
+                auto root{ static_cast<Inner*>(m_root) };
+                m_root = root->children[0];
+                delete root;
+            }
+            --m_size;
+            return true;
+        }
+
+        // the smallest value >= x
+        std::optional<T> successor(T x) const
+        {
+            auto [leaf, position]{ lowerBound(x) };
+            if (position < leaf->count)
+                return leaf->values[position];
+            if (leaf->next)
+                return leaf->next->values[0];
+            return std::nullopt;
+        }
+
+        // the largest value <= x
+        std::optional<T> predecessor(T x) const
+        {
+            auto [leaf, position]{ lowerBound(x) };
+            if (position < leaf->count && leaf->values[position] == x)
+                return x;
+            if (position > 0)
+                return leaf->values[position - 1];
+            if (leaf->prev)
+                return leaf->prev->values[leaf->prev->count - 1];
+            return std::nullopt;
+        }
+
+        // the value closest to x (the smaller one on a tie). both neighbours are found with one
+        // descent: they're next to the lower bound, in the same leaf or in the one next to it
+        std::optional<T> nearest(T x) const
+        {
+            auto [leaf, position]{ lowerBound(x) };
+
+            std::optional<T> above{};
+            if (position < leaf->count)
+                above = leaf->values[position];
+            else if (leaf->next)
+                above = leaf->next->values[0];
+
+            std::optional<T> below{};
+            if (position > 0)
+                below = leaf->values[position - 1];
+            else if (leaf->prev)
+                below = leaf->prev->values[leaf->prev->count - 1];
+
+            if (!below)
+                return above;
+            if (!above)
+                return below;
+            // compare the distances without overflowing: x - below and above - x are both >= 0
+            using Unsigned = std::make_unsigned_t<T>;
+            auto distanceBelow{ static_cast<Unsigned>(static_cast<Unsigned>(x) - static_cast<Unsigned>(*below)) };
+            auto distanceAbove{ static_cast<Unsigned>(static_cast<Unsigned>(*above) - static_cast<Unsigned>(x)) };
+            return distanceAbove < distanceBelow ? above : below;
+        }
+
+        // replaces the contents with sorted, which must be sorted and without duplicates. O(n),
+        // and every node ends up between half and completely full
+        void build(std::span<const T> sorted)
+        {
+            assert(std::adjacent_find(sorted.begin(), sorted.end(), [](T a, T b) { return !(a < b); }) == sorted.end()
+                   && "build needs sorted values without duplicates");
+
+            clear();
+            if (sorted.empty())
+                return;
+            delete static_cast<Leaf*>(m_root);
+            m_root = nullptr;
+
+            // the leaves: the values spread evenly, so that no leaf is less than half full
+            std::size_t leaves{ (sorted.size() + s_leafCapacity - 1) / s_leafCapacity };
+            std::vector<Node*> level;
+            std::vector<T> lowest;
+            Leaf* previous{ nullptr };
+            std::size_t next{ 0 };
+            for (std::size_t l{ 0 }; l < leaves; ++l)
+            {
+                std::size_t count{ sorted.size() / leaves + (l < sorted.size() % leaves) };
+                auto leaf{ new Leaf{} };
+                std::copy(sorted.begin() + static_cast<std::ptrdiff_t>(next), sorted.begin() + static_cast<std::ptrdiff_t>(next + count), leaf->values);
+                leaf->count = count;
+                leaf->prev = previous;
+                if (previous)
+                    previous->next = leaf;
+                else
+                    m_first = leaf;
+                previous = leaf;
+
+                level.push_back(leaf);
+                lowest.push_back(leaf->values[0]);
+                next += count;
+            }
+            m_last = previous;
+
+            std::vector<T> parentLowest;
+            while (level.size() > 1)
+            {
+                level = buildLevel(level, lowest, parentLowest);
+                lowest.swap(parentLowest);
+            }
+            m_root = level[0];
+            m_size = sorted.size();
+        }
+
+        // calls fn(value) for every value, in order
+        template <typename Fn>
+        void forEach(Fn&& fn) const
+        {
+            for (const Leaf* leaf{ m_first }; leaf; leaf = leaf->next)
+            {
+                for (std::size_t i{ 0 }; i < leaf->count; ++i)
+                    fn(leaf->values[i]);
+            }
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                 ============[ the quiz, with an IntegerSet ]============
+---------------------------------------------------------------------------------------*/
+
+// quiz_1 from 12.8, with scripted guesses instead of std::cin
+
+#include <random>
+#include <ctime>
+#include <cstdlib>          // std::abs
+
+namespace quiz_1
+{
+    constexpr int g_maxNearestDelta{ 4 };
+
+    int getRandomInt(int min, int max)
+    {
+        static std::mt19937 mt{ static_cast<std::mt19937::result_type>(std::time(nullptr)) };
+        return std::uniform_int_distribution{ min, max }(mt);
+    }
+
+    void main()
+    {
+        int start{ 6 };
+        int howMany{ 5 };
+        int multiplier{ getRandomInt(2, 4) };
+
+        // the squares are sorted already: build the set in one go
+        std::vector<int> generated;
+        for (int i{ 0 }; i < howMany; ++i)
+            generated.push_back(multiplier * (start + i) * (start + i));
+        int_set::IntegerSet<int> numbers;
+        numbers.build(generated);
+
+        std::cout << "I generated " << howMany << " square numbers.\n"
+                  << "Do you know what each number is after multiplying it by " << multiplier << "?\n";
+
+        std::vector<int> guesses{ generated[2], generated[0], generated[4], generated[3] + 2 };
+        for (int guess : guesses)
+        {
+            std::cout << "> " << guess << '\n';
+
+            if (numbers.erase(guess))
+            {
+                if (!numbers.empty())
+                    std::cout << "Nice! " << numbers.size() << " number(s) left.\n";
+                else
+                {
+                    std::cout << "Nice! you found all numbers, good job!\n";
+                    break;
+                }
+            }
+            else
+            {
+                std::cout << guess << " is wrong!";
+
+                auto nearest{ numbers.nearest(guess) };
+                if (nearest && std::abs(guess - *nearest) <= g_maxNearestDelta)
+                    std::cout << " Try " << *nearest << " next time.";
+                std::cout << '\n';
+
+                break;
+            }
+        }
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <set>
+#include <iterator>         // std::prev
+#include <limits>
+#include <cstdint>
+
+namespace checks
+{
+    template <typename T>
+    int compare(const int_set::IntegerSet<T>& set, const std::set<T>& expected, T x)
+    {
+        int failures{ 0 };
+        failures += set.contains(x) != (expected.count(x) == 1);
+
+        auto above{ expected.lower_bound(x) };
+        std::optional<T> successor{ above == expected.end() ? std::nullopt : std::optional<T>{ *above } };
+        failures += set.successor(x) != successor;
+
+        auto upper{ expected.upper_bound(x) };
+        std::optional<T> predecessor{ upper == expected.begin() ? std::nullopt : std::optional<T>{ *std::prev(upper) } };
+        failures += set.predecessor(x) != predecessor;
+
+        std::optional<T> nearest{ successor };
+        if (predecessor && (!successor || static_cast<long double>(*successor) - x >= static_cast<long double>(x) - *predecessor))
+            nearest = predecessor;
+        failures += set.nearest(x) != nearest;
+        return failures;
+    }
+
+    template <typename T>
+    int run(std::mt19937_64& mt, T low, T high, int operations)
+    {
+        int failures{ 0 };
+        int_set::IntegerSet<T> set;
+        std::set<T> expected;
+        std::uniform_int_distribution<T> random{ low, high };
+
+        for (int i{ 0 }; i < operations; ++i)
+        {
+            T x{ random(mt) };
+            switch (mt() % 4)
+            {
+            case 0:
+            case 1:
+                failures += set.insert(x) != expected.insert(x).second;
+                break;
+            case 2:
+                failures += set.erase(x) != (expected.erase(x) == 1);
+                break;
+            case 3:
+                failures += compare(set, expected, x);
+                break;
+            }
+            failures += set.size() != expected.size();
+
+            // now and then: erase most of it, to exercise merges all the way up to the root
+            if (i % 20'000 == 19'999)
+            {
+                std::vector<T> values(expected.begin(), expected.end());
+                for (std::size_t k{ 0 }; k < values.size(); ++k)
+                {
+                    if (k % 10 != 0)
+                    {
+                        failures += !set.erase(values[k]);
+                        expected.erase(values[k]);
+                    }
+                }
+            }
+        }
+
+        // in order, all of them
+        std::vector<T> all;
+        set.forEach([&](T x) { all.push_back(x); });
+        failures += !std::equal(all.begin(), all.end(), expected.begin(), expected.end());
+
+        // and a built set answers the same, and keeps working after inserts and erases
+        set.build(all);
+        for (int i{ 0 }; i < 2'000; ++i)
+        {
+            T x{ random(mt) };
+            failures += compare(set, expected, x);
+            if (i % 2 == 0)
+                failures += set.erase(x) != (expected.erase(x) == 1);
+            else
+                failures += set.insert(x) != expected.insert(x).second;
+        }
+        return failures;
+    }
+
+    void main()
+    {
+        std::mt19937_64 mt{ 47 };
+        int failures{ 0 };
+
+        failures += run<int>(mt, 0, 5'000, 100'000);                // dense: lots of hits
+        failures += run<int>(mt, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), 100'000);
+        failures += run<std::int64_t>(mt, -1'000'000'000'000, 1'000'000'000'000, 50'000);
+        failures += run<unsigned>(mt, 0, 200, 10'000);               // tiny: the root stays a leaf
+
+        int_set::IntegerSet<int> empty;
+        failures += empty.nearest(3).has_value() || empty.successor(3).has_value() || empty.erase(3);
+        empty.build(std::span<const int>{});
+        failures += !empty.empty();
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// the game's pattern on n live values: guesses that are right half of the time (find and
+// erase) and wrong the other half (nearest value), with a new value inserted for every one
+// erased so that n stays the same. quiz_1's unsorted vector, a sorted vector (binary
+// search, but erase and insert still move half the values), std::set, and IntegerSet.
+
+#include <chrono>
+#include <iomanip>          // std::setw
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    struct Guess
+    {
+        int value{};
+        int replacement{};      // inserted when value was right
+    };
+
+    // ns per guess
+    template <typename Play>
+    double timePerGuess(const std::vector<Guess>& guesses, std::size_t count, long long& checksum, Play play)
+    {
+        Timer t;
+        for (std::size_t i{ 0 }; i < count; ++i)
+            checksum += play(guesses[i]);
+        return t.elapsed() / static_cast<double>(count) * 1e9;
+    }
+
+    void row(std::size_t live, std::mt19937& mt)
+    {
+        // squares of distinct numbers, times 3
+        std::vector<int> values;
+        for (std::size_t i{ 0 }; i < 2 * live; ++i)
+            values.push_back(static_cast<int>(3 * static_cast<long long>(i) * static_cast<long long>(i) % 2'000'000'000));
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        std::shuffle(values.begin(), values.end(), mt);
+
+        std::vector<int> initial(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(live));
+        std::vector<int> spare(values.begin() + static_cast<std::ptrdiff_t>(live), values.end());
+
+        // the right guesses are a sample of the live values, each replaced by a spare one
+        constexpr std::size_t guessCount{ 200'000 };
+        std::vector<Guess> guesses;
+        {
+            std::vector<int> current(initial);
+            std::size_t nextSpare{ 0 };
+            for (std::size_t i{ 0 }; i < guessCount; ++i)
+            {
+                if (i % 2 == 0 && nextSpare < spare.size())
+                {
+                    std::size_t k{ mt() % current.size() };
+                    guesses.push_back({ current[k], spare[nextSpare] });
+                    current[k] = spare[nextSpare++];
+                }
+                else
+                    guesses.push_back({ static_cast<int>(mt() % 2'000'000'000), 0 });
+            }
+        }
+
+        long long checksum{ 0 };
+        auto nearestOf{ [](auto&& found) { return found ? *found : 0; } };
+
+        // the O(n) ones get fewer guesses
+        std::size_t slowCount{ std::min<std::size_t>(guessCount, 20'000'000 / live) };
+
+        std::vector<int> unsorted(initial);
+        double vectorTime{ timePerGuess(guesses, slowCount, checksum, [&](const Guess& guess) {
+            auto found{ std::ranges::find(unsorted, guess.value) };
+            if (found != unsorted.end())
+            {
+                unsorted.erase(found);
+                unsorted.push_back(guess.replacement);
+                return 1;
+            }
+            return *std::ranges::min_element(unsorted, [&](int a, int b) {
+                return std::abs(static_cast<long long>(a) - guess.value) < std::abs(static_cast<long long>(b) - guess.value);
+            });
+        }) };
+
+        std::vector<int> sorted(initial);
+        std::sort(sorted.begin(), sorted.end());
+        double sortedTime{ timePerGuess(guesses, slowCount, checksum, [&](const Guess& guess) {
+            auto found{ std::ranges::lower_bound(sorted, guess.value) };
+            if (found != sorted.end() && *found == guess.value)
+            {
+                sorted.erase(found);
+                sorted.insert(std::ranges::lower_bound(sorted, guess.replacement), guess.replacement);
+                return 1;
+            }
+            if (found == sorted.end())
+                return sorted.back();
+            if (found == sorted.begin())
+                return *found;
+            return static_cast<long long>(*found) - guess.value < static_cast<long long>(guess.value) - *std::prev(found) ? *found : *std::prev(found);
+        }) };
+
+        std::set<int> tree(initial.begin(), initial.end());
+        double setTime{ timePerGuess(guesses, guessCount, checksum, [&](const Guess& guess) {
+            if (tree.erase(guess.value))
+            {
+                tree.insert(guess.replacement);
+                return 1;
+            }
+            auto above{ tree.lower_bound(guess.value) };
+            if (above == tree.end())
+                return *std::prev(above);
+            if (above == tree.begin())
+                return *above;
+            return static_cast<long long>(*above) - guess.value < static_cast<long long>(guess.value) - *std::prev(above) ? *above : *std::prev(above);
+        }) };
+
+        std::sort(initial.begin(), initial.end());
+        int_set::IntegerSet<int> set;
+        Timer t;
+        set.build(initial);
+        double buildTime{ t.elapsed() / static_cast<double>(live) * 1e9 };
+        double integerSetTime{ timePerGuess(guesses, guessCount, checksum, [&](const Guess& guess) {
+            if (set.erase(guess.value))
+            {
+                set.insert(guess.replacement);
+                return 1;
+            }
+            return nearestOf(set.nearest(guess.value));
+        }) };
+
+        std::cout << std::setw(10) << live << std::setw(12) << vectorTime << std::setw(12) << sortedTime
+                  << std::setw(12) << setTime << std::setw(12) << integerSetTime << std::setw(12) << buildTime
+                  << (checksum == 0 ? " (?)" : "") << '\n';
+    }
+
+    void main()
+    {
+        std::mt19937 mt{ 5 };
+        std::cout << std::fixed << std::setprecision(1) << "ns per guess (build: ns per value)\n"
+                  << std::setw(10) << "live" << std::setw(12) << "vector" << std::setw(12) << "sorted vec"
+                  << std::setw(12) << "std::set" << std::setw(12) << "IntegerSet" << std::setw(12) << "build" << '\n';
+        for (std::size_t live : { 1'000u, 10'000u, 100'000u, 1'000'000u, 4'000'000u })
+            row(live, mt);
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    quiz_1::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
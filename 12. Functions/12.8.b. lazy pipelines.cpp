@@ -0,0 +1,930 @@
+#include <iostream>
+#include <vector>
+#include <ranges>
+#include <iterator>         // std::default_sentinel_t
+#include <functional>       // std::invoke, std::plus
+#include <coroutine>
+#include <exception>        // std::exception_ptr
+#include <optional>
+#include <type_traits>
+#include <concepts>
+#include <utility>          // std::pair, std::forward, std::as_const
+#include <memory>           // std::addressof
+#include <cstddef>          // std::size_t
+
+
+// quiz_1 in 12.8 fills a std::vector with std::for_each and a lambda that changes a captured
+// variable, and then works on the vector. that's fine for a quiz, but a chain of steps like
+// "generate, transform, keep some, take the first n" written that way makes a temporary
+// vector for every step, and reads and writes all of them.
+
+// this is a small library of LAZY pipelines:
+//     lazy::iota(1) | lazy::map(square) | lazy::filter(isEven) | lazy::take(10) | lazy::toVector()
+// nothing runs until the last step (a TERMINAL: toVector, to<Container>, reduce, sum, count,
+// forEach, first). then the whole chain runs as ONE loop, with no containers in between.
+
+// how: every stage is PUSH based. a stage has push(sink), which calls sink(x) for every element,
+// until the sink returns false ("that's enough"). map(f).push(sink) is
+//     source.push([&](auto&& x) { return sink(f(x)); })
+// so every stage adds a lambda around the next one, and after inlining, the compiler sees a
+// single loop with the generator at the top and the terminal at the bottom; the same code as a
+// hand-written loop (see the benchmark). std::views are PULL based: every iterator asks the one
+// before it for the next element, and filter and take need extra checks for that.
+// pulling is still needed for two things:
+    // - zip(range): the pipeline on the left pushes, and every element is paired with the next
+    //   element PULLED from the range on the right
+    // - Generator<T>: a C++20 coroutine that co_yields its elements. it's a range (begin/end),
+    //   so it can be the start of a pipeline, or the right side of a zip. every element costs a
+    //   resume of the coroutine, so in hot loops, iota and generate are faster
+// a range (std::vector, std::array, std::views::iota, Generator...) on the left of | becomes the
+// start of a pipeline. lvalues are used in place; rvalues are moved into the pipeline.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                    ============[ Generator: coroutines ]============
+---------------------------------------------------------------------------------------*/
+
+namespace lazy
+{
+    template <typename T>
+    class Generator
+    {
+    public:
+        struct promise_type
+        {
+            // the yielded object lives in the coroutine until it's resumed again
+            const T* value{ nullptr };
+            std::exception_ptr exception{};
+
+            Generator get_return_object() { return Generator{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() { exception = std::current_exception(); }
+
+            std::suspend_always yield_value(const T& x) noexcept
+            {
+                value = std::addressof(x);
+                return {};
+            }
+        };
+
+        class Iterator
+        {
+        private:
+            std::coroutine_handle<promise_type> m_handle{};
+
+        public:
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+            explicit Iterator(std::coroutine_handle<promise_type> handle)
+                : m_handle{ handle }
+            {
+            }
+
+            const T& operator*() const { return *m_handle.promise().value; }
+
+            Iterator& operator++()
+            {
+                resume(m_handle);
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+
+            bool operator==(std::default_sentinel_t) const { return !m_handle || m_handle.done(); }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> m_handle{};
+
+        explicit Generator(std::coroutine_handle<promise_type> handle)
+            : m_handle{ handle }
+        {
+        }
+
+        // an exception thrown inside the coroutine comes out here, in the loop that reads it
+        static void resume(std::coroutine_handle<promise_type> handle)
+        {
+            handle.resume();
+            if (handle.promise().exception)
+                std::rethrow_exception(handle.promise().exception);
+        }
+
+    public:
+        Generator(Generator&& other) noexcept
+            : m_handle{ std::exchange(other.m_handle, {}) }
+        {
+        }
+
+        Generator& operator=(Generator&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (m_handle)
+                    m_handle.destroy();
+                m_handle = std::exchange(other.m_handle, {});
+            }
+            return *this;
+        }
+
+        ~Generator()
+        {
+            if (m_handle)
+                m_handle.destroy();
+        }
+
+        // can only be iterated once
+        Iterator begin()
+        {
+            resume(m_handle);
+            return Iterator{ m_handle };
+        }
+
+        std::default_sentinel_t end() { return {}; }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                          ============[ stages ]============
+---------------------------------------------------------------------------------------*/
+
+// every stage has a value_type (what it pushes) and push(sink). sinks take one element and return
+// whether they want more.
+
+namespace lazy
+{
+    namespace detail
+    {
+        struct PipelineTag {};
+        struct AdaptorTag {};
+    }
+
+    template <typename P>
+    concept Pipeline = std::derived_from<P, detail::PipelineTag>;
+
+    // a range as a source. [Range] is a reference type for lvalues, so they aren't copied
+    template <typename Range>
+    class From : public detail::PipelineTag
+    {
+    private:
+        Range m_range;
+
+    public:
+        using value_type = std::ranges::range_value_t<std::remove_cvref_t<Range>>;
+
+        explicit From(Range&& range)
+            : m_range{ std::forward<Range>(range) }
+        {
+        }
+
+        template <typename Sink>
+        void push(Sink&& sink)
+        {
+            for (auto&& x : m_range)
+            {
+                if (!sink(x))
+                    return;
+            }
+        }
+    };
+
+    template <std::ranges::input_range Range>
+    From<Range> from(Range&& range)
+    {
+        return From<Range>{ std::forward<Range>(range) };
+    }
+
+    // start, start + 1, ... forever, or up to (not including) end
+    template <typename T, bool Bounded>
+    class Iota : public detail::PipelineTag
+    {
+    private:
+        T m_start;
+        T m_end;
+
+    public:
+        using value_type = T;
+
+        Iota(T start, T end)
+            : m_start{ start }
+            , m_end{ end }
+        {
+        }
+
+        template <typename Sink>
+        void push(Sink&& sink)
+        {
+            for (T i{ m_start }; !Bounded || i < m_end; ++i)
+            {
+                if (!sink(i))
+                    return;
+            }
+        }
+    };
+
+    template <typename T>
+    Iota<T, false> iota(T start) { return { start, start }; }
+
+    template <typename T>
+    Iota<T, true> iota(T start, T end) { return { start, end }; }
+
+    // fn(), fn(), fn()... forever; fn may change what it captured, like quiz_1's lambda
+    template <typename Fn>
+    class Generate : public detail::PipelineTag
+    {
+    private:
+        Fn m_fn;
+
+    public:
+        using value_type = std::remove_cvref_t<std::invoke_result_t<Fn&>>;
+
+        explicit Generate(Fn fn)
+            : m_fn{ std::move(fn) }
+        {
+        }
+
+        template <typename Sink>
+        void push(Sink&& sink)
+        {
+            while (sink(std::invoke(m_fn)))
+                ;
+        }
+    };
+
+    template <typename Fn>
+    Generate<Fn> generate(Fn fn) { return Generate<Fn>{ std::move(fn) }; }
+
+    template <Pipeline P, typename Fn>
+    class Map : public detail::PipelineTag
+    {
+    private:
+        P m_source;
+        Fn m_fn;
+
+    public:
+        using value_type = std::remove_cvref_t<std::invoke_result_t<Fn&, const typename P::value_type&>>;
+
+        Map(P source, Fn fn)
+            : m_source{ std::move(source) }
+            , m_fn{ std::move(fn) }
+        {
+        }
+
+        template <typename Sink>
+        void push(Sink&& sink)
+        {
+            m_source.push([&](auto&& x) { return sink(std::invoke(m_fn, std::forward<decltype(x)>(x))); });
+        }
+    };
+
+    template <Pipeline P, typename Predicate>
+    class Filter : public detail::PipelineTag
+    {
+    private:
+        P m_source;
+        Predicate m_predicate;
+
+    public:
+        using value_type = typename P::value_type;
+
+        Filter(P source, Predicate predicate)
+            : m_source{ std::move(source) }
+            , m_predicate{ std::move(predicate) }
+        {
+        }
+
+        template <typename Sink>
+        void push(Sink&& sink)
+        {
+            m_source.push([&](auto&& x) {
+                if (!std::invoke(m_predicate, std::as_const(x)))
+                    return true;
+                return static_cast<bool>(sink(std::forward<decltype(x)>(x)));
+            });
+        }
+    };
+
+    template <Pipeline P>
+    class Take : public detail::PipelineTag
+    {
+    private:
+        P m_source;
+        std::size_t m_count;
+
+    public:
+        using value_type = typename P::value_type;
+
+        Take(P source, std::size_t count)
+            : m_source{ std::move(source) }
+            , m_count{ count }
+        {
+        }
+
+        // stops the source right after the last one, so an infinite source is fine
+        template <typename Sink>
+        void push(Sink&& sink)
+        {
+            if (m_count == 0)
+                return;
+            std::size_t left{ m_count };
+            m_source.push([&](auto&& x) { return sink(std::forward<decltype(x)>(x)) && --left != 0; });
+        }
+    };
+
+    // pairs of (element, element of [Range]), as long as both have elements
+    template <Pipeline P, typename Range>
+    class Zip : public detail::PipelineTag
+    {
+    private:
+        P m_source;
+        Range m_range;
+
+    public:
+        using value_type = std::pair<typename P::value_type, std::ranges::range_value_t<std::remove_cvref_t<Range>>>;
+
+        Zip(P source, Range&& range)
+            : m_source{ std::move(source) }
+            , m_range{ std::forward<Range>(range) }
+        {
+        }
+
+        template <typename Sink>
+        void push(Sink&& sink)
+        {
+            auto it{ std::ranges::begin(m_range) };
+            auto end{ std::ranges::end(m_range) };
+            if (it == end)
+                return;
+            m_source.push([&](auto&& x) {
+                bool more{ static_cast<bool>(sink(value_type{ std::forward<decltype(x)>(x), *it })) };
+                ++it;
+                return more && it != end;
+            });
+        }
+    };
+
+    // std::vectors of [size] elements (the last one may be shorter). it's the same vector every
+    // time, passed by const reference: a stage that keeps it (like toVector) copies it
+    template <Pipeline P>
+    class Chunk : public detail::PipelineTag
+    {
+    private:
+        P m_source;
+        std::size_t m_size;
+
+    public:
+        using value_type = std::vector<typename P::value_type>;
+
+        Chunk(P source, std::size_t size)
+            : m_source{ std::move(source) }
+            , m_size{ size }
+        {
+        }
+
+        template <typename Sink>
+        void push(Sink&& sink)
+        {
+            value_type buffer{};
+            buffer.reserve(m_size);
+            bool more{ true };
+            m_source.push([&](auto&& x) {
+                buffer.push_back(std::forward<decltype(x)>(x));
+                if (buffer.size() < m_size)
+                    return true;
+                more = sink(std::as_const(buffer));
+                buffer.clear();
+                return more;
+            });
+            if (more && !buffer.empty())
+                sink(std::as_const(buffer));
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                    ============[ adaptors, terminals, | ]============
+---------------------------------------------------------------------------------------*/
+
+// map(fn) etc. only remember their arguments; [pipeline | adaptor] calls adaptor(pipeline)
+
+namespace lazy
+{
+    namespace detail
+    {
+        template <typename Fn>
+        struct MapAdaptor : AdaptorTag
+        {
+            Fn fn;
+            template <Pipeline P> auto operator()(P p) { return Map<P, Fn>{ std::move(p), std::move(fn) }; }
+        };
+
+        template <typename Predicate>
+        struct FilterAdaptor : AdaptorTag
+        {
+            Predicate predicate;
+            template <Pipeline P> auto operator()(P p) { return Filter<P, Predicate>{ std::move(p), std::move(predicate) }; }
+        };
+
+        struct TakeAdaptor : AdaptorTag
+        {
+            std::size_t count;
+            template <Pipeline P> auto operator()(P p) { return Take<P>{ std::move(p), count }; }
+        };
+
+        struct ChunkAdaptor : AdaptorTag
+        {
+            std::size_t size;
+            template <Pipeline P> auto operator()(P p) { return Chunk<P>{ std::move(p), size }; }
+        };
+
+        template <typename Range>
+        struct ZipAdaptor : AdaptorTag
+        {
+            Range range;
+            template <Pipeline P> auto operator()(P p) { return Zip<P, Range>{ std::move(p), std::forward<Range>(range) }; }
+        };
+
+        template <typename Container>
+        struct ToAdaptor : AdaptorTag
+        {
+            template <Pipeline P>
+            Container operator()(P p)
+            {
+                Container out{};
+                p.push([&](auto&& x) {
+                    if constexpr (requires { out.push_back(std::forward<decltype(x)>(x)); })
+                        out.push_back(std::forward<decltype(x)>(x));
+                    else
+                        out.insert(out.end(), std::forward<decltype(x)>(x));
+                    return true;
+                });
+                return out;
+            }
+        };
+
+        struct ToVectorAdaptor : AdaptorTag
+        {
+            template <Pipeline P>
+            auto operator()(P p) { return ToAdaptor<std::vector<typename P::value_type>>{}(std::move(p)); }
+        };
+
+        template <typename T, typename Op>
+        struct ReduceAdaptor : AdaptorTag
+        {
+            T init;
+            Op op;
+
+            template <Pipeline P>
+            T operator()(P p)
+            {
+                T result{ std::move(init) };
+                p.push([&](auto&& x) {
+                    result = std::invoke(op, std::move(result), std::forward<decltype(x)>(x));
+                    return true;
+                });
+                return result;
+            }
+        };
+
+        struct SumAdaptor : AdaptorTag
+        {
+            template <Pipeline P>
+            auto operator()(P p) { return ReduceAdaptor<typename P::value_type, std::plus<>>{ {}, {}, {} }(std::move(p)); }
+        };
+
+        struct CountAdaptor : AdaptorTag
+        {
+            template <Pipeline P>
+            std::size_t operator()(P p)
+            {
+                std::size_t count{ 0 };
+                p.push([&](auto&&) {
+                    ++count;
+                    return true;
+                });
+                return count;
+            }
+        };
+
+        template <typename Fn>
+        struct ForEachAdaptor : AdaptorTag
+        {
+            Fn fn;
+
+            template <Pipeline P>
+            void operator()(P p)
+            {
+                p.push([&](auto&& x) {
+                    std::invoke(fn, std::forward<decltype(x)>(x));
+                    return true;
+                });
+            }
+        };
+
+        struct FirstAdaptor : AdaptorTag
+        {
+            template <Pipeline P>
+            std::optional<typename P::value_type> operator()(P p)
+            {
+                std::optional<typename P::value_type> first{};
+                p.push([&](auto&& x) {
+                    first.emplace(std::forward<decltype(x)>(x));
+                    return false;
+                });
+                return first;
+            }
+        };
+    }
+
+    template <typename Fn> detail::MapAdaptor<Fn> map(Fn fn) { return { {}, std::move(fn) }; }
+    template <typename Predicate> detail::FilterAdaptor<Predicate> filter(Predicate predicate) { return { {}, std::move(predicate) }; }
+    inline detail::TakeAdaptor take(std::size_t count) { return { {}, count }; }
+    inline detail::ChunkAdaptor chunk(std::size_t size) { return { {}, size }; }
+    template <std::ranges::input_range Range> detail::ZipAdaptor<Range> zip(Range&& range) { return { {}, std::forward<Range>(range) }; }
+
+    template <typename Container> detail::ToAdaptor<Container> to() { return {}; }
+    inline detail::ToVectorAdaptor toVector() { return {}; }
+    template <typename T, typename Op = std::plus<>> detail::ReduceAdaptor<T, Op> reduce(T init, Op op = {}) { return { {}, std::move(init), std::move(op) }; }
+    inline detail::SumAdaptor sum() { return {}; }
+    inline detail::CountAdaptor count() { return {}; }
+    template <typename Fn> detail::ForEachAdaptor<Fn> forEach(Fn fn) { return { {}, std::move(fn) }; }
+    inline detail::FirstAdaptor first() { return {}; }
+
+    template <typename A>
+    concept Adaptor = std::derived_from<std::remove_cvref_t<A>, detail::AdaptorTag>;
+
+    // in detail, next to the adaptors, so that ADL finds it when the left side is a std::vector
+    namespace detail
+    {
+        template <Pipeline P, Adaptor A>
+        auto operator|(P p, A&& adaptor)
+        {
+            return std::forward<A>(adaptor)(std::move(p));
+        }
+
+        template <std::ranges::input_range Range, Adaptor A>
+            requires (!Pipeline<std::remove_cvref_t<Range>>)
+        auto operator|(Range&& range, A&& adaptor)
+        {
+            return std::forward<A>(adaptor)(from(std::forward<Range>(range)));
+        }
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                            ============[ quiz_1 ]============
+---------------------------------------------------------------------------------------*/
+
+#include <random>
+#include <string>
+#include <ctime>
+#include <cstdlib>          // std::abs
+#include <algorithm>        // std::ranges::find, std::ranges::min_element
+
+namespace quiz_1
+{
+    constexpr int g_maxNearestDelta{ 4 };
+
+    int getRandomInt(int min, int max)
+    {
+        static std::mt19937 mt{ static_cast<std::mt19937::result_type>(std::time(nullptr)) };
+        return std::uniform_int_distribution{ min, max }(mt);
+    }
+
+    void main()
+    {
+        int start{ 6 };
+        int howMany{ 5 };
+        int multiplier{ getRandomInt(2, 4) };
+
+        // the same generating lambda, but straight into the vector, in one loop
+        auto nextSquare{ [&] {
+            int square{ multiplier * start * start };
+            ++start;
+            return square;
+        } };
+        std::vector<int> numbers{ lazy::generate(nextSquare) | lazy::take(static_cast<std::size_t>(howMany)) | lazy::toVector() };
+
+        std::cout << "I generated " << howMany << " square numbers.\n"
+                  << "Do you know what each number is after multiplying it by " << multiplier << "?\n";
+
+        std::vector<int> guesses{ numbers[2], numbers[0], numbers[4], numbers[3] + 2 };
+        for (int guess : guesses)
+        {
+            std::cout << "> " << guess << '\n';
+
+            auto found{ std::ranges::find(numbers, guess) };
+            if (found != numbers.end())
+            {
+                numbers.erase(found);
+
+                if (numbers.size() != 0)
+                    std::cout << "Nice! " << numbers.size() << " number(s) left.\n";
+                else
+                {
+                    std::cout << "Nice! you found all numbers, good job!\n";
+                    break;
+                }
+            }
+            else
+            {
+                std::cout << guess << " is wrong!";
+
+                auto nearest{ std::ranges::min_element(numbers,
+                                                       [guess](int a, int b) {
+                                                           return (std::abs(a - guess) < std::abs(b - guess));
+                                                       }) };
+                if (std::abs(guess - *nearest) <= g_maxNearestDelta)
+                    std::cout << " Try " << *nearest << " next time.";
+                std::cout << '\n';
+
+                break;
+            }
+        }
+    }
+}
+
+namespace example
+{
+    // a coroutine: the squares, forever
+    lazy::Generator<long long> squares()
+    {
+        for (long long i{ 1 };; ++i)
+            co_yield i * i;
+    }
+
+    void main()
+    {
+        // several steps, one loop
+        auto sums{ squares()
+                   | lazy::filter([](long long x) { return x % 2 == 0; })
+                   | lazy::take(12)
+                   | lazy::chunk(5)
+                   | lazy::map([](const std::vector<long long>& chunk) { return lazy::from(chunk) | lazy::sum(); })
+                   | lazy::toVector() };
+        std::cout << "even squares, 5 at a time:";
+        for (long long s : sums)
+            std::cout << ' ' << s;
+        std::cout << '\n';
+
+        std::vector<std::string> names{ "ada", "brian", "carol" };
+        lazy::iota(1) | lazy::zip(names) | lazy::forEach([](const auto& pair) { std::cout << pair.first << ". " << pair.second << '\n'; });
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <set>
+#include <list>
+#include <stdexcept>
+#include <numeric>          // std::accumulate
+
+namespace checks
+{
+    lazy::Generator<int> countTo(int n)
+    {
+        for (int i{ 0 }; i < n; ++i)
+            co_yield i;
+    }
+
+    lazy::Generator<int> failAfter(int n)
+    {
+        for (int i{ 0 }; i < n; ++i)
+            co_yield i;
+        throw std::runtime_error{ "generator failed" };
+    }
+
+    void main()
+    {
+        int failures{ 0 };
+        std::mt19937 mt{ 50 };
+
+        // random chains against std::views
+        for (int round{ 0 }; round < 300; ++round)
+        {
+            std::vector<int> values(mt() % 300);
+            for (auto& x : values)
+                x = static_cast<int>(mt() % 1000) - 500;
+            int divisor{ static_cast<int>(mt() % 5) + 1 };
+            std::size_t count{ mt() % 400 };
+
+            auto ours{ values | lazy::map([](int x) { return 3 * x + 1; }) | lazy::filter([&](int x) { return x % divisor == 0; })
+                       | lazy::take(count) | lazy::toVector() };
+            auto view{ values | std::views::transform([](int x) { return 3 * x + 1; }) | std::views::filter([&](int x) { return x % divisor == 0; })
+                       | std::views::take(count) };
+            failures += !std::ranges::equal(ours, view);
+
+            failures += (values | lazy::filter([&](int x) { return x % divisor == 0; }) | lazy::count())
+                        != static_cast<std::size_t>(std::ranges::count_if(values, [&](int x) { return x % divisor == 0; }));
+            failures += (values | lazy::sum()) != std::accumulate(values.begin(), values.end(), 0);
+
+            std::size_t size{ mt() % 7 + 1 };
+            auto chunks{ values | lazy::chunk(size) | lazy::toVector() };
+            std::vector<int> joined{};
+            for (const auto& c : chunks)
+            {
+                failures += c.empty() || c.size() > size;
+                joined.insert(joined.end(), c.begin(), c.end());
+            }
+            failures += joined != values;
+            failures += chunks.size() != (values.size() + size - 1) / size;
+        }
+
+        // take on infinite sources, and take(0), which must not generate anything
+        int generated{ 0 };
+        failures += (lazy::generate([&] { return ++generated; }) | lazy::take(5) | lazy::toVector()) != std::vector{ 1, 2, 3, 4, 5 };
+        failures += generated != 5;
+        failures += (lazy::generate([&] { return ++generated; }) | lazy::take(0) | lazy::count()) != 0 || generated != 5;
+        failures += (lazy::iota(10) | lazy::first()) != std::optional{ 10 };
+        failures += (lazy::iota(3, 3) | lazy::first()).has_value();
+        failures += (lazy::iota(0, 10) | lazy::reduce(1LL, [](long long a, int b) { return a * (b + 1); })) != 3628800;
+
+        // zip stops with the shorter side, and the left side isn't pushed further than needed
+        int pushed{ 0 };
+        auto pairs{ lazy::generate([&] { return pushed++; }) | lazy::zip(std::vector<char>{ 'a', 'b', 'c' }) | lazy::toVector() };
+        failures += pairs.size() != 3 || pairs[2] != std::pair{ 2, 'c' } || pushed != 3;
+        failures += (lazy::iota(0, 2) | lazy::zip(countTo(10)) | lazy::count()) != 2;
+        failures += (lazy::iota(0, 5) | lazy::zip(std::vector<int>{}) | lazy::count()) != 0;
+
+        // generators as sources, and other containers as results
+        failures += (countTo(5) | lazy::map([](int x) { return x * x; }) | lazy::toVector()) != std::vector{ 0, 1, 4, 9, 16 };
+        failures += (countTo(0) | lazy::count()) != 0;
+        failures += (std::list<int>{ 3, 1, 3, 2 } | lazy::to<std::set<int>>()) != std::set{ 1, 2, 3 };
+        failures += (std::vector<std::string>{ "a", "bb", "ccc" } | lazy::map([](const std::string& s) { return s.size(); }) | lazy::sum()) != 6;
+
+        // an exception in the coroutine reaches the caller
+        bool caught{ false };
+        try
+        {
+            failAfter(3) | lazy::count();
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        failures += !caught;
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// the sum of 3x^2 + 1 over the x in [0, 2^26) that aren't multiples of 3, for the first 2^25 of
+// them, five ways:
+    // - a hand-written loop
+    // - the pipeline
+    // - std::views
+    // - the 12.8 way: a vector per step
+    // - the pipeline on a coroutine (a resume per element)
+// ns per element of the input.
+
+#include <chrono>
+#include <iomanip>          // std::setw
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr long long g_size{ 1LL << 26 };
+    constexpr std::size_t g_take{ 1 << 25 };
+
+    lazy::Generator<long long> numbers(long long n)
+    {
+        for (long long i{ 0 }; i < n; ++i)
+            co_yield i;
+    }
+
+    long long handWritten()
+    {
+        long long sum{ 0 };
+        std::size_t taken{ 0 };
+        for (long long x{ 0 }; x < g_size && taken < g_take; ++x)
+        {
+            if (x % 3 == 0)
+                continue;
+            sum += 3 * x * x + 1;
+            ++taken;
+        }
+        return sum;
+    }
+
+    // (the squares are computed after the filter, as in the loop above)
+    long long pipeline()
+    {
+        return lazy::iota(0LL, g_size)
+               | lazy::filter([](long long x) { return x % 3 != 0; })
+               | lazy::map([](long long x) { return 3 * x * x + 1; })
+               | lazy::take(g_take)
+               | lazy::sum();
+    }
+
+    long long views()
+    {
+        auto view{ std::views::iota(0LL, g_size)
+                   | std::views::filter([](long long x) { return x % 3 != 0; })
+                   | std::views::transform([](long long x) { return 3 * x * x + 1; })
+                   | std::views::take(g_take) };
+        long long sum{ 0 };
+        for (long long x : view)
+            sum += x;
+        return sum;
+    }
+
+    long long vectors()
+    {
+        std::vector<long long> all(static_cast<std::size_t>(g_size));
+        long long next{ 0 };
+        std::for_each(all.begin(), all.end(), [&](long long& x) { x = next++; });
+        std::vector<long long> kept{};
+        std::copy_if(all.begin(), all.end(), std::back_inserter(kept), [](long long x) { return x % 3 != 0; });
+        kept.resize(std::min(kept.size(), g_take));
+        std::vector<long long> mapped(kept.size());
+        std::transform(kept.begin(), kept.end(), mapped.begin(), [](long long x) { return 3 * x * x + 1; });
+        return std::accumulate(mapped.begin(), mapped.end(), 0LL);
+    }
+
+    long long coroutine()
+    {
+        return numbers(g_size)
+               | lazy::filter([](long long x) { return x % 3 != 0; })
+               | lazy::map([](long long x) { return 3 * x * x + 1; })
+               | lazy::take(g_take)
+               | lazy::sum();
+    }
+
+    void main()
+    {
+        std::cout << "benchmark (ns per element):\n";
+        long long expected{ handWritten() };
+        auto run{ [&](const char* name, long long (*fn)()) {
+            Timer t;
+            long long result{ fn() };
+            double ns{ t.elapsed() * 1e9 / static_cast<double>(g_size) };
+            std::cout << "    " << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(7) << ns << (result == expected ? "" : "  (wrong result!)") << '\n';
+        } };
+
+        run("hand-written", handWritten);
+        run("lazy", pipeline);
+        run("std::views", views);
+        run("vectors", vectors);
+        run("coroutine", coroutine);
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    quiz_1::main();
+    example::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
@@ -0,0 +1,592 @@
+#include <iostream>
+#include <vector>
+#include <span>
+#include <new>              // ::operator new, std::align_val_t
+#include <algorithm>        // std::lower_bound, std::min
+#include <limits>
+#include <numeric>          // std::midpoint
+#include <bit>              // std::popcount, std::countr_one, std::bit_width
+#include <cstdint>
+#include <cstddef>          // std::size_t
+#include <cassert>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+// [ description ]
+/*---------------------------------------------------------------------------------------
+    binarySearch_iterative and binarySearch_recursive in quiz_3 search a sorted array in
+    its natural layout. for 15 ints that's perfect. for 100 million, every step of the
+    search lands on a different cache line, far from the last one: the first few steps
+    always touch the same few lines (those stay cached), but the last ~15 of them are all
+    cache misses (and TLB misses), one after the other, because the next address depends on
+    the comparison we're waiting for. on top of that, the comparison is a branch that goes
+    either way with probability 1/2, so half of them are mispredicted.
+
+    here we build static search indices (built once, searched many times) that fix this:
+        - a BRANCHLESS lower bound on the sorted array, with both possible next middles
+          prefetched: no mispredictions, and the memory latency overlaps a little
+        - the EYTZINGER layout: the keys in the order of a breadth first walk of the binary
+          search tree (root at 1, children of k at 2k and 2k+1). the first levels of the
+          tree are packed in the first cache lines (hot, cached), and the 16 descendants of
+          a node 4 levels down are in one cache line, so we prefetch 4 levels ahead
+        - the S-TREE: a static B-tree with 16 keys (one cache line) per node. a node is
+          searched with SSE2 (compare x with all 16 keys, count how many are smaller), and a
+          search touches only log17(n) cache lines instead of log2(n)
+        - BATCHED queries: most real lookups don't depend on each other (a join, a bulk
+          membership test). searching 16 keys at once, level by level, has 16 independent
+          cache misses in flight instead of one
+    every search returns the lower bound: the index (in the sorted array) of the first key
+    that's >= x, or the size if there's none. find() turns it into quiz_3's "index or -1".
+---------------------------------------------------------------------------------------*/
+
+namespace search
+{
+    namespace detail
+    {
+        inline void prefetch(const void* address)
+        {
+#if defined(__GNUC__)
+            __builtin_prefetch(address);
+#else
+            (void)address;
+#endif
+        }
+
+        // a fixed size array on its own cache lines
+        template <typename T>
+        class AlignedArray
+        {
+        private:
+            static constexpr std::size_t s_alignment{ 64 };
+
+            T* m_data{ nullptr };
+            std::size_t m_size{ 0 };
+
+        public:
+            explicit AlignedArray(std::size_t size)
+                : m_data{ static_cast<T*>(::operator new(std::max<std::size_t>(size, 1) * sizeof(T), std::align_val_t{ s_alignment })) }
+                , m_size{ size }
+            {
+            }
+
+            AlignedArray(const AlignedArray&) = delete;
+            AlignedArray& operator=(const AlignedArray&) = delete;
+
+            ~AlignedArray()
+            {
+                ::operator delete(m_data, std::align_val_t{ s_alignment });
+            }
+
+            T& operator[](std::size_t index) { return m_data[index]; }
+            const T& operator[](std::size_t index) const { return m_data[index]; }
+            const T* data() const { return m_data; }
+            std::size_t size() const { return m_size; }
+        };
+    }
+
+    // quiz_3's binarySearch_iterative, for comparison (it returns the index of any equal key)
+    inline int binarySearch_iterative(const int* array, int target, int min, int max)
+    {
+        assert(array && "invalid array");
+
+        while (min <= max)
+        {
+            int mid{ std::midpoint(min, max) };
+
+            if (array[mid] > target)
+                max = mid - 1;
+            else if (array[mid] < target)
+                min = mid + 1;
+            else
+                return mid;
+        }
+        return -1;
+    }
+
+    // the loop always runs ceil(log2(n)) times; the only thing that depends on the comparison
+    // is how far base moves. that's a multiplication by 0 or 1: written as ?:, gcc makes it
+    // a branch again
+    inline std::size_t branchlessLowerBound(std::span<const int> sorted, int x)
+    {
+        if (sorted.empty())
+            return 0;
+
+        const int* base{ sorted.data() };
+        std::size_t length{ sorted.size() };
+        while (length > 1)
+        {
+            std::size_t half{ length / 2 };
+            detail::prefetch(base + half / 2);
+            detail::prefetch(base + half + half / 2);
+            base += half * static_cast<std::size_t>(base[half - 1] < x);
+            length -= half;
+        }
+        return static_cast<std::size_t>(base - sorted.data()) + (*base < x);
+    }
+
+    inline int find(std::span<const int> sorted, std::size_t lowerBound, int x)
+    {
+        return (lowerBound < sorted.size() && sorted[lowerBound] == x) ? static_cast<int>(lowerBound) : -1;
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ Eytzinger layout ]============
+---------------------------------------------------------------------------------------*/
+
+namespace search
+{
+    class Eytzinger
+    {
+    private:
+        std::size_t m_size{};
+        detail::AlignedArray<int> m_keys;               // 1-based: m_keys[0] is unused
+        detail::AlignedArray<std::uint32_t> m_ranks;    // m_ranks[k]: the index of m_keys[k] in the sorted array
+
+        // an in-order walk of the tree visits the keys in sorted order
+        void build(std::span<const int> sorted, std::size_t& next, std::size_t k)
+        {
+            if (k > m_size)
+                return;
+            build(sorted, next, 2 * k);
+            m_keys[k] = sorted[next];
+            m_ranks[k] = static_cast<std::uint32_t>(next++);
+            build(sorted, next, 2 * k + 1);
+        }
+
+        // the search goes right (2k + 1) while the key is < x, and left (2k) at the answer. at
+        // the end, the right turns after the last left turn are trailing 1 bits of k: shift
+        // them out, and the left turn too, and k is the answer (0 if we never turned left)
+        std::size_t rankOf(std::size_t k) const
+        {
+            k >>= std::countr_one(k) + 1;
+            return k == 0 ? m_size : m_ranks[k];
+        }
+
+    public:
+        explicit Eytzinger(std::span<const int> sorted)
+            : m_size{ sorted.size() }, m_keys{ sorted.size() + 1 }, m_ranks{ sorted.size() + 1 }
+        {
+            assert(sorted.size() < std::numeric_limits<std::uint32_t>::max() && "too many keys");
+            std::size_t next{ 0 };
+            build(sorted, next, 1);
+        }
+
+        std::size_t size() const { return m_size; }
+
+        std::size_t lowerBound(int x) const
+        {
+            std::size_t k{ 1 };
+            while (k <= m_size)
+            {
+                // 16 ints are a cache line: the 16 great-great-grandchildren of k
+                detail::prefetch(m_keys.data() + std::min(16 * k, m_size));
+                k = 2 * k + (m_keys[k] < x);
+            }
+            return rankOf(k);
+        }
+
+        // 16 queries at a time, one tree level at a time: the first levels where every path
+        // is full, and then the last (partial) one
+        void lowerBound(std::span<const int> queries, std::span<std::size_t> results) const
+        {
+            assert(results.size() >= queries.size());
+            constexpr std::size_t batch{ 16 };
+            const int fullLevels{ static_cast<int>(std::bit_width(m_size + 1)) - 1 };
+
+            std::size_t i{ 0 };
+            for (; i + batch <= queries.size(); i += batch)
+            {
+                std::size_t k[batch];
+                for (std::size_t j{ 0 }; j < batch; ++j)
+                    k[j] = 1;
+
+                for (int level{ 0 }; level < fullLevels; ++level)
+                {
+                    for (std::size_t j{ 0 }; j < batch; ++j)
+                    {
+                        detail::prefetch(m_keys.data() + std::min(16 * k[j], m_size));
+                        k[j] = 2 * k[j] + (m_keys[k[j]] < queries[i + j]);
+                    }
+                }
+                for (std::size_t j{ 0 }; j < batch; ++j)
+                {
+                    if (k[j] <= m_size)
+                        k[j] = 2 * k[j] + (m_keys[k[j]] < queries[i + j]);
+                    results[i + j] = rankOf(k[j]);
+                }
+            }
+            for (; i < queries.size(); ++i)
+                results[i] = lowerBound(queries[i]);
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                    ============[ S-tree (static B-tree) ]============
+---------------------------------------------------------------------------------------*/
+
+namespace search
+{
+    class STree
+    {
+    public:
+        static constexpr std::size_t s_nodeKeys{ 16 };      // 16 ints: one cache line
+
+    private:
+        static constexpr std::size_t s_noSlot{ std::numeric_limits<std::size_t>::max() };
+
+        std::size_t m_size{};
+        std::size_t m_nodes{};
+        detail::AlignedArray<int> m_keys;               // node k is m_keys[16k, 16k + 16)
+        detail::AlignedArray<std::uint32_t> m_ranks;
+
+        static std::size_t child(std::size_t node, std::size_t i) { return node * (s_nodeKeys + 1) + i + 1; }
+
+        // in order again: child 0, key 0, child 1, key 1, ..., key 15, child 16. the slots after
+        // the last key are INT_MAX, with the rank "not found"
+        void build(std::span<const int> sorted, std::size_t& next, std::size_t node)
+        {
+            if (node >= m_nodes)
+                return;
+            for (std::size_t i{ 0 }; i < s_nodeKeys; ++i)
+            {
+                build(sorted, next, child(node, i));
+                std::size_t slot{ node * s_nodeKeys + i };
+                if (next < sorted.size())
+                {
+                    m_keys[slot] = sorted[next];
+                    m_ranks[slot] = static_cast<std::uint32_t>(next++);
+                }
+                else
+                {
+                    m_keys[slot] = std::numeric_limits<int>::max();
+                    m_ranks[slot] = static_cast<std::uint32_t>(m_size);
+                }
+            }
+            build(sorted, next, child(node, s_nodeKeys));
+        }
+
+        // how many of the node's 16 (sorted) keys are < x: that's the child to go down to
+        unsigned countLess(std::size_t node, int x) const
+        {
+            const int* keys{ m_keys.data() + node * s_nodeKeys };
+#if defined(__SSE2__)
+            __m128i value{ _mm_set1_epi32(x) };
+            auto lessThan{ [&](std::size_t offset) {
+                return _mm_cmpgt_epi32(value, _mm_load_si128(reinterpret_cast<const __m128i*>(keys + offset)));
+            } };
+            __m128i low{ _mm_packs_epi32(lessThan(0), lessThan(4)) };
+            __m128i high{ _mm_packs_epi32(lessThan(8), lessThan(12)) };
+            auto mask{ static_cast<unsigned>(_mm_movemask_epi8(_mm_packs_epi16(low, high))) };
+            return static_cast<unsigned>(std::popcount(mask));
+#else
+            unsigned count{ 0 };
+            for (std::size_t i{ 0 }; i < s_nodeKeys; ++i)
+                count += keys[i] < x;
+            return count;
+#endif
+        }
+
+    public:
+        explicit STree(std::span<const int> sorted)
+            : m_size{ sorted.size() }
+            , m_nodes{ (sorted.size() + s_nodeKeys - 1) / s_nodeKeys }
+            , m_keys{ m_nodes * s_nodeKeys }
+            , m_ranks{ m_nodes * s_nodeKeys }
+        {
+            assert(sorted.size() < std::numeric_limits<std::uint32_t>::max() && "too many keys");
+            std::size_t next{ 0 };
+            build(sorted, next, 0);
+        }
+
+        std::size_t size() const { return m_size; }
+
+        // the answer is the key we stopped at on the lowest level that had one (further down
+        // means further left in sorted order). we keep its slot, and look its rank up only at the
+        // end: that's one cache miss, instead of one per level
+        std::size_t lowerBound(int x) const
+        {
+            std::size_t slot{ s_noSlot };
+            for (std::size_t node{ 0 }; node < m_nodes;)
+            {
+                unsigned i{ countLess(node, x) };
+                if (i < s_nodeKeys)
+                    slot = node * s_nodeKeys + i;
+                node = child(node, i);
+            }
+            return slot == s_noSlot ? m_size : m_ranks[slot];
+        }
+
+        void lowerBound(std::span<const int> queries, std::span<std::size_t> results) const
+        {
+            assert(results.size() >= queries.size());
+            constexpr std::size_t batch{ 16 };
+
+            std::size_t i{ 0 };
+            for (; i + batch <= queries.size(); i += batch)
+            {
+                std::size_t node[batch];
+                std::size_t slot[batch];
+                for (std::size_t j{ 0 }; j < batch; ++j)
+                {
+                    node[j] = 0;
+                    slot[j] = s_noSlot;
+                }
+
+                for (bool searching{ m_nodes > 0 }; searching;)
+                {
+                    searching = false;
+                    for (std::size_t j{ 0 }; j < batch; ++j)
+                    {
+                        if (node[j] >= m_nodes)
+                            continue;
+                        unsigned k{ countLess(node[j], queries[i + j]) };
+                        if (k < s_nodeKeys)
+                            slot[j] = node[j] * s_nodeKeys + k;
+                        node[j] = child(node[j], k);
+                        if (node[j] < m_nodes)
+                        {
+                            detail::prefetch(m_keys.data() + node[j] * s_nodeKeys);
+                            searching = true;
+                        }
+                    }
+                }
+
+                for (std::size_t j{ 0 }; j < batch; ++j)
+                    results[i + j] = slot[j] == s_noSlot ? m_size : m_ranks[slot[j]];
+            }
+            for (; i < queries.size(); ++i)
+                results[i] = lowerBound(queries[i]);
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                   ============[ the quiz, with every search ]============
+---------------------------------------------------------------------------------------*/
+
+namespace quiz_3
+{
+    void main()
+    {
+        constexpr int array[]{ 3, 6, 8, 12, 14, 17, 20, 21, 26, 32, 36, 37, 42, 44, 48 };
+
+        constexpr int numTestValues{ 9 };
+        constexpr int testValues[numTestValues]{ 0, 3, 12, 13, 22, 26, 43, 44, 49 };
+        int expectedValues[numTestValues]{ -1, 0, 3, -1, -1, 8, -1 ,13, -1 };
+
+        search::Eytzinger eytzinger{ array };
+        search::STree stree{ array };
+
+        int failed{ 0 };
+        for (int count{ 0 }; count < numTestValues; ++count)
+        {
+            int x{ testValues[count] };
+            int results[]{
+                search::binarySearch_iterative(array, x, 0, static_cast<int>(std::size(array) - 1)),
+                search::find(array, search::branchlessLowerBound(array, x), x),
+                search::find(array, eytzinger.lowerBound(x), x),
+                search::find(array, stree.lowerBound(x), x),
+            };
+            for (int result : results)
+                failed += result != expectedValues[count];
+        }
+
+        std::cout << (failed == 0 ? "all test values passed!\n" : "there's something wrong with your code!\n");
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <random>
+
+namespace checks
+{
+    // every search against std::lower_bound, single and batched, for sizes around the edges of
+    // full trees (2^k - 1 keys for Eytzinger, multiples of 16 for the S-tree), with duplicates
+    // and with the extremes of int
+    int checkSize(std::size_t size, std::mt19937& mt)
+    {
+        std::vector<int> sorted(size);
+        for (auto& key : sorted)
+            key = static_cast<int>(mt() % (2 * size + 1)) - static_cast<int>(size);
+        if (size > 2)
+        {
+            sorted[0] = std::numeric_limits<int>::min();
+            sorted[1] = std::numeric_limits<int>::max();
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        search::Eytzinger eytzinger{ sorted };
+        search::STree stree{ sorted };
+
+        std::vector<int> queries(100);
+        for (auto& query : queries)
+            query = static_cast<int>(mt() % (2 * size + 5)) - static_cast<int>(size) - 2;
+        queries[0] = std::numeric_limits<int>::min();
+        queries[1] = std::numeric_limits<int>::max();
+
+        std::vector<std::size_t> batchedEytzinger(queries.size());
+        std::vector<std::size_t> batchedSTree(queries.size());
+        eytzinger.lowerBound(queries, batchedEytzinger);
+        stree.lowerBound(queries, batchedSTree);
+
+        int failures{ 0 };
+        for (std::size_t i{ 0 }; i < queries.size(); ++i)
+        {
+            int x{ queries[i] };
+            auto expected{ static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), x) - sorted.begin()) };
+            failures += search::branchlessLowerBound(sorted, x) != expected;
+            failures += eytzinger.lowerBound(x) != expected || batchedEytzinger[i] != expected;
+            failures += stree.lowerBound(x) != expected || batchedSTree[i] != expected;
+        }
+        return failures;
+    }
+
+    void main()
+    {
+        std::mt19937 mt{ 46 };
+        int failures{ 0 };
+        for (std::size_t size{ 0 }; size < 600; ++size)
+            failures += checkSize(size, mt);
+        for (std::size_t size : { 4095u, 4096u, 4097u, 65535u, 70'000u, 300'001u })
+            failures += checkSize(size, mt);
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// ns per lookup of a random key, for sorted arrays of 4 KiB (L1) up to 256 MiB (far past
+// any cache; multi-GB arrays behave the same, only worse, and don't fit in this machine)
+
+#include <chrono>
+#include <iomanip>          // std::setw
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_queries{ 1 << 20 };
+
+    void row(std::size_t size, std::mt19937& mt)
+    {
+        std::vector<int> sorted(size);
+        for (std::size_t i{ 0 }; i < size; ++i)
+            sorted[i] = static_cast<int>(2 * i);        // every other number, so half the queries miss
+
+        std::vector<int> queries(g_queries);
+        for (auto& query : queries)
+            query = static_cast<int>(mt() % (2 * size));
+
+        std::vector<std::size_t> results(g_queries);
+        std::size_t checksum{ 0 };
+        auto time{ [&](auto search) {
+            Timer t;
+            search();
+            double nanoseconds{ t.elapsed() / g_queries * 1e9 };
+            for (std::size_t result : results)
+                checksum += result;
+            return nanoseconds;
+        } };
+
+        double quiz{ time([&] {
+            for (std::size_t i{ 0 }; i < g_queries; ++i)
+                results[i] = static_cast<std::size_t>(search::binarySearch_iterative(sorted.data(), queries[i], 0, static_cast<int>(size) - 1));
+        }) };
+        double standard{ time([&] {
+            for (std::size_t i{ 0 }; i < g_queries; ++i)
+                results[i] = static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), queries[i]) - sorted.begin());
+        }) };
+        double branchless{ time([&] {
+            for (std::size_t i{ 0 }; i < g_queries; ++i)
+                results[i] = search::branchlessLowerBound(sorted, queries[i]);
+        }) };
+
+        search::Eytzinger eytzinger{ sorted };
+        double eytzingerOne{ time([&] {
+            for (std::size_t i{ 0 }; i < g_queries; ++i)
+                results[i] = eytzinger.lowerBound(queries[i]);
+        }) };
+        double eytzingerBatch{ time([&] { eytzinger.lowerBound(queries, results); }) };
+
+        search::STree stree{ sorted };
+        double streeOne{ time([&] {
+            for (std::size_t i{ 0 }; i < g_queries; ++i)
+                results[i] = stree.lowerBound(queries[i]);
+        }) };
+        double streeBatch{ time([&] { stree.lowerBound(queries, results); }) };
+
+        std::cout << std::setw(10) << size * sizeof(int) / 1024 << " KiB"
+                  << std::setw(9) << quiz << std::setw(9) << standard << std::setw(11) << branchless
+                  << std::setw(11) << eytzingerOne << std::setw(9) << eytzingerBatch
+                  << std::setw(9) << streeOne << std::setw(9) << streeBatch
+                  << (checksum == 0 ? " (?)" : "") << '\n';
+    }
+
+    void main()
+    {
+        std::mt19937 mt{ 4 };
+        std::cout << std::fixed << std::setprecision(1) << "ns per lookup\n"
+                  << std::setw(14) << "keys" << std::setw(9) << "quiz" << std::setw(9) << "std::lb" << std::setw(11) << "branchless"
+                  << std::setw(11) << "eytzinger" << std::setw(9) << "batch" << std::setw(9) << "s-tree" << std::setw(9) << "batch" << '\n';
+        for (std::size_t size{ 1 << 10 }; size <= (std::size_t{ 1 } << 26); size *= 4)
+            row(size, mt);
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    quiz_3::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
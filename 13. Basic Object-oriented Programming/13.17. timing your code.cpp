@@ -73,9 +73,10 @@ namespace an_example
             {
                 if (array[currentIndex] < array[smallestIndex])
                     smallestIndex = currentIndex;
-
-                std::swap(array[startIndex], array[smallestIndex]);
             }
+
+            // one swap per pass, once we know where the smallest element is
+            std::swap(array[startIndex], array[smallestIndex]);
         }
     }
 
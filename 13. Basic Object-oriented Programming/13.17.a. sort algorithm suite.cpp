@@ -0,0 +1,988 @@
+#include <iostream>
+#include <iomanip>          // std::setw
+#include <vector>
+#include <span>
+#include <array>
+#include <string>
+#include <iterator>         // std::iterator_traits
+#include <algorithm>        // std::iter_swap, std::make_heap, std::sort_heap, std::upper_bound...
+#include <functional>       // std::less
+#include <type_traits>
+#include <utility>          // std::move, std::pair
+#include <bit>              // std::bit_width
+#include <cstring>          // std::memset
+#include <cstdint>
+#include <cstddef>          // std::size_t, std::ptrdiff_t
+
+
+// 13.17 times selection, bubble and insertion sort against std::ranges::sort on ONE input:
+// 10000 ints in reverse order. which sort is fastest depends a lot on the input though, so
+// this file adds the sorts that are actually used in practice, and times all of them over a
+// matrix of sizes and input patterns:
+
+//  - pdqsort (pattern-defeating quicksort, Orson Peters): introsort's quicksort + heapsort
+//    fallback, plus: insertion sort for small ranges, a ninther pivot for big ones, a special
+//    partition for runs of equal elements, a cheap "is this already sorted?" check after a
+//    partition that didn't move anything, and shuffling when a partition is very unbalanced
+//    (which is what breaks the patterns that make quicksort quadratic).
+//  - branchless block partitioning (BlockQuicksort, Edelkamp & Weiss): partitioning random
+//    data mispredicts about every other comparison. instead, the comparisons of a block of 64
+//    elements are only used to write down the offsets of misplaced elements (no branch on the
+//    result), and then the elements are swapped by offset. pdqsort uses it for arithmetic
+//    types with the default comparison.
+//  - LSD radix sort for integer keys: no comparisons at all, 1 byte of the key per pass,
+//    counted with one histogram pass for all bytes. passes where every key has the same byte
+//    are skipped.
+//  - adaptive (natural) merge sort: finds the runs that are already sorted (or reversed),
+//    and merges them timsort-style. nearly sorted input costs nearly nothing. it's stable.
+
+// the benchmark prints ns per element for every (input, size, algorithm), and the winner.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ small sorts ]============
+---------------------------------------------------------------------------------------*/
+
+namespace sorting::detail
+{
+    constexpr std::ptrdiff_t g_insertionSortThreshold{ 24 };
+    constexpr std::ptrdiff_t g_nintherThreshold{ 128 };
+    constexpr std::size_t g_partialInsertionSortLimit{ 8 };
+    constexpr std::size_t g_blockSize{ 64 };
+
+    template <typename Iter, typename Compare>
+    void insertionSort(Iter begin, Iter end, Compare compare)
+    {
+        using T = typename std::iterator_traits<Iter>::value_type;
+        if (begin == end)
+            return;
+
+        for (Iter current{ begin + 1 }; current != end; ++current)
+        {
+            Iter sift{ current };
+            Iter siftPrev{ current - 1 };
+            if (compare(*sift, *siftPrev))
+            {
+                T moving{ std::move(*sift) };
+                do
+                    *sift-- = std::move(*siftPrev);
+                while (sift != begin && compare(moving, *--siftPrev));
+                *sift = std::move(moving);
+            }
+        }
+    }
+
+    // requires that *(begin - 1) is not greater than anything in [begin, end), so the inner
+    // loop doesn't need the sift != begin check
+    template <typename Iter, typename Compare>
+    void unguardedInsertionSort(Iter begin, Iter end, Compare compare)
+    {
+        using T = typename std::iterator_traits<Iter>::value_type;
+        if (begin == end)
+            return;
+
+        for (Iter current{ begin + 1 }; current != end; ++current)
+        {
+            Iter sift{ current };
+            Iter siftPrev{ current - 1 };
+            if (compare(*sift, *siftPrev))
+            {
+                T moving{ std::move(*sift) };
+                do
+                    *sift-- = std::move(*siftPrev);
+                while (compare(moving, *--siftPrev));
+                *sift = std::move(moving);
+            }
+        }
+    }
+
+    // insertion sort that gives up (returns false) after moving more than a few elements
+    template <typename Iter, typename Compare>
+    bool partialInsertionSort(Iter begin, Iter end, Compare compare)
+    {
+        using T = typename std::iterator_traits<Iter>::value_type;
+        if (begin == end)
+            return true;
+
+        std::size_t moved{ 0 };
+        for (Iter current{ begin + 1 }; current != end; ++current)
+        {
+            Iter sift{ current };
+            Iter siftPrev{ current - 1 };
+            if (compare(*sift, *siftPrev))
+            {
+                T moving{ std::move(*sift) };
+                do
+                    *sift-- = std::move(*siftPrev);
+                while (sift != begin && compare(moving, *--siftPrev));
+                *sift = std::move(moving);
+                moved += static_cast<std::size_t>(current - sift);
+            }
+
+            if (moved > g_partialInsertionSortLimit)
+                return false;
+        }
+        return true;
+    }
+
+    template <typename Iter, typename Compare>
+    void sort2(Iter a, Iter b, Compare compare)
+    {
+        if (compare(*b, *a))
+            std::iter_swap(a, b);
+    }
+
+    template <typename Iter, typename Compare>
+    void sort3(Iter a, Iter b, Iter c, Compare compare)
+    {
+        sort2(a, b, compare);
+        sort2(b, c, compare);
+        sort2(a, b, compare);
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ partitions ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  all three take the pivot from *begin, and return where it ended up.
+
+  - partitionRight puts the elements equal to the pivot on the right. it also says whether
+    the range was already partitioned (no element had to be swapped).
+  - partitionLeft puts the elements equal to the pivot on the left. it's used when the
+    pivot is equal to the element just before the range, so everything equal to it can be
+    left out of the recursion: that's what makes few-unique inputs fast.
+  - partitionRightBranchless does what partitionRight does, with block partitioning.
+*/
+
+namespace sorting::detail
+{
+    template <typename Iter, typename Compare>
+    std::pair<Iter, bool> partitionRight(Iter begin, Iter end, Compare compare)
+    {
+        using T = typename std::iterator_traits<Iter>::value_type;
+        T pivot{ std::move(*begin) };
+        Iter first{ begin };
+        Iter last{ end };
+
+        // the median of 3 guarantees an element >= pivot on the right, so the first loop is safe
+        while (compare(*++first, pivot))
+            ;
+
+        if (first - 1 == begin)
+            while (first < last && !compare(*--last, pivot))
+                ;
+        else
+            while (!compare(*--last, pivot))
+                ;
+
+        bool alreadyPartitioned{ first >= last };
+        while (first < last)
+        {
+            std::iter_swap(first, last);
+            while (compare(*++first, pivot))
+                ;
+            while (!compare(*--last, pivot))
+                ;
+        }
+
+        Iter pivotPosition{ first - 1 };
+        *begin = std::move(*pivotPosition);
+        *pivotPosition = std::move(pivot);
+        return { pivotPosition, alreadyPartitioned };
+    }
+
+    template <typename Iter, typename Compare>
+    Iter partitionLeft(Iter begin, Iter end, Compare compare)
+    {
+        using T = typename std::iterator_traits<Iter>::value_type;
+        T pivot{ std::move(*begin) };
+        Iter first{ begin };
+        Iter last{ end };
+
+        while (compare(pivot, *--last))
+            ;
+
+        if (last + 1 == end)
+            while (first < last && !compare(pivot, *++first))
+                ;
+        else
+            while (!compare(pivot, *++first))
+                ;
+
+        while (first < last)
+        {
+            std::iter_swap(first, last);
+            while (compare(pivot, *--last))
+                ;
+            while (!compare(pivot, *++first))
+                ;
+        }
+
+        Iter pivotPosition{ last };
+        *begin = std::move(*pivotPosition);
+        *pivotPosition = std::move(pivot);
+        return pivotPosition;
+    }
+
+    // swaps first + offsetsLeft[i] with last - offsetsRight[i]. when the counts differ, a
+    // cyclic permutation is cheaper than swaps (one move per element instead of three)
+    template <typename Iter>
+    void swapOffsets(Iter first, Iter last, const unsigned char* offsetsLeft, const unsigned char* offsetsRight,
+                     std::size_t count, bool useSwaps)
+    {
+        using T = typename std::iterator_traits<Iter>::value_type;
+        if (useSwaps)
+        {
+            for (std::size_t i{ 0 }; i < count; ++i)
+                std::iter_swap(first + offsetsLeft[i], last - offsetsRight[i]);
+        }
+        else if (count > 0)
+        {
+            Iter left{ first + offsetsLeft[0] };
+            Iter right{ last - offsetsRight[0] };
+            T moving{ std::move(*left) };
+            *left = std::move(*right);
+            for (std::size_t i{ 1 }; i < count; ++i)
+            {
+                left = first + offsetsLeft[i];
+                *right = std::move(*left);
+                right = last - offsetsRight[i];
+                *left = std::move(*right);
+            }
+            *right = std::move(moving);
+        }
+    }
+
+    template <typename Iter, typename Compare>
+    std::pair<Iter, bool> partitionRightBranchless(Iter begin, Iter end, Compare compare)
+    {
+        using T = typename std::iterator_traits<Iter>::value_type;
+        T pivot{ std::move(*begin) };
+        Iter first{ begin };
+        Iter last{ end };
+
+        while (compare(*++first, pivot))
+            ;
+
+        if (first - 1 == begin)
+            while (first < last && !compare(*--last, pivot))
+                ;
+        else
+            while (!compare(*--last, pivot))
+                ;
+
+        bool alreadyPartitioned{ first >= last };
+        if (!alreadyPartitioned)
+        {
+            std::iter_swap(first, last);
+            ++first;
+
+            // [first, last) is unknown. blocks are taken from both ends: offsetsLeft holds the
+            // offsets (from offsetsLeftBase) of elements on the left that belong on the right,
+            // offsetsRight the same for the right side, counted backwards from offsetsRightBase
+            alignas(64) unsigned char offsetsLeft[g_blockSize];
+            alignas(64) unsigned char offsetsRight[g_blockSize];
+
+            Iter offsetsLeftBase{ first };
+            Iter offsetsRightBase{ last };
+            std::size_t countLeft{ 0 }, countRight{ 0 }, startLeft{ 0 }, startRight{ 0 };
+
+            while (first < last)
+            {
+                // refill whichever blocks are empty, splitting what's left between them
+                std::size_t unknown{ static_cast<std::size_t>(last - first) };
+                std::size_t leftSplit{ countLeft == 0 ? (countRight == 0 ? unknown / 2 : unknown) : 0 };
+                std::size_t rightSplit{ countRight == 0 ? (unknown - leftSplit) : 0 };
+
+                // the offset is always written, and the count only moves when it's misplaced
+                std::size_t leftCount{ std::min(leftSplit, g_blockSize) };
+                for (std::size_t i{ 0 }; i < leftCount; ++i)
+                {
+                    offsetsLeft[countLeft] = static_cast<unsigned char>(i);
+                    countLeft += !compare(*first, pivot);
+                    ++first;
+                }
+
+                std::size_t rightCount{ std::min(rightSplit, g_blockSize) };
+                for (std::size_t i{ 0 }; i < rightCount;)
+                {
+                    offsetsRight[countRight] = static_cast<unsigned char>(++i);
+                    countRight += compare(*--last, pivot);
+                }
+
+                std::size_t count{ std::min(countLeft, countRight) };
+                swapOffsets(offsetsLeftBase, offsetsRightBase, offsetsLeft + startLeft, offsetsRight + startRight,
+                            count, countLeft == countRight);
+                countLeft -= count;
+                countRight -= count;
+                startLeft += count;
+                startRight += count;
+
+                if (countLeft == 0)
+                {
+                    startLeft = 0;
+                    offsetsLeftBase = first;
+                }
+                if (countRight == 0)
+                {
+                    startRight = 0;
+                    offsetsRightBase = last;
+                }
+            }
+
+            // one side still has misplaced elements: move them to the boundary
+            if (countLeft)
+            {
+                while (countLeft--)
+                    std::iter_swap(offsetsLeftBase + offsetsLeft[startLeft + countLeft], --last);
+                first = last;
+            }
+            if (countRight)
+            {
+                while (countRight--)
+                {
+                    std::iter_swap(offsetsRightBase - offsetsRight[startRight + countRight], first);
+                    ++first;
+                }
+                last = first;
+            }
+        }
+
+        Iter pivotPosition{ first - 1 };
+        *begin = std::move(*pivotPosition);
+        *pivotPosition = std::move(pivot);
+        return { pivotPosition, alreadyPartitioned };
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ pdqsort ]============
+---------------------------------------------------------------------------------------*/
+
+namespace sorting
+{
+    namespace detail
+    {
+        template <bool Branchless, typename Iter, typename Compare>
+        void pdqsortLoop(Iter begin, Iter end, Compare compare, int badAllowed, bool leftmost = true)
+        {
+            while (true)
+            {
+                std::ptrdiff_t size{ end - begin };
+                if (size < g_insertionSortThreshold)
+                {
+                    if (leftmost)
+                        insertionSort(begin, end, compare);
+                    else
+                        unguardedInsertionSort(begin, end, compare);
+                    return;
+                }
+
+                // the pivot goes to *begin: median of 3, or the ninther (median of 3 medians of 3)
+                std::ptrdiff_t half{ size / 2 };
+                if (size > g_nintherThreshold)
+                {
+                    sort3(begin, begin + half, end - 1, compare);
+                    sort3(begin + 1, begin + (half - 1), end - 2, compare);
+                    sort3(begin + 2, begin + (half + 1), end - 3, compare);
+                    sort3(begin + (half - 1), begin + half, begin + (half + 1), compare);
+                    std::iter_swap(begin, begin + half);
+                }
+                else
+                    sort3(begin + half, begin, end - 1, compare);
+
+                // the element before the range is the pivot of an earlier partition, so it's
+                // <= everything here. if it's also >= the pivot, they're equal, and all the
+                // elements equal to it can be put on the left and never looked at again.
+                if (!leftmost && !compare(*(begin - 1), *begin))
+                {
+                    begin = partitionLeft(begin, end, compare) + 1;
+                    continue;
+                }
+
+                auto [pivotPosition, alreadyPartitioned]{ Branchless ? partitionRightBranchless(begin, end, compare)
+                                                                     : partitionRight(begin, end, compare) };
+
+                std::ptrdiff_t leftSize{ pivotPosition - begin };
+                std::ptrdiff_t rightSize{ end - (pivotPosition + 1) };
+
+                if (leftSize < size / 8 || rightSize < size / 8)
+                {
+                    // a bad partition. too many of them and we give up on quicksort...
+                    if (--badAllowed == 0)
+                    {
+                        std::make_heap(begin, end, compare);
+                        std::sort_heap(begin, end, compare);
+                        return;
+                    }
+
+                    // ...otherwise, shuffle a few elements around, to break whatever pattern
+                    // made the pivot bad
+                    if (leftSize >= g_insertionSortThreshold)
+                    {
+                        std::iter_swap(begin, begin + leftSize / 4);
+                        std::iter_swap(pivotPosition - 1, pivotPosition - leftSize / 4);
+                        if (leftSize > g_nintherThreshold)
+                        {
+                            std::iter_swap(begin + 1, begin + (leftSize / 4 + 1));
+                            std::iter_swap(begin + 2, begin + (leftSize / 4 + 2));
+                            std::iter_swap(pivotPosition - 2, pivotPosition - (leftSize / 4 + 1));
+                            std::iter_swap(pivotPosition - 3, pivotPosition - (leftSize / 4 + 2));
+                        }
+                    }
+
+                    if (rightSize >= g_insertionSortThreshold)
+                    {
+                        std::iter_swap(pivotPosition + 1, pivotPosition + (1 + rightSize / 4));
+                        std::iter_swap(end - 1, end - rightSize / 4);
+                        if (rightSize > g_nintherThreshold)
+                        {
+                            std::iter_swap(pivotPosition + 2, pivotPosition + (2 + rightSize / 4));
+                            std::iter_swap(pivotPosition + 3, pivotPosition + (3 + rightSize / 4));
+                            std::iter_swap(end - 2, end - (1 + rightSize / 4));
+                            std::iter_swap(end - 3, end - (2 + rightSize / 4));
+                        }
+                    }
+                }
+                else if (alreadyPartitioned && partialInsertionSort(begin, pivotPosition, compare)
+                         && partialInsertionSort(pivotPosition + 1, end, compare))
+                {
+                    // a good partition that didn't swap anything: the input may well be
+                    // sorted already, and a bounded insertion sort just proved it
+                    return;
+                }
+
+                // recurse into the left part, loop on the right part
+                pdqsortLoop<Branchless>(begin, pivotPosition, compare, badAllowed, leftmost);
+                begin = pivotPosition + 1;
+                leftmost = false;
+            }
+        }
+
+        template <typename T, typename Compare>
+        constexpr bool g_branchlessByDefault{
+            std::is_arithmetic_v<T>
+            && (std::is_same_v<Compare, std::less<T>> || std::is_same_v<Compare, std::less<>>
+                || std::is_same_v<Compare, std::greater<T>> || std::is_same_v<Compare, std::greater<>>)
+        };
+
+        template <typename Iter>
+        int badPartitionsAllowed(Iter begin, Iter end)
+        {
+            return static_cast<int>(std::bit_width(static_cast<std::size_t>(end - begin)));
+        }
+    }
+
+    // not stable, O(n log n) worst case, O(n) on sorted and reversed input. uses block
+    // partitioning when comparing arithmetic types with std::less/std::greater
+    template <typename Iter, typename Compare = std::less<>>
+    void pdqsort(Iter begin, Iter end, Compare compare = {})
+    {
+        using T = typename std::iterator_traits<Iter>::value_type;
+        if (end - begin < 2)
+            return;
+        detail::pdqsortLoop<detail::g_branchlessByDefault<T, Compare>>(begin, end, compare,
+                                                                       detail::badPartitionsAllowed(begin, end));
+    }
+
+    // the same, always with the branchy (Branchless = false) or the block partition
+    template <bool Branchless, typename Iter, typename Compare = std::less<>>
+    void pdqsortWith(Iter begin, Iter end, Compare compare = {})
+    {
+        if (end - begin < 2)
+            return;
+        detail::pdqsortLoop<Branchless>(begin, end, compare, detail::badPartitionsAllowed(begin, end));
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                          ============[ radix sort ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - the key of a signed integer is its bits with the sign bit flipped, which puts the
+    negative numbers (now 0xxx...) below the positive ones (now 1xxx...) as unsigned.
+  - one pass per byte, least significant first. every pass is a counting sort, which is
+    stable, so after the last pass the keys are sorted by all bytes.
+  - all histograms are counted in ONE pass over the input. if a byte has the same value in
+    every key (a histogram with one full bucket), that pass does nothing and is skipped.
+    sorting 32 bit values that are all below 65536 takes 2 passes, not 4.
+  - the passes go back and forth between [values] and a buffer of the same size, so the
+    extra memory is n elements. below a few hundred elements, clearing and reading the
+    histograms costs more than sorting (see the benchmark).
+*/
+
+namespace sorting
+{
+    template <typename T>
+        requires std::is_integral_v<T>
+    void radixSort(std::span<T> values)
+    {
+        using Key = std::make_unsigned_t<T>;
+        constexpr std::size_t passes{ sizeof(T) };
+        constexpr Key flip{ std::is_signed_v<T> ? static_cast<Key>(Key{ 1 } << (8 * sizeof(T) - 1)) : Key{ 0 } };
+
+        if (values.size() < 2)
+            return;
+
+        auto byteOf{ [](T value, std::size_t pass) {
+            return static_cast<std::size_t>((static_cast<Key>(static_cast<Key>(value) ^ flip) >> (8 * pass)) & 0xff);
+        } };
+
+        std::vector<std::array<std::size_t, 256>> counts(passes);
+        for (auto& histogram : counts)
+            histogram.fill(0);
+        for (T value : values)
+        {
+            for (std::size_t pass{ 0 }; pass < passes; ++pass)
+                ++counts[pass][byteOf(value, pass)];
+        }
+
+        std::vector<T> buffer(values.size());
+        std::span<T> from{ values };
+        std::span<T> to{ buffer };
+
+        for (std::size_t pass{ 0 }; pass < passes; ++pass)
+        {
+            auto& histogram{ counts[pass] };
+            if (histogram[byteOf(from[0], pass)] == values.size())
+                continue;
+
+            // counts -> where each bucket starts
+            std::size_t offset{ 0 };
+            for (std::size_t& count : histogram)
+                offset += std::exchange(count, offset);
+
+            for (T value : from)
+                to[histogram[byteOf(value, pass)]++] = value;
+            std::swap(from, to);
+        }
+
+        if (from.data() != values.data())
+            std::copy(from.begin(), from.end(), values.begin());
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ adaptive merge sort ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - the input is cut into runs: maximal stretches that are already ascending, or strictly
+    descending (those are reversed in place; strictly, so that reversing stays stable).
+    runs shorter than minRun (32 to 64) are extended with insertion sort.
+  - runs go on a stack, and are merged as soon as the lengths on top of it stop shrinking
+    fast enough (timsort's rules, with the fix from "Proving that Android's, Java's and
+    Python's sorting algorithm is broken"). that keeps merges balanced, so O(n log n).
+  - a merge first skips what's already in place: the part of the left run that is <= the
+    first of the right run, and the part of the right run that is >= the last of the left
+    run. if nothing's left, there's nothing to merge at all, which is what makes sorted
+    and nearly sorted input cheap. then the shorter side is moved to a buffer.
+*/
+
+namespace sorting
+{
+    namespace detail
+    {
+        inline std::size_t minimumRun(std::size_t size)
+        {
+            std::size_t lowBits{ 0 };
+            while (size >= 64)
+            {
+                lowBits |= size & 1;
+                size >>= 1;
+            }
+            return size + lowBits;
+        }
+
+        // merges the sorted [begin, middle) and [middle, end), stable
+        template <typename Iter, typename Compare, typename Buffer>
+        void mergeRuns(Iter begin, Iter middle, Iter end, Compare compare, Buffer& buffer)
+        {
+            if (!compare(*middle, *(middle - 1)))
+                return;
+
+            begin = std::upper_bound(begin, middle, *middle, compare);
+            end = std::lower_bound(middle, end, *(middle - 1), compare);
+
+            if (middle - begin <= end - middle)
+            {
+                // the left side goes to the buffer, and we merge forwards
+                buffer.assign(std::make_move_iterator(begin), std::make_move_iterator(middle));
+                auto left{ buffer.begin() };
+                Iter right{ middle };
+                Iter out{ begin };
+                while (left != buffer.end() && right != end)
+                    *out++ = compare(*right, *left) ? std::move(*right++) : std::move(*left++);
+                std::move(left, buffer.end(), out);
+            }
+            else
+            {
+                // the right side goes to the buffer, and we merge backwards
+                buffer.assign(std::make_move_iterator(middle), std::make_move_iterator(end));
+                auto right{ buffer.end() };
+                Iter left{ middle };
+                Iter out{ end };
+                while (right != buffer.begin() && left != begin)
+                    *--out = compare(*(right - 1), *(left - 1)) ? std::move(*--left) : std::move(*--right);
+                std::move_backward(buffer.begin(), right, out);
+            }
+        }
+    }
+
+    template <typename Iter, typename Compare = std::less<>>
+    void adaptiveMergeSort(Iter begin, Iter end, Compare compare = {})
+    {
+        using T = typename std::iterator_traits<Iter>::value_type;
+        const std::size_t size{ static_cast<std::size_t>(end - begin) };
+        if (size < 2)
+            return;
+
+        struct Run
+        {
+            std::size_t start{};
+            std::size_t length{};
+        };
+
+        const std::size_t minRun{ detail::minimumRun(size) };
+        std::vector<Run> runs{};
+        std::vector<T> buffer{};
+
+        auto merge{ [&](std::size_t i) {
+            Run& left{ runs[i] };
+            const Run& right{ runs[i + 1] };
+            detail::mergeRuns(begin + static_cast<std::ptrdiff_t>(left.start), begin + static_cast<std::ptrdiff_t>(right.start),
+                              begin + static_cast<std::ptrdiff_t>(right.start + right.length), compare, buffer);
+            left.length += right.length;
+            runs.erase(runs.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+        } };
+
+        for (std::size_t start{ 0 }; start < size;)
+        {
+            Iter first{ begin + static_cast<std::ptrdiff_t>(start) };
+            Iter runEnd{ first + 1 };
+            if (runEnd != end && compare(*runEnd, *first))
+            {
+                while (runEnd != end && compare(*runEnd, *(runEnd - 1)))
+                    ++runEnd;
+                std::reverse(first, runEnd);
+            }
+            else
+            {
+                while (runEnd != end && !compare(*runEnd, *(runEnd - 1)))
+                    ++runEnd;
+            }
+
+            std::size_t length{ static_cast<std::size_t>(runEnd - first) };
+            if (length < minRun)
+            {
+                length = std::min(minRun, size - start);
+                detail::insertionSort(first, first + static_cast<std::ptrdiff_t>(length), compare);
+            }
+
+            runs.push_back({ start, length });
+            start += length;
+
+            while (runs.size() > 1)
+            {
+                std::size_t n{ runs.size() - 2 };
+                if ((n > 0 && runs[n - 1].length <= runs[n].length + runs[n + 1].length)
+                    || (n > 1 && runs[n - 2].length <= runs[n - 1].length + runs[n].length))
+                {
+                    if (runs[n - 1].length < runs[n + 1].length)
+                        --n;
+                    merge(n);
+                }
+                else if (runs[n].length <= runs[n + 1].length)
+                    merge(n);
+                else
+                    break;
+            }
+        }
+
+        while (runs.size() > 1)
+        {
+            std::size_t n{ runs.size() - 2 };
+            if (n > 0 && runs[n - 1].length < runs[n + 1].length)
+                --n;
+            merge(n);
+        }
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                        ============[ inputs and checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <random>
+
+namespace inputs
+{
+    enum class Pattern
+    {
+        random,
+        sorted,
+        reversed,
+        nearlySorted,       // sorted, then 1% of the elements swapped with random others
+        organPipe,          // ascending, then descending
+        fewUnique,          // 16 distinct values
+
+        maxPatterns,
+    };
+
+    constexpr const char* g_patternNames[]{ "random", "sorted", "reversed", "nearly sorted", "organ pipe", "few unique" };
+
+    std::vector<std::int32_t> make(Pattern pattern, std::size_t size, std::mt19937_64& mt)
+    {
+        std::vector<std::int32_t> values(size);
+        switch (pattern)
+        {
+        case Pattern::random:
+            for (auto& value : values)
+                value = static_cast<std::int32_t>(mt());
+            break;
+        case Pattern::sorted:
+        case Pattern::nearlySorted:
+            for (std::size_t i{ 0 }; i < size; ++i)
+                values[i] = static_cast<std::int32_t>(i);
+            if (pattern == Pattern::nearlySorted)
+            {
+                for (std::size_t i{ 0 }; i < size / 100; ++i)
+                    std::swap(values[mt() % size], values[mt() % size]);
+            }
+            break;
+        case Pattern::reversed:
+            for (std::size_t i{ 0 }; i < size; ++i)
+                values[i] = static_cast<std::int32_t>(size - i);
+            break;
+        case Pattern::organPipe:
+            for (std::size_t i{ 0 }; i < size; ++i)
+                values[i] = static_cast<std::int32_t>(i < size / 2 ? i : size - i);
+            break;
+        case Pattern::fewUnique:
+            for (auto& value : values)
+                value = static_cast<std::int32_t>(mt() % 16) - 8;
+            break;
+        default:
+            break;
+        }
+        return values;
+    }
+}
+
+namespace checks
+{
+    void main()
+    {
+        std::mt19937_64 mt{ 41 };
+        int failures{ 0 };
+
+        for (int p{ 0 }; p < static_cast<int>(inputs::Pattern::maxPatterns); ++p)
+        {
+            for (std::size_t size : { 0, 1, 2, 3, 23, 24, 25, 127, 128, 129, 1000, 4096, 100'000 })
+            {
+                auto values{ inputs::make(static_cast<inputs::Pattern>(p), size, mt) };
+                auto expected{ values };
+                std::sort(expected.begin(), expected.end());
+
+                auto check{ [&](auto sort) {
+                    auto copy{ values };
+                    sort(copy);
+                    failures += copy != expected;
+                } };
+
+                check([](auto& v) { sorting::pdqsort(v.begin(), v.end()); });
+                check([](auto& v) { sorting::pdqsortWith<false>(v.begin(), v.end()); });
+                check([](auto& v) { sorting::pdqsortWith<true>(v.begin(), v.end()); });
+                check([](auto& v) { sorting::radixSort(std::span{ v }); });
+                check([](auto& v) { sorting::adaptiveMergeSort(v.begin(), v.end()); });
+
+                // descending, through the comparison
+                auto descending{ values };
+                sorting::pdqsort(descending.begin(), descending.end(), std::greater<>{});
+                failures += !std::is_sorted(descending.begin(), descending.end(), std::greater<>{});
+            }
+        }
+
+        // other types: strings (never branchless), and every width and signedness of radix keys
+        std::vector<std::string> words{};
+        for (int i{ 0 }; i < 5000; ++i)
+            words.push_back(std::to_string(mt() % 1000));
+        auto sortedWords{ words };
+        std::sort(sortedWords.begin(), sortedWords.end());
+        auto pdqWords{ words };
+        sorting::pdqsort(pdqWords.begin(), pdqWords.end());
+        sorting::adaptiveMergeSort(words.begin(), words.end());
+        failures += pdqWords != sortedWords || words != sortedWords;
+
+        auto checkRadix{ [&]<typename T>(T) {
+            std::vector<T> values(3000);
+            for (T& value : values)
+                value = static_cast<T>(mt());
+            auto expected{ values };
+            std::sort(expected.begin(), expected.end());
+            sorting::radixSort(std::span{ values });
+            failures += values != expected;
+        } };
+        checkRadix(std::int8_t{});
+        checkRadix(std::uint16_t{});
+        checkRadix(std::int64_t{});
+        checkRadix(std::uint64_t{});
+
+        // the merge sort is stable: sort (key, position) pairs by key only, positions must stay in order
+        for (int p{ 0 }; p < static_cast<int>(inputs::Pattern::maxPatterns); ++p)
+        {
+            auto keys{ inputs::make(static_cast<inputs::Pattern>(p), 50'000, mt) };
+            std::vector<std::pair<std::int32_t, std::size_t>> pairs(keys.size());
+            for (std::size_t i{ 0 }; i < keys.size(); ++i)
+                pairs[i] = { keys[i] % 100, i };
+            sorting::adaptiveMergeSort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            failures += !std::is_sorted(pairs.begin(), pairs.end());
+        }
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// ns per element for every pattern, size and sort. small sizes are sorted many times over
+// (a fresh copy each time) so that every cell sorts about the same number of elements.
+
+// the full matrix goes up to 10^8, which needs about 1.2 GB and a lot of patience; the
+// default stops at 10^7.
+
+#include <chrono>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_largestSize{ 10'000'000 };
+    constexpr std::size_t g_elementsPerCell{ 2'000'000 };
+
+    using Values = std::vector<std::int32_t>;
+
+    struct Algorithm
+    {
+        const char* name{};
+        void (*sort)(Values::iterator, Values::iterator);
+    };
+
+    constexpr Algorithm g_algorithms[]{
+        { "std::sort",   [](auto b, auto e) { std::sort(b, e); } },
+        { "std::stable", [](auto b, auto e) { std::stable_sort(b, e); } },
+        { "pdq",         [](auto b, auto e) { sorting::pdqsortWith<false>(b, e); } },
+        { "pdq block",   [](auto b, auto e) { sorting::pdqsortWith<true>(b, e); } },
+        { "radix",       [](auto b, auto e) { sorting::radixSort(std::span{ b, e }); } },
+        { "merge",       [](auto b, auto e) { sorting::adaptiveMergeSort(b, e); } },
+    };
+
+    void main()
+    {
+        std::mt19937_64 mt{ 13 };
+
+        std::cout << std::fixed << std::setprecision(1) << std::setw(14) << "input" << std::setw(10) << "size";
+        for (const Algorithm& algorithm : g_algorithms)
+            std::cout << std::setw(12) << algorithm.name;
+        std::cout << "   fastest\n";
+
+        for (int p{ 0 }; p < static_cast<int>(inputs::Pattern::maxPatterns); ++p)
+        {
+            for (std::size_t size{ 10 }; size <= g_largestSize; size *= 10)
+            {
+                // [copies] independent inputs of [size] elements, back to back
+                std::size_t copies{ std::max<std::size_t>(1, g_elementsPerCell / size) };
+                Values original{};
+                original.reserve(size * copies);
+                for (std::size_t c{ 0 }; c < copies; ++c)
+                {
+                    auto input{ inputs::make(static_cast<inputs::Pattern>(p), size, mt) };
+                    original.insert(original.end(), input.begin(), input.end());
+                }
+
+                std::cout << std::setw(14) << inputs::g_patternNames[p] << std::setw(10) << size;
+
+                Values work{};
+                double best{ 1e300 };
+                const char* fastest{ "" };
+                for (const Algorithm& algorithm : g_algorithms)
+                {
+                    work = original;
+                    Timer t;
+                    for (std::size_t c{ 0 }; c < copies; ++c)
+                    {
+                        auto first{ work.begin() + static_cast<std::ptrdiff_t>(c * size) };
+                        algorithm.sort(first, first + static_cast<std::ptrdiff_t>(size));
+                    }
+                    double nanoseconds{ t.elapsed() / static_cast<double>(copies * size) * 1e9 };
+
+                    if (!std::is_sorted(work.begin(), work.begin() + static_cast<std::ptrdiff_t>(size)))
+                        std::cout << " (unsorted!)";
+                    std::cout << std::setw(12) << nanoseconds;
+                    if (nanoseconds < best)
+                    {
+                        best = nanoseconds;
+                        fastest = algorithm.name;
+                    }
+                }
+                std::cout << "   " << fastest << '\n';
+            }
+        }
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
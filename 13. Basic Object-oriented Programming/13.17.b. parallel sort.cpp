@@ -0,0 +1,503 @@
+#include <iostream>
+#include <vector>
+#include <span>
+#include <deque>
+#include <functional>       // std::function, std::less
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>        // std::sort, std::stable_sort, std::upper_bound
+#include <random>
+#include <cstdint>
+#include <cstddef>          // std::size_t
+
+
+// every sort in 13.17 (and 13.17.a) runs on one core. this is a parallel SAMPLESORT:
+
+//  1. pick a random sample of the input, sort it, and take evenly spaced elements of it as
+//     SPLITTERS. k splitters cut the values into buckets of about the same size.
+//  2. split the input into blocks, one task per block: find the bucket of every element
+//     (a binary search over the splitters), write it down, and count the elements per
+//     (block, bucket).
+//  3. prefix sums over the counts give every (block, bucket) its place in the output, so
+//     the blocks can all move their elements into a buffer at the same time, without locks.
+//  4. one task per bucket: sort it (with std::sort or std::stable_sort), and copy it back.
+
+// - inputs with few distinct values would put everything into a few huge buckets. so if a
+//   value appears more than once among the splitters, it gets an EQUALITY BUCKET of its own:
+//   a bucket of equal elements doesn't need sorting at all.
+// - step 3 keeps the elements of a bucket in their original order, so with std::stable_sort
+//   in step 4 the whole sort is stable. the policy picks which one is used.
+// - the tasks run on a small thread pool. the thread that called the sort works too: while
+//   it waits for a group of tasks, it runs tasks from the queue.
+// - below a cutoff (or with 1 thread) it's just std::sort/std::stable_sort.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                          ============[ thread pool ]============
+---------------------------------------------------------------------------------------*/
+
+namespace parallel
+{
+    class ThreadPool
+    {
+    private:
+        std::deque<std::function<void()>> m_tasks{};
+        std::mutex m_mutex{};
+        std::condition_variable m_wake{};
+        bool m_stopping{ false };
+        std::vector<std::jthread> m_workers{};
+
+        void work()
+        {
+            while (true)
+            {
+                std::function<void()> task{};
+                {
+                    std::unique_lock lock{ m_mutex };
+                    m_wake.wait(lock, [&] { return m_stopping || !m_tasks.empty(); });
+                    if (m_tasks.empty())
+                        return;
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        // [threads] counts the thread that will wait for the tasks, so it starts threads - 1
+        explicit ThreadPool(unsigned threads)
+        {
+            for (unsigned i{ 1 }; i < threads; ++i)
+                m_workers.emplace_back([this] { work(); });
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard lock{ m_mutex };
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned threads() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+        void submit(std::function<void()> task)
+        {
+            {
+                std::lock_guard lock{ m_mutex };
+                m_tasks.push_back(std::move(task));
+            }
+            m_wake.notify_one();
+        }
+
+        // runs one queued task on the calling thread, if there is one
+        bool runOne()
+        {
+            std::function<void()> task{};
+            {
+                std::lock_guard lock{ m_mutex };
+                if (m_tasks.empty())
+                    return false;
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            task();
+            return true;
+        }
+    };
+
+    // a set of tasks to wait for. the tasks must not throw.
+    class TaskGroup
+    {
+    private:
+        ThreadPool& m_pool;
+        std::size_t m_pending{ 0 };
+        std::mutex m_mutex{};
+        std::condition_variable m_done{};
+
+    public:
+        explicit TaskGroup(ThreadPool& pool)
+            : m_pool{ pool }
+        {
+        }
+
+        ~TaskGroup() { wait(); }
+
+        template <typename Fn>
+        void run(Fn fn)
+        {
+            {
+                std::lock_guard lock{ m_mutex };
+                ++m_pending;
+            }
+
+            // notifying while holding the lock: once wait() sees 0, the group may be destroyed
+            m_pool.submit([this, fn = std::move(fn)] {
+                fn();
+                std::lock_guard lock{ m_mutex };
+                if (--m_pending == 0)
+                    m_done.notify_all();
+            });
+        }
+
+        // helps with the queue while waiting, so a pool of 1 thread (the caller) still works
+        void wait()
+        {
+            while (m_pool.runOne())
+                ;
+
+            std::unique_lock lock{ m_mutex };
+            m_done.wait(lock, [&] { return m_pending == 0; });
+        }
+    };
+
+    // fn(i) for i in [0, count), one task each, and waits
+    template <typename Fn>
+    void forEachIndex(ThreadPool& pool, std::size_t count, Fn fn)
+    {
+        TaskGroup group{ pool };
+        for (std::size_t i{ 0 }; i < count; ++i)
+            group.run([&fn, i] { fn(i); });
+        group.wait();
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ samplesort ]============
+---------------------------------------------------------------------------------------*/
+
+namespace parallel
+{
+    enum class Stability
+    {
+        unstable,
+        stable,
+    };
+
+    struct SortOptions
+    {
+        unsigned threads{ std::max(std::thread::hardware_concurrency(), 1u) };
+        Stability stability{ Stability::unstable };
+        std::size_t sequentialCutoff{ 1 << 16 };       // fewer elements than that: sort sequentially
+    };
+
+    namespace detail
+    {
+        constexpr std::size_t g_maxSplitters{ 127 };         // so that 2 * 127 + 1 buckets fit in a byte
+        constexpr std::size_t g_oversampling{ 32 };
+        constexpr std::size_t g_blocksPerThread{ 4 };
+
+        template <typename T, typename Compare>
+        void sortSequential(std::span<T> values, Compare& compare, Stability stability)
+        {
+            if (stability == Stability::stable)
+                std::stable_sort(values.begin(), values.end(), compare);
+            else
+                std::sort(values.begin(), values.end(), compare);
+        }
+    }
+
+    template <typename T, typename Compare = std::less<>>
+    void sort(ThreadPool& pool, std::span<T> values, Compare compare = {}, Stability stability = Stability::unstable,
+              std::size_t sequentialCutoff = SortOptions{}.sequentialCutoff)
+    {
+        const std::size_t size{ values.size() };
+        const unsigned threads{ pool.threads() };
+        if (threads == 1 || size < std::max<std::size_t>(sequentialCutoff, 2))
+        {
+            detail::sortSequential(values, compare, stability);
+            return;
+        }
+
+        // 1. splitters, from a sorted random sample (duplicates removed, each one remembers
+        //    whether it was duplicated: that's what gets an equality bucket)
+        const std::size_t wanted{ std::min<std::size_t>(detail::g_maxSplitters, 8 * std::size_t{ threads } - 1) };
+        std::vector<T> sample{};
+        {
+            std::mt19937_64 mt{ size };
+            std::size_t sampleSize{ std::min(size, (wanted + 1) * detail::g_oversampling) };
+            sample.reserve(sampleSize);
+            for (std::size_t i{ 0 }; i < sampleSize; ++i)
+                sample.push_back(values[mt() % size]);
+            std::sort(sample.begin(), sample.end(), compare);
+        }
+
+        std::vector<T> splitters{};
+        std::vector<char> repeated{};
+        for (std::size_t i{ 1 }; i <= wanted; ++i)
+        {
+            const T& candidate{ sample[i * sample.size() / (wanted + 1)] };
+            if (!splitters.empty() && !compare(splitters.back(), candidate))
+                repeated.back() = true;
+            else
+            {
+                splitters.push_back(candidate);
+                repeated.push_back(false);
+            }
+        }
+
+        // bucket 2j holds the values between splitter j - 1 and j, bucket 2j - 1 the values
+        // equal to splitter j - 1 (it stays empty unless that splitter was repeated)
+        const std::size_t bucketCount{ 2 * splitters.size() + 1 };
+        auto bucketOf{ [&](const T& value) -> std::uint8_t {
+            std::size_t j{ static_cast<std::size_t>(std::upper_bound(splitters.begin(), splitters.end(), value, compare)
+                                                    - splitters.begin()) };
+            bool equal{ j > 0 && repeated[j - 1] && !compare(splitters[j - 1], value) };
+            return static_cast<std::uint8_t>(2 * j - equal);
+        } };
+
+        // 2. classify and count, block by block
+        const std::size_t blocks{ std::min<std::size_t>(size, std::size_t{ threads } * detail::g_blocksPerThread) };
+        auto blockBegin{ [&](std::size_t block) { return block * size / blocks; } };
+
+        std::vector<std::uint8_t> buckets(size);
+        std::vector<std::size_t> counts(blocks * bucketCount, 0);
+        forEachIndex(pool, blocks, [&](std::size_t block) {
+            std::size_t* count{ counts.data() + block * bucketCount };
+            for (std::size_t i{ blockBegin(block) }; i < blockBegin(block + 1); ++i)
+            {
+                buckets[i] = bucketOf(values[i]);
+                ++count[buckets[i]];
+            }
+        });
+
+        // 3. where every (block, bucket) starts: bucket by bucket, and block by block within a
+        //    bucket, so the original order is kept inside every bucket
+        std::vector<std::size_t> bucketStarts(bucketCount + 1, 0);
+        std::vector<std::size_t> offsets(blocks * bucketCount);
+        {
+            std::size_t offset{ 0 };
+            for (std::size_t bucket{ 0 }; bucket < bucketCount; ++bucket)
+            {
+                bucketStarts[bucket] = offset;
+                for (std::size_t block{ 0 }; block < blocks; ++block)
+                {
+                    offsets[block * bucketCount + bucket] = offset;
+                    offset += counts[block * bucketCount + bucket];
+                }
+            }
+            bucketStarts[bucketCount] = offset;
+        }
+
+        std::vector<T> buffer(size);
+        forEachIndex(pool, blocks, [&](std::size_t block) {
+            std::size_t* offset{ offsets.data() + block * bucketCount };
+            for (std::size_t i{ blockBegin(block) }; i < blockBegin(block + 1); ++i)
+                buffer[offset[buckets[i]]++] = std::move(values[i]);
+        });
+
+        // 4. sort the buckets (biggest first, so a big one doesn't start last) and copy them back
+        std::vector<std::size_t> order(bucketCount);
+        for (std::size_t i{ 0 }; i < bucketCount; ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return bucketStarts[a + 1] - bucketStarts[a] > bucketStarts[b + 1] - bucketStarts[b];
+        });
+
+        forEachIndex(pool, bucketCount, [&](std::size_t i) {
+            std::size_t bucket{ order[i] };
+            std::span<T> part{ buffer.data() + bucketStarts[bucket], bucketStarts[bucket + 1] - bucketStarts[bucket] };
+            if (bucket % 2 == 0)
+                detail::sortSequential(part, compare, stability);
+            std::move(part.begin(), part.end(), values.begin() + static_cast<std::ptrdiff_t>(bucketStarts[bucket]));
+        });
+    }
+
+    // the same, on a pool of options.threads that lives for this call only
+    template <typename T, typename Compare = std::less<>>
+    void sort(std::span<T> values, Compare compare = {}, SortOptions options = {})
+    {
+        if (options.threads <= 1 || values.size() < options.sequentialCutoff)
+        {
+            detail::sortSequential(values, compare, options.stability);
+            return;
+        }
+
+        ThreadPool pool{ options.threads };
+        sort(pool, values, compare, options.stability, options.sequentialCutoff);
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <string>
+
+namespace checks
+{
+    void main()
+    {
+        std::mt19937_64 mt{ 42 };
+        int failures{ 0 };
+
+        for (unsigned threads : { 1u, 2u, 3u, 8u })
+        {
+            parallel::ThreadPool pool{ threads };
+            for (std::size_t size : { 0, 1, 1000, 70'000, 300'001 })
+            {
+                // random, few unique, all equal, sorted
+                for (int pattern{ 0 }; pattern < 4; ++pattern)
+                {
+                    std::vector<std::int64_t> values(size);
+                    for (std::size_t i{ 0 }; i < size; ++i)
+                    {
+                        values[i] = pattern == 0 ? static_cast<std::int64_t>(mt()) : pattern == 1 ? static_cast<std::int64_t>(mt() % 5)
+                                  : pattern == 2 ? 7 : static_cast<std::int64_t>(i);
+                    }
+                    auto expected{ values };
+                    std::sort(expected.begin(), expected.end());
+
+                    parallel::sort(pool, std::span{ values }, std::less<>{}, parallel::Stability::unstable, 1024);
+                    failures += values != expected;
+                }
+
+                // stability: (key, position) pairs sorted by key only
+                std::vector<std::pair<int, std::size_t>> pairs(size);
+                for (std::size_t i{ 0 }; i < size; ++i)
+                    pairs[i] = { static_cast<int>(mt() % 1000), i };
+                parallel::sort(pool, std::span{ pairs }, [](const auto& a, const auto& b) { return a.first < b.first; },
+                               parallel::Stability::stable, 1024);
+                failures += !std::is_sorted(pairs.begin(), pairs.end());
+            }
+        }
+
+        // a type that isn't trivial, through the one-call interface
+        std::vector<std::string> words(100'000);
+        for (auto& word : words)
+            word = std::to_string(mt() % 50'000);
+        auto expected{ words };
+        std::sort(expected.begin(), expected.end());
+        parallel::sort(std::span{ words }, std::less<>{}, { 4, parallel::Stability::unstable, 1000 });
+        failures += words != expected;
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// strong scaling: the same input sorted with 1, 2, 4... threads, up to all of them. the
+// speedup is against std::sort. 10^7, 10^8 and 10^9 elements: 10^9 64-bit elements need
+// about 17 GB (the input, a buffer of the same size, and a byte per element), so the sizes that
+// don't fit in the machine's memory are skipped. (every run refills the input from the same
+// seed instead of copying a saved original, which would take another 8 GB.)
+
+#include <chrono>
+#include <unistd.h>     // sysconf
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_sizes[]{ 10'000'000, 100'000'000, 1'000'000'000 };
+
+    std::size_t physicalMemory()
+    {
+        long pages{ ::sysconf(_SC_PHYS_PAGES) };
+        long pageSize{ ::sysconf(_SC_PAGE_SIZE) };
+        return pages > 0 && pageSize > 0 ? static_cast<std::size_t>(pages) * static_cast<std::size_t>(pageSize) : 0;
+    }
+
+    void fill(std::vector<std::uint64_t>& values, std::uint64_t seed)
+    {
+        std::mt19937_64 mt{ seed };
+        for (auto& value : values)
+            value = mt();
+    }
+
+    void main()
+    {
+        const unsigned cores{ std::max(std::thread::hardware_concurrency(), 1u) };
+        std::vector<unsigned> threadCounts{};
+        for (unsigned t{ 1 }; t < cores; t *= 2)
+            threadCounts.push_back(t);
+        threadCounts.push_back(cores);
+
+        std::cout << "(" << cores << " hardware threads)\n";
+
+        for (std::size_t size : g_sizes)
+        {
+            std::size_t needed{ size * (2 * sizeof(std::uint64_t) + 1) };
+            if (needed > physicalMemory())
+            {
+                std::cout << size << " random uint64: skipped, needs about " << (needed >> 30) << " GiB of memory, the machine has "
+                          << (physicalMemory() >> 30) << " GiB\n";
+                continue;
+            }
+
+            const std::uint64_t seed{ size };
+            std::vector<std::uint64_t> values(size);
+            fill(values, seed);
+            Timer t;
+            std::sort(values.begin(), values.end());
+            double sequential{ t.elapsed() };
+            std::cout << size << " random uint64, std::sort: " << sequential << " s\n";
+
+            for (parallel::Stability stability : { parallel::Stability::unstable, parallel::Stability::stable })
+            {
+                for (unsigned threads : threadCounts)
+                {
+                    fill(values, seed);
+                    t.reset();
+                    parallel::sort(std::span{ values }, std::less<>{}, { threads, stability });
+                    double seconds{ t.elapsed() };
+
+                    std::cout << "  " << (stability == parallel::Stability::stable ? "stable  " : "unstable") << ", "
+                              << threads << " thread(s): " << seconds << " s, speedup " << sequential / seconds
+                              << (std::is_sorted(values.begin(), values.end()) ? "" : " (unsorted!)") << '\n';
+                }
+            }
+        }
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
@@ -0,0 +1,661 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <algorithm>        // std::sort, std::min
+#include <concepts>         // std::integral, std::floating_point
+#include <type_traits>
+#include <bit>              // std::bit_cast, std::bit_width
+#include <limits>
+#include <utility>          // std::move
+#include <cstring>          // std::memcmp
+#include <cstdint>
+#include <cstddef>          // std::size_t
+
+
+// 14.7 ends with an operator< for Car that sorts by make, and then by model. every call of that
+// operator< compares up to two pairs of strings, and std::sort calls it about n log n times,
+// each time from the first byte of each field again. with more fields ("ORDER BY make,
+// year DESC, price") the comparator becomes a chain of ifs, one per field, some reversed.
+
+// the trick databases use: encode the whole key of a record, once, into a single string of
+// bytes whose plain memcmp() order is the order we want. sorting is then sorting byte strings:
+// no per-field logic, no branches on field types, and nothing to follow but one buffer.
+    // - unsigned ints: big endian (the most significant byte has to be compared first)
+    // - signed ints: big endian with the sign bit flipped, so negatives come before positives
+    // - floats: the IEEE bits, with the sign bit flipped for positives and all bits flipped
+    //   for negatives (a more negative float has a larger magnitude). -0.0 becomes 0.0, and
+    //   every NaN the same NaN, after +infinity
+    // - strings: the bytes, with 0x00 escaped as 0x00 0xFF and a 0x00 0x00 terminator, so a
+    //   string sorts before every longer string that starts with it, and whatever comes after
+    //   it in the key is never compared against the string's own bytes
+    // - descending fields: the same bytes, all flipped
+// the keys also work as std::string keys (std::string compares like memcmp), e.g. in a
+// std::map or a sorted vector that we binary search: that's an index.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ encoding keys ]============
+---------------------------------------------------------------------------------------*/
+
+namespace sort_key
+{
+    enum class Order
+    {
+        ascending,
+        descending,
+    };
+
+    // appends the encoded fields of one key to a string
+    class KeyBuilder
+    {
+    private:
+        std::string& m_out;
+
+        void put(unsigned char byte, Order order)
+        {
+            m_out.push_back(static_cast<char>(order == Order::ascending ? byte : static_cast<unsigned char>(~byte)));
+        }
+
+        void putBigEndian(std::uint64_t value, std::size_t bytes, Order order)
+        {
+            for (std::size_t i{ bytes }; i-- > 0;)
+                put(static_cast<unsigned char>(value >> (8 * i)), order);
+        }
+
+    public:
+        explicit KeyBuilder(std::string& out)
+            : m_out{ out }
+        {
+        }
+
+        KeyBuilder& add(std::string_view value, Order order = Order::ascending)
+        {
+            // the string is copied in pieces between its zeros (usually: in one piece)
+            std::size_t start{ m_out.size() };
+            for (std::size_t from{ 0 };;)
+            {
+                std::size_t zero{ value.find('\0', from) };
+                if (zero == std::string_view::npos)
+                {
+                    m_out.append(value.substr(from));
+                    break;
+                }
+                m_out.append(value.substr(from, zero + 1 - from));
+                m_out.push_back('\xFF');
+                from = zero + 1;
+            }
+            m_out.append(2, '\0');
+
+            if (order == Order::descending)
+            {
+                for (std::size_t i{ start }; i < m_out.size(); ++i)
+                    m_out[i] = static_cast<char>(~m_out[i]);
+            }
+            return *this;
+        }
+
+        // (std::make_unsigned_t<bool> is ill-formed, so bool gets its own overload)
+        KeyBuilder& add(bool value, Order order = Order::ascending)
+        {
+            put(value ? 1 : 0, order);
+            return *this;
+        }
+
+        template <std::integral T>
+            requires (!std::same_as<T, bool>)
+        KeyBuilder& add(T value, Order order = Order::ascending)
+        {
+            using Unsigned = std::make_unsigned_t<T>;
+            auto bits{ static_cast<std::uint64_t>(static_cast<Unsigned>(value)) };
+            if constexpr (std::is_signed_v<T>)
+                bits ^= std::uint64_t{ 1 } << (8 * sizeof(T) - 1);
+            putBigEndian(bits, sizeof(T), order);
+            return *this;
+        }
+
+        template <std::floating_point T>
+            requires (sizeof(T) == 4 || sizeof(T) == 8)
+        KeyBuilder& add(T value, Order order = Order::ascending)
+        {
+            using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+            constexpr Bits signBit{ Bits{ 1 } << (8 * sizeof(T) - 1) };
+
+            if (value == 0)
+                value = 0;
+            else if (value != value)
+                value = std::numeric_limits<T>::quiet_NaN();
+
+            auto bits{ std::bit_cast<Bits>(value) };
+            bits = (bits & signBit) ? static_cast<Bits>(~bits) : static_cast<Bits>(bits | signBit);
+            putBigEndian(bits, sizeof(T), order);
+            return *this;
+        }
+    };
+
+    // the bytes compared as unsigned chars, like memcmp, then the shorter first
+    inline bool less(std::string_view a, std::string_view b)
+    {
+        int result{ std::memcmp(a.data(), b.data(), std::min(a.size(), b.size())) };
+        return result != 0 ? result < 0 : a.size() < b.size();
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                  ============[ keys for a whole table ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  KeyTable builds the key of every record once, all into one buffer, with
+  encode(KeyBuilder&, const Record&). order() then sorts the records' indices by key. since the
+  keys are plain byte strings, that's a job for a string sort: 8 bytes of each key are cached
+  big endian in a uint64 next to the index, records with equal bytes move on to the next 8,
+  and no byte of a key is compared twice (almost).
+
+  sortByKey(records, encode) builds the table, and moves the records into that order.
+*/
+
+namespace sort_key
+{
+    class KeyTable
+    {
+    private:
+        struct Entry
+        {
+            std::uint64_t head{};       // the first 8 bytes of the key, zero padded
+            std::size_t index{};
+        };
+
+        static constexpr std::size_t s_smallRange{ 32 };
+
+        std::string m_bytes{};
+        std::vector<std::size_t> m_offsets{ 0 };   // key i is m_bytes[m_offsets[i], m_offsets[i + 1])
+
+        // 8 bytes of the key from depth on, big endian, zero padded
+        static std::uint64_t head(std::string_view key, std::size_t depth)
+        {
+            std::uint64_t value{ 0 };
+            for (std::size_t k{ depth }; k < depth + 8; ++k)
+                value = (value << 8) | (k < key.size() ? static_cast<unsigned char>(key[k]) : 0);
+            return value;
+        }
+
+        // a multikey quicksort on the cached heads (as in the string sort of the chapter 11
+        // quiz_2.a): all the keys in [begin, end) are equal up to depth, equal heads go on 8
+        // bytes deeper, and the std::sort of small ranges compares from depth on. [budget]
+        // limits the recursion into the lower and upper parts: when bad pivots have used it
+        // up, the range is left to std::sort too, like introsort does.
+        void sortRange(Entry* begin, Entry* end, std::size_t depth, int budget) const
+        {
+            while (static_cast<std::size_t>(end - begin) > s_smallRange && budget > 0)
+            {
+                std::uint64_t a{ begin->head };
+                std::uint64_t b{ begin[(end - begin) / 2].head };
+                std::uint64_t c{ end[-1].head };
+                std::uint64_t pivot{ std::max(std::min(a, b), std::min(std::max(a, b), c)) };
+
+                Entry* lower{ begin };
+                Entry* upper{ end };
+                for (Entry* entry{ begin }; entry < upper;)
+                {
+                    if (entry->head < pivot)
+                        std::swap(*entry++, *lower++);
+                    else if (entry->head > pivot)
+                        std::swap(*entry, *--upper);
+                    else
+                        ++entry;
+                }
+
+                sortRange(begin, lower, depth, budget - 1);
+                sortRange(upper, end, depth, budget - 1);
+
+                // keys that end within these 8 bytes are done: they only differ by length
+                Entry* unfinished{ std::partition(lower, upper, [&](const Entry& entry) { return (*this)[entry.index].size() <= depth + 8; }) };
+                std::sort(lower, unfinished, [&](const Entry& x, const Entry& y) { return (*this)[x.index].size() < (*this)[y.index].size(); });
+
+                begin = unfinished;
+                end = upper;
+                depth += 8;
+                for (Entry* entry{ begin }; entry != end; ++entry)
+                    entry->head = head((*this)[entry->index], depth);
+            }
+
+            std::sort(begin, end, [&](const Entry& x, const Entry& y) {
+                if (x.head != y.head)
+                    return x.head < y.head;
+                std::string_view keyX{ (*this)[x.index] };
+                std::string_view keyY{ (*this)[y.index] };
+                return less(keyX.substr(std::min(depth, keyX.size())), keyY.substr(std::min(depth, keyY.size())));
+            });
+        }
+
+    public:
+        template <typename Record, typename Encode>
+        KeyTable(std::span<const Record> records, Encode encode)
+        {
+            m_offsets.reserve(records.size() + 1);
+            KeyBuilder builder{ m_bytes };
+            for (const auto& record : records)
+            {
+                encode(builder, record);
+                m_offsets.push_back(m_bytes.size());
+            }
+        }
+
+        std::size_t size() const { return m_offsets.size() - 1; }
+
+        std::string_view operator[](std::size_t index) const
+        {
+            return std::string_view{ m_bytes }.substr(m_offsets[index], m_offsets[index + 1] - m_offsets[index]);
+        }
+
+        // the indices of the records, sorted by key
+        std::vector<std::size_t> order() const
+        {
+            std::vector<Entry> entries(size());
+            for (std::size_t i{ 0 }; i < entries.size(); ++i)
+                entries[i] = { head((*this)[i], 0), i };
+
+            sortRange(entries.data(), entries.data() + entries.size(), 0, 2 * static_cast<int>(std::bit_width(entries.size())));
+
+            std::vector<std::size_t> indices(entries.size());
+            for (std::size_t i{ 0 }; i < entries.size(); ++i)
+                indices[i] = entries[i].index;
+            return indices;
+        }
+    };
+
+    template <typename Record, typename Encode>
+    void sortByKey(std::span<Record> records, Encode encode)
+    {
+        KeyTable keys{ std::span<const Record>{ records }, encode };
+
+        std::vector<Record> sorted;
+        sorted.reserve(records.size());
+        for (std::size_t index : keys.order())
+            sorted.push_back(std::move(records[index]));
+        std::move(sorted.begin(), sorted.end(), records.begin());
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                          ============[ Car ]============
+---------------------------------------------------------------------------------------*/
+
+namespace example
+{
+    class Car
+    {
+    private:
+        std::string m_make{};
+        std::string m_model{};
+
+    public:
+        Car(std::string_view make, std::string_view model)
+            : m_make{ make }, m_model{ model }
+        {
+        }
+
+        const std::string& make() const { return m_make; }
+        const std::string& model() const { return m_model; }
+
+        // sort by make, then by model (the operator< 14.7 talks about)
+        friend bool operator<(const Car& c1, const Car& c2)
+        {
+            if (c1.m_make != c2.m_make)
+                return c1.m_make < c2.m_make;
+            return c1.m_model < c2.m_model;
+        }
+
+        // the same order, as a key
+        friend void encodeKey(sort_key::KeyBuilder& key, const Car& car)
+        {
+            key.add(car.m_make).add(car.m_model);
+        }
+    };
+
+    // a used car listing: ORDER BY make, year DESC, price
+    struct Listing
+    {
+        Car car;
+        int year{};
+        double price{};
+    };
+
+    void encodeListing(sort_key::KeyBuilder& key, const Listing& listing)
+    {
+        key.add(listing.car.make())
+           .add(listing.year, sort_key::Order::descending)
+           .add(listing.price);
+    }
+
+    void main()
+    {
+        std::vector<Car> cars{
+            { "Toyota", "Corolla" }, { "Toyota", "Camry" }, { "Honda", "Civic" }, { "Honda", "Accord" }, { "BMW", "3" },
+        };
+        sort_key::sortByKey(std::span{ cars }, [](sort_key::KeyBuilder& key, const Car& car) { encodeKey(key, car); });
+        for (const auto& car : cars)
+            std::cout << car.make() << ' ' << car.model() << '\n';
+        std::cout << '\n';
+
+        std::vector<Listing> listings{
+            { { "Toyota", "Camry" }, 2019, 18'500.0 }, { { "Honda", "Civic" }, 2021, 21'000.0 },
+            { { "Toyota", "Corolla" }, 2021, 19'990.0 }, { { "Honda", "Accord" }, 2021, 20'500.0 },
+            { { "Toyota", "Camry" }, 2021, 17'250.0 }, { { "Honda", "Civic" }, 2015, 9'800.0 },
+        };
+        sort_key::sortByKey(std::span{ listings }, encodeListing);
+        for (const auto& listing : listings)
+            std::cout << listing.car.make() << ' ' << listing.car.model() << ", " << listing.year << ", $" << listing.price << '\n';
+        std::cout << '\n';
+
+        // the keys as an index: which listings are Hondas from 2021? all the keys that start with
+        // the key of ("Honda", 2021), in a sorted vector of keys
+        sort_key::KeyTable keys{ std::span<const Listing>{ listings }, encodeListing };
+        std::vector<std::string_view> index;
+        for (std::size_t i{ 0 }; i < keys.size(); ++i)
+            index.push_back(keys[i]);
+        std::sort(index.begin(), index.end(), sort_key::less);
+
+        std::string prefix;
+        sort_key::KeyBuilder{ prefix }.add("Honda").add(2021, sort_key::Order::descending);
+        auto first{ std::lower_bound(index.begin(), index.end(), std::string_view{ prefix }, sort_key::less) };
+        std::size_t count{ 0 };
+        for (auto it{ first }; it != index.end() && it->starts_with(prefix); ++it)
+            ++count;
+        std::cout << count << " Hondas from 2021\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+#include <random>
+#include <array>
+#include <tuple>
+
+namespace checks
+{
+    struct Row
+    {
+        std::string name{};
+        std::int16_t small{};
+        std::int64_t big{};
+        std::uint32_t count{};
+        float ratio{};
+        double value{};
+    };
+
+    // the comparator version of: ORDER BY name DESC, small, big DESC, count, ratio DESC, value
+    bool rowLess(const Row& a, const Row& b)
+    {
+        return std::tuple{ b.name, a.small, b.big, a.count, b.ratio, a.value }
+             < std::tuple{ a.name, b.small, a.big, b.count, a.ratio, b.value };
+    }
+
+    void encodeRow(sort_key::KeyBuilder& key, const Row& row)
+    {
+        key.add(row.name, sort_key::Order::descending)
+           .add(row.small)
+           .add(row.big, sort_key::Order::descending)
+           .add(row.count)
+           .add(row.ratio, sort_key::Order::descending)
+           .add(row.value);
+    }
+
+    std::string keyOf(const Row& row)
+    {
+        std::string key;
+        sort_key::KeyBuilder builder{ key };
+        encodeRow(builder, row);
+        return key;
+    }
+
+    // the values of 8 byte keys (so the heads are the values) that make the median of 3 pick
+    // the second smallest head as the pivot every time: the "gas" adversary from the chapter 11
+    // quiz_2.a, run on the same partitioning, here for ranges of any size
+    std::vector<std::uint64_t> quicksortKiller(std::size_t count)
+    {
+        constexpr std::uint64_t gas{ ~std::uint64_t{ 0 } };
+        std::vector<std::uint64_t> value(count, gas);
+        std::uint64_t nextSolid{ 0 };
+
+        std::vector<std::size_t> order(count);
+        for (std::size_t i{ 0 }; i < count; ++i)
+            order[i] = i;
+
+        std::vector<std::pair<std::size_t, std::size_t>> ranges{ { 0, count } };
+        while (!ranges.empty())
+        {
+            auto [begin, end]{ ranges.back() };
+            ranges.pop_back();
+            if (end - begin <= 1)
+                continue;
+
+            std::size_t middle{ begin + (end - begin) / 2 };
+            for (std::size_t candidate : { begin, middle })
+            {
+                if (value[order[candidate]] == gas)
+                    value[order[candidate]] = nextSolid++;
+            }
+            std::uint64_t a{ value[order[begin]] };
+            std::uint64_t b{ value[order[middle]] };
+            std::uint64_t c{ value[order[end - 1]] };
+            std::uint64_t pivot{ std::max(std::min(a, b), std::min(std::max(a, b), c)) };
+
+            std::size_t lower{ begin };
+            std::size_t upper{ end };
+            for (std::size_t entry{ begin }; entry < upper;)
+            {
+                if (value[order[entry]] < pivot)
+                    std::swap(order[entry++], order[lower++]);
+                else if (value[order[entry]] > pivot)
+                    std::swap(order[entry], order[--upper]);
+                else
+                    ++entry;
+            }
+            ranges.push_back({ begin, lower });
+            ranges.push_back({ upper, end });
+        }
+
+        for (auto& v : value)
+        {
+            if (v == gas)
+                v = nextSolid++;
+        }
+        return value;
+    }
+
+    void main()
+    {
+        std::mt19937 mt{ 45 };
+        int failures{ 0 };
+
+        // few distinct values per field, so that the later fields decide often; strings that
+        // are prefixes of each other and contain zeros; the extremes of every type
+        auto pick{ [&](auto... values) {
+            std::array all{ values... };
+            return all[mt() % all.size()];
+        } };
+
+        std::vector<Row> rows(5'000);
+        for (auto& row : rows)
+        {
+            row.name = pick(std::string{}, std::string{ "a" }, std::string{ "ab" }, std::string{ "a\0", 2 },
+                            std::string{ "a\0b", 3 }, std::string{ "\xff" }, std::string{ "b" });
+            row.small = pick(std::int16_t{ -32768 }, std::int16_t{ -1 }, std::int16_t{ 0 }, std::int16_t{ 1 }, std::int16_t{ 32767 });
+            row.big = pick(std::numeric_limits<std::int64_t>::min(), std::int64_t{ -5 }, std::int64_t{ 7 },
+                           std::numeric_limits<std::int64_t>::max());
+            row.count = pick(0u, 1u, 256u, 0xFFFF'FFFFu);
+            row.ratio = pick(-std::numeric_limits<float>::infinity(), -1.5f, -0.0f, 0.0f, 1e-40f, 2.5f,
+                             std::numeric_limits<float>::infinity());
+            row.value = pick(-1e300, -2.0, 0.0, 3.25, 1e300);
+        }
+
+        // every pair of keys compares like the comparator
+        for (int i{ 0 }; i < 200'000; ++i)
+        {
+            const Row& a{ rows[mt() % rows.size()] };
+            const Row& b{ rows[mt() % rows.size()] };
+            failures += (keyOf(a) < keyOf(b)) != rowLess(a, b);
+        }
+
+        // and sorting by key gives the same order as sorting with the comparator
+        auto expected{ rows };
+        std::stable_sort(expected.begin(), expected.end(), rowLess);
+        sort_key::sortByKey(std::span{ rows }, encodeRow);
+        for (std::size_t i{ 0 }; i < rows.size(); ++i)
+            failures += keyOf(rows[i]) != keyOf(expected[i]);
+
+        // bool fields: false before true, and the other way around when descending
+        auto boolKey{ [](bool value, sort_key::Order order) {
+            std::string key;
+            sort_key::KeyBuilder{ key }.add(value, order);
+            return key;
+        } };
+        failures += !(boolKey(false, sort_key::Order::ascending) < boolKey(true, sort_key::Order::ascending));
+        failures += !(boolKey(true, sort_key::Order::descending) < boolKey(false, sort_key::Order::descending));
+        failures += boolKey(true, sort_key::Order::ascending).size() != 1;
+
+        // bad pivots every time: without a limit, that's one level of recursion per 2 records
+        auto killer{ quicksortKiller(20'000) };
+        auto sortedKiller{ killer };
+        std::sort(sortedKiller.begin(), sortedKiller.end());
+        sort_key::sortByKey(std::span{ killer }, [](sort_key::KeyBuilder& key, std::uint64_t value) { key.add(value); });
+        failures += killer != sortedKiller;
+
+        // NaN: after +infinity, whatever its sign
+        failures += !(keyOf({ .value = std::numeric_limits<double>::infinity() }) < keyOf({ .value = -std::numeric_limits<double>::quiet_NaN() }));
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// 1'000'000 Cars and 1'000'000 Listings sorted with std::sort and a comparator, and with
+// sortByKey (which includes building the keys, and moving the records into place)
+
+#include <chrono>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_records{ 1'000'000 };
+
+    constexpr std::array<std::array<std::string_view, 4>, 6> g_models{ {
+        { "Toyota", "Corolla", "Camry", "RAV4" },
+        { "Honda", "Civic", "Accord", "CR-V" },
+        { "Volkswagen", "Golf", "Passat", "Tiguan" },
+        { "Mercedes-Benz", "C-Class", "E-Class", "GLC" },
+        { "Mercedes-AMG", "C 63", "E 63", "GT" },
+        { "BMW", "3 Series", "5 Series", "X3" },
+    } };
+
+    void main()
+    {
+        using example::Car;
+        using example::Listing;
+
+        std::mt19937 mt{ 3 };
+        std::vector<Listing> listings;
+        listings.reserve(g_records);
+        for (std::size_t i{ 0 }; i < g_records; ++i)
+        {
+            const auto& maker{ g_models[mt() % g_models.size()] };
+            // trims, so that the models share long prefixes: "Camry LE 2.5 Hybrid 412"
+            std::string model{ std::string{ maker[1 + mt() % 3] } + " Trim " + std::to_string(mt() % 1000) };
+            listings.push_back({ Car{ maker[0], model }, 2000 + static_cast<int>(mt() % 25), static_cast<double>(mt() % 5'000'000) / 100.0 });
+        }
+
+        std::vector<Car> original;
+        original.reserve(g_records);
+        for (const auto& listing : listings)
+            original.push_back(listing.car);
+
+        std::cout << "Cars (make, model):\n";
+        auto cars{ original };
+        Timer t;
+        std::sort(cars.begin(), cars.end());
+        std::cout << "    std::sort, operator<  : " << t.elapsed() << " s\n";
+
+        cars = original;
+        t.reset();
+        sort_key::sortByKey(std::span{ cars }, [](sort_key::KeyBuilder& key, const Car& car) { encodeKey(key, car); });
+        std::cout << "    sortByKey             : " << t.elapsed() << " s\n";
+
+        std::cout << "Listings (make, year DESC, price):\n";
+        auto sorted{ listings };
+        t.reset();
+        std::sort(sorted.begin(), sorted.end(), [](const Listing& a, const Listing& b) {
+            if (a.car.make() != b.car.make())
+                return a.car.make() < b.car.make();
+            if (a.year != b.year)
+                return a.year > b.year;
+            return a.price < b.price;
+        });
+        std::cout << "    std::sort, comparator : " << t.elapsed() << " s\n";
+
+        sorted = listings;
+        t.reset();
+        sort_key::sortByKey(std::span{ sorted }, example::encodeListing);
+        std::cout << "    sortByKey             : " << t.elapsed() << " s\n";
+
+        // often the order is all we need (to print, to page through), not the moved records
+        t.reset();
+        sort_key::KeyTable keys{ std::span<const Listing>{ listings }, example::encodeListing };
+        auto order{ keys.order() };
+        std::cout << "    KeyTable::order()     : " << t.elapsed() << " s\n";
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    example::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
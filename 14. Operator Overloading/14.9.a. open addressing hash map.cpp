@@ -0,0 +1,623 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>           // std::unique_ptr
+#include <utility>          // std::pair, std::move
+#include <algorithm>
+#include <bit>              // std::countr_zero, std::bit_ceil
+#include <cstring>          // std::memcpy, std::memset
+#include <cstdint>
+#include <cstddef>          // std::size_t
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+// the GradeMap in the 14.9 quiz looks up a name with std::find_if over a std::vector, so every
+// access compares the name against every student: O(n).
+
+// the usual fix is a hash table: turn the key into a number (the hash), and use that number to
+// jump (almost) directly to the right slot. std::unordered_map does this, but it allocates a
+// node for every element and chains colliding elements in linked lists, so a lookup still
+// chases pointers all over memory.
+
+// in this file we write a "flat" hash map in the style of Google's Swiss tables:
+    // - all elements live in one array of slots (open addressing, no nodes)
+    // - a second array of one-byte "control" values tells, for every slot, whether it's empty
+    //   and, if not, 7 bits of the element's hash
+    // - lookups compare 16 control bytes at once with SSE2, and only compare the actual keys
+    //   for the (very few) slots whose 7 hash bits match
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                   ============[ a fast hash for strings ]============
+---------------------------------------------------------------------------------------*/
+
+// std::hash<std::string> is fine, but not especially fast on short strings. this one reads the
+// string 8 bytes at a time and mixes them with a 64x64 -> 128 bit multiplication (the same
+// idea as wyhash). short strings are read with two overlapping loads, so there's no loop
+// and no per-byte work at all.
+
+namespace flat_map
+{
+    namespace detail
+    {
+        __extension__ using uint128 = unsigned __int128;
+
+        inline std::uint64_t mix(std::uint64_t a, std::uint64_t b)
+        {
+            uint128 product{ static_cast<uint128>(a) * b };
+            return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+        }
+
+        inline std::uint64_t read8(const char* p)
+        {
+            std::uint64_t value{};
+            std::memcpy(&value, p, 8);
+            return value;
+        }
+
+        inline std::uint64_t read4(const char* p)
+        {
+            std::uint32_t value{};
+            std::memcpy(&value, p, 4);
+            return value;
+        }
+    }
+
+    inline std::uint64_t hashString(std::string_view str)
+    {
+        constexpr std::uint64_t k0{ 0xA0761D6478BD642FULL };
+        constexpr std::uint64_t k1{ 0xE7037ED1A0B428DBULL };
+        constexpr std::uint64_t k2{ 0x8EBC6AF09C88C6E3ULL };
+
+        const char* p{ str.data() };
+        std::size_t length{ str.size() };
+        std::uint64_t seed{ k0 ^ length };
+
+        while (length > 16)
+        {
+            seed = detail::mix(detail::read8(p) ^ k1, detail::read8(p + 8) ^ seed);
+            p += 16;
+            length -= 16;
+        }
+
+        std::uint64_t a{};
+        std::uint64_t b{};
+        if (length >= 8)
+        {
+            a = detail::read8(p);
+            b = detail::read8(p + length - 8);
+        }
+        else if (length >= 4)
+        {
+            a = detail::read4(p);
+            b = detail::read4(p + length - 4);
+        }
+        else if (length > 0)
+        {
+            a = (static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) << 16)
+              | (static_cast<std::uint64_t>(static_cast<unsigned char>(p[length / 2])) << 8)
+              | static_cast<std::uint64_t>(static_cast<unsigned char>(p[length - 1]));
+        }
+
+        return detail::mix(detail::mix(a ^ k1, b ^ seed), str.size() ^ k2);
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                  ============[ control bytes and group probing ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - the hash is split in two parts:
+        H1 (the high bits) picks the slot where we start looking
+        H2 (the low 7 bits) is stored in the control byte of the slot the element ends up in
+
+  - a control byte is either s_empty (0x80, the high bit set) or an H2 value (0 to 127).
+
+  - to look up a key, we load the 16 control bytes starting at its H1 slot and compare them all
+    with H2 at once. that gives a 16-bit mask of candidate slots. a byte that is s_empty means
+    the key can't be any further, so we can stop.
+
+  - the control array has 16 extra bytes at the end that mirror the first 16, so a group that
+    wraps around the end of the table can still be loaded with one instruction.
+*/
+
+namespace flat_map
+{
+    namespace detail
+    {
+        constexpr std::int8_t s_empty{ static_cast<std::int8_t>(0x80) };
+        constexpr std::size_t s_groupWidth{ 16 };
+
+        // a 16-bit mask with one bit per control byte
+        struct BitMask
+        {
+            std::uint32_t bits{};
+
+            explicit operator bool() const { return bits != 0; }
+            int lowest() const { return std::countr_zero(bits); }
+            void removeLowest() { bits &= bits - 1; }
+        };
+
+        struct Group
+        {
+#if defined(__SSE2__)
+            __m128i ctrl{};
+
+            explicit Group(const std::int8_t* p)
+                : ctrl{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) }
+            {
+            }
+
+            BitMask match(std::int8_t h2) const
+            {
+                return { static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2)))) };
+            }
+
+            BitMask matchEmpty() const
+            {
+                // s_empty is the only control value with the high bit set
+                return { static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl)) };
+            }
+#else
+            std::int8_t ctrl[s_groupWidth]{};
+
+            explicit Group(const std::int8_t* p)
+            {
+                std::memcpy(ctrl, p, s_groupWidth);
+            }
+
+            BitMask match(std::int8_t h2) const
+            {
+                std::uint32_t bits{ 0 };
+                for (std::size_t i{ 0 }; i < s_groupWidth; ++i)
+                    bits |= static_cast<std::uint32_t>(ctrl[i] == h2) << i;
+                return { bits };
+            }
+
+            BitMask matchEmpty() const
+            {
+                return match(s_empty);
+            }
+#endif
+        };
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                 ============[ the map, and deleting without tombstones ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - we probe LINEARLY, one slot at a time (we just check 16 of them per step). an element
+    always sits in the first empty slot at or after its H1 slot at the time it was inserted.
+
+  - most open-addressing tables mark erased slots as "deleted" (a tombstone) because simply
+    emptying the slot could cut a probe sequence in half. tombstones pile up over time and make
+    lookups slower until the table is rebuilt.
+
+  - with linear probing we can do better: "backward shift deletion". after emptying a slot, we
+    look at the elements after it, and move back every one whose H1 slot allows it to live in
+    the hole. the table then looks exactly as if the erased element had never been inserted.
+*/
+
+namespace flat_map
+{
+    template <typename T>
+    class FlatStringMap
+    {
+    private:
+        using slot_type = std::pair<std::string, T>;
+
+        static constexpr std::size_t s_minCapacity{ 16 };
+
+        std::unique_ptr<std::int8_t[]> m_ctrl{};
+        std::unique_ptr<slot_type[]> m_slots{};
+        std::size_t m_capacity{ 0 };         // always a power of 2 (or 0)
+        std::size_t m_size{ 0 };
+
+        std::size_t mask() const { return m_capacity - 1; }
+        static std::size_t h1(std::uint64_t hash) { return static_cast<std::size_t>(hash >> 7); }
+        static std::int8_t h2(std::uint64_t hash) { return static_cast<std::int8_t>(hash & 0x7F); }
+
+        bool isFull(std::size_t index) const { return m_ctrl[index] >= 0; }
+
+        void setCtrl(std::size_t index, std::int8_t value)
+        {
+            m_ctrl[index] = value;
+
+            // keep the mirrored copy of the first group up to date
+            if (index < detail::s_groupWidth)
+                m_ctrl[m_capacity + index] = value;
+        }
+
+        // the index of key's slot, or m_capacity if it isn't in the map
+        std::size_t findIndex(std::string_view key, std::uint64_t hash) const
+        {
+            if (m_capacity == 0)
+                return 0;
+
+            std::size_t position{ h1(hash) & mask() };
+            auto tag{ h2(hash) };
+
+            while (true)
+            {
+                detail::Group group{ m_ctrl.get() + position };
+
+                for (auto candidates{ group.match(tag) }; candidates; candidates.removeLowest())
+                {
+                    std::size_t index{ (position + static_cast<std::size_t>(candidates.lowest())) & mask() };
+                    if (m_slots[index].first == key)
+                        return index;
+                }
+
+                if (group.matchEmpty())
+                    return m_capacity;
+
+                position = (position + detail::s_groupWidth) & mask();
+            }
+        }
+
+        // the first empty slot at or after the H1 slot of hash
+        std::size_t findEmpty(std::uint64_t hash) const
+        {
+            std::size_t position{ h1(hash) & mask() };
+            while (true)
+            {
+                detail::Group group{ m_ctrl.get() + position };
+                if (auto empty{ group.matchEmpty() })
+                    return (position + static_cast<std::size_t>(empty.lowest())) & mask();
+
+                position = (position + detail::s_groupWidth) & mask();
+            }
+        }
+
+        void rehash(std::size_t newCapacity)
+        {
+            auto oldCtrl{ std::move(m_ctrl) };
+            auto oldSlots{ std::move(m_slots) };
+            std::size_t oldCapacity{ m_capacity };
+
+            m_capacity = newCapacity;
+            m_ctrl = std::make_unique<std::int8_t[]>(m_capacity + detail::s_groupWidth);
+            m_slots = std::make_unique<slot_type[]>(m_capacity);
+            std::memset(m_ctrl.get(), static_cast<unsigned char>(detail::s_empty), m_capacity + detail::s_groupWidth);
+
+            for (std::size_t i{ 0 }; i < oldCapacity; ++i)
+            {
+                if (oldCtrl[i] < 0)
+                    continue;
+
+                auto hash{ hashString(oldSlots[i].first) };
+                std::size_t index{ findEmpty(hash) };
+                setCtrl(index, h2(hash));
+                m_slots[index] = std::move(oldSlots[i]);
+            }
+        }
+
+        std::size_t insertIndex(std::string_view key)
+        {
+            auto hash{ hashString(key) };
+
+            std::size_t index{ findIndex(key, hash) };
+            if (index != m_capacity && m_capacity != 0)
+                return index;
+
+            // keep at least 1/8 of the slots empty so probe sequences stay short
+            if ((m_size + 1) * 8 > m_capacity * 7)
+                rehash(std::max(s_minCapacity, m_capacity * 2));
+
+            index = findEmpty(hash);
+            setCtrl(index, h2(hash));
+            m_slots[index].first.assign(key);
+            ++m_size;
+            return index;
+        }
+
+    public:
+        FlatStringMap() = default;
+
+        explicit FlatStringMap(std::size_t expectedSize)
+        {
+            reserve(expectedSize);
+        }
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        std::size_t capacity() const { return m_capacity; }
+
+        void reserve(std::size_t count)
+        {
+            std::size_t needed{ std::bit_ceil(std::max(s_minCapacity, count * 8 / 7 + 1)) };
+            if (needed > m_capacity)
+                rehash(needed);
+        }
+
+        // lookups take a std::string_view, so looking up a string literal or a part of a
+        // bigger string never creates a temporary std::string
+        T* find(std::string_view key)
+        {
+            std::size_t index{ findIndex(key, hashString(key)) };
+            return index < m_capacity ? &m_slots[index].second : nullptr;
+        }
+
+        const T* find(std::string_view key) const
+        {
+            std::size_t index{ findIndex(key, hashString(key)) };
+            return index < m_capacity ? &m_slots[index].second : nullptr;
+        }
+
+        bool contains(std::string_view key) const
+        {
+            return find(key) != nullptr;
+        }
+
+        // like std::map::operator[]: inserts a default value if key isn't there yet.
+        // note that the reference is only valid until the next insertion (which may rehash).
+        T& operator[](std::string_view key)
+        {
+            return m_slots[insertIndex(key)].second;
+        }
+
+        bool erase(std::string_view key)
+        {
+            std::size_t hole{ findIndex(key, hashString(key)) };
+            if (hole >= m_capacity)
+                return false;
+
+            // backward shift: move later elements of the same probe run into the hole
+            std::size_t current{ (hole + 1) & mask() };
+            while (isFull(current))
+            {
+                std::size_t home{ h1(hashString(m_slots[current].first)) & mask() };
+
+                // can the element at [current] live at [hole]? only if [hole] lies cyclically
+                // between its home slot and [current]
+                if (((current - home) & mask()) >= ((current - hole) & mask()))
+                {
+                    m_slots[hole] = std::move(m_slots[current]);
+                    setCtrl(hole, m_ctrl[current]);
+                    hole = current;
+                }
+                current = (current + 1) & mask();
+            }
+
+            m_slots[hole] = slot_type{};
+            setCtrl(hole, detail::s_empty);
+            --m_size;
+            return true;
+        }
+
+        template <typename Fn>
+        void forEach(Fn&& fn) const
+        {
+            for (std::size_t i{ 0 }; i < m_capacity; ++i)
+                if (isFull(i))
+                    fn(std::string_view{ m_slots[i].first }, m_slots[i].second);
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ GradeMap, revisited ]============
+---------------------------------------------------------------------------------------*/
+
+namespace quiz
+{
+    class GradeMap
+    {
+    private:
+        flat_map::FlatStringMap<char> m_map{};
+
+    public:
+        char& operator[](std::string_view name)
+        {
+            return m_map[name];
+        }
+
+        bool remove(std::string_view name)
+        {
+            return m_map.erase(name);
+        }
+    };
+
+    void main()
+    {
+        GradeMap grades{};
+
+        grades["Joe"] = 'A';
+        grades["Frank"] = 'B';
+
+        std::cout << "Joe has a grade of " << grades["Joe"] << '\n';
+        std::cout << "Frank has a grade of " << grades["Frank"] << '\n';
+
+        std::cout << std::boolalpha << "Removed Joe: " << grades.remove("Joe") << '\n';
+        std::cout << "Removed Joe again: " << grades.remove("Joe") << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+// random inserts and erases, compared against std::unordered_map
+
+#include <unordered_map>
+#include <random>
+
+namespace checks
+{
+    void main()
+    {
+        std::mt19937 mt{ 3 };
+        flat_map::FlatStringMap<int> ours{};
+        std::unordered_map<std::string, int> reference{};
+
+        bool ok{ true };
+        for (int i{ 0 }; i < 200'000 && ok; ++i)
+        {
+            std::string key{ "key" + std::to_string(mt() % 5000) };
+
+            if (mt() % 3 == 0)
+                ok = (ours.erase(key) == (reference.erase(key) == 1));
+            else
+            {
+                int value{ static_cast<int>(mt()) };
+                ours[key] = value;
+                reference[key] = value;
+            }
+
+            ok = ok && ours.size() == reference.size();
+        }
+
+        for (const auto& [key, value] : reference)
+            ok = ok && ours.find(key) && *ours.find(key) == value;
+
+        std::cout << std::boolalpha << "matches std::unordered_map: " << ok << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <map>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    // the original GradeMap from 14.9
+    class VectorGradeMap
+    {
+    private:
+        std::vector<std::pair<std::string, char>> m_map{};
+
+    public:
+        char& operator[](std::string_view name)
+        {
+            auto found{ std::find_if(m_map.begin(), m_map.end(), [name](const auto& a) { return name == a.first; }) };
+            if (found != m_map.end())
+                return found->second;
+
+            m_map.push_back({ std::string{ name }, char{} });
+            return m_map.back().second;
+        }
+    };
+
+    std::vector<std::string> makeNames(std::size_t count)
+    {
+        std::mt19937 mt{ 9 };
+        std::vector<std::string> names{};
+        for (std::size_t i{ 0 }; i < count; ++i)
+        {
+            std::string name(5 + mt() % 10, ' ');
+            for (char& ch : name)
+                ch = static_cast<char>('a' + mt() % 26);
+            names.push_back(name);
+        }
+        return names;
+    }
+
+    // fills the map with every name, then looks each one up [rounds] times
+    template <typename Map, typename Lookup>
+    double run(const std::vector<std::string>& names, int rounds, Lookup lookup)
+    {
+        Map map{};
+        for (const auto& name : names)
+            lookup(map, name) = 'A';
+
+        Timer t;
+        long sum{ 0 };
+        for (int round{ 0 }; round < rounds; ++round)
+            for (const auto& name : names)
+                sum += lookup(map, std::string_view{ name });
+        double time{ t.elapsed() };
+
+        if (sum == 0)
+            std::cout << '?';
+        return time / static_cast<double>(names.size() * static_cast<std::size_t>(rounds)) * 1e9;
+    }
+
+    void main()
+    {
+        for (std::size_t count : { 100, 10'000, 1'000'000 })
+        {
+            auto names{ makeNames(count) };
+            int rounds{ static_cast<int>(2'000'000 / count) + 1 };
+
+            std::cout << count << " names (ns per lookup):";
+
+            if (count <= 10'000)
+                std::cout << "  GradeMap(vector) " << run<VectorGradeMap>(names, std::max(1, rounds / 100),
+                    [](VectorGradeMap& map, std::string_view name) -> char& { return map[name]; });
+
+            std::cout << "  std::map " << run<std::map<std::string, char, std::less<>>>(names, rounds,
+                [](auto& map, std::string_view name) -> char& {
+                    auto found{ map.find(name) };
+                    return found != map.end() ? found->second : map[std::string{ name }]; });
+
+            std::cout << "  std::unordered_map " << run<std::unordered_map<std::string, char>>(names, rounds,
+                [](auto& map, std::string_view name) -> char& { return map[std::string{ name }]; });
+
+            std::cout << "  FlatStringMap " << run<flat_map::FlatStringMap<char>>(names, rounds,
+                [](auto& map, std::string_view name) -> char& { return map[name]; });
+
+            std::cout << '\n';
+        }
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    quiz::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
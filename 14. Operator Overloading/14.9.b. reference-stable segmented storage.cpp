@@ -0,0 +1,564 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <new>              // ::operator new, std::align_val_t
+#include <memory>           // std::destroy_at
+#include <utility>          // std::forward
+#include <iterator>
+#include <type_traits>      // std::conditional_t
+#include <stdexcept>        // std::out_of_range
+#include <cstddef>          // std::size_t
+
+
+// the GradeMap quiz in 14.9 has this warning in it: "std::vector will add a copy of your
+// StudentGrade to itself (resizing if needed, invalidating all previously returned references)".
+
+// std::vector keeps its elements in ONE contiguous block. when that block is full, it
+// allocates a bigger one, MOVES every element over, and frees the old one. any reference or
+// pointer we got from operator[] or back() before that now dangles.
+
+// std::deque doesn't move its elements, but its block size is small and fixed by the library
+// (512 bytes in libstdc++), and its iterators are slow-ish.
+
+// in this file we write a segmented vector:
+    // - elements live in blocks of 2^n elements. a full block is never touched again, we
+    //   simply allocate the next one. so elements NEVER move, and references stay valid for
+    //   as long as the container lives (or until that element is popped).
+    // - because every block has the same power-of-two size, element i is at
+    //   blocks[i >> n][i & (2^n - 1)]: a shift, a mask and one load.
+    // - appending is O(1): no copying, ever.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ the segmented vector ]============
+---------------------------------------------------------------------------------------*/
+
+namespace segmented
+{
+    template <typename T, unsigned BlockBits = 10>
+    class SegmentedVector
+    {
+    private:
+        static constexpr std::size_t s_blockSize{ std::size_t{ 1 } << BlockBits };
+        static constexpr std::size_t s_blockMask{ s_blockSize - 1 };
+
+        // one pointer per block, plus a nullptr at the end (the iterators rely on it)
+        std::vector<T*> m_blocks{ nullptr };
+        std::size_t m_size{ 0 };
+
+        static T* allocateBlock()
+        {
+            return static_cast<T*>(::operator new(s_blockSize * sizeof(T), std::align_val_t{ alignof(T) }));
+        }
+
+        static void freeBlock(T* block)
+        {
+            ::operator delete(block, std::align_val_t{ alignof(T) });
+        }
+
+        std::size_t blockCount() const { return m_blocks.size() - 1; }
+
+        // the address the next element goes to, allocating a block if needed
+        T* nextSlot()
+        {
+            std::size_t block{ m_size >> BlockBits };
+            if (block == blockCount())
+            {
+                m_blocks.back() = allocateBlock();
+                m_blocks.push_back(nullptr);
+            }
+            return m_blocks[block] + (m_size & s_blockMask);
+        }
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = T&;
+        using const_reference = const T&;
+
+        static constexpr std::size_t blockSize() { return s_blockSize; }
+
+        SegmentedVector() = default;
+
+        // copying would have to copy every element anyway, and the point of this container
+        // is references into it, so we don't allow it
+        SegmentedVector(const SegmentedVector&) = delete;
+        SegmentedVector& operator=(const SegmentedVector&) = delete;
+
+        // moving steals the blocks: references stay valid, they now belong to the new container
+        SegmentedVector(SegmentedVector&& other) noexcept
+            : m_blocks{ std::exchange(other.m_blocks, { nullptr }) }
+            , m_size{ std::exchange(other.m_size, 0) }
+        {
+        }
+
+        SegmentedVector& operator=(SegmentedVector&& other) noexcept
+        {
+            if (this != &other)
+            {
+                clear();
+                for (T* block : m_blocks)
+                    freeBlock(block);
+                m_blocks = std::exchange(other.m_blocks, { nullptr });
+                m_size = std::exchange(other.m_size, 0);
+            }
+            return *this;
+        }
+
+        ~SegmentedVector()
+        {
+            clear();
+            for (T* block : m_blocks)
+                freeBlock(block);       // ::operator delete(nullptr) is fine
+        }
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        std::size_t capacity() const { return blockCount() * s_blockSize; }
+
+        T& operator[](std::size_t index) { return m_blocks[index >> BlockBits][index & s_blockMask]; }
+        const T& operator[](std::size_t index) const { return m_blocks[index >> BlockBits][index & s_blockMask]; }
+
+        T& at(std::size_t index)
+        {
+            if (index >= m_size)
+                throw std::out_of_range{ "SegmentedVector::at" };
+            return (*this)[index];
+        }
+
+        const T& at(std::size_t index) const
+        {
+            if (index >= m_size)
+                throw std::out_of_range{ "SegmentedVector::at" };
+            return (*this)[index];
+        }
+
+        T& back() { return (*this)[m_size - 1]; }
+        const T& back() const { return (*this)[m_size - 1]; }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            T* slot{ ::new (nextSlot()) T(std::forward<Args>(args)...) };
+            ++m_size;
+            return *slot;
+        }
+
+        T& push_back(const T& value) { return emplace_back(value); }
+        T& push_back(T&& value) { return emplace_back(std::move(value)); }
+
+        // only the last element is destroyed, every other reference stays valid.
+        // the (possibly now empty) block is kept around for the next push_back.
+        void pop_back()
+        {
+            --m_size;
+            std::destroy_at(&(*this)[m_size]);
+        }
+
+        void clear()
+        {
+            while (m_size > 0)
+                pop_back();
+        }
+
+        // calls fn(element) block by block, so the inner loop runs over contiguous memory
+        // and can be vectorized just like a loop over a std::vector
+        template <typename Fn>
+        void forEach(Fn&& fn)
+        {
+            std::size_t remaining{ m_size };
+            for (std::size_t block{ 0 }; remaining > 0; ++block)
+            {
+                std::size_t count{ remaining < s_blockSize ? remaining : s_blockSize };
+                T* first{ m_blocks[block] };
+                for (T* p{ first }; p != first + count; ++p)
+                    fn(*p);
+                remaining -= count;
+            }
+        }
+
+        template <typename Fn>
+        void forEach(Fn&& fn) const
+        {
+            std::size_t remaining{ m_size };
+            for (std::size_t block{ 0 }; remaining > 0; ++block)
+            {
+                std::size_t count{ remaining < s_blockSize ? remaining : s_blockSize };
+                const T* first{ m_blocks[block] };
+                for (const T* p{ first }; p != first + count; ++p)
+                    fn(*p);
+                remaining -= count;
+            }
+        }
+
+        // a forward iterator that walks a block with a plain pointer, and only looks at the
+        // block table when it reaches the end of a block
+        template <bool IsConst>
+        class Iterator
+        {
+        private:
+            using element_type = std::conditional_t<IsConst, const T, T>;
+
+            element_type* m_ptr{};
+            element_type* m_blockEnd{};
+            T* const* m_block{};
+
+            friend class Iterator<true>;      // for the conversion below
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = element_type*;
+            using reference = element_type&;
+
+            Iterator() = default;
+
+            Iterator(T* const* block, std::size_t offset)
+                : m_ptr{ *block ? *block + offset : nullptr }
+                , m_blockEnd{ *block ? *block + s_blockSize : nullptr }
+                , m_block{ block }
+            {
+            }
+
+            // an iterator converts to a const_iterator, like std::vector's do
+            template <bool OtherConst>
+                requires (IsConst && !OtherConst)
+            Iterator(const Iterator<OtherConst>& other)
+                : m_ptr{ other.m_ptr }
+                , m_blockEnd{ other.m_blockEnd }
+                , m_block{ other.m_block }
+            {
+            }
+
+            reference operator*() const { return *m_ptr; }
+            pointer operator->() const { return m_ptr; }
+
+            Iterator& operator++()
+            {
+                if (++m_ptr == m_blockEnd)
+                {
+                    ++m_block;
+                    m_ptr = *m_block;       // nullptr once we walk off the last block
+                    m_blockEnd = m_ptr ? m_ptr + s_blockSize : nullptr;
+                }
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator copy{ *this };
+                ++*this;
+                return copy;
+            }
+
+            friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_ptr == b.m_ptr; }
+        };
+
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        iterator begin() { return { m_blocks.data(), 0 }; }
+        iterator end() { return { m_blocks.data() + (m_size >> BlockBits), m_size & s_blockMask }; }
+        const_iterator begin() const { return { m_blocks.data(), 0 }; }
+        const_iterator end() const { return { m_blocks.data() + (m_size >> BlockBits), m_size & s_blockMask }; }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ GradeMap, revisited ]============
+---------------------------------------------------------------------------------------*/
+
+// because the StudentGrades never move, the index can store std::string_views that point at
+// the names INSIDE the container, instead of a second copy of every name.
+
+#include <unordered_map>
+
+namespace quiz
+{
+    struct StudentGrade
+    {
+        std::string name{};
+        char grade{};
+    };
+
+    class GradeMap
+    {
+    private:
+        segmented::SegmentedVector<StudentGrade, 8> m_grades{};
+        std::unordered_map<std::string_view, std::size_t> m_index{};
+
+    public:
+        // the returned reference stays valid for the lifetime of the GradeMap
+        char& operator[](std::string_view name)
+        {
+            auto found{ m_index.find(name) };
+            if (found != m_index.end())
+                return m_grades[found->second].grade;
+
+            StudentGrade& added{ m_grades.push_back({ std::string{ name } }) };
+            m_index.emplace(added.name, m_grades.size() - 1);
+            return added.grade;
+        }
+    };
+
+    void main()
+    {
+        GradeMap grades{};
+
+        char& joe{ grades["Joe"] };
+        joe = 'A';
+
+        // add lots of students: with a std::vector this would reallocate many times
+        for (int i{ 0 }; i < 10'000; ++i)
+            grades["Student " + std::to_string(i)] = 'C';
+
+        joe = 'B';      // still fine
+        std::cout << "Joe has a grade of " << grades["Joe"] << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+// random pushes, pops and clears, compared against std::vector. small blocks (8 elements),
+// so almost every push crosses into a new block, and a type that counts its live objects.
+
+#include <random>
+#include <algorithm>    // std::equal
+#include <ranges>
+
+namespace checks
+{
+    struct Tracked
+    {
+        static inline int s_alive{ 0 };
+        std::string text{};
+
+        Tracked(std::string t) : text{ std::move(t) } { ++s_alive; }
+        Tracked(const Tracked& other) : text{ other.text } { ++s_alive; }
+        Tracked(Tracked&& other) noexcept : text{ std::move(other.text) } { ++s_alive; }
+        ~Tracked() { --s_alive; }
+    };
+
+    using Vector = segmented::SegmentedVector<Tracked, 3>;
+
+    static_assert(std::forward_iterator<Vector::iterator>);
+    static_assert(std::forward_iterator<Vector::const_iterator>);
+    static_assert(std::ranges::forward_range<const Vector>);
+    static_assert(std::is_convertible_v<Vector::iterator, Vector::const_iterator>);
+    static_assert(!std::is_convertible_v<Vector::const_iterator, Vector::iterator>);
+
+    int matches(const Vector& ours, const std::vector<std::string>& expected)
+    {
+        int failures{ ours.size() != expected.size() };
+        failures += !std::equal(ours.begin(), ours.end(), expected.begin(), expected.end(),
+                                [](const Tracked& a, const std::string& b) { return a.text == b; });
+
+        std::vector<std::string> visited{};
+        ours.forEach([&visited](const Tracked& element) { visited.push_back(element.text); });
+        failures += visited != expected;
+
+        for (std::size_t i{ 0 }; i < expected.size(); ++i)
+            failures += ours.at(i).text != expected[i];
+        return failures;
+    }
+
+    void main()
+    {
+        std::mt19937 mt{ 32 };
+        int failures{ 0 };
+
+        {
+            Vector ours{};
+            std::vector<std::string> expected{};
+            std::vector<const Tracked*> addresses{};    // of every element, taken when it was added
+
+            for (int i{ 0 }; i < 20'000; ++i)
+            {
+                auto action{ mt() % 100 };
+                if (action < 70 || expected.empty())
+                {
+                    std::string text{ std::to_string(mt()) };
+                    addresses.push_back(&ours.push_back(Tracked{ text }));
+                    expected.push_back(text);
+                }
+                else if (action < 99)
+                {
+                    ours.pop_back();
+                    expected.pop_back();
+                    addresses.pop_back();
+                }
+                else
+                {
+                    // the blocks are kept: growing again reuses the same addresses
+                    std::size_t capacity{ ours.capacity() };
+                    const Tracked* first{ &ours[0] };
+                    ours.clear();
+                    expected.clear();
+                    addresses.clear();
+                    addresses.push_back(&ours.push_back(Tracked{ "again" }));
+                    expected.push_back("again");
+                    failures += ours.capacity() != capacity || &ours[0] != first;
+                }
+
+                // no element has moved, however many blocks were added since
+                if (i % 1'000 == 0)
+                {
+                    for (std::size_t k{ 0 }; k < addresses.size(); ++k)
+                        failures += addresses[k] != &ours[k] || addresses[k]->text != expected[k];
+                }
+            }
+            failures += matches(ours, expected);
+            failures += Tracked::s_alive != static_cast<int>(expected.size());
+
+            // iterator -> const_iterator, and the non-const forEach writing through
+            Vector::const_iterator it{ ours.begin() };
+            failures += it != ours.cbegin() || &*it != &ours[0];
+            ours.forEach([](Tracked& element) { element.text += '!'; });
+            for (std::string& text : expected)
+                text += '!';
+            failures += matches(ours, expected);
+
+            bool threw{ false };
+            try
+            {
+                static_cast<const Vector&>(ours).at(ours.size());
+            }
+            catch (const std::out_of_range&)
+            {
+                threw = true;
+            }
+            failures += !threw;
+
+            // moving steals the blocks: the references now point into the new container
+            const Tracked* firstAddress{ &ours[0] };
+            Vector moved{ std::move(ours) };
+            failures += &moved[0] != firstAddress || !ours.empty() || ours.begin() != ours.end();
+            failures += matches(moved, expected);
+
+            ours.push_back(Tracked{ "reused" });      // the moved-from container still works
+            failures += ours.size() != 1 || ours[0].text != "reused";
+
+            Vector assigned{};
+            for (int i{ 0 }; i < 20; ++i)
+                assigned.push_back(Tracked{ "old" });
+            assigned = std::move(moved);
+            failures += &assigned[0] != firstAddress || !moved.empty();
+            failures += matches(assigned, expected);
+            failures += Tracked::s_alive != static_cast<int>(expected.size()) + 1;
+        }
+        failures += Tracked::s_alive != 0;
+
+        std::cout << "checks: " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <deque>
+#include <random>
+#include <numeric>      // std::accumulate
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_count{ 20'000'000 };
+
+    template <typename Container>
+    void run(std::string_view name, const std::vector<std::size_t>& randomIndices)
+    {
+        Container container{};
+
+        Timer t;
+        for (std::size_t i{ 0 }; i < g_count; ++i)
+            container.push_back(static_cast<int>(i));
+        double appendTime{ t.elapsed() };
+
+        t.reset();
+        long long sum{ 0 };
+        for (std::size_t index : randomIndices)
+            sum += container[index];
+        double randomTime{ t.elapsed() };
+
+        t.reset();
+        for (int value : container)
+            sum += value;
+        double iterateTime{ t.elapsed() };
+
+        std::cout << name << "append " << appendTime << " s, random access " << randomTime
+                  << " s, iterate " << iterateTime << " s";
+
+        if constexpr (requires { container.forEach([](int) {}); })
+        {
+            t.reset();
+            container.forEach([&sum](int value) { sum += value; });
+            std::cout << ", forEach " << t.elapsed() << " s";
+        }
+
+        std::cout << (sum == 0 ? " ?" : "") << '\n';
+    }
+
+    void main()
+    {
+        std::mt19937_64 mt{ 5 };
+        std::vector<std::size_t> randomIndices(g_count);
+        for (auto& index : randomIndices)
+            index = mt() % g_count;
+
+        run<std::vector<int>>("std::vector     : ", randomIndices);
+        run<std::deque<int>>("std::deque      : ", randomIndices);
+        run<segmented::SegmentedVector<int, 12>>("SegmentedVector : ", randomIndices);
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    quiz::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
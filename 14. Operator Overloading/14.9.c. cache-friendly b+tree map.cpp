@@ -0,0 +1,883 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>          // std::pair, std::move
+#include <functional>       // std::less
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>          // std::size_t
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+// using_map() at the end of 14.9 uses std::map, which is a red-black tree: every element is
+// its own heap allocation, and a lookup follows one pointer per level of the tree. with a
+// million elements that's about 20 levels, and most of those pointers point to memory that
+// isn't in the cache.
+
+// a B+tree stores MANY keys per node instead of one:
+    // - a node holds a small sorted array of keys (sized to a few cache lines), so a million
+    //   elements only need 4 or 5 levels, and every level is one or two cache misses.
+    // - searching inside a node is a scan over a small contiguous array, which is exactly what
+    //   SIMD instructions are good at.
+    // - all the values live in the leaves, and the leaves are linked together, so a range scan
+    //   ("every key between a and b") is a walk along a linked list of arrays.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+               ============[ searching inside a node with SIMD ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - because the keys in a node are sorted, "the position of the first key >= x" is the same as
+    "how many keys are < x". counting doesn't need any branches: compare every key with x and
+    add up the results.
+
+  - for integer keys we compare 4 keys at a time and add up the comparison results in the
+    vector register. SSE2 has no 64 bit comparison (it came with SSE4.2), so, like in 11.19.b,
+    int64 keys are compared with 32 bit instructions. for other key types (std::string,
+    double...) we fall back to a branchless loop.
+*/
+
+namespace bplus_tree
+{
+    namespace detail
+    {
+        // the number of keys[0, count) that are < key (or <= key when OrEqual is true)
+        template <bool OrEqual, typename Key, typename Compare>
+        std::size_t countLess(const Key* keys, std::size_t count, const Key& key, const Compare& compare)
+        {
+            std::size_t result{ 0 };
+            for (std::size_t i{ 0 }; i < count; ++i)
+            {
+                if constexpr (OrEqual)
+                    result += !compare(key, keys[i]);       // keys[i] <= key
+                else
+                    result += compare(keys[i], key);
+            }
+            return result;
+        }
+
+#if defined(__SSE2__)
+        template <bool OrEqual>
+        std::size_t countLess(const std::int32_t* keys, std::size_t count, const std::int32_t& key, const std::less<std::int32_t>&)
+        {
+            const __m128i needle{ _mm_set1_epi32(key) };
+            __m128i counts{ _mm_setzero_si128() };
+            std::size_t i{ 0 };
+
+            // a true comparison is -1, so the lanes count down. without POPCNT (which came after
+            // SSE2) std::popcount of a movemask is a function call, so the counts stay in the
+            // register until the end. for OrEqual we count the keys that are > key instead.
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128i chunk{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)) };
+                counts = _mm_add_epi32(counts, OrEqual ? _mm_cmpgt_epi32(chunk, needle) : _mm_cmplt_epi32(chunk, needle));
+            }
+
+            std::int32_t lanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+            auto found{ static_cast<std::size_t>(-(lanes[0] + lanes[1] + lanes[2] + lanes[3])) };
+            std::size_t result{ OrEqual ? i - found : found };
+
+            for (; i < count; ++i)
+                result += OrEqual ? keys[i] <= key : keys[i] < key;
+
+            return result;
+        }
+#endif
+
+#if defined(__SSE2__)
+        // we split 4 keys into their high and low 32 bit halves: a key is < key when its high
+        // half is (signed), or when the high halves are equal and its low half is (unsigned, so
+        // with the top bit flipped). with the halves of 4 keys in 2 registers, that's cheaper
+        // than emulating _mm_cmpgt_epi64 on 2 keys at a time.
+        template <bool OrEqual>
+        std::size_t countLess(const std::int64_t* keys, std::size_t count, const std::int64_t& key, const std::less<std::int64_t>&)
+        {
+            const __m128i flip{ _mm_set1_epi32(static_cast<int>(0x8000'0000)) };
+            const __m128i needleHigh{ _mm_set1_epi32(static_cast<std::int32_t>(key >> 32)) };
+            const __m128i needleLow{ _mm_set1_epi32(static_cast<std::int32_t>(static_cast<std::uint32_t>(key) ^ 0x8000'0000)) };
+            __m128i counts{ _mm_setzero_si128() };
+            std::size_t i{ 0 };
+
+            // counted the same way as for int32
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 first{ _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i))) };
+                __m128 second{ _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i + 2))) };
+                __m128i high{ _mm_castps_si128(_mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1))) };
+                __m128i low{ _mm_xor_si128(_mm_castps_si128(_mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0))), flip) };
+
+                __m128i sameHigh{ _mm_cmpeq_epi32(high, needleHigh) };
+                __m128i counted{ OrEqual ? _mm_or_si128(_mm_cmpgt_epi32(high, needleHigh), _mm_and_si128(sameHigh, _mm_cmpgt_epi32(low, needleLow)))
+                                         : _mm_or_si128(_mm_cmplt_epi32(high, needleHigh), _mm_and_si128(sameHigh, _mm_cmplt_epi32(low, needleLow))) };
+                counts = _mm_add_epi32(counts, counted);
+            }
+
+            std::int32_t lanes[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+            auto found{ static_cast<std::size_t>(-(lanes[0] + lanes[1] + lanes[2] + lanes[3])) };
+            std::size_t result{ OrEqual ? i - found : found };
+
+            for (; i < count; ++i)
+                result += OrEqual ? keys[i] <= key : keys[i] < key;
+
+            return result;
+        }
+#endif
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ the tree ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - inner nodes hold [count] separator keys and [count + 1] children. everything in child i is
+    < keys[i], everything in child i+1 is >= keys[i].
+
+  - leaves hold up to N keys and their values, plus pointers to the previous and next leaf.
+
+  - a full node is split in two halves when we insert into it, and the split propagates
+    upwards (which is how the tree grows in height: at the root).
+
+  - erase() removes the element from its leaf but doesn't merge half-empty leaves. the tree
+    stays correct (the separators still bound their subtrees), it just isn't perfectly packed
+    any more. many database B+trees work like this, since deletes are rare compared to reads.
+    bulkLoad() builds a perfectly packed tree again.
+*/
+
+namespace bplus_tree
+{
+    template <typename Key, typename Value, typename Compare = std::less<Key>>
+    class BPlusTreeMap
+    {
+    private:
+        // keys sized to about 4 cache lines, but at least 8 per node
+        static constexpr std::size_t s_order{ sizeof(Key) * 8 > 256 ? 8 : 256 / sizeof(Key) };
+
+        struct Node
+        {
+            bool isLeaf{};
+            std::size_t count{ 0 };
+            Key keys[s_order]{};
+        };
+
+        struct Leaf : Node
+        {
+            Value values[s_order]{};
+            Leaf* next{ nullptr };
+            Leaf* prev{ nullptr };
+
+            Leaf() { this->isLeaf = true; }
+        };
+
+        struct Inner : Node
+        {
+            Node* children[s_order + 1]{};
+
+            Inner() { this->isLeaf = false; }
+        };
+
+        Node* m_root{ nullptr };
+        Leaf* m_first{ nullptr };
+        std::size_t m_size{ 0 };
+        std::size_t m_height{ 0 };
+        [[no_unique_address]] Compare m_compare{};
+
+        std::size_t lowerBoundIn(const Node* node, const Key& key) const
+        {
+            return detail::countLess<false>(node->keys, node->count, key, m_compare);
+        }
+
+        std::size_t childIndex(const Inner* node, const Key& key) const
+        {
+            return detail::countLess<true>(node->keys, node->count, key, m_compare);
+        }
+
+        Leaf* findLeaf(const Key& key) const
+        {
+            Node* node{ m_root };
+            while (node && !node->isLeaf)
+            {
+                auto inner{ static_cast<Inner*>(node) };
+                node = inner->children[childIndex(inner, key)];
+            }
+            return static_cast<Leaf*>(node);
+        }
+
+        static void destroy(Node* node)
+        {
+            if (!node)
+                return;
+
+            if (node->isLeaf)
+                delete static_cast<Leaf*>(node);
+            else
+            {
+                auto inner{ static_cast<Inner*>(node) };
+                for (std::size_t i{ 0 }; i <= inner->count; ++i)
+                    destroy(inner->children[i]);
+                delete inner;
+            }
+        }
+
+        struct Split
+        {
+            Key separator{};
+            Node* right{ nullptr };
+        };
+
+        // inserts into the subtree below node. returns the slot of the value, and fills in
+        // split if node had to be split in two
+        Value* insertInto(Node* node, const Key& key, Split& split)
+        {
+            if (node->isLeaf)
+            {
+                auto leaf{ static_cast<Leaf*>(node) };
+                std::size_t position{ lowerBoundIn(leaf, key) };
+
+                if (position < leaf->count && !m_compare(key, leaf->keys[position]))
+                    return &leaf->values[position];     // already there
+
+                if (leaf->count == s_order)
+                {
+                    // split the leaf, then insert into the correct half
+                    auto right{ new Leaf{} };
+                    std::size_t half{ s_order / 2 };
+                    for (std::size_t i{ half }; i < s_order; ++i)
+                    {
+                        right->keys[i - half] = std::move(leaf->keys[i]);
+                        right->values[i - half] = std::move(leaf->values[i]);
+                    }
+                    right->count = s_order - half;
+                    leaf->count = half;
+
+                    right->next = leaf->next;
+                    right->prev = leaf;
+                    if (leaf->next)
+                        leaf->next->prev = right;
+                    leaf->next = right;
+
+                    split = { right->keys[0], right };
+
+                    // position == half means key < right->keys[0]: it goes at the end of the left leaf
+                    if (position > half)
+                    {
+                        leaf = right;
+                        position -= half;
+                    }
+                }
+
+                for (std::size_t i{ leaf->count }; i > position; --i)
+                {
+                    leaf->keys[i] = std::move(leaf->keys[i - 1]);
+                    leaf->values[i] = std::move(leaf->values[i - 1]);
+                }
+                leaf->keys[position] = key;
+                leaf->values[position] = Value{};
+                ++leaf->count;
+                ++m_size;
+                return &leaf->values[position];
+            }
+
+            auto inner{ static_cast<Inner*>(node) };
+            std::size_t index{ childIndex(inner, key) };
+
+            Split childSplit{};
+            Value* slot{ insertInto(inner->children[index], key, childSplit) };
+            if (!childSplit.right)
+                return slot;
+
+            // the child was split: add its new right half after it
+            if (inner->count == s_order)
+            {
+                // split this inner node too. the middle key moves up instead of being copied.
+                Key keys[s_order + 1];
+                Node* children[s_order + 2];
+
+                for (std::size_t i{ 0 }, j{ 0 }; i < s_order; ++i, ++j)
+                {
+                    if (i == index)
+                        keys[j++] = childSplit.separator;
+                    keys[j] = std::move(inner->keys[i]);
+                }
+                if (index == s_order)
+                    keys[s_order] = childSplit.separator;
+
+                for (std::size_t i{ 0 }, j{ 0 }; i <= s_order; ++i, ++j)
+                {
+                    children[j] = inner->children[i];
+                    if (i == index)
+                        children[++j] = childSplit.right;
+                }
+
+                auto right{ new Inner{} };
+                std::size_t half{ (s_order + 1) / 2 };
+
+                inner->count = half;
+                for (std::size_t i{ 0 }; i < half; ++i)
+                {
+                    inner->keys[i] = std::move(keys[i]);
+                    inner->children[i] = children[i];
+                }
+                inner->children[half] = children[half];
+
+                right->count = s_order - half;
+                for (std::size_t i{ 0 }; i < right->count; ++i)
+                {
+                    right->keys[i] = std::move(keys[half + 1 + i]);
+                    right->children[i] = children[half + 1 + i];
+                }
+                right->children[right->count] = children[s_order + 1];
+
+                split = { std::move(keys[half]), right };
+                return slot;
+            }
+
+            for (std::size_t i{ inner->count }; i > index; --i)
+            {
+                inner->keys[i] = std::move(inner->keys[i - 1]);
+                inner->children[i + 1] = inner->children[i];
+            }
+            inner->keys[index] = childSplit.separator;
+            inner->children[index + 1] = childSplit.right;
+            ++inner->count;
+            return slot;
+        }
+
+    public:
+        BPlusTreeMap() = default;
+        BPlusTreeMap(const BPlusTreeMap&) = delete;
+        BPlusTreeMap& operator=(const BPlusTreeMap&) = delete;
+
+        ~BPlusTreeMap()
+        {
+            destroy(m_root);
+        }
+
+        static constexpr std::size_t order() { return s_order; }
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+        std::size_t height() const { return m_height; }
+
+        Value* find(const Key& key)
+        {
+            Leaf* leaf{ findLeaf(key) };
+            if (!leaf)
+                return nullptr;
+
+            std::size_t position{ lowerBoundIn(leaf, key) };
+            if (position < leaf->count && !m_compare(key, leaf->keys[position]))
+                return &leaf->values[position];
+            return nullptr;
+        }
+
+        bool contains(const Key& key) { return find(key) != nullptr; }
+
+        // like std::map::operator[]: inserts a default value if key isn't there yet.
+        // the reference is valid until the next insert or erase.
+        Value& operator[](const Key& key)
+        {
+            if (!m_root)
+            {
+                auto leaf{ new Leaf{} };
+                m_root = leaf;
+                m_first = leaf;
+                m_height = 1;
+            }
+
+            Split split{};
+            Value* slot{ insertInto(m_root, key, split) };
+
+            if (split.right)
+            {
+                auto root{ new Inner{} };
+                root->count = 1;
+                root->keys[0] = std::move(split.separator);
+                root->children[0] = m_root;
+                root->children[1] = split.right;
+                m_root = root;
+                ++m_height;
+            }
+            return *slot;
+        }
+
+        bool erase(const Key& key)
+        {
+            Leaf* leaf{ findLeaf(key) };
+            if (!leaf)
+                return false;
+
+            std::size_t position{ lowerBoundIn(leaf, key) };
+            if (position >= leaf->count || m_compare(key, leaf->keys[position]))
+                return false;
+
+            for (std::size_t i{ position }; i + 1 < leaf->count; ++i)
+            {
+                leaf->keys[i] = std::move(leaf->keys[i + 1]);
+                leaf->values[i] = std::move(leaf->values[i + 1]);
+            }
+            --leaf->count;
+            --m_size;
+            return true;
+        }
+
+        // a position in the leaf chain. it skips leaves that erase() left empty.
+        class Iterator
+        {
+        private:
+            Leaf* m_leaf{ nullptr };
+            std::size_t m_index{ 0 };
+
+            void skipEmpty()
+            {
+                while (m_leaf && m_index >= m_leaf->count)
+                {
+                    m_leaf = m_leaf->next;
+                    m_index = 0;
+                }
+            }
+
+        public:
+            Iterator() = default;
+
+            Iterator(Leaf* leaf, std::size_t index)
+                : m_leaf{ leaf }
+                , m_index{ index }
+            {
+                skipEmpty();
+            }
+
+            const Key& key() const { return m_leaf->keys[m_index]; }
+            Value& value() const { return m_leaf->values[m_index]; }
+
+            std::pair<const Key&, Value&> operator*() const { return { key(), value() }; }
+
+            Iterator& operator++()
+            {
+                ++m_index;
+                skipEmpty();
+                return *this;
+            }
+
+            friend bool operator==(const Iterator& a, const Iterator& b)
+            {
+                return a.m_leaf == b.m_leaf && (a.m_leaf == nullptr || a.m_index == b.m_index);
+            }
+        };
+
+        Iterator begin() const { return { m_first, 0 }; }
+        Iterator end() const { return {}; }
+
+        // the first element whose key is >= key
+        Iterator lowerBound(const Key& key) const
+        {
+            Leaf* leaf{ findLeaf(key) };
+            return leaf ? Iterator{ leaf, lowerBoundIn(leaf, key) } : end();
+        }
+
+        // calls fn(key, value) for every key in [first, last)
+        template <typename Fn>
+        void forEachInRange(const Key& first, const Key& last, Fn&& fn) const
+        {
+            Leaf* leaf{ findLeaf(first) };
+            if (!leaf)
+                return;
+
+            std::size_t index{ lowerBoundIn(leaf, first) };
+            for (; leaf; leaf = leaf->next, index = 0)
+            {
+                for (; index < leaf->count; ++index)
+                {
+                    if (!m_compare(leaf->keys[index], last))
+                        return;
+                    fn(leaf->keys[index], leaf->values[index]);
+                }
+            }
+        }
+
+        // builds a packed tree from elements that are sorted by key and have no duplicates.
+        // this is O(n), much faster than n inserts, and leaves every node full.
+        template <typename Range>
+        void bulkLoad(const Range& sorted)
+        {
+            destroy(m_root);
+            m_root = nullptr;
+            m_first = nullptr;
+            m_size = 0;
+            m_height = 0;
+
+            // 1. the leaves, chained together
+            std::vector<Node*> level{};
+            std::vector<Key> lowKeys{};     // the smallest key under each node of [level]
+            Leaf* previous{ nullptr };
+
+            for (const auto& [key, value] : sorted)
+            {
+                if (!previous || previous->count == s_order)
+                {
+                    auto leaf{ new Leaf{} };
+                    leaf->prev = previous;
+                    if (previous)
+                        previous->next = leaf;
+                    else
+                        m_first = leaf;
+
+                    level.push_back(leaf);
+                    lowKeys.push_back(key);
+                    previous = leaf;
+                }
+
+                previous->keys[previous->count] = key;
+                previous->values[previous->count] = value;
+                ++previous->count;
+                ++m_size;
+            }
+
+            if (level.empty())
+                return;
+            m_height = 1;
+
+            // 2. inner levels, until only the root is left. the children are spread evenly over
+            //    the parents, so the last parent doesn't end up with a single child.
+            while (level.size() > 1)
+            {
+                std::vector<Node*> parents{};
+                std::vector<Key> parentLowKeys{};
+
+                std::size_t parentCount{ (level.size() + s_order) / (s_order + 1) };
+                for (std::size_t p{ 0 }, i{ 0 }; p < parentCount; ++p)
+                {
+                    std::size_t children{ (level.size() - i) / (parentCount - p) };
+
+                    auto parent{ new Inner{} };
+                    parent->children[0] = level[i];
+                    for (std::size_t c{ 1 }; c < children; ++c)
+                    {
+                        parent->keys[c - 1] = lowKeys[i + c];
+                        parent->children[c] = level[i + c];
+                    }
+                    parent->count = children - 1;
+
+                    parents.push_back(parent);
+                    parentLowKeys.push_back(lowKeys[i]);
+                    i += children;
+                }
+
+                level = std::move(parents);
+                lowKeys = std::move(parentLowKeys);
+                ++m_height;
+            }
+
+            m_root = level.front();
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ using_map, revisited ]============
+---------------------------------------------------------------------------------------*/
+
+namespace using_map
+{
+    void main()
+    {
+        bplus_tree::BPlusTreeMap<std::string, char> grades{};
+
+        grades["Joe"] = 'A';
+        grades["Frank"] = 'B';
+        grades["Susan"] = 'C';
+        grades["Tom"] = 'D';
+
+        std::cout << "Joe has a grade of " << grades["Joe"] << '\n';
+        std::cout << "Frank has a grade of " << grades["Frank"] << '\n';
+
+        // like std::map, the elements come out sorted by key
+        for (auto [name, grade] : grades)
+            std::cout << name << ": " << grade << '\n';
+
+        // and we can ask for a range of keys: every name from "F" up to (not including) "T"
+        std::cout << "from F to T:";
+        grades.forEachInRange("F", "T", [](const std::string& name, char) { std::cout << ' ' << name; });
+        std::cout << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+// random inserts, erases, lookups and range scans, compared against std::map
+
+#include <map>
+#include <random>
+#include <algorithm>    // std::sort
+#include <limits>
+
+namespace checks
+{
+    template <typename Key>
+    int run(std::string_view name, auto makeKey)
+    {
+        std::mt19937_64 mt{ 33 };
+        std::map<Key, int> expected{};
+        bplus_tree::BPlusTreeMap<Key, int> tree{};
+        int failures{ 0 };
+
+        for (int i{ 0 }; i < 200'000; ++i)
+        {
+            Key key{ makeKey(mt() % 50'000) };
+            switch (mt() % 4)
+            {
+            case 0:
+            case 1:
+                expected[key] = i;
+                tree[key] = i;
+                break;
+            case 2:
+                failures += (expected.erase(key) == 1) != tree.erase(key);
+                break;
+            case 3:
+            {
+                auto found{ expected.find(key) };
+                int* value{ tree.find(key) };
+                failures += (found == expected.end()) != (value == nullptr);
+                failures += value && *value != found->second;
+                break;
+            }
+            }
+        }
+        failures += expected.size() != tree.size();
+
+        // a full scan visits the same elements in the same order
+        auto it{ expected.begin() };
+        for (auto [key, value] : tree)
+        {
+            failures += it == expected.end() || it->first != key || it->second != value;
+            ++it;
+        }
+
+        // and so do range scans
+        for (int i{ 0 }; i < 1'000; ++i)
+        {
+            Key first{ makeKey(mt() % 50'000) };
+            Key last{ makeKey(mt() % 50'000) };
+            std::size_t count{ 0 };
+            auto from{ expected.lower_bound(first) };
+            tree.forEachInRange(first, last, [&](const Key& key, int) {
+                failures += from == expected.end() || from->first != key;
+                ++from;
+                ++count;
+            });
+            failures += first < last && from != expected.lower_bound(last);
+        }
+
+        // bulk loading the same elements gives the same answers
+        bplus_tree::BPlusTreeMap<Key, int> loaded{};
+        loaded.bulkLoad(expected);
+        failures += loaded.size() != expected.size();
+        for (const auto& [key, value] : expected)
+        {
+            int* found{ loaded.find(key) };
+            failures += !found || *found != value;
+        }
+
+        std::cout << name << ": " << expected.size() << " elements, height " << tree.height()
+                  << " (bulk loaded: " << loaded.height() << "), " << failures << " failures\n";
+        return failures;
+    }
+
+    // the SIMD count for int64 against the plain loop, around the values where the 32 bit halves
+    // of the comparison disagree
+    void countLess64()
+    {
+        constexpr std::int64_t edges[]{ std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max(),
+                                        0, -1, 1, 0xffff'ffff, 0x1'0000'0000, -0xffff'ffff, -0x1'0000'0000, 0x7fff'ffff, 0x8000'0000 };
+        std::mt19937_64 mt{ 33 };
+        auto plainLess{ [](std::int64_t a, std::int64_t b) { return a < b; } };
+        int failures{ 0 };
+
+        for (int i{ 0 }; i < 20'000; ++i)
+        {
+            auto pick{ [&]() -> std::int64_t {
+                switch (mt() % 3)
+                {
+                case 0: return edges[mt() % std::size(edges)];
+                case 1: return static_cast<std::int64_t>(static_cast<std::uint64_t>(edges[mt() % std::size(edges)]) + mt() % 5 - 2);   // wraps at the ends
+                default: return static_cast<std::int64_t>(mt());
+                }
+            } };
+
+            std::vector<std::int64_t> keys(mt() % 20);
+            for (auto& key : keys)
+                key = pick();
+            std::sort(keys.begin(), keys.end());
+            std::int64_t key{ pick() };
+
+            std::less<std::int64_t> less{};
+            failures += bplus_tree::detail::countLess<false>(keys.data(), keys.size(), key, less)
+                     != bplus_tree::detail::countLess<false>(keys.data(), keys.size(), key, plainLess);
+            failures += bplus_tree::detail::countLess<true>(keys.data(), keys.size(), key, less)
+                     != bplus_tree::detail::countLess<true>(keys.data(), keys.size(), key, plainLess);
+        }
+
+        std::cout << "int64 countLess: " << failures << " failures\n";
+    }
+
+    void main()
+    {
+        run<std::int32_t>("int32 keys ", [](std::uint64_t n) { return static_cast<std::int32_t>(n) - 25'000; });
+        run<std::int64_t>("int64 keys ", [](std::uint64_t n) { return static_cast<std::int64_t>(n * 0x9e3779b97f4a7c15); });
+        run<std::int64_t>("int64 small", [](std::uint64_t n) { return static_cast<std::int64_t>(n) - 25'000; });     // equal high halves
+        countLess64();
+        run<std::string>("string keys", [](std::uint64_t n) { return "student " + std::to_string(n); });
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <algorithm>    // std::sort
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_count{ 1'000'000 };
+    constexpr std::size_t g_scanLength{ 100 };
+
+    // ns per insert, ns per lookup, ns per range scan of g_scanLength elements
+    template <typename Map>
+    void run(std::string_view name, const std::vector<std::int64_t>& keys, const std::vector<std::int64_t>& queries)
+    {
+        Map map{};
+
+        Timer t;
+        for (std::int64_t key : keys)
+            map[key] = key;
+        double insertTime{ t.elapsed() };
+
+        t.reset();
+        std::uint64_t sum{ 0 };
+        for (std::int64_t key : queries)
+        {
+            if constexpr (requires { map.lowerBound(key); })
+                sum += static_cast<std::uint64_t>(*map.find(key));
+            else
+                sum += static_cast<std::uint64_t>(map.find(key)->second);
+        }
+        double findTime{ t.elapsed() };
+
+        t.reset();
+        for (std::size_t i{ 0 }; i < queries.size() / 10; ++i)
+        {
+            if constexpr (requires { map.lowerBound(queries[i]); })
+            {
+                std::size_t n{ 0 };
+                for (auto it{ map.lowerBound(queries[i]) }; it != map.end() && n < g_scanLength; ++it, ++n)
+                    sum += static_cast<std::uint64_t>(it.value());
+            }
+            else
+            {
+                std::size_t n{ 0 };
+                for (auto it{ map.lower_bound(queries[i]) }; it != map.end() && n < g_scanLength; ++it, ++n)
+                    sum += static_cast<std::uint64_t>(it->second);
+            }
+        }
+        double scanTime{ t.elapsed() };
+
+        std::cout << name << "insert " << insertTime * 1e9 / static_cast<double>(keys.size()) << " ns, find "
+                  << findTime * 1e9 / static_cast<double>(queries.size()) << " ns, scan of " << g_scanLength << ' '
+                  << scanTime * 1e9 / static_cast<double>(queries.size() / 10) << " ns" << (sum == 0 ? " ?" : "") << '\n';
+    }
+
+    void main()
+    {
+        std::mt19937_64 mt{ 9 };
+        std::vector<std::int64_t> keys(g_count);
+        for (auto& key : keys)
+            key = static_cast<std::int64_t>(mt() >> 1);
+
+        std::vector<std::int64_t> queries(g_count);
+        for (auto& query : queries)
+            query = keys[mt() % keys.size()];
+
+        std::cout << "(" << g_count << " random int64 keys, " << bplus_tree::BPlusTreeMap<std::int64_t, std::int64_t>::order()
+                  << " keys per node)\n";
+        run<std::map<std::int64_t, std::int64_t>>("std::map     : ", keys, queries);
+        run<bplus_tree::BPlusTreeMap<std::int64_t, std::int64_t>>("BPlusTreeMap : ", keys, queries);
+
+        // building from sorted data
+        std::vector<std::pair<std::int64_t, std::int64_t>> sorted(keys.size());
+        for (std::size_t i{ 0 }; i < keys.size(); ++i)
+            sorted[i] = { keys[i], keys[i] };
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+        Timer t;
+        std::map<std::int64_t, std::int64_t> map{ sorted.begin(), sorted.end() };
+        double mapTime{ t.elapsed() };
+
+        t.reset();
+        bplus_tree::BPlusTreeMap<std::int64_t, std::int64_t> tree{};
+        tree.bulkLoad(sorted);
+        double treeTime{ t.elapsed() };
+
+        std::cout << "from sorted input: std::map " << mapTime << " s, BPlusTreeMap::bulkLoad " << treeTime
+                  << " s (height " << tree.height() << ", " << map.size() << " elements)\n";
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    using_map::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
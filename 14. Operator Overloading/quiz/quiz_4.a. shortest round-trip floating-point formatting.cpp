@@ -0,0 +1,623 @@
+#include <iostream>
+#include <bit>              // std::bit_cast
+#include <cmath>            // std::isnan, std::isinf, std::signbit
+#include <cstring>          // std::memcpy, std::memmove, std::memset
+#include <cstdint>
+#include <cstddef>          // std::size_t
+#include <type_traits>
+#include <string_view>
+#include <charconv>         // std::to_chars
+
+
+// [ description ]
+/*---------------------------------------------------------------------------------------
+    operator<< for FixedPoint2 (quiz 4) and Average (quiz 2) converts the value to double
+    and hands it to the stream. the stream then formats it with the locale's rules, which
+    is slow, and with 6 significant digits by default, which loses information.
+
+    here we write two formatters that write straight into a char buffer:
+        - toShortest(): the SHORTEST decimal text that reads back (with std::from_chars or
+          std::strtod) as exactly the same double (or float). the digits come from
+          std::to_chars, and we lay them out like JavaScript does.
+        - toFixed(): a fixed number of digits after the decimal point, correctly rounded.
+
+    neither of them looks at the locale, so the decimal point is always '.'.
+---------------------------------------------------------------------------------------*/
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                    ============[ where the digits come from ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - a double is f * 2^e with a 53-bit integer f. every number in the half-way interval
+    [m-, m+] around it reads back as the same double, so we want the number with the fewest
+    digits in that interval (and the one closest to the exact value, if there are several).
+
+  - the fast classic for this is Grisu2, but it works with approximate powers of ten and has
+    to shrink the interval to stay safe, so about 1 in 1000 results comes out one digit
+    longer than needed. Grisu3 detects those cases and bails out to a slow exact algorithm;
+    Ryu gets every case exact and fast.
+
+  - std::to_chars(first, last, value, std::chars_format::scientific) with no precision is
+    specified to give exactly the shortest round-trip digits (libstdc++ uses Ryu for it), it
+    never looks at the locale, and it beats a hand-written Grisu2. so we let it produce the
+    digits in "d.ddde+XX" form and only do the layout ourselves.
+*/
+
+namespace float_text
+{
+    namespace detail
+    {
+        // writes the shortest round-trip digits of a positive, finite, non-zero value to out
+        // as buffer[0, length) * 10^decimalExponent
+        template <typename T>
+        void shortestDigits(char* out, int& length, int& decimalExponent, T value)
+        {
+            // "1.2345678901234567e-308" at most
+            char* end{ std::to_chars(out, out + 24, value, std::chars_format::scientific).ptr };
+
+            char* e{ out + 1 };
+            while (*e != 'e')
+                ++e;
+
+            // drop the decimal point, if there is one: "1.23e+05" -> "123"
+            length = 1;
+            if (e != out + 1)
+            {
+                length = static_cast<int>(e - out) - 1;
+                std::memmove(out + 1, out + 2, static_cast<std::size_t>(length - 1));
+            }
+
+            int exponent{ 0 };
+            for (const char* p{ e + 2 }; p != end; ++p)
+                exponent = exponent * 10 + (*p - '0');
+            if (e[1] == '-')
+                exponent = -exponent;
+
+            decimalExponent = exponent - (length - 1);
+        }
+        inline char* writeExponent(char* out, int exponent)
+        {
+            *out++ = 'e';
+            *out++ = exponent < 0 ? '-' : '+';
+            auto magnitude{ static_cast<unsigned>(exponent < 0 ? -exponent : exponent) };
+
+            if (magnitude >= 100)
+            {
+                *out++ = static_cast<char>('0' + magnitude / 100);
+                magnitude %= 100;
+            }
+            *out++ = static_cast<char>('0' + magnitude / 10);
+            *out++ = static_cast<char>('0' + magnitude % 10);
+            return out;
+        }
+
+        // lays out the digits buffer[0, length) * 10^decimalExponent (already at out) as
+        //      123000      1.23        0.000123        1.23e+21        1.23e-07
+        // the same rules as JavaScript's Number.prototype.toString()
+        inline char* layout(char* out, int length, int decimalExponent)
+        {
+            int pointPosition{ length + decimalExponent };     // digits before the decimal point
+
+            if (length <= pointPosition && pointPosition <= 21)
+            {
+                // 123000
+                std::memset(out + length, '0', static_cast<std::size_t>(pointPosition - length));
+                return out + pointPosition;
+            }
+
+            if (0 < pointPosition && pointPosition <= 21)
+            {
+                // 1.23
+                std::memmove(out + pointPosition + 1, out + pointPosition, static_cast<std::size_t>(length - pointPosition));
+                out[pointPosition] = '.';
+                return out + length + 1;
+            }
+
+            if (-6 < pointPosition && pointPosition <= 0)
+            {
+                // 0.000123
+                int zeros{ -pointPosition };
+                std::memmove(out + 2 + zeros, out, static_cast<std::size_t>(length));
+                out[0] = '0';
+                out[1] = '.';
+                std::memset(out + 2, '0', static_cast<std::size_t>(zeros));
+                return out + 2 + zeros + length;
+            }
+
+            // 1.23e+21
+            if (length == 1)
+                return writeExponent(out + 1, pointPosition - 1);
+
+            std::memmove(out + 2, out + 1, static_cast<std::size_t>(length - 1));
+            out[1] = '.';
+            return writeExponent(out + length + 1, pointPosition - 1);
+        }
+    }
+
+    // the longest text toShortest() can write is "-1.2345678901234567e-308" plus a bit of room
+    // for the layouts with zeros ("0.000001234..." / "123...000")
+    constexpr std::size_t g_maxShortestLength{ 32 };
+
+    template <typename T>
+        requires std::is_same_v<T, double> || std::is_same_v<T, float>
+    char* toShortest(char* out, T value)
+    {
+        if (std::isnan(value))
+        {
+            std::memcpy(out, "nan", 3);
+            return out + 3;
+        }
+
+        if (std::signbit(value))
+        {
+            *out++ = '-';
+            value = -value;
+        }
+
+        if (std::isinf(value))
+        {
+            std::memcpy(out, "inf", 3);
+            return out + 3;
+        }
+
+        if (value == 0)
+        {
+            *out = '0';
+            return out + 1;
+        }
+
+        int length{};
+        int decimalExponent{};
+        detail::shortestDigits(out, length, decimalExponent, value);
+
+        return detail::layout(out, length, decimalExponent);
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                 ============[ fixed number of decimal places ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - "2 decimal places" means rounding the EXACT value of the double (not value * 100, which
+    is itself rounded) to a multiple of 0.01.
+
+  - a double is exactly m * 2^e. for the common case -- a magnitude below 2^63 and at most 19
+    decimal places -- m * 10^precision fits in a 128-bit integer, and dividing it by 2^-e is
+    just a shift. the bits shifted out tell us how to round: up if more than half, and to
+    even on an exact tie (the same thing printf does).
+
+  - everything else (huge numbers, silly precisions) goes to std::to_chars, which is exact
+    but slower.
+*/
+
+namespace float_text
+{
+    namespace detail
+    {
+        __extension__ using uint128 = unsigned __int128;
+
+        inline char* writeUnsigned(char* out, uint128 value)
+        {
+            char digits[40];
+            char* p{ digits + sizeof(digits) };
+            do
+            {
+                *--p = static_cast<char>('0' + static_cast<unsigned>(value % 10));
+                value /= 10;
+            } while (value != 0);
+
+            auto length{ static_cast<std::size_t>(digits + sizeof(digits) - p) };
+            std::memcpy(out, p, length);
+            return out + length;
+        }
+    }
+
+    constexpr int g_maxFastPrecision{ 19 };
+
+    // out must have room for 20 + precision characters in the fast case, or 330 + precision
+    // in general (309 integer digits of DBL_MAX, the sign and the point)
+    inline char* toFixed(char* out, double value, int precision)
+    {
+        if (std::isnan(value) || std::isinf(value))
+            return toShortest(out, value);
+
+        auto bits{ std::bit_cast<std::uint64_t>(value) };
+        auto exponentBits{ static_cast<int>((bits >> 52) & 0x7FF) };
+        std::uint64_t mantissa{ bits & ((std::uint64_t{ 1 } << 52) - 1) };
+
+        int exponent{ exponentBits == 0 ? -1074 : exponentBits - 1075 };
+        if (exponentBits != 0)
+            mantissa |= std::uint64_t{ 1 } << 52;
+
+        if (precision < 0 || precision > g_maxFastPrecision || exponent > 10)      // |value| >= 2^63
+            return std::to_chars(out, out + 330 + (precision > 0 ? precision : 0), value, std::chars_format::fixed, precision).ptr;
+
+        std::uint64_t tenToPrecision{ 1 };
+        for (int i{ 0 }; i < precision; ++i)
+            tenToPrecision *= 10;
+
+        // scaled = round(mantissa * 2^exponent * 10^precision), half to even
+        detail::uint128 product{ static_cast<detail::uint128>(mantissa) * tenToPrecision };
+        detail::uint128 scaled{};
+
+        if (exponent >= 0)
+            scaled = product << exponent;
+        else if (-exponent >= 128)
+            scaled = 0;     // way below 0.5 units of the last place, since product < 2^117
+        else
+        {
+            int shift{ -exponent };
+            detail::uint128 half{ detail::uint128{ 1 } << (shift - 1) };
+            detail::uint128 remainder{ product & ((half << 1) - 1) };
+
+            scaled = product >> shift;
+            if (remainder > half || (remainder == half && (scaled & 1)))
+                ++scaled;
+        }
+
+        if (std::signbit(value))
+            *out++ = '-';
+
+        detail::uint128 integral{ scaled / tenToPrecision };
+        auto fractional{ static_cast<std::uint64_t>(scaled % tenToPrecision) };
+
+        out = detail::writeUnsigned(out, integral);
+        if (precision > 0)
+        {
+            *out++ = '.';
+            for (int i{ precision - 1 }; i >= 0; --i)
+            {
+                out[i] = static_cast<char>('0' + fractional % 10);
+                fractional /= 10;
+            }
+            out += precision;
+        }
+        return out;
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+              ============[ FixedPoint2 and Average, revisited ]============
+---------------------------------------------------------------------------------------*/
+
+namespace quizzes
+{
+    // quiz 4
+    class FixedPoint2
+    {
+    private:
+        std::int16_t m_base{};
+        std::int8_t m_fraction{};
+
+    public:
+        FixedPoint2(std::int16_t base, std::int8_t fraction)
+            : m_base{ base }
+            , m_fraction{ fraction }
+        {
+        }
+
+        operator double() const
+        {
+            return static_cast<double>(m_fraction)/100 + m_base;
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const FixedPoint2& p)
+        {
+            // exactly two decimals, and no locale lookup
+            char buffer[48];
+            return out << std::string_view(buffer, float_text::toFixed(buffer, static_cast<double>(p), 2));
+        }
+    };
+
+    // quiz 2
+    class Average
+    {
+    private:
+        std::int_least32_t m_sum{};
+        std::int_least8_t m_num{};
+
+    public:
+        Average& operator+=(int x)
+        {
+            m_sum += static_cast<std::int_least32_t>(x);
+            ++m_num;
+            return *this;
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const Average& average)
+        {
+            // every digit that is needed to get the same double back, and not one more
+            char buffer[float_text::g_maxShortestLength];
+            double value{ static_cast<double>(average.m_sum)/average.m_num };
+            return out << std::string_view(buffer, float_text::toShortest(buffer, value));
+        }
+    };
+
+    void main()
+    {
+        std::cout << FixedPoint2{ 34, 56 } << ' ' << FixedPoint2{ -2, -8 } << ' ' << FixedPoint2{ 0, 5 } << '\n';
+
+        Average avg{};
+        (avg += 4) += 8;
+        avg += 25;
+        std::cout << avg << '\n';       // 12.333333333333334 instead of std::cout's 12.3333
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ round-trip tests ]============
+---------------------------------------------------------------------------------------*/
+
+// every value is formatted, parsed back with std::from_chars, and its bits compared. we also
+// compare the number of digits with plain std::to_chars, so a layout bug that adds or drops a
+// digit shows up as well.
+
+// by default we test the edge values (zero, the smallest and largest, every power of 2 and of
+// 10 and their neighbours) and a few million random bit patterns of each type. there are only
+// 2^32 floats, so we can also test ALL of them: run the program with --exhaustive (it takes a
+// few minutes).
+
+#include <random>
+#include <limits>
+#include <string>
+
+namespace tests
+{
+    struct Result
+    {
+        std::uint64_t tested{};
+        std::uint64_t failures{};
+        std::uint64_t notShortest{};
+    };
+
+    // the number of significant digits only: the layouts differ ("123000" vs "1.23e+05"), but
+    // the digits from the first to the last non-zero one don't
+    int countDigits(const char* first, const char* last)
+    {
+        std::string_view digits(first, static_cast<std::size_t>(last - first));
+        digits = digits.substr(0, digits.find('e'));
+
+        auto firstDigit{ digits.find_first_of("123456789") };
+        auto lastDigit{ digits.find_last_of("123456789") };
+        if (firstDigit == std::string_view::npos)
+            return 1;
+
+        auto count{ lastDigit - firstDigit + 1 };
+        if (digits.substr(firstDigit, count).find('.') != std::string_view::npos)
+            --count;
+        return static_cast<int>(count);
+    }
+
+    template <typename T>
+    void testValue(T value, Result& result)
+    {
+        using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+        if (std::isnan(value) || std::isinf(value))
+            return;
+
+        char text[float_text::g_maxShortestLength];
+        char reference[float_text::g_maxShortestLength];
+        char* end{ float_text::toShortest(text, value) };
+
+        T parsed{};
+        std::from_chars(text, end, parsed);
+        ++result.tested;
+
+        if (std::bit_cast<Bits>(parsed) != std::bit_cast<Bits>(value) && result.failures++ < 10)
+            std::cout << (sizeof(T) == 4 ? "float" : "double") << " round-trip failure: " << std::string_view(text, end) << '\n';
+
+        auto [referenceEnd, ec]{ std::to_chars(reference, reference + sizeof(reference), value, std::chars_format::scientific) };
+        if (countDigits(text, end) != countDigits(reference, referenceEnd))
+            ++result.notShortest;
+    }
+
+    // the values where the digit count or the layout changes, and their neighbours, both signs
+    template <typename T>
+    void testEdges(Result& result)
+    {
+        using limits = std::numeric_limits<T>;
+        auto withNeighbours{ [&](T value) {
+            for (T edge : { value, std::nextafter(value, T{ 0 }), std::nextafter(value, limits::infinity()) })
+            {
+                testValue(edge, result);
+                testValue(-edge, result);
+            }
+        } };
+
+        withNeighbours(T{ 0 });
+        withNeighbours(limits::denorm_min());
+        withNeighbours(limits::min());
+        withNeighbours(limits::max());
+
+        for (int exponent{ limits::min_exponent - limits::digits }; exponent < limits::max_exponent; ++exponent)
+            withNeighbours(std::ldexp(T{ 1 }, exponent));
+
+        for (int exponent{ limits::min_exponent10 - limits::digits10 - 2 }; exponent <= limits::max_exponent10; ++exponent)
+        {
+            std::string power{ "1e" + std::to_string(exponent) };
+            T value{};
+            std::from_chars(power.data(), power.data() + power.size(), value);
+            withNeighbours(value);
+        }
+    }
+
+    Result testFloats(bool exhaustive)
+    {
+        Result result{};
+        testEdges<float>(result);
+
+        if (exhaustive)
+        {
+            for (std::uint64_t bits{ 0 }; bits <= 0xFFFFFFFFULL; ++bits)
+                testValue(std::bit_cast<float>(static_cast<std::uint32_t>(bits)), result);
+        }
+        else
+        {
+            std::mt19937_64 mt{ 42 };
+            for (int i{ 0 }; i < 4'000'000; ++i)
+                testValue(std::bit_cast<float>(static_cast<std::uint32_t>(mt())), result);
+        }
+
+        return result;
+    }
+
+    Result testDoubles(std::uint64_t count)
+    {
+        Result result{};
+        testEdges<double>(result);
+
+        std::mt19937_64 mt{ 42 };
+        for (std::uint64_t i{ 0 }; i < count; ++i)
+            testValue(std::bit_cast<double>(mt()), result);
+
+        return result;
+    }
+
+    // toFixed() against std::to_chars, which is exact
+    Result testFixed(std::uint64_t count)
+    {
+        Result result{};
+        std::mt19937_64 mt{ 7 };
+        std::uniform_real_distribution<double> magnitudes{ -20.0, 18.0 };
+        char ours[400];
+        char reference[400];
+
+        for (std::uint64_t i{ 0 }; i < count; ++i)
+        {
+            double value{ std::pow(10.0, magnitudes(mt)) * (mt() % 2 ? 1 : -1) };
+            auto precision{ static_cast<int>(mt() % 20) };
+            if (i % 4 == 0)
+                value = static_cast<double>(static_cast<std::int64_t>(mt() % 100000)) / 8;     // exact ties, like 0.125
+
+            std::string_view a(ours, float_text::toFixed(ours, value, precision));
+            std::string_view b(reference, std::to_chars(reference, reference + sizeof(reference), value,
+                                                        std::chars_format::fixed, precision).ptr);
+            ++result.tested;
+
+            if (a != b && result.failures++ < 10)
+                std::cout << "fixed mismatch: " << a << " vs " << b << '\n';
+        }
+
+        return result;
+    }
+
+    void main(bool exhaustive)
+    {
+        auto floats{ testFloats(exhaustive) };
+        std::cout << "floats : " << floats.tested << " tested, " << floats.failures << " round-trip failures, "
+                  << floats.notShortest << " not shortest\n";
+
+        auto doubles{ testDoubles(4'000'000) };
+        std::cout << "doubles: " << doubles.tested << " tested, " << doubles.failures << " round-trip failures, "
+                  << doubles.notShortest << " not shortest\n";
+
+        auto fixed{ testFixed(1'000'000) };
+        std::cout << "fixed  : " << fixed.tested << " tested, " << fixed.failures << " mismatches\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                        ============[ throughput ]============
+---------------------------------------------------------------------------------------*/
+
+#include <chrono>
+#include <sstream>
+#include <vector>
+#include <cstdio>       // std::snprintf
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    template <typename Fn>
+    void run(std::string_view name, const std::vector<double>& values, Fn fn)
+    {
+        std::vector<char> buffer(values.size() * 40);
+
+        Timer t;
+        char* out{ buffer.data() };
+        for (double value : values)
+        {
+            out = fn(out, value);
+            *out++ = '\n';
+        }
+        double time{ t.elapsed() };
+
+        std::cout << name << static_cast<double>(values.size()) / time / 1e6 << " million/s\n";
+    }
+
+    void main()
+    {
+        std::mt19937_64 mt{ 1 };
+        std::uniform_real_distribution<double> metrics{ 0.0, 1000.0 };
+        std::vector<double> values(2'000'000);
+        for (double& value : values)
+            value = metrics(mt);
+
+        run("toShortest             : ", values, [](char* out, double v) { return float_text::toShortest(out, v); });
+        run("std::to_chars          : ", values, [](char* out, double v) { return std::to_chars(out, out + 32, v).ptr; });
+        run("snprintf %.17g         : ", values, [](char* out, double v) { return out + std::snprintf(out, 32, "%.17g", v); });
+        run("toFixed(3)             : ", values, [](char* out, double v) { return float_text::toFixed(out, v, 3); });
+        run("std::to_chars fixed(3) : ", values, [](char* out, double v) {
+            return std::to_chars(out, out + 40, v, std::chars_format::fixed, 3).ptr; });
+
+        std::vector<double> fewer(values.begin(), values.begin() + 200'000);
+        run("std::ostringstream     : ", fewer, [](char* out, double v) {
+            std::ostringstream stream{};
+            stream.precision(17);
+            stream << v;
+            auto text{ stream.str() };
+            std::memcpy(out, text.data(), text.size());
+            return out + text.size();
+        });
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main(int argc, char* argv[])
+{
+    quizzes::main();
+    tests::main(argc > 1 && std::string_view{ argv[1] } == "--exhaustive");
+    benchmark::main();
+
+    return 0;
+}
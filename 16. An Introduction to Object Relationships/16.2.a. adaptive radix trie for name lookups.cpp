@@ -0,0 +1,983 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>       // std::reference_wrapper
+#include <algorithm>        // std::min
+#include <utility>          // std::move
+#include <bit>              // std::countr_zero
+#include <cstdint>
+#include <cstddef>          // std::size_t
+#include <cstring>          // std::memmove, std::memcpy
+#include <new>              // ::operator new
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+
+// quiz::Department in 16.2 keeps its teachers in a std::vector. finding a teacher by name, or
+// every teacher whose name starts with "Be", means looking at every teacher.
+
+// a trie stores the names character by character: all names that start with "Be" share the
+// path B -> e, so a prefix query walks down that path and then lists everything below it.
+// a naive trie wastes a lot of memory though (a node per character, 256 child pointers per
+// node). an ADAPTIVE RADIX TREE (ART) fixes both:
+    // - path compression: a chain of nodes with only one child is stored as one node with a
+    //   string prefix ("lazy expansion" does the same for the tail of a single key: it just
+    //   stays in the leaf).
+    // - adaptive node sizes: a node with few children uses a small node type, and grows into a
+    //   bigger one when it fills up:
+    //       Node4    up to 4 children     sorted key bytes, linear search
+    //       Node16   up to 16 children    sorted key bytes, searched with one SIMD compare
+    //       Node48   up to 48 children    a 256 entry byte-index into 48 child slots
+    //       Node256  up to 256 children   direct array, indexed by the byte
+    // - children are kept in byte order, so walking the tree lists the keys SORTED, which is
+    //   what autocomplete wants.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ the adaptive radix tree ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - a key can be a prefix of another key ("Bob" and "Bobby"). the node where "Bob" ends keeps
+    the leaf for "Bob" in a separate [terminal] slot, and that leaf comes first when listing
+    the node in order (a shorter key sorts before its extensions).
+
+  - there is no erase: names are only ever added to a department. (erase would shrink nodes
+    the same way insert grows them.)
+*/
+
+namespace art
+{
+    template <typename T>
+    class RadixTree
+    {
+    private:
+        enum class NodeType : std::uint8_t
+        {
+            leaf,
+            node4,
+            node16,
+            node48,
+            node256,
+        };
+
+        struct Node
+        {
+            NodeType type{};
+        };
+
+        // the characters of the key are stored right after the leaf, in the same allocation
+        struct Leaf : Node
+        {
+            std::uint32_t length{};
+            T value;
+
+            Leaf(std::size_t keyLength, T v)
+                : Node{ NodeType::leaf }
+                , length{ static_cast<std::uint32_t>(keyLength) }
+                , value{ std::move(v) }
+            {
+            }
+
+            std::string_view key() const { return { reinterpret_cast<const char*>(this + 1), length }; }
+
+            static Leaf* make(std::string_view key, T value)
+            {
+                void* memory{ ::operator new(sizeof(Leaf) + key.size()) };
+                auto leaf{ ::new (memory) Leaf{ key.size(), std::move(value) } };
+                std::memcpy(leaf + 1, key.data(), key.size());
+                return leaf;
+            }
+
+            static void destroy(Leaf* leaf)
+            {
+                if (leaf)
+                {
+                    leaf->~Leaf();
+                    ::operator delete(leaf);
+                }
+            }
+        };
+
+        struct Inner : Node
+        {
+            std::uint16_t count{ 0 };
+            std::string prefix{};
+            Leaf* terminal{ nullptr };
+        };
+
+        struct Node4 : Inner
+        {
+            std::uint8_t keys[4]{};
+            Node* children[4]{};
+
+            Node4() { this->type = NodeType::node4; }
+        };
+
+        struct Node16 : Inner
+        {
+            std::uint8_t keys[16]{};
+            Node* children[16]{};
+
+            Node16() { this->type = NodeType::node16; }
+        };
+
+        struct Node48 : Inner
+        {
+            std::uint8_t index[256]{};      // 0 = no child, otherwise slot + 1
+            Node* children[48]{};
+
+            Node48() { this->type = NodeType::node48; }
+        };
+
+        struct Node256 : Inner
+        {
+            Node* children[256]{};
+
+            Node256() { this->type = NodeType::node256; }
+        };
+
+        Node* m_root{ nullptr };
+        std::size_t m_size{ 0 };
+
+        static std::uint8_t byteAt(std::string_view key, std::size_t depth)
+        {
+            return static_cast<std::uint8_t>(key[depth]);
+        }
+
+        // the child slot for [byte], or nullptr
+        static Node** findChild(Inner* inner, std::uint8_t byte)
+        {
+            switch (inner->type)
+            {
+            case NodeType::node4:
+            {
+                auto node{ static_cast<Node4*>(inner) };
+                for (std::size_t i{ 0 }; i < node->count; ++i)
+                {
+                    if (node->keys[i] == byte)
+                        return &node->children[i];
+                }
+                return nullptr;
+            }
+            case NodeType::node16:
+            {
+                auto node{ static_cast<Node16*>(inner) };
+#if defined(__SSE2__)
+                __m128i equal{ _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i*>(node->keys))) };
+                unsigned mask{ static_cast<unsigned>(_mm_movemask_epi8(equal)) & ((1u << node->count) - 1) };
+                return mask ? &node->children[std::countr_zero(mask)] : nullptr;
+#else
+                for (std::size_t i{ 0 }; i < node->count; ++i)
+                {
+                    if (node->keys[i] == byte)
+                        return &node->children[i];
+                }
+                return nullptr;
+#endif
+            }
+            case NodeType::node48:
+            {
+                auto node{ static_cast<Node48*>(inner) };
+                std::uint8_t slot{ node->index[byte] };
+                return slot ? &node->children[slot - 1] : nullptr;
+            }
+            case NodeType::node256:
+            {
+                auto node{ static_cast<Node256*>(inner) };
+                return node->children[byte] ? &node->children[byte] : nullptr;
+            }
+            default:
+                return nullptr;
+            }
+        }
+
+        // inserts into a sorted key/child array with room for one more
+        static void insertSorted(std::uint8_t* keys, Node** children, std::size_t count, std::uint8_t byte, Node* child)
+        {
+            std::size_t position{ 0 };
+            while (position < count && keys[position] < byte)
+                ++position;
+
+            std::memmove(keys + position + 1, keys + position, count - position);
+            std::memmove(children + position + 1, children + position, (count - position) * sizeof(Node*));
+            keys[position] = byte;
+            children[position] = child;
+        }
+
+        template <typename Bigger, typename Smaller>
+        static Bigger* growFrom(Smaller* node)
+        {
+            auto bigger{ new Bigger{} };
+            bigger->count = node->count;
+            bigger->prefix = std::move(node->prefix);
+            bigger->terminal = node->terminal;
+            return bigger;
+        }
+
+        // adds a child under a byte that isn't there yet. [slot] is the pointer to the node,
+        // which is replaced by a bigger node when the current one is full.
+        static void addChild(Node*& slot, std::uint8_t byte, Node* child)
+        {
+            switch (slot->type)
+            {
+            case NodeType::node4:
+            {
+                auto node{ static_cast<Node4*>(slot) };
+                if (node->count < 4)
+                {
+                    insertSorted(node->keys, node->children, node->count++, byte, child);
+                    return;
+                }
+
+                auto bigger{ growFrom<Node16>(node) };
+                std::copy(node->keys, node->keys + 4, bigger->keys);
+                std::copy(node->children, node->children + 4, bigger->children);
+                delete node;
+                slot = bigger;
+                insertSorted(bigger->keys, bigger->children, bigger->count++, byte, child);
+                return;
+            }
+            case NodeType::node16:
+            {
+                auto node{ static_cast<Node16*>(slot) };
+                if (node->count < 16)
+                {
+                    insertSorted(node->keys, node->children, node->count++, byte, child);
+                    return;
+                }
+
+                auto bigger{ growFrom<Node48>(node) };
+                for (std::uint8_t i{ 0 }; i < 16; ++i)
+                {
+                    bigger->index[node->keys[i]] = static_cast<std::uint8_t>(i + 1);
+                    bigger->children[i] = node->children[i];
+                }
+                delete node;
+                slot = bigger;
+                addChild(slot, byte, child);
+                return;
+            }
+            case NodeType::node48:
+            {
+                auto node{ static_cast<Node48*>(slot) };
+                if (node->count < 48)
+                {
+                    // children are never removed, so the slots 0..count-1 are the used ones
+                    node->children[node->count] = child;
+                    node->index[byte] = static_cast<std::uint8_t>(++node->count);
+                    return;
+                }
+
+                auto bigger{ growFrom<Node256>(node) };
+                for (std::size_t b{ 0 }; b < 256; ++b)
+                {
+                    if (node->index[b])
+                        bigger->children[b] = node->children[node->index[b] - 1];
+                }
+                delete node;
+                slot = bigger;
+                addChild(slot, byte, child);
+                return;
+            }
+            case NodeType::node256:
+            {
+                auto node{ static_cast<Node256*>(slot) };
+                node->children[byte] = child;
+                ++node->count;
+                return;
+            }
+            default:
+                return;
+            }
+        }
+
+        // puts a leaf into a fresh node whose path ends at [depth]
+        static void placeLeaf(Node*& slot, Leaf* leaf, std::size_t depth)
+        {
+            auto inner{ static_cast<Inner*>(slot) };
+            if (depth == leaf->key().size())
+                inner->terminal = leaf;
+            else
+                addChild(slot, byteAt(leaf->key(), depth), leaf);
+        }
+
+        // returns false if the key was already there (and its value has been replaced)
+        bool insert(Node*& slot, std::string_view key, std::size_t depth, T& value)
+        {
+            if (!slot)
+            {
+                slot = Leaf::make(key, std::move(value));
+                return true;
+            }
+
+            if (slot->type == NodeType::leaf)
+            {
+                auto leaf{ static_cast<Leaf*>(slot) };
+                if (leaf->key() == key)
+                {
+                    leaf->value = std::move(value);
+                    return false;
+                }
+
+                // two keys share this path: a new node for their common part, with both below it
+                std::size_t common{ 0 };
+                std::size_t limit{ std::min(leaf->key().size(), key.size()) - depth };
+                while (common < limit && leaf->key()[depth + common] == key[depth + common])
+                    ++common;
+
+                auto node{ new Node4{} };
+                node->prefix = key.substr(depth, common);
+                Node* replacement{ node };
+                placeLeaf(replacement, leaf, depth + common);
+                placeLeaf(replacement, Leaf::make(key, std::move(value)), depth + common);
+                slot = replacement;
+                return true;
+            }
+
+            auto inner{ static_cast<Inner*>(slot) };
+            std::string_view prefix{ inner->prefix };
+
+            std::size_t matched{ 0 };
+            while (matched < prefix.size() && depth + matched < key.size() && prefix[matched] == key[depth + matched])
+                ++matched;
+
+            if (matched < prefix.size())
+            {
+                // the key leaves the compressed path halfway: split the path at that point
+                auto node{ new Node4{} };
+                node->prefix = inner->prefix.substr(0, matched);
+                std::uint8_t byte{ static_cast<std::uint8_t>(inner->prefix[matched]) };
+                inner->prefix.erase(0, matched + 1);
+
+                Node* replacement{ node };
+                addChild(replacement, byte, inner);
+                placeLeaf(replacement, Leaf::make(key, std::move(value)), depth + matched);
+                slot = replacement;
+                return true;
+            }
+
+            depth += prefix.size();
+            if (depth == key.size())
+            {
+                if (inner->terminal)
+                {
+                    inner->terminal->value = std::move(value);
+                    return false;
+                }
+                inner->terminal = Leaf::make(key, std::move(value));
+                return true;
+            }
+
+            if (Node** child{ findChild(inner, byteAt(key, depth)) })
+                return insert(*child, key, depth + 1, value);
+
+            addChild(slot, byteAt(key, depth), Leaf::make(key, std::move(value)));
+            return true;
+        }
+
+        // calls visit(leaf) for every leaf below node, in key order, until visit returns false
+        template <typename Visit>
+        static bool walk(const Node* node, Visit& visit)
+        {
+            if (node->type == NodeType::leaf)
+                return visit(*static_cast<const Leaf*>(node));
+
+            auto inner{ static_cast<const Inner*>(node) };
+            if (inner->terminal && !visit(*inner->terminal))
+                return false;
+
+            switch (node->type)
+            {
+            case NodeType::node4:
+            {
+                auto n{ static_cast<const Node4*>(node) };
+                for (std::size_t i{ 0 }; i < n->count; ++i)
+                {
+                    if (!walk(n->children[i], visit))
+                        return false;
+                }
+                return true;
+            }
+            case NodeType::node16:
+            {
+                auto n{ static_cast<const Node16*>(node) };
+                for (std::size_t i{ 0 }; i < n->count; ++i)
+                {
+                    if (!walk(n->children[i], visit))
+                        return false;
+                }
+                return true;
+            }
+            case NodeType::node48:
+            {
+                auto n{ static_cast<const Node48*>(node) };
+                for (std::size_t b{ 0 }; b < 256; ++b)
+                {
+                    if (n->index[b] && !walk(n->children[n->index[b] - 1], visit))
+                        return false;
+                }
+                return true;
+            }
+            case NodeType::node256:
+            {
+                auto n{ static_cast<const Node256*>(node) };
+                for (std::size_t b{ 0 }; b < 256; ++b)
+                {
+                    if (n->children[b] && !walk(n->children[b], visit))
+                        return false;
+                }
+                return true;
+            }
+            default:
+                return true;
+            }
+        }
+
+        // the node below which every key starts with [prefix], or nullptr if there is none
+        const Node* findPrefix(std::string_view prefix) const
+        {
+            const Node* node{ m_root };
+            std::size_t depth{ 0 };
+
+            while (node)
+            {
+                if (node->type == NodeType::leaf)
+                    return static_cast<const Leaf*>(node)->key().starts_with(prefix) ? node : nullptr;
+
+                auto inner{ static_cast<const Inner*>(node) };
+                std::size_t length{ std::min(inner->prefix.size(), prefix.size() - depth) };
+                if (inner->prefix.compare(0, length, prefix, depth, length) != 0)
+                    return nullptr;
+
+                depth += inner->prefix.size();
+                if (depth >= prefix.size())
+                    return node;
+
+                Node** child{ findChild(const_cast<Inner*>(inner), byteAt(prefix, depth)) };
+                node = child ? *child : nullptr;
+                ++depth;
+            }
+            return nullptr;
+        }
+
+        static void destroy(Node* node)
+        {
+            if (!node)
+                return;
+
+            if (node->type == NodeType::leaf)
+            {
+                Leaf::destroy(static_cast<Leaf*>(node));
+                return;
+            }
+
+            auto inner{ static_cast<Inner*>(node) };
+            Leaf::destroy(inner->terminal);
+
+            switch (node->type)
+            {
+            case NodeType::node4:
+                for (std::size_t i{ 0 }; i < inner->count; ++i)
+                    destroy(static_cast<Node4*>(node)->children[i]);
+                delete static_cast<Node4*>(node);
+                break;
+            case NodeType::node16:
+                for (std::size_t i{ 0 }; i < inner->count; ++i)
+                    destroy(static_cast<Node16*>(node)->children[i]);
+                delete static_cast<Node16*>(node);
+                break;
+            case NodeType::node48:
+                for (std::size_t i{ 0 }; i < inner->count; ++i)
+                    destroy(static_cast<Node48*>(node)->children[i]);
+                delete static_cast<Node48*>(node);
+                break;
+            case NodeType::node256:
+                for (Node* child : static_cast<Node256*>(node)->children)
+                    destroy(child);
+                delete static_cast<Node256*>(node);
+                break;
+            default:
+                break;
+            }
+        }
+
+        // heap memory owned by a string (0 when it fits in the string object itself)
+        static std::size_t heapBytes(const std::string& string)
+        {
+            return string.capacity() > std::string{}.capacity() ? string.capacity() + 1 : 0;
+        }
+
+        static std::size_t memoryOf(const Node* node)
+        {
+            if (!node)
+                return 0;
+
+            if (node->type == NodeType::leaf)
+                return sizeof(Leaf) + static_cast<const Leaf*>(node)->length;
+
+            auto inner{ static_cast<const Inner*>(node) };
+            std::size_t bytes{ heapBytes(inner->prefix) + memoryOf(inner->terminal) };
+            switch (node->type)
+            {
+            case NodeType::node4:
+                bytes += sizeof(Node4);
+                for (std::size_t i{ 0 }; i < inner->count; ++i)
+                    bytes += memoryOf(static_cast<const Node4*>(node)->children[i]);
+                break;
+            case NodeType::node16:
+                bytes += sizeof(Node16);
+                for (std::size_t i{ 0 }; i < inner->count; ++i)
+                    bytes += memoryOf(static_cast<const Node16*>(node)->children[i]);
+                break;
+            case NodeType::node48:
+                bytes += sizeof(Node48);
+                for (std::size_t i{ 0 }; i < inner->count; ++i)
+                    bytes += memoryOf(static_cast<const Node48*>(node)->children[i]);
+                break;
+            case NodeType::node256:
+                bytes += sizeof(Node256);
+                for (const Node* child : static_cast<const Node256*>(node)->children)
+                    bytes += memoryOf(child);
+                break;
+            default:
+                break;
+            }
+            return bytes;
+        }
+
+    public:
+        RadixTree() = default;
+        RadixTree(const RadixTree&) = delete;
+        RadixTree& operator=(const RadixTree&) = delete;
+
+        ~RadixTree()
+        {
+            destroy(m_root);
+        }
+
+        std::size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        // adds the key, or replaces its value if it's already there
+        void insert(std::string_view key, T value)
+        {
+            if (insert(m_root, key, 0, value))
+                ++m_size;
+        }
+
+        const T* find(std::string_view key) const
+        {
+            const Node* node{ m_root };
+            std::size_t depth{ 0 };
+
+            while (node)
+            {
+                if (node->type == NodeType::leaf)
+                {
+                    auto leaf{ static_cast<const Leaf*>(node) };
+                    return leaf->key() == key ? &leaf->value : nullptr;
+                }
+
+                auto inner{ static_cast<const Inner*>(node) };
+                if (key.size() - depth < inner->prefix.size() || key.compare(depth, inner->prefix.size(), inner->prefix) != 0)
+                    return nullptr;
+
+                depth += inner->prefix.size();
+                if (depth == key.size())
+                    return inner->terminal ? &inner->terminal->value : nullptr;
+
+                Node** child{ findChild(const_cast<Inner*>(inner), byteAt(key, depth)) };
+                node = child ? *child : nullptr;
+                ++depth;
+            }
+            return nullptr;
+        }
+
+        // calls fn(key, value) for every key, in sorted order
+        template <typename Fn>
+        void forEach(Fn&& fn) const
+        {
+            forEachWithPrefix("", fn);
+        }
+
+        // calls fn(key, value) for every key that starts with [prefix], in sorted order
+        template <typename Fn>
+        void forEachWithPrefix(std::string_view prefix, Fn&& fn) const
+        {
+            if (const Node* node{ findPrefix(prefix) })
+            {
+                auto visit{ [&fn](const Leaf& leaf) { fn(leaf.key(), leaf.value); return true; } };
+                walk(node, visit);
+            }
+        }
+
+        // puts the first [limit] keys (in sorted order) that start with [prefix] into [result],
+        // and returns how many there are. this stops walking as soon as it has enough, so it
+        // costs O(prefix length + limit), however many names match. [result] is cleared first,
+        // so a caller that completes over and over can keep reusing the same vector (and its
+        // capacity) instead of getting a new one every time.
+        std::size_t complete(std::string_view prefix, std::size_t limit, std::vector<std::pair<std::string_view, const T*>>& result) const
+        {
+            result.clear();
+            const Node* node{ findPrefix(prefix) };
+            if (!node || limit == 0)
+                return 0;
+
+            auto visit{ [&](const Leaf& leaf) {
+                result.emplace_back(leaf.key(), &leaf.value);
+                return result.size() < limit;
+            } };
+            walk(node, visit);
+            return result.size();
+        }
+
+        // bytes of heap memory used by the nodes, leaves and their strings
+        std::size_t memoryUsage() const
+        {
+            return memoryOf(m_root);
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ Department, with an index ]============
+---------------------------------------------------------------------------------------*/
+
+// the department still owns its list of teachers in the order they were added. the tree is an
+// index on top of it: it maps each name to the teacher (a reference, like the vector holds).
+// two teachers with the same name share an index entry, which points at the one added last.
+
+namespace quiz
+{
+    class Teacher
+    {
+    private:
+        std::string m_name{};
+
+    public:
+        Teacher(const std::string_view name)
+            : m_name{ name }
+        {
+        }
+
+        const std::string& getName() const { return m_name; }
+    };
+
+    class Department
+    {
+    private:
+        std::vector<std::reference_wrapper<const Teacher>> m_teachers{};
+        art::RadixTree<std::reference_wrapper<const Teacher>> m_byName{};
+
+    public:
+        Department() = default;
+
+        void add(const Teacher& teacher)
+        {
+            m_teachers.push_back(teacher);
+            m_byName.insert(teacher.getName(), teacher);
+        }
+
+        const Teacher* find(std::string_view name) const
+        {
+            auto found{ m_byName.find(name) };
+            return found ? &found->get() : nullptr;
+        }
+
+        // the teachers whose name starts with [prefix], sorted by name
+        std::vector<std::reference_wrapper<const Teacher>> startingWith(std::string_view prefix) const
+        {
+            std::vector<std::reference_wrapper<const Teacher>> result{};
+            m_byName.forEachWithPrefix(prefix, [&result](std::string_view, const Teacher& teacher) { result.push_back(teacher); });
+            return result;
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const Department& dept);
+    };
+
+    std::ostream& operator<<(std::ostream& out, const Department& dept)
+    {
+        out << "Department: ";
+        for (const auto& teacher: dept.m_teachers)
+            out << teacher.get().getName() << ' ';
+        return out;
+    }
+
+    void main()
+    {
+        Teacher t1{ "Bob" };
+        Teacher t2{ "Frank" };
+        Teacher t3{ "Beth" };
+        Teacher t4{ "Bobby" };
+
+        Department department{};
+        department.add(t1);
+        department.add(t2);
+        department.add(t3);
+        department.add(t4);
+
+        std::cout << department << '\n';
+
+        if (const Teacher* frank{ department.find("Frank") })
+            std::cout << "found " << frank->getName() << '\n';
+        std::cout << "Fred is " << (department.find("Fred") ? "" : "not ") << "in the department\n";
+
+        std::cout << "names starting with B:";
+        for (const Teacher& teacher : department.startingWith("B"))
+            std::cout << ' ' << teacher.getName();
+        std::cout << '\n';
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+// random names (with lots of shared prefixes, and names that are prefixes of other names),
+// compared against a sorted std::vector
+
+#include <random>
+
+namespace checks
+{
+    std::string randomName(std::mt19937_64& mt)
+    {
+        static constexpr std::string_view syllables[]{ "an", "be", "bo", "ca", "da", "el", "fa", "ga", "ha", "jo",
+                                                       "ka", "li", "ma", "na", "ol", "pe", "ra", "sa", "ta", "vi" };
+        std::string name{};
+        std::size_t count{ 1 + mt() % 4 };
+        for (std::size_t i{ 0 }; i < count; ++i)
+            name += syllables[mt() % std::size(syllables)];
+        if (mt() % 8 == 0)
+            name += static_cast<char>(0x80 + mt() % 0x80);      // bytes >= 0x80 must sort after ASCII
+        return name;
+    }
+
+    void main()
+    {
+        std::mt19937_64 mt{ 35 };
+        std::vector<std::string> names{};
+        art::RadixTree<int> tree{};
+
+        for (int i{ 0 }; i < 50'000; ++i)
+        {
+            names.push_back(randomName(mt));
+            tree.insert(names.back(), static_cast<int>(names.back().size()));
+        }
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+
+        int failures{ static_cast<int>(tree.size() != names.size()) };
+
+        for (const auto& name : names)
+        {
+            const int* value{ tree.find(name) };
+            failures += !value || *value != static_cast<int>(name.size());
+        }
+        for (int i{ 0 }; i < 10'000; ++i)
+        {
+            std::string name{ randomName(mt) + "x" };
+            failures += tree.find(name) != nullptr;
+        }
+
+        // full ordered walk
+        std::size_t position{ 0 };
+        tree.forEach([&](std::string_view key, int) { failures += position >= names.size() || names[position++] != key; });
+        failures += position != names.size();
+
+        // prefix queries
+        for (int i{ 0 }; i < 2'000; ++i)
+        {
+            std::string prefix{ randomName(mt).substr(0, mt() % 5) };
+            auto first{ std::lower_bound(names.begin(), names.end(), prefix) };
+
+            auto it{ first };
+            tree.forEachWithPrefix(prefix, [&](std::string_view key, int) { failures += it == names.end() || *it++ != key; });
+            failures += it != names.end() && it->starts_with(prefix);
+
+            std::vector<std::pair<std::string_view, const int*>> completions{};
+            failures += tree.complete(prefix, 10, completions) != completions.size();
+            failures += completions.size() != std::min<std::size_t>(10, static_cast<std::size_t>(it - first));
+            for (std::size_t c{ 0 }; c < completions.size(); ++c)
+                failures += first + static_cast<std::ptrdiff_t>(c) == names.end() || first[static_cast<std::ptrdiff_t>(c)] != completions[c].first;
+        }
+
+        std::cout << "checks: " << names.size() << " names, " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// exact lookups, autocomplete (the first 10 names with a prefix) and memory, against a sorted
+// std::vector of (name, teacher) pairs searched with std::lower_bound
+
+// on the machine this was written on, with 2 million names, the tree finds a name about twice
+// as fast as the binary search, but it LOSES on the other two: complete(10) takes about 780 ns
+// against 575 ns, and the tree needs 141 MiB against 117 MiB.
+    // - after its one binary search, the vector's 10 names sit next to each other. the tree
+    //   visits 10 leaves, and every leaf is its own allocation somewhere in the heap.
+    // - a leaf stores its whole name (so that key() can return it), and the nodes above the
+    //   leaves come on top of that. the vector only has the names.
+// so the tree is worth it for exact lookups, and for a set of names that keeps changing (every
+// insert into the sorted vector shifts half of it), not for autocomplete on a fixed set.
+
+#include <chrono>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    constexpr std::size_t g_names{ 2'000'000 };
+    constexpr std::size_t g_queries{ 1'000'000 };
+
+    std::size_t stringHeap(const std::string& string)
+    {
+        return string.capacity() > std::string{}.capacity() ? string.capacity() + 1 : 0;
+    }
+
+    void main()
+    {
+        static constexpr std::string_view firstNames[]{ "james", "mary", "john", "patricia", "robert", "jennifer", "michael",
+                                                        "linda", "william", "elizabeth", "david", "barbara", "richard", "susan",
+                                                        "joseph", "jessica", "thomas", "sarah", "charles", "karen" };
+        std::mt19937_64 mt{ 36 };
+
+        // "firstname lastname-suffix" with random syllable last names, so that there are many
+        // shared prefixes but also a long, varied tail
+        std::vector<std::string> names(g_names);
+        for (auto& name : names)
+        {
+            name = firstNames[mt() % std::size(firstNames)];
+            name += ' ';
+            name += checks::randomName(mt);
+            name += checks::randomName(mt);
+            name += ' ';
+            name += std::to_string(mt() % 1000);
+        }
+
+        std::vector<quiz::Teacher> teachers(names.begin(), names.end());
+
+        Timer t;
+        art::RadixTree<const quiz::Teacher*> tree{};
+        for (const auto& teacher : teachers)
+            tree.insert(teacher.getName(), &teacher);
+        double treeBuild{ t.elapsed() };
+
+        t.reset();
+        std::vector<std::pair<std::string, const quiz::Teacher*>> sorted{};
+        sorted.reserve(teachers.size());
+        for (const auto& teacher : teachers)
+            sorted.emplace_back(teacher.getName(), &teacher);
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first == b.first; }), sorted.end());
+        double vectorBuild{ t.elapsed() };
+
+        std::vector<std::string> queries(g_queries);
+        for (auto& query : queries)
+            query = names[mt() % names.size()];
+
+        std::vector<std::string> prefixes(g_queries);
+        for (auto& prefix : prefixes)
+        {
+            const std::string& name{ names[mt() % names.size()] };
+            prefix = name.substr(0, std::min(name.size(), 3 + mt() % 8));
+        }
+
+        // exact lookups
+        t.reset();
+        std::size_t found{ 0 };
+        for (const auto& query : queries)
+            found += tree.find(query) != nullptr;
+        double treeFind{ t.elapsed() };
+
+        t.reset();
+        for (const auto& query : queries)
+        {
+            auto it{ std::lower_bound(sorted.begin(), sorted.end(), query, [](const auto& entry, const std::string& key) { return entry.first < key; }) };
+            found += it != sorted.end() && it->first == query;
+        }
+        double vectorFind{ t.elapsed() };
+
+        // autocomplete, both into a reused vector
+        t.reset();
+        std::size_t completed{ 0 };
+        std::vector<std::pair<std::string_view, const quiz::Teacher* const*>> completions{};
+        for (const auto& prefix : prefixes)
+            completed += tree.complete(prefix, 10, completions);
+        double treeComplete{ t.elapsed() };
+
+        t.reset();
+        std::vector<std::pair<std::string_view, const quiz::Teacher*>> results{};
+        for (const auto& prefix : prefixes)
+        {
+            results.clear();
+            auto it{ std::lower_bound(sorted.begin(), sorted.end(), prefix, [](const auto& entry, const std::string& key) { return entry.first < key; }) };
+            for (; it != sorted.end() && results.size() < 10 && it->first.starts_with(prefix); ++it)
+                results.emplace_back(it->first, it->second);
+            completed += results.size();
+        }
+        double vectorComplete{ t.elapsed() };
+
+        std::size_t vectorMemory{ sorted.capacity() * sizeof(sorted[0]) };
+        for (const auto& entry : sorted)
+            vectorMemory += stringHeap(entry.first);
+
+        auto perQuery{ [](double seconds) { return seconds * 1e9 / static_cast<double>(g_queries); } };
+        std::cout << "(" << tree.size() << " distinct names)\n"
+                  << "RadixTree     : build " << treeBuild << " s, find " << perQuery(treeFind) << " ns, complete(10) "
+                  << perQuery(treeComplete) << " ns, " << tree.memoryUsage() / (1 << 20) << " MiB\n"
+                  << "sorted vector : build " << vectorBuild << " s, find " << perQuery(vectorFind) << " ns, complete(10) "
+                  << perQuery(vectorComplete) << " ns, " << vectorMemory / (1 << 20) << " MiB"
+                  << (found == 0 || completed == 0 ? " ?" : "") << '\n';
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    quiz::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
@@ -0,0 +1,667 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <thread>
+#include <atomic>
+#include <algorithm>        // std::sort, std::unique, std::max
+#include <numeric>          // std::exclusive_scan
+#include <cstdint>
+#include <cstddef>          // std::size_t
+
+
+// in 16.3 every Doctor has a std::vector of references to its Patients, and every Patient a
+// std::vector of references to its Doctors. that's fine for three patients. for hundreds of
+// millions of associations it isn't:
+    // - every doctor and every patient has its own heap allocation (two, counting the name),
+    //   each with allocator overhead and push_back's spare capacity.
+    // - a reference is 8 bytes, even though a 4 byte number is enough to tell 4 billion
+    //   doctors apart.
+    // - going from a doctor to its patients to THEIR doctors jumps all over memory.
+
+// the compressed sparse row (CSR) format stores the whole graph in two arrays per direction:
+    // - neighbors: the patients of doctor 0, then the patients of doctor 1, ... back to back.
+    // - offsets: where each doctor's patients start. doctor d's patients are
+    //   neighbors[offsets[d] .. offsets[d + 1]), and its degree is offsets[d + 1] - offsets[d].
+// that's 4 bytes per association (per direction) plus 8 bytes per doctor, with no pointers at
+// all. the catch is that inserting into the middle of an array is expensive, so new
+// associations are collected in a batch, and the arrays are rebuilt in one linear pass.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                    ============[ one direction: Adjacency ]============
+---------------------------------------------------------------------------------------*/
+
+namespace csr
+{
+    using Vertex = std::uint32_t;
+
+    struct Edge
+    {
+        Vertex doctor{};
+        Vertex patient{};
+
+        friend bool operator==(const Edge&, const Edge&) = default;
+    };
+
+    // rows are doctors (or patients), and the neighbors of every row are sorted and unique
+    class Adjacency
+    {
+    private:
+        std::vector<std::uint64_t> m_offsets{ 0 };
+        std::vector<Vertex> m_neighbors{};
+
+    public:
+        Adjacency() = default;
+
+        Adjacency(std::vector<std::uint64_t> offsets, std::vector<Vertex> neighbors)
+            : m_offsets{ std::move(offsets) }
+            , m_neighbors{ std::move(neighbors) }
+        {
+        }
+
+        std::size_t rows() const { return m_offsets.size() - 1; }
+        std::size_t edges() const { return m_neighbors.size(); }
+
+        std::span<const Vertex> neighbors(Vertex row) const
+        {
+            if (row >= rows())
+                return {};
+            return { m_neighbors.data() + m_offsets[row], m_neighbors.data() + m_offsets[row + 1] };
+        }
+
+        std::size_t degree(Vertex row) const
+        {
+            return row < rows() ? m_offsets[row + 1] - m_offsets[row] : 0;
+        }
+
+        bool contains(Vertex row, Vertex column) const
+        {
+            auto list{ neighbors(row) };
+            return std::binary_search(list.begin(), list.end(), column);
+        }
+
+        std::size_t memoryUsage() const
+        {
+            return m_offsets.capacity() * sizeof(std::uint64_t) + m_neighbors.capacity() * sizeof(Vertex);
+        }
+
+        // this adjacency plus [extra] (sorted by row, then column, no duplicates), with
+        // [rowCount] rows. one pass over both, merging row by row.
+        template <typename Row, typename Column>
+        Adjacency merged(std::span<const Edge> extra, std::size_t rowCount, Row row, Column column) const
+        {
+            std::vector<std::uint64_t> offsets(rowCount + 1);
+            std::vector<Vertex> columns{};
+            columns.reserve(edges() + extra.size());
+
+            std::size_t e{ 0 };
+            for (std::size_t r{ 0 }; r < rowCount; ++r)
+            {
+                offsets[r] = columns.size();
+                auto old{ neighbors(static_cast<Vertex>(r)) };
+                auto o{ old.begin() };
+
+                for (; e < extra.size() && row(extra[e]) == r; ++e)
+                {
+                    Vertex added{ column(extra[e]) };
+                    for (; o != old.end() && *o < added; ++o)
+                        columns.push_back(*o);
+                    if (o != old.end() && *o == added)
+                        continue;       // already there
+                    columns.push_back(added);
+                }
+                columns.insert(columns.end(), o, old.end());
+            }
+            offsets[rowCount] = columns.size();
+
+            return { std::move(offsets), std::move(columns) };
+        }
+
+        // the same edges seen from the other side, with [columnCount] rows. because we visit
+        // our rows in order, every row of the result comes out sorted.
+        Adjacency transposed(std::size_t columnCount) const
+        {
+            std::vector<std::uint64_t> offsets(columnCount + 1);
+            for (Vertex column : m_neighbors)
+                ++offsets[column];
+            std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), std::uint64_t{ 0 });
+
+            std::vector<Vertex> columns(m_neighbors.size());
+            std::vector<std::uint64_t> next(offsets.begin(), offsets.end() - 1);
+            for (std::size_t r{ 0 }; r < rows(); ++r)
+            {
+                for (Vertex column : neighbors(static_cast<Vertex>(r)))
+                    columns[next[column]++] = static_cast<Vertex>(r);
+            }
+
+            return { std::move(offsets), std::move(columns) };
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                  ============[ both directions, with batching ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - doctors and patients are numbers: 0, 1, 2... their names and other data live in plain
+    arrays indexed by that number (see association::main() below).
+
+  - addEdge() only appends to a pending list. rebuild() sorts the pending edges and merges them
+    into the doctor -> patient arrays, then builds patient -> doctor by transposing. both steps
+    are linear in the size of the graph.
+
+  - addEdge() rebuilds by itself once the pending list is 1/8 the size of the graph (or
+    [minimumBatch], whichever is bigger), so the cost of rebuilding is spread out over many
+    insertions, like std::vector's growth. until then, pending edges are not visible to queries.
+*/
+
+namespace csr
+{
+    class AssociationGraph
+    {
+    private:
+        Adjacency m_patientsOf{};       // doctor -> patients
+        Adjacency m_doctorsOf{};        // patient -> doctors
+        std::vector<Edge> m_pending{};
+        std::size_t m_doctorCount{ 0 };
+        std::size_t m_patientCount{ 0 };
+        std::size_t m_minimumBatch{};
+
+    public:
+        explicit AssociationGraph(std::size_t minimumBatch = 1 << 16)
+            : m_minimumBatch{ minimumBatch }
+        {
+        }
+
+        void addEdge(Vertex doctor, Vertex patient)
+        {
+            m_pending.push_back({ doctor, patient });
+            if (m_pending.size() >= std::max(m_minimumBatch, edges() / 8))
+                rebuild();
+        }
+
+        void addEdges(std::span<const Edge> edges)
+        {
+            m_pending.insert(m_pending.end(), edges.begin(), edges.end());
+            if (m_pending.size() >= std::max(m_minimumBatch, this->edges() / 8))
+                rebuild();
+        }
+
+        void rebuild()
+        {
+            if (m_pending.empty())
+                return;
+
+            std::sort(m_pending.begin(), m_pending.end(), [](const Edge& a, const Edge& b) {
+                return a.doctor != b.doctor ? a.doctor < b.doctor : a.patient < b.patient;
+            });
+            m_pending.erase(std::unique(m_pending.begin(), m_pending.end()), m_pending.end());
+
+            for (const Edge& edge : m_pending)
+            {
+                m_doctorCount = std::max(m_doctorCount, std::size_t{ edge.doctor } + 1);
+                m_patientCount = std::max(m_patientCount, std::size_t{ edge.patient } + 1);
+            }
+
+            m_patientsOf = m_patientsOf.merged(m_pending, m_doctorCount,
+                                               [](const Edge& edge) { return edge.doctor; },
+                                               [](const Edge& edge) { return edge.patient; });
+            m_doctorsOf = {};       // free it before building the new one
+            m_doctorsOf = m_patientsOf.transposed(m_patientCount);
+
+            m_pending.clear();
+            m_pending.shrink_to_fit();
+        }
+
+        std::size_t doctors() const { return m_doctorCount; }
+        std::size_t patients() const { return m_patientCount; }
+        std::size_t edges() const { return m_patientsOf.edges(); }
+        std::size_t pendingEdges() const { return m_pending.size(); }
+
+        std::span<const Vertex> patientsOf(Vertex doctor) const { return m_patientsOf.neighbors(doctor); }
+        std::span<const Vertex> doctorsOf(Vertex patient) const { return m_doctorsOf.neighbors(patient); }
+        std::size_t patientCount(Vertex doctor) const { return m_patientsOf.degree(doctor); }
+        std::size_t doctorCount(Vertex patient) const { return m_doctorsOf.degree(patient); }
+        bool sees(Vertex doctor, Vertex patient) const { return m_patientsOf.contains(doctor, patient); }
+
+        std::size_t memoryUsage() const
+        {
+            return m_patientsOf.memoryUsage() + m_doctorsOf.memoryUsage() + m_pending.capacity() * sizeof(Edge);
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                   ============[ parallel BFS and 2-hop queries ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - BFS treats doctors and patients as one set of vertices: doctor d is vertex d, patient p is
+    vertex doctors() + p. it goes level by level: the current frontier is split between the
+    threads, and a vertex is claimed by whichever thread manages to write its distance first
+    (a compare-exchange), so every vertex ends up in exactly one thread's next frontier.
+
+  - a 2-hop query asks "which doctors share a patient with doctor d?". a batch of those is
+    split between the threads; each thread marks the doctors it has seen in its own array,
+    stamped with the query number, so the array never has to be cleared.
+
+  - with threads == 1 (or a small frontier) everything runs on the calling thread.
+*/
+
+namespace csr
+{
+    namespace detail
+    {
+        // calls fn(begin, end, threadIndex) on [threads] threads, for equal slices of [0, count)
+        template <typename Fn>
+        void parallelFor(std::size_t count, unsigned threads, Fn&& fn)
+        {
+            if (threads <= 1 || count < 4096)
+            {
+                fn(std::size_t{ 0 }, count, 0u);
+                return;
+            }
+
+            std::vector<std::jthread> workers{};
+            for (unsigned t{ 0 }; t < threads; ++t)
+            {
+                std::size_t begin{ count * t / threads };
+                std::size_t end{ count * (t + 1) / threads };
+                workers.emplace_back([&fn, begin, end, t] { fn(begin, end, t); });
+            }
+        }
+    }
+
+    constexpr std::uint32_t g_unreached{ ~std::uint32_t{ 0 } };
+
+    // distance (in edges) from [doctor] to every doctor and patient, g_unreached if there's no path
+    std::vector<std::uint32_t> bfs(const AssociationGraph& graph, Vertex doctor, unsigned threads)
+    {
+        const std::size_t doctors{ graph.doctors() };
+        std::vector<std::uint32_t> distance(doctors + graph.patients(), g_unreached);
+        if (doctor >= doctors)
+            return distance;
+
+        std::vector<Vertex> frontier{ doctor };
+        distance[doctor] = 0;
+        std::vector<std::vector<Vertex>> next(std::max(threads, 1u));
+
+        for (std::uint32_t level{ 1 }; !frontier.empty(); ++level)
+        {
+            detail::parallelFor(frontier.size(), threads, [&](std::size_t begin, std::size_t end, unsigned t) {
+                std::vector<Vertex>& mine{ next[t] };
+                auto visit{ [&](Vertex vertex) {
+                    std::atomic_ref<std::uint32_t> slot{ distance[vertex] };
+                    std::uint32_t expected{ g_unreached };
+                    if (slot.load(std::memory_order_relaxed) == g_unreached
+                        && slot.compare_exchange_strong(expected, level, std::memory_order_relaxed))
+                        mine.push_back(vertex);
+                } };
+
+                for (std::size_t i{ begin }; i < end; ++i)
+                {
+                    Vertex vertex{ frontier[i] };
+                    if (vertex < doctors)
+                    {
+                        for (Vertex patient : graph.patientsOf(vertex))
+                            visit(static_cast<Vertex>(doctors + patient));
+                    }
+                    else
+                    {
+                        for (Vertex other : graph.doctorsOf(static_cast<Vertex>(vertex - doctors)))
+                            visit(other);
+                    }
+                }
+            });
+
+            frontier.clear();
+            for (auto& mine : next)
+            {
+                frontier.insert(frontier.end(), mine.begin(), mine.end());
+                mine.clear();
+            }
+        }
+
+        return distance;
+    }
+
+    // for every doctor in [queries]: how many OTHER doctors share at least one patient with it
+    std::vector<std::uint32_t> twoHopCounts(const AssociationGraph& graph, std::span<const Vertex> queries, unsigned threads)
+    {
+        std::vector<std::uint32_t> result(queries.size());
+        std::atomic<std::size_t> nextQuery{ 0 };
+        constexpr std::size_t chunk{ 64 };      // degrees vary a lot, so threads take small chunks as they go
+
+        auto work{ [&] {
+            std::vector<std::uint32_t> seen(graph.doctors(), 0);
+            for (std::size_t first{ nextQuery.fetch_add(chunk) }; first < queries.size(); first = nextQuery.fetch_add(chunk))
+            {
+                for (std::size_t q{ first }; q < std::min(first + chunk, queries.size()); ++q)
+                {
+                    Vertex doctor{ queries[q] };
+                    std::uint32_t stamp{ static_cast<std::uint32_t>(q + 1) };
+                    if (doctor < seen.size())
+                        seen[doctor] = stamp;
+
+                    std::uint32_t count{ 0 };
+                    for (Vertex patient : graph.patientsOf(doctor))
+                    {
+                        for (Vertex other : graph.doctorsOf(patient))
+                        {
+                            if (seen[other] != stamp)
+                            {
+                                seen[other] = stamp;
+                                ++count;
+                            }
+                        }
+                    }
+                    result[q] = count;
+                }
+            }
+        } };
+
+        if (threads <= 1)
+            work();
+        else
+        {
+            std::vector<std::jthread> workers{};
+            for (unsigned t{ 0 }; t < threads; ++t)
+                workers.emplace_back(work);
+        }
+        return result;
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                   ============[ association, revisited ]============
+---------------------------------------------------------------------------------------*/
+
+// the same doctors and patients as in 16.3, with the names in plain arrays
+
+namespace association
+{
+    void main()
+    {
+        std::vector<std::string> doctors{ "James", "Scott" };
+        std::vector<std::string> patients{ "Dave", "Frank", "Betsy" };
+
+        csr::AssociationGraph graph{};
+        graph.addEdge(0, 0);        // james sees dave
+        graph.addEdge(1, 0);        // scott sees dave
+        graph.addEdge(1, 2);        // scott sees betsy
+        graph.rebuild();
+
+        for (csr::Vertex d{ 0 }; d < doctors.size(); ++d)
+        {
+            std::cout << doctors[d] << " is seeing patients: ";
+            for (csr::Vertex p : graph.patientsOf(d))
+                std::cout << patients[p] << ' ';
+            std::cout << '\n';
+        }
+
+        for (csr::Vertex p{ 0 }; p < patients.size(); ++p)
+        {
+            if (graph.doctorCount(p) == 0)
+            {
+                std::cout << patients[p] << " has no doctors right now\n";
+                continue;
+            }
+
+            std::cout << patients[p] << " is seeing doctors: ";
+            for (csr::Vertex d : graph.doctorsOf(p))
+                std::cout << doctors[d] << ' ';
+            std::cout << '\n';
+        }
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+// random edges added in batches (with duplicates), compared against sets; BFS and 2-hop
+// compared between 1 and 4 threads, and against a simple sequential BFS
+
+#include <set>
+#include <queue>
+#include <random>
+
+namespace checks
+{
+    void main()
+    {
+        std::mt19937_64 mt{ 36 };
+        constexpr csr::Vertex doctors{ 3'000 };
+        constexpr csr::Vertex patients{ 20'000 };
+
+        csr::AssociationGraph graph{ 1'000 };
+        std::vector<std::set<csr::Vertex>> expectedPatients(doctors), expectedDoctors(patients);
+        int failures{ 0 };
+
+        for (int i{ 0 }; i < 60'000; ++i)
+        {
+            csr::Vertex d{ static_cast<csr::Vertex>(mt() % doctors) };
+            csr::Vertex p{ static_cast<csr::Vertex>(mt() % patients) };
+            graph.addEdge(d, p);
+            expectedPatients[d].insert(p);
+            expectedDoctors[p].insert(d);
+        }
+        graph.rebuild();
+
+        for (csr::Vertex d{ 0 }; d < graph.doctors(); ++d)
+        {
+            auto list{ graph.patientsOf(d) };
+            failures += !std::equal(list.begin(), list.end(), expectedPatients[d].begin(), expectedPatients[d].end());
+        }
+        for (csr::Vertex p{ 0 }; p < graph.patients(); ++p)
+        {
+            auto list{ graph.doctorsOf(p) };
+            failures += !std::equal(list.begin(), list.end(), expectedDoctors[p].begin(), expectedDoctors[p].end());
+        }
+
+        // sequential BFS over the sets
+        std::vector<std::uint32_t> expected(graph.doctors() + graph.patients(), csr::g_unreached);
+        std::queue<csr::Vertex> queue{};
+        expected[0] = 0;
+        queue.push(0);
+        while (!queue.empty())
+        {
+            csr::Vertex v{ queue.front() };
+            queue.pop();
+            auto relax{ [&](csr::Vertex u) {
+                if (expected[u] == csr::g_unreached)
+                {
+                    expected[u] = expected[v] + 1;
+                    queue.push(u);
+                }
+            } };
+            if (v < graph.doctors())
+                for (csr::Vertex p : expectedPatients[v])
+                    relax(static_cast<csr::Vertex>(graph.doctors() + p));
+            else
+                for (csr::Vertex d : expectedDoctors[v - graph.doctors()])
+                    relax(d);
+        }
+        failures += csr::bfs(graph, 0, 1) != expected;
+        failures += csr::bfs(graph, 0, 4) != expected;
+
+        std::vector<csr::Vertex> queries(doctors);
+        std::iota(queries.begin(), queries.end(), csr::Vertex{ 0 });
+        auto counts{ csr::twoHopCounts(graph, queries, 1) };
+        failures += counts != csr::twoHopCounts(graph, queries, 4);
+        for (csr::Vertex d{ 0 }; d < 100; ++d)
+        {
+            std::set<csr::Vertex> others{};
+            for (csr::Vertex p : expectedPatients[d])
+                others.insert(expectedDoctors[p].begin(), expectedDoctors[p].end());
+            others.erase(d);
+            failures += counts[d] != others.size();
+        }
+
+        std::cout << "checks: " << graph.edges() << " edges, " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// memory, build time and a full scan of every doctor's patients, against the 16.3 layout
+// (every doctor and patient with its own std::vector of pointers); then BFS and 2-hop with
+// different thread counts
+
+#include <chrono>
+#include <cmath>        // std::pow
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    // the 16.3 layout
+    struct PointerPatient;
+    struct PointerDoctor
+    {
+        std::vector<const PointerPatient*> patients{};
+    };
+    struct PointerPatient
+    {
+        std::vector<const PointerDoctor*> doctors{};
+    };
+
+    constexpr csr::Vertex g_doctors{ 200'000 };
+    constexpr csr::Vertex g_patients{ 2'000'000 };
+    constexpr std::size_t g_edges{ 10'000'000 };
+
+    void main()
+    {
+        // some doctors are much busier than others
+        std::mt19937_64 mt{ 37 };
+        std::uniform_real_distribution<double> uniform{ 0.0, 1.0 };
+        std::vector<csr::Edge> edges(g_edges);
+        for (auto& edge : edges)
+            edge = { static_cast<csr::Vertex>(g_doctors * std::pow(uniform(mt), 2.0)), static_cast<csr::Vertex>(mt() % g_patients) };
+
+        Timer t;
+        std::vector<PointerDoctor> pointerDoctors(g_doctors);
+        std::vector<PointerPatient> pointerPatients(g_patients);
+        for (const auto& edge : edges)
+        {
+            pointerDoctors[edge.doctor].patients.push_back(&pointerPatients[edge.patient]);
+            pointerPatients[edge.patient].doctors.push_back(&pointerDoctors[edge.doctor]);
+        }
+        double pointerBuild{ t.elapsed() };
+
+        std::size_t pointerMemory{ (pointerDoctors.size() + pointerPatients.size()) * sizeof(std::vector<void*>) };
+        for (const auto& doctor : pointerDoctors)
+            pointerMemory += doctor.patients.capacity() * sizeof(void*);
+        for (const auto& patient : pointerPatients)
+            pointerMemory += patient.doctors.capacity() * sizeof(void*);
+
+        t.reset();
+        csr::AssociationGraph graph{};
+        for (std::size_t i{ 0 }; i < edges.size(); i += 1'000'000)     // arriving in batches
+            graph.addEdges(std::span{ edges }.subspan(i, std::min<std::size_t>(1'000'000, edges.size() - i)));
+        graph.rebuild();
+        double csrBuild{ t.elapsed() };
+
+        // full scan: the number of patients per doctor's patients' doctors (a 2-hop sum)
+        t.reset();
+        std::uint64_t pointerSum{ 0 };
+        for (const auto& doctor : pointerDoctors)
+        {
+            for (const PointerPatient* patient : doctor.patients)
+                pointerSum += patient->doctors.size();
+        }
+        double pointerScan{ t.elapsed() };
+
+        t.reset();
+        std::uint64_t csrSum{ 0 };
+        for (csr::Vertex d{ 0 }; d < graph.doctors(); ++d)
+        {
+            for (csr::Vertex p : graph.patientsOf(d))
+                csrSum += graph.doctorCount(p);
+        }
+        double csrScan{ t.elapsed() };
+
+        std::cout << "(" << g_doctors << " doctors, " << g_patients << " patients, " << g_edges << " associations)\n"
+                  << "vectors of pointers : " << pointerMemory / (1 << 20) << " MiB (+ allocator overhead), build "
+                  << pointerBuild << " s, scan " << pointerScan << " s\n"
+                  << "CSR                 : " << graph.memoryUsage() / (1 << 20) << " MiB, build " << csrBuild
+                  << " s, scan " << csrScan << " s" << (csrSum == 0 || pointerSum == 0 ? " ?" : "") << '\n';
+
+        std::vector<PointerDoctor>{}.swap(pointerDoctors);
+        std::vector<PointerPatient>{}.swap(pointerPatients);
+
+        std::vector<csr::Vertex> queries(20'000);
+        for (auto& query : queries)
+            query = static_cast<csr::Vertex>(mt() % g_doctors);
+
+        std::cout << "(" << std::thread::hardware_concurrency() << " hardware threads)\n";
+        for (unsigned threads : { 1u, 2u, 4u, 8u })
+        {
+            t.reset();
+            auto distance{ csr::bfs(graph, 0, threads) };
+            double bfsTime{ t.elapsed() };
+            std::size_t reached{ static_cast<std::size_t>(std::count_if(distance.begin(), distance.end(), [](std::uint32_t d) { return d != csr::g_unreached; })) };
+
+            t.reset();
+            auto counts{ csr::twoHopCounts(graph, queries, threads) };
+            double twoHopTime{ t.elapsed() };
+
+            std::cout << threads << " thread(s): BFS " << bfsTime << " s (" << reached << " reached), "
+                      << queries.size() << " 2-hop queries " << twoHopTime << " s" << (counts.empty() ? " ?" : "") << '\n';
+        }
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    association::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
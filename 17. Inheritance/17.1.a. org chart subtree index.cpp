@@ -0,0 +1,601 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <utility>          // std::pair
+#include <algorithm>        // std::shuffle, std::min
+#include <cstdint>
+#include <cstddef>          // std::size_t
+
+
+// in 17.1 a Supervisor is an Employee that oversees up to 5 other employees (m_overseesIDs).
+// put together, those form a tree: the org chart.
+
+// "what is the total salary of everyone under this supervisor?" is a walk over the
+// supervisor's whole subtree. for the CEO of a 500k person company, that's 500k employees,
+// reached by following pointers all over the heap.
+
+// the trick in this file: list the employees in the order a depth-first walk of the tree
+// visits them (an Euler tour). a supervisor is visited right before everyone who reports to
+// them (directly or not), and nobody else is visited in between. so:
+    // - every subtree is a CONTIGUOUS range [in, out) of that list.
+    // - the number of people in a supervisor's subtree (themselves included) is simply out - in.
+    // - a sum over a subtree is a sum over a range, which prefix sums answer in O(1), or a
+    //   Fenwick tree answers in O(log n) while still allowing O(log n) salary changes.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                       ============[ the classes from 17.1 ]============
+---------------------------------------------------------------------------------------*/
+
+class Person
+{
+// all members public for now for the sake of simplicity
+public:
+    std::string m_name{};
+    int m_age{};
+
+    Person(const std::string& name="", int age=0)
+        : m_name{ name }
+        , m_age{ age }
+    {
+    }
+
+    const std::string& getName() const { return m_name; }
+    int getAge() const { return m_age; }
+};
+
+class Employee : public Person
+{
+public:
+    double m_hourlySalary{};
+    long m_employeeID{};
+
+    Employee(double hourlySalary=0.0, long employeeID=0)
+        : m_hourlySalary{ hourlySalary }
+        , m_employeeID{ employeeID }
+    {
+    }
+
+    void printNameAndSalary() const
+    {
+        std::cout << m_name << ": " << m_hourlySalary << '\n';
+    }
+};
+
+class Supervisor : public Employee
+{
+public:
+    long m_overseesIDs[5]{};    // can oversee a max of 5 employees
+};
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ flattening the tree ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - the employees are numbered 0..n-1 (their position in whatever array holds them), and the
+    tree is given as "who is the supervisor of employee i" (g_noSupervisor for the people at
+    the top; there may be several, which makes it a forest).
+
+  - the walk is done with an explicit stack instead of recursion: a chain of a few hundred
+    thousand employees would overflow the call stack.
+
+  - employees in a cycle ("A reports to B, B reports to A") and everyone under them have
+    nobody at the top, so the walk never reaches them. they get an empty range past the end
+    of the tour: no headcount, a sum of 0, and never under (or over) anybody.
+*/
+
+namespace org_chart
+{
+    using Index = std::uint32_t;
+    constexpr Index g_noSupervisor{ ~Index{ 0 } };
+
+    class Hierarchy
+    {
+    private:
+        std::vector<Index> m_in{};          // position of each employee in the tour
+        std::vector<Index> m_out{};         // one past the position of the last one under them
+        std::vector<Index> m_order{};       // the tour itself: m_order[m_in[i]] == i
+
+    public:
+        explicit Hierarchy(std::span<const Index> supervisorOf)
+            : m_in(supervisorOf.size())
+            , m_out(supervisorOf.size())
+        {
+            const std::size_t n{ supervisorOf.size() };
+
+            // the direct reports of every employee, as CSR arrays (see 16.3.a)
+            std::vector<Index> firstReport(n + 1, 0);
+            for (Index supervisor : supervisorOf)
+            {
+                if (supervisor != g_noSupervisor)
+                    ++firstReport[supervisor + 1];
+            }
+            for (std::size_t i{ 0 }; i < n; ++i)
+                firstReport[i + 1] += firstReport[i];
+
+            std::vector<Index> reports(firstReport[n]);
+            std::vector<Index> next(firstReport.begin(), firstReport.end() - 1);
+            for (std::size_t i{ 0 }; i < n; ++i)
+            {
+                if (supervisorOf[i] != g_noSupervisor)
+                    reports[next[supervisorOf[i]]++] = static_cast<Index>(i);
+            }
+
+            // depth-first walk from every top-level employee. [cursor] remembers which report
+            // of each employee on the stack we visit next.
+            m_order.reserve(n);
+            std::vector<Index> stack{};
+            std::vector<Index> cursor(firstReport.begin(), firstReport.end() - 1);
+
+            for (std::size_t root{ 0 }; root < n; ++root)
+            {
+                if (supervisorOf[root] != g_noSupervisor)
+                    continue;
+
+                m_in[root] = static_cast<Index>(m_order.size());
+                m_order.push_back(static_cast<Index>(root));
+                stack.push_back(static_cast<Index>(root));
+
+                while (!stack.empty())
+                {
+                    Index top{ stack.back() };
+                    if (cursor[top] == firstReport[top + 1])
+                    {
+                        m_out[top] = static_cast<Index>(m_order.size());
+                        stack.pop_back();
+                        continue;
+                    }
+
+                    Index report{ reports[cursor[top]++] };
+                    m_in[report] = static_cast<Index>(m_order.size());
+                    m_order.push_back(report);
+                    stack.push_back(report);
+                }
+            }
+
+            // the employees we never reached (see above)
+            for (std::size_t i{ 0 }; i < n; ++i)
+            {
+                if (m_out[i] == 0)
+                {
+                    m_in[i] = static_cast<Index>(m_order.size());
+                    m_out[i] = static_cast<Index>(m_order.size());
+                }
+            }
+        }
+
+        std::size_t size() const { return m_in.size(); }
+        bool isWellFormed() const { return m_order.size() == m_in.size(); }
+
+        // false for the employees in (or under) a cycle; reached employees have out > in
+        bool isReached(Index employee) const { return m_in[employee] < m_out[employee]; }
+
+        // the range of tour positions taken by [employee] and everyone under them
+        Index in(Index employee) const { return m_in[employee]; }
+        Index out(Index employee) const { return m_out[employee]; }
+
+        // the number of people under [employee], not counting themselves
+        std::size_t headcountUnder(Index employee) const
+        {
+            return isReached(employee) ? m_out[employee] - m_in[employee] - 1 : 0;
+        }
+
+        // whether [employee] reports to [supervisor], directly or through others
+        bool isUnder(Index employee, Index supervisor) const
+        {
+            return m_in[supervisor] < m_in[employee] && m_in[employee] < m_out[supervisor];
+        }
+
+        std::span<const Index> tour() const { return m_order; }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                       ============[ subtree rollups ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - StaticRollup: prefix sums over the tour. prefix[k] is the sum of the first k values, so
+    a subtree's sum is prefix[out] - prefix[in]. O(1) per query, but a change of one value
+    would have to update every prefix after it.
+
+  - Rollup: a Fenwick tree (binary indexed tree) over the tour. tree[k] holds the sum of the
+    values in (k - lowbit(k), k], so a prefix sum adds up at most log2(n) entries, and changing
+    one value touches at most log2(n) entries too.
+*/
+
+namespace org_chart
+{
+    template <typename T>
+    class StaticRollup
+    {
+    private:
+        const Hierarchy* m_hierarchy{};
+        std::vector<T> m_prefix{};
+
+    public:
+        StaticRollup(const Hierarchy& hierarchy, std::span<const T> values)
+            : m_hierarchy{ &hierarchy }
+            , m_prefix(hierarchy.tour().size() + 1)
+        {
+            auto tour{ hierarchy.tour() };
+            for (std::size_t position{ 0 }; position < tour.size(); ++position)
+                m_prefix[position + 1] = m_prefix[position] + values[tour[position]];
+        }
+
+        // the total for [employee] and everyone under them
+        T sumOf(Index employee) const
+        {
+            return m_prefix[m_hierarchy->out(employee)] - m_prefix[m_hierarchy->in(employee)];
+        }
+    };
+
+    template <typename T>
+    class Rollup
+    {
+    private:
+        const Hierarchy* m_hierarchy{};
+        std::vector<T> m_tree{};        // 1-based: m_tree[0] is unused
+        std::vector<T> m_values{};      // by employee, so set() knows the old value
+
+        // the sum of the first [count] values in tour order
+        T prefix(std::size_t count) const
+        {
+            T sum{};
+            for (; count > 0; count &= count - 1)
+                sum += m_tree[count];
+            return sum;
+        }
+
+    public:
+        Rollup(const Hierarchy& hierarchy, std::span<const T> values)
+            : m_hierarchy{ &hierarchy }
+            , m_tree(hierarchy.tour().size() + 1)
+            , m_values(values.begin(), values.end())
+        {
+            // O(n) construction: every entry adds itself into the next entry that covers it
+            auto tour{ hierarchy.tour() };
+            for (std::size_t k{ 1 }; k <= tour.size(); ++k)
+            {
+                m_tree[k] += values[tour[k - 1]];
+                std::size_t parent{ k + (k & (~k + 1)) };
+                if (parent <= tour.size())
+                    m_tree[parent] += m_tree[k];
+            }
+        }
+
+        T sumOf(Index employee) const
+        {
+            return prefix(m_hierarchy->out(employee)) - prefix(m_hierarchy->in(employee));
+        }
+
+        T valueOf(Index employee) const { return m_values[employee]; }
+
+        void set(Index employee, T value)
+        {
+            T delta{ value - m_values[employee] };
+            m_values[employee] = value;
+            for (std::size_t k{ std::size_t{ m_hierarchy->in(employee) } + 1 }; k < m_tree.size(); k += k & (~k + 1))
+                m_tree[k] += delta;
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                       ============[ a small org chart ]============
+---------------------------------------------------------------------------------------*/
+
+#include <unordered_map>
+
+namespace example
+{
+    void main()
+    {
+        // the employees, in no particular order, and who supervises whom by employee ID
+        std::vector<Employee> employees{ { 95.0, 1 }, { 60.0, 2 }, { 55.0, 3 }, { 30.25, 4 }, { 20.25, 5 }, { 22.0, 6 } };
+        const char* names[]{ "Ada", "Bill", "Cleo", "Dan", "Frank", "Gus" };
+        for (std::size_t i{ 0 }; i < employees.size(); ++i)
+            employees[i].m_name = names[i];
+
+        Supervisor ada{};
+        ada.m_employeeID = 1;
+        ada.m_overseesIDs[0] = 2;
+        ada.m_overseesIDs[1] = 3;
+        Supervisor bill{};
+        bill.m_employeeID = 2;
+        bill.m_overseesIDs[0] = 4;
+        bill.m_overseesIDs[1] = 5;
+        Supervisor cleo{};
+        cleo.m_employeeID = 3;
+        cleo.m_overseesIDs[0] = 6;
+
+        // employee IDs -> positions in [employees], then "supervisor of" by position
+        std::unordered_map<long, org_chart::Index> position{};
+        for (std::size_t i{ 0 }; i < employees.size(); ++i)
+            position[employees[i].m_employeeID] = static_cast<org_chart::Index>(i);
+
+        std::vector<org_chart::Index> supervisorOf(employees.size(), org_chart::g_noSupervisor);
+        for (const Supervisor* supervisor : { &ada, &bill, &cleo })
+        {
+            for (long id : supervisor->m_overseesIDs)
+            {
+                if (id != 0)
+                    supervisorOf[position[id]] = position[supervisor->m_employeeID];
+            }
+        }
+
+        org_chart::Hierarchy hierarchy{ supervisorOf };
+        std::vector<double> salaries{};
+        for (const auto& employee : employees)
+            salaries.push_back(employee.m_hourlySalary);
+        org_chart::Rollup<double> payroll{ hierarchy, salaries };
+
+        for (org_chart::Index i{ 0 }; i < employees.size(); ++i)
+        {
+            std::cout << employees[i].getName() << ": " << hierarchy.headcountUnder(i) << " people under them, "
+                      << payroll.sumOf(i) << " per hour including themselves\n";
+        }
+
+        payroll.set(position[5], 25.0);     // Frank gets a raise
+        std::cout << "after Frank's raise, Ada's part of the company costs " << payroll.sumOf(position[1]) << " per hour\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ checks ]============
+---------------------------------------------------------------------------------------*/
+
+// random forests, compared against walking the tree
+
+#include <random>
+#include <cmath>        // std::abs
+
+namespace checks
+{
+    void main()
+    {
+        std::mt19937_64 mt{ 37 };
+        constexpr std::size_t n{ 20'000 };
+
+        // a supervisor always comes earlier than their reports here, but not in the shuffled
+        // numbering below
+        std::vector<org_chart::Index> permutation(n);
+        for (std::size_t i{ 0 }; i < n; ++i)
+            permutation[i] = static_cast<org_chart::Index>(i);
+        std::shuffle(permutation.begin(), permutation.end(), mt);
+
+        std::vector<org_chart::Index> supervisorOf(n, org_chart::g_noSupervisor);
+        std::vector<std::int64_t> salary(n);
+        for (std::size_t i{ 0 }; i < n; ++i)
+        {
+            if (i >= 3)     // 3 top-level employees
+                supervisorOf[permutation[i]] = permutation[mt() % i];
+            salary[permutation[i]] = static_cast<std::int64_t>(mt() % 1000);
+        }
+
+        org_chart::Hierarchy hierarchy{ supervisorOf };
+        org_chart::Rollup<std::int64_t> rollup{ hierarchy, salary };
+        org_chart::StaticRollup<std::int64_t> fixed{ hierarchy, salary };
+
+        // the slow way: walk up from every employee, adding into every supervisor on the way
+        auto slowSums{ [&] {
+            std::vector<std::int64_t> sums(salary.begin(), salary.end());
+            std::vector<std::size_t> counts(n, 0);
+            for (std::size_t i{ 0 }; i < n; ++i)
+            {
+                for (org_chart::Index s{ supervisorOf[i] }; s != org_chart::g_noSupervisor; s = supervisorOf[s])
+                {
+                    sums[s] += salary[i];
+                    ++counts[s];
+                }
+            }
+            return std::pair{ sums, counts };
+        } };
+
+        int failures{ !hierarchy.isWellFormed() };
+        auto [sums, counts] { slowSums() };
+        for (org_chart::Index i{ 0 }; i < n; ++i)
+        {
+            failures += rollup.sumOf(i) != sums[i] || fixed.sumOf(i) != sums[i];
+            failures += hierarchy.headcountUnder(i) != counts[i];
+        }
+        for (org_chart::Index i{ 0 }; i < n; ++i)
+        {
+            org_chart::Index s{ supervisorOf[i] };
+            failures += s != org_chart::g_noSupervisor && !hierarchy.isUnder(i, s);
+            failures += hierarchy.isUnder(i, i);
+        }
+
+        // point updates
+        for (int k{ 0 }; k < 1'000; ++k)
+        {
+            org_chart::Index i{ static_cast<org_chart::Index>(mt() % n) };
+            salary[i] = static_cast<std::int64_t>(mt() % 1000);
+            rollup.set(i, salary[i]);
+        }
+        auto [newSums, newCounts] { slowSums() };
+        for (org_chart::Index i{ 0 }; i < n; ++i)
+            failures += rollup.sumOf(i) != newSums[i];
+
+        // a cycle (1 -> 2 -> 3 -> 1) with someone under it (4), next to a proper tree (0 -> 5)
+        std::vector<org_chart::Index> cyclic{ org_chart::g_noSupervisor, 3, 1, 2, 3, 0 };
+        std::vector<std::int64_t> pay{ 10, 20, 30, 40, 50, 60 };
+        org_chart::Hierarchy broken{ cyclic };
+        org_chart::Rollup<std::int64_t> brokenRollup{ broken, pay };
+        org_chart::StaticRollup<std::int64_t> brokenFixed{ broken, pay };
+
+        failures += broken.isWellFormed();
+        failures += broken.headcountUnder(0) != 1 || brokenRollup.sumOf(0) != 70 || brokenFixed.sumOf(0) != 70;
+        failures += broken.isUnder(5, 0) != true;
+        for (org_chart::Index i : { 1, 2, 3, 4 })
+        {
+            failures += broken.isReached(i) || broken.headcountUnder(i) != 0;
+            failures += brokenRollup.sumOf(i) != 0 || brokenFixed.sumOf(i) != 0;
+            failures += broken.isUnder(i, 0) || broken.isUnder(0, i) || broken.isUnder(4, i);
+        }
+        brokenRollup.set(4, 99);       // must not touch anybody's sum
+        brokenRollup.set(5, 1);
+        failures += brokenRollup.sumOf(0) != 11 || brokenRollup.valueOf(4) != 99;
+
+        std::cout << "checks: " << n << " employees, " << failures << " failures\n";
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// a 500k person org chart: total salary and headcount under a random supervisor, by walking
+// the tree of Employee objects (each with a std::vector of pointers to its reports) vs. the
+// rollups
+
+#include <chrono>
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    struct Node
+    {
+        Employee employee{};
+        std::vector<const Node*> reports{};
+    };
+
+    std::pair<double, std::size_t> walk(const Node* node)
+    {
+        double total{ node->employee.m_hourlySalary };
+        std::size_t headcount{ 0 };
+        for (const Node* report : node->reports)
+        {
+            auto [sum, count] { walk(report) };
+            total += sum;
+            headcount += count + 1;
+        }
+        return { total, headcount };
+    }
+
+    constexpr std::size_t g_employees{ 500'000 };
+    constexpr std::size_t g_queries{ 2'000 };
+
+    void main()
+    {
+        std::mt19937_64 mt{ 38 };
+
+        // everybody reports to someone hired not too long before them: about 30 levels deep
+        std::vector<org_chart::Index> supervisorOf(g_employees, org_chart::g_noSupervisor);
+        std::vector<double> salaries(g_employees);
+        for (std::size_t i{ 0 }; i < g_employees; ++i)
+        {
+            if (i > 0)
+                supervisorOf[i] = static_cast<org_chart::Index>(i - 1 - mt() % std::min<std::size_t>(i, 20'000));
+            salaries[i] = 15.0 + static_cast<double>(mt() % 10'000) / 100.0;
+        }
+
+        std::vector<Node> nodes(g_employees);
+        for (std::size_t i{ 0 }; i < g_employees; ++i)
+        {
+            nodes[i].employee = Employee{ salaries[i], static_cast<long>(i) };
+            if (supervisorOf[i] != org_chart::g_noSupervisor)
+                nodes[supervisorOf[i]].reports.push_back(&nodes[i]);
+        }
+
+        // queries: mostly managers high up (the expensive ones), some anywhere
+        std::vector<org_chart::Index> queries(g_queries);
+        for (auto& query : queries)
+            query = static_cast<org_chart::Index>(mt() % 2 ? mt() % 1'000 : mt() % g_employees);
+
+        Timer t;
+        double walkTotal{ 0 };
+        for (org_chart::Index query : queries)
+        {
+            auto [sum, count] { walk(&nodes[query]) };
+            walkTotal += sum + static_cast<double>(count);
+        }
+        double walkTime{ t.elapsed() };
+
+        t.reset();
+        org_chart::Hierarchy hierarchy{ supervisorOf };
+        org_chart::StaticRollup<double> fixed{ hierarchy, salaries };
+        org_chart::Rollup<double> rollup{ hierarchy, salaries };
+        double buildTime{ t.elapsed() };
+
+        t.reset();
+        double staticTotal{ 0 };
+        for (org_chart::Index query : queries)
+            staticTotal += fixed.sumOf(query) + static_cast<double>(hierarchy.headcountUnder(query));
+        double staticTime{ t.elapsed() };
+
+        t.reset();
+        double fenwickTotal{ 0 };
+        for (org_chart::Index query : queries)
+            fenwickTotal += rollup.sumOf(query) + static_cast<double>(hierarchy.headcountUnder(query));
+        double fenwickTime{ t.elapsed() };
+
+        t.reset();
+        for (std::size_t i{ 0 }; i < 1'000'000; ++i)
+            rollup.set(static_cast<org_chart::Index>(mt() % g_employees), 20.0);
+        double updateTime{ t.elapsed() };
+
+        auto perQuery{ [](double seconds) { return seconds * 1e9 / static_cast<double>(g_queries); } };
+        std::cout << "(" << g_employees << " employees, " << g_queries << " rollup queries)\n"
+                  << "walking the tree : " << perQuery(walkTime) << " ns per query\n"
+                  << "building index   : " << buildTime * 1e3 << " ms\n"
+                  << "prefix sums      : " << perQuery(staticTime) << " ns per query\n"
+                  << "fenwick tree     : " << perQuery(fenwickTime) << " ns per query, "
+                  << updateTime * 1e9 / 1e6 << " ns per salary update"
+                  << (std::abs(staticTotal - walkTotal) > 1e-9 * walkTotal || std::abs(fenwickTotal - walkTotal) > 1e-9 * walkTotal
+                          ? " (results differ?)" : "") << '\n';
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    example::main();
+    checks::main();
+    benchmark::main();
+
+    return 0;
+}
@@ -0,0 +1,1843 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <exception>        // std::exception_ptr
+#include <system_error>     // std::system_error
+#include <stdexcept>        // std::runtime_error
+#include <type_traits>
+#include <utility>          // std::exchange, std::pair
+#include <array>
+#include <algorithm>        // std::max, std::min
+#include <cstring>          // std::memcpy
+#include <cstdint>
+#include <cstddef>          // std::size_t
+#include <cerrno>
+
+#include <fcntl.h>          // open
+#include <unistd.h>         // write, fdatasync, ftruncate, close
+#include <sys/mman.h>       // mmap, munmap
+#include <sys/stat.h>       // fstat
+
+#if defined(__SSE4_2__)
+    #include <nmmintrin.h>  // _mm_crc32_u64
+#endif
+
+
+// the quiz in 19 ends with StringValuePair<T>: a std::string key and a value of any type.
+// those pairs only live as long as the program does.
+
+// in this file we store them on disk, in a small embedded key-value store:
+    // - every put() or erase() is APPENDED to a log file (a write-ahead log). appending is the
+    //   cheapest thing a disk can do, and a half-written record at the end of the file (because
+    //   of a crash) can be detected with a checksum and thrown away.
+    // - making a write durable means calling fdatasync(), which can take milliseconds. with
+    //   "group commit", one fdatasync() covers every write that arrived while the previous one
+    //   was running, so many threads share the cost. how often we sync is configurable.
+    // - reads don't scan the log: a hash index maps every key to the offset of its latest
+    //   record, and the log itself is memory-mapped, so a get() is a hash lookup and a memcpy.
+    // - the index is saved to disk now and then (a checkpoint), and on startup it is
+    //   memory-mapped instead of loaded. only the part of the log written AFTER the last
+    //   checkpoint has to be replayed, so startup doesn't get slower as the store grows.
+    // - overwritten and erased records are garbage. a background thread copies the live
+    //   records into a fresh log (compaction) once the garbage takes up too much space.
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ StringValuePair ]============
+---------------------------------------------------------------------------------------*/
+
+// (from quiz_1.cpp)
+
+template <typename T_1, typename T_2=T_1>
+class Pair
+{
+private:
+    T_1 m_first{};
+    T_2 m_second{};
+
+public:
+    Pair(T_1 value1, T_2 value2)
+        : m_first{ value1 }
+        , m_second{ value2 }
+    {
+    }
+
+    T_1& first() { return m_first; }
+    T_2& second() { return m_second; }
+    const T_1& first() const { return m_first; }
+    const T_2& second() const { return m_second; }
+};
+
+template <typename T>
+class StringValuePair : public Pair<std::string, T>
+{
+public:
+    StringValuePair(const std::string& string, T value)
+        : Pair<std::string, T>::Pair{ string, value }
+    {
+    }
+};
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                  ============[ records, checksums and files ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - a record in the log is a 16 byte header followed by the key and the value:
+        [ crc32c | key length | value length | kind ][ key ... ][ value ... ]
+    the checksum covers everything after itself, so a record that was only partly written
+    (or overwritten with garbage) doesn't match its checksum.
+
+  - values are stored as raw bytes, so T has to be trivially copyable (int, double, a struct
+    of those...), or a std::string.
+*/
+
+namespace kv_store
+{
+    namespace detail
+    {
+        // crc32c (the Castagnoli polynomial), because SSE4.2 has an instruction for it
+        constexpr auto g_crcTable{ [] {
+            std::array<std::uint32_t, 256> table{};
+            for (std::uint32_t i{ 0 }; i < 256; ++i)
+            {
+                std::uint32_t crc{ i };
+                for (int bit{ 0 }; bit < 8; ++bit)
+                    crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+                table[i] = crc;
+            }
+            return table;
+        }() };
+
+        inline std::uint32_t crc32c(const char* data, std::size_t length, std::uint32_t crc = 0)
+        {
+            crc = ~crc;
+#if defined(__SSE4_2__)
+            std::uint64_t wide{ crc };
+            for (; length >= 8; data += 8, length -= 8)
+            {
+                std::uint64_t chunk;
+                std::memcpy(&chunk, data, 8);
+                wide = _mm_crc32_u64(wide, chunk);
+            }
+            crc = static_cast<std::uint32_t>(wide);
+#endif
+            for (; length > 0; ++data, --length)
+                crc = g_crcTable[(crc ^ static_cast<unsigned char>(*data)) & 0xff] ^ (crc >> 8);
+            return ~crc;
+        }
+
+        inline std::uint64_t hashKey(std::string_view key)
+        {
+            // FNV-1a, with a final mix so the low bits (which pick the slot) depend on every byte
+            std::uint64_t hash{ 0xcbf29ce484222325 };
+            for (char ch : key)
+                hash = (hash ^ static_cast<unsigned char>(ch)) * 0x100000001b3;
+            hash ^= hash >> 32;
+            hash *= 0xd6e8feb86659fd93;
+            hash ^= hash >> 32;
+            return hash | 1;        // 0 marks an empty slot in the index
+        }
+
+        enum class RecordKind : std::uint32_t
+        {
+            put = 1,
+            erase = 2,
+        };
+
+        struct RecordHeader
+        {
+            std::uint32_t crc{};
+            std::uint32_t keyLength{};
+            std::uint32_t valueLength{};
+            RecordKind kind{};
+        };
+        static_assert(sizeof(RecordHeader) == 16);
+
+        struct RecordView
+        {
+            RecordKind kind{};
+            std::string_view key{};
+            const char* value{};
+            std::size_t valueLength{};
+            std::size_t size{};         // of the whole record, header included
+        };
+
+        // the record at [offset]. only used on records we know are complete.
+        inline RecordView viewRecord(const char* log, std::uint64_t offset)
+        {
+            RecordHeader header;
+            std::memcpy(&header, log + offset, sizeof(header));
+            const char* key{ log + offset + sizeof(header) };
+            return { header.kind, { key, header.keyLength }, key + header.keyLength, header.valueLength,
+                     sizeof(header) + header.keyLength + header.valueLength };
+        }
+
+        // the record at [offset] if it is complete and its checksum matches, used when
+        // replaying a log that might end with a torn write
+        inline std::optional<RecordView> parseRecord(const char* log, std::uint64_t offset, std::uint64_t end)
+        {
+            RecordHeader header;
+            if (end - offset < sizeof(header))
+                return std::nullopt;
+            std::memcpy(&header, log + offset, sizeof(header));
+
+            std::uint64_t size{ sizeof(header) + std::uint64_t{ header.keyLength } + header.valueLength };
+            if (end - offset < size || (header.kind != RecordKind::put && header.kind != RecordKind::erase))
+                return std::nullopt;
+
+            const char* covered{ log + offset + sizeof(header.crc) };
+            if (crc32c(covered, size - sizeof(header.crc)) != header.crc)
+                return std::nullopt;
+
+            return viewRecord(log, offset);
+        }
+
+        inline void appendRecord(std::string& out, RecordKind kind, std::string_view key, const char* value, std::size_t valueLength)
+        {
+            std::size_t start{ out.size() };
+            RecordHeader header{ 0, static_cast<std::uint32_t>(key.size()), static_cast<std::uint32_t>(valueLength), kind };
+
+            out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.append(key);
+            out.append(value, valueLength);
+
+            header.crc = crc32c(out.data() + start + sizeof(header.crc), out.size() - start - sizeof(header.crc));
+            std::memcpy(out.data() + start, &header.crc, sizeof(header.crc));
+        }
+
+        template <typename T>
+        struct Codec
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "values are stored as raw bytes");
+
+            static const char* data(const T& value) { return reinterpret_cast<const char*>(&value); }
+            static std::size_t size(const T&) { return sizeof(T); }
+
+            static T decode(const char* bytes, std::size_t)
+            {
+                T value;
+                std::memcpy(&value, bytes, sizeof(T));
+                return value;
+            }
+        };
+
+        template <>
+        struct Codec<std::string>
+        {
+            static const char* data(const std::string& value) { return value.data(); }
+            static std::size_t size(const std::string& value) { return value.size(); }
+            static std::string decode(const char* bytes, std::size_t length) { return { bytes, length }; }
+        };
+
+        [[noreturn]] inline void throwErrno(const std::string& what)
+        {
+            throw std::system_error{ errno, std::generic_category(), what };
+        }
+
+        inline void writeAll(int fd, const char* data, std::size_t size)
+        {
+            while (size > 0)
+            {
+                ssize_t written{ ::write(fd, data, size) };
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throwErrno("write");
+                }
+                data += written;
+                size -= static_cast<std::size_t>(written);
+            }
+        }
+
+        inline void syncDirectory(const std::filesystem::path& directory)
+        {
+            int fd{ ::open(directory.c_str(), O_RDONLY | O_DIRECTORY) };
+            if (fd < 0)
+                throwErrno("open " + directory.string());
+            ::fsync(fd);
+            ::close(fd);
+        }
+
+        // scope guards for the files and mappings that are half set up when something throws.
+        // release() (or keep()) hands them over once they are in their final place.
+        class FileDescriptor
+        {
+        private:
+            int m_fd{ -1 };
+
+        public:
+            explicit FileDescriptor(int fd) : m_fd{ fd } {}
+            FileDescriptor(const FileDescriptor&) = delete;
+            FileDescriptor& operator=(const FileDescriptor&) = delete;
+            ~FileDescriptor()
+            {
+                if (m_fd >= 0)
+                    ::close(m_fd);
+            }
+
+            int get() const { return m_fd; }
+            int release() { return std::exchange(m_fd, -1); }
+        };
+
+        class Mapping
+        {
+        private:
+            const char* m_data{ nullptr };
+            std::size_t m_size{ 0 };
+
+        public:
+            Mapping(const char* data, std::size_t size) : m_data{ data }, m_size{ size } {}
+            Mapping(const Mapping&) = delete;
+            Mapping& operator=(const Mapping&) = delete;
+            ~Mapping()
+            {
+                if (m_data)
+                    ::munmap(const_cast<char*>(m_data), m_size);
+            }
+
+            const char* get() const { return m_data; }
+            const char* release() { return std::exchange(m_data, nullptr); }
+        };
+
+        class RemoveUnlessKept
+        {
+        private:
+            std::filesystem::path m_path{};
+            bool m_keep{ false };
+
+        public:
+            explicit RemoveUnlessKept(std::filesystem::path path) : m_path{ std::move(path) } {}
+            RemoveUnlessKept(const RemoveUnlessKept&) = delete;
+            RemoveUnlessKept& operator=(const RemoveUnlessKept&) = delete;
+            ~RemoveUnlessKept()
+            {
+                std::error_code ignored{};
+                if (!m_keep)
+                    std::filesystem::remove(m_path, ignored);
+            }
+
+            void keep() { m_keep = true; }
+        };
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                      ============[ the hash index ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - an open addressing table (linear probing) of { hash, offset } slots. the key itself isn't
+    stored: it's in the log, at [offset], and we compare against it when the hashes match.
+
+  - the slots are one flat block of memory, so a checkpoint is a single write() of that block,
+    and loading a checkpoint is a single mmap() of the file. we map it MAP_PRIVATE: our changes
+    stay in memory (the file is only replaced by the next checkpoint). the file is read once
+    on open to check the slots' checksum, which is still much cheaper than replaying the log.
+
+  - erase shifts the following slots back instead of leaving a tombstone (like 14.9.a).
+*/
+
+namespace kv_store
+{
+    struct Slot
+    {
+        std::uint64_t hash{};
+        std::uint64_t offset{};
+    };
+
+    class Index
+    {
+    private:
+        void* m_mapping{ nullptr };
+        std::size_t m_mappingSize{ 0 };
+        Slot* m_slots{ nullptr };
+        std::size_t m_mask{ 0 };
+        std::size_t m_count{ 0 };
+
+        static void* allocate(std::size_t bytes)
+        {
+            void* memory{ ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+            if (memory == MAP_FAILED)
+                detail::throwErrno("mmap");
+            return memory;
+        }
+
+        void grow()
+        {
+            Index bigger{ (m_mask + 1) * 2 };
+            forEach([&bigger](const Slot& slot) { bigger.insertNew(slot); });
+            *this = std::move(bigger);
+        }
+
+        // for slots that are known not to be in the table yet
+        void insertNew(const Slot& slot)
+        {
+            std::size_t i{ slot.hash & m_mask };
+            while (m_slots[i].hash != 0)
+                i = (i + 1) & m_mask;
+            m_slots[i] = slot;
+            ++m_count;
+        }
+
+    public:
+        explicit Index(std::size_t capacity = 1024)
+            : m_mappingSize{ capacity * sizeof(Slot) }
+            , m_mask{ capacity - 1 }
+        {
+            m_mapping = allocate(m_mappingSize);
+            m_slots = static_cast<Slot*>(m_mapping);    // anonymous memory is zeroed: every slot is empty
+        }
+
+        // takes over a mapped checkpoint file, with the slots starting at [slots]
+        Index(void* mapping, std::size_t mappingSize, Slot* slots, std::size_t capacity, std::size_t count)
+            : m_mapping{ mapping }
+            , m_mappingSize{ mappingSize }
+            , m_slots{ slots }
+            , m_mask{ capacity - 1 }
+            , m_count{ count }
+        {
+        }
+
+        Index(Index&& other) noexcept
+            : m_mapping{ std::exchange(other.m_mapping, nullptr) }
+            , m_mappingSize{ std::exchange(other.m_mappingSize, 0) }
+            , m_slots{ std::exchange(other.m_slots, nullptr) }
+            , m_mask{ std::exchange(other.m_mask, 0) }
+            , m_count{ std::exchange(other.m_count, 0) }
+        {
+        }
+
+        Index& operator=(Index&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (m_mapping)
+                    ::munmap(m_mapping, m_mappingSize);
+                m_mapping = std::exchange(other.m_mapping, nullptr);
+                m_mappingSize = std::exchange(other.m_mappingSize, 0);
+                m_slots = std::exchange(other.m_slots, nullptr);
+                m_mask = std::exchange(other.m_mask, 0);
+                m_count = std::exchange(other.m_count, 0);
+            }
+            return *this;
+        }
+
+        ~Index()
+        {
+            if (m_mapping)
+                ::munmap(m_mapping, m_mappingSize);
+        }
+
+        std::size_t size() const { return m_count; }
+        std::size_t capacity() const { return m_mask + 1; }
+        const Slot* slots() const { return m_slots; }
+
+        // matches(offset) tells whether the record at offset has the key we are looking for
+        template <typename Matches>
+        Slot* find(std::uint64_t hash, Matches&& matches) const
+        {
+            for (std::size_t i{ hash & m_mask }; m_slots[i].hash != 0; i = (i + 1) & m_mask)
+            {
+                if (m_slots[i].hash == hash && matches(m_slots[i].offset))
+                    return &m_slots[i];
+            }
+            return nullptr;
+        }
+
+        // the slot for the key, and whether it was just added (its offset still has to be set)
+        template <typename Matches>
+        std::pair<Slot*, bool> findOrInsert(std::uint64_t hash, Matches&& matches)
+        {
+            if ((m_count + 1) * 4 > capacity() * 3)
+                grow();
+
+            std::size_t i{ hash & m_mask };
+            for (; m_slots[i].hash != 0; i = (i + 1) & m_mask)
+            {
+                if (m_slots[i].hash == hash && matches(m_slots[i].offset))
+                    return { &m_slots[i], false };
+            }
+
+            m_slots[i].hash = hash;
+            ++m_count;
+            return { &m_slots[i], true };
+        }
+
+        void erase(Slot* slot)
+        {
+            std::size_t hole{ static_cast<std::size_t>(slot - m_slots) };
+            for (std::size_t i{ (hole + 1) & m_mask }; m_slots[i].hash != 0; i = (i + 1) & m_mask)
+            {
+                // move slot i into the hole, unless its home slot lies (cyclically) after the hole
+                std::size_t home{ m_slots[i].hash & m_mask };
+                if (((i - home) & m_mask) >= ((i - hole) & m_mask))
+                {
+                    m_slots[hole] = m_slots[i];
+                    hole = i;
+                }
+            }
+            m_slots[hole] = {};
+            --m_count;
+        }
+
+        template <typename Fn>
+        void forEach(Fn&& fn) const
+        {
+            for (std::size_t i{ 0 }; i <= m_mask; ++i)
+            {
+                if (m_slots[i].hash != 0)
+                    fn(m_slots[i]);
+            }
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                           ============[ the store ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - the directory holds two kinds of files:
+        data.<id>.log   the log. compaction writes a new one with the next id.
+        index           the last checkpoint: which log it belongs to, how far into that log it
+                        goes, and the index slots.
+    a checkpoint is written to index.tmp, synced, and renamed over index. rename() is atomic,
+    so after a crash we see either the old checkpoint or the new one, never half of one.
+
+  - durability settings:
+        none        put() returns once the record is in the OS page cache. survives the
+                    program crashing, but not the machine crashing.
+        batched     like none, but the background thread syncs every syncInterval, or as soon
+                    as syncEveryRecords records are waiting. at most that much is lost when the
+                    machine crashes.
+        everyWrite  put() only returns once its record is synced. concurrent puts share one
+                    fdatasync() (group commit).
+
+  - concurrency: puts and erases are serialized by a lock, gets share it. syncing happens
+    OUTSIDE that lock, so writers can keep appending while a sync is running, and the next
+    sync picks up all of them at once.
+*/
+
+namespace kv_store
+{
+    enum class Durability
+    {
+        none,
+        batched,
+        everyWrite,
+    };
+
+    struct Options
+    {
+        Durability durability{ Durability::batched };
+        std::size_t syncEveryRecords{ 1024 };
+        std::chrono::milliseconds syncInterval{ 10 };
+
+        double compactWhenGarbageAbove{ 0.5 };          // fraction of the log that is dead records
+        std::uint64_t compactMinBytes{ 4 << 20 };
+        std::uint64_t checkpointEveryBytes{ 16 << 20 };  // of log written since the last checkpoint
+
+        bool backgroundThread{ true };
+    };
+
+    struct Stats
+    {
+        std::size_t keys{};
+        std::uint64_t logBytes{};
+        std::uint64_t liveBytes{};
+        std::uint64_t syncs{};
+        std::uint64_t compactions{};
+        std::uint64_t replayedRecords{};    // from the log tail, when the store was opened
+        bool usedCheckpoint{};
+    };
+
+    template <typename T>
+    class Store
+    {
+    private:
+        using Codec = detail::Codec<T>;
+
+        // the log is mapped once with room to grow: pages past the end of the file become
+        // readable as soon as write() extends the file, so we never have to remap
+        static constexpr std::size_t s_logReserve{ std::size_t{ 1 } << 36 };    // 64 GiB of address space
+
+        static constexpr std::uint64_t s_checkpointMagic{ 0x32'78'65'64'6e'69'76'6b };  // "kvindex2"
+
+        struct CheckpointHeader
+        {
+            std::uint64_t magic{ s_checkpointMagic };
+            std::uint64_t logId{};
+            std::uint64_t logEnd{};
+            std::uint64_t liveBytes{};
+            std::uint64_t capacity{};
+            std::uint64_t count{};
+            std::uint64_t slotsCrc{};       // of the slots after the header
+            std::uint64_t crc{};            // of the fields above
+        };
+        static_assert(sizeof(CheckpointHeader) == 64);
+
+        std::filesystem::path m_directory{};
+        Options m_options{};
+
+        // guarded by m_lock (shared for readers)
+        mutable std::shared_mutex m_lock{};
+        int m_logFd{ -1 };
+        const char* m_log{ nullptr };
+        std::uint64_t m_logId{ 0 };
+        std::uint64_t m_logEnd{ 0 };
+        std::uint64_t m_liveBytes{ 0 };
+        Index m_index{};
+        std::string m_record{};             // encoding buffer for put/erase
+        bool m_failed{ false };             // a failed append left a torn record we couldn't cut off
+
+        // group commit. m_written counts records appended to the log, m_synced the ones
+        // that are known to be on disk.
+        mutable std::mutex m_syncMutex{};
+        std::condition_variable m_syncDone{};
+        std::condition_variable m_backgroundWake{};
+        std::atomic<std::uint64_t> m_written{ 0 };
+        std::uint64_t m_synced{ 0 };
+        bool m_syncing{ false };
+        std::uint64_t m_syncCount{ 0 };
+
+        // checkpoints and compactions run one at a time
+        std::mutex m_maintenanceMutex{};
+        std::atomic<std::uint64_t> m_checkpointEnd{ 0 };
+        std::atomic<std::uint64_t> m_compactions{ 0 };
+
+        std::thread m_background{};
+        bool m_stop{ false };
+        std::exception_ptr m_backgroundError{};
+        std::atomic<bool> m_backgroundFailed{ false };      // m_backgroundError is set, checked without the lock
+
+        std::uint64_t m_replayedRecords{ 0 };
+        bool m_usedCheckpoint{ false };
+
+        std::filesystem::path logPath(std::uint64_t id) const
+        {
+            return m_directory / ("data." + std::to_string(id) + ".log");
+        }
+
+        static std::uint64_t headerCrc(const CheckpointHeader& header)
+        {
+            return detail::crc32c(reinterpret_cast<const char*>(&header), offsetof(CheckpointHeader, crc));
+        }
+
+        static const char* mapLog(int fd)
+        {
+            void* mapping{ ::mmap(nullptr, s_logReserve, PROT_READ, MAP_SHARED | MAP_NORESERVE, fd, 0) };
+            if (mapping == MAP_FAILED)
+                detail::throwErrno("mmap log");
+            return static_cast<const char*>(mapping);
+        }
+
+        static int openLog(const std::filesystem::path& path, int flags)
+        {
+            int fd{ ::open(path.c_str(), O_RDWR | O_CLOEXEC | flags, 0644) };
+            if (fd < 0)
+                detail::throwErrno("open " + path.string());
+            return fd;
+        }
+
+        // applies a record that is already in [log] at [offset] to an index
+        static void apply(Index& index, std::uint64_t& liveBytes, const char* log, std::uint64_t offset, const detail::RecordView& record)
+        {
+            std::uint64_t hash{ detail::hashKey(record.key) };
+            auto matches{ [&](std::uint64_t other) { return detail::viewRecord(log, other).key == record.key; } };
+
+            if (record.kind == detail::RecordKind::put)
+            {
+                auto [slot, added] { index.findOrInsert(hash, matches) };
+                if (!added)
+                    liveBytes -= detail::viewRecord(log, slot->offset).size;
+                slot->offset = offset;
+                liveBytes += record.size;
+            }
+            else if (Slot* slot{ index.find(hash, matches) })
+            {
+                liveBytes -= detail::viewRecord(log, slot->offset).size;
+                index.erase(slot);
+            }
+        }
+
+        // replays the records in [from, end of file) into the index, and cuts off a torn tail
+        void replay(std::uint64_t from)
+        {
+            struct stat info{};
+            if (::fstat(m_logFd, &info) != 0)
+                detail::throwErrno("fstat");
+            std::uint64_t fileEnd{ static_cast<std::uint64_t>(info.st_size) };
+
+            std::uint64_t offset{ from };
+            while (auto record{ detail::parseRecord(m_log, offset, fileEnd) })
+            {
+                apply(m_index, m_liveBytes, m_log, offset, *record);
+                offset += record->size;
+                ++m_replayedRecords;
+            }
+
+            if (offset != fileEnd && ::ftruncate(m_logFd, static_cast<off_t>(offset)) != 0)
+                detail::throwErrno("ftruncate");
+            if (::lseek(m_logFd, static_cast<off_t>(offset), SEEK_SET) < 0)
+                detail::throwErrno("lseek");
+            m_logEnd = offset;
+        }
+
+        // maps the checkpoint, if there is a valid one. returns its log end.
+        std::optional<std::uint64_t> loadCheckpoint()
+        {
+            int fd{ ::open((m_directory / "index").c_str(), O_RDONLY | O_CLOEXEC) };
+            if (fd < 0)
+                return std::nullopt;
+
+            struct stat info{};
+            CheckpointHeader header{};
+            bool valid{ ::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(header)
+                        && ::pread(fd, &header, sizeof(header), 0) == sizeof(header)
+                        && header.magic == s_checkpointMagic && header.crc == headerCrc(header)
+                        && header.capacity != 0 && (header.capacity & (header.capacity - 1)) == 0
+                        && static_cast<std::uint64_t>(info.st_size) == sizeof(header) + header.capacity * sizeof(Slot) };
+
+            void* mapping{ MAP_FAILED };
+            if (valid)
+                mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+
+            if (mapping == MAP_FAILED)
+                return std::nullopt;
+
+            // the slot offsets go straight into the log, so a damaged slot must not be used:
+            // check them all (this reads the whole file once), and replay the log instead
+            auto* slots{ reinterpret_cast<Slot*>(static_cast<char*>(mapping) + sizeof(header)) };
+            if (slotsCrc(slots, header.capacity) != header.slotsCrc)
+            {
+                ::munmap(mapping, static_cast<std::size_t>(info.st_size));
+                return std::nullopt;
+            }
+
+            m_index = Index{ mapping, static_cast<std::size_t>(info.st_size), slots, header.capacity, header.count };
+            m_logId = header.logId;
+            m_liveBytes = header.liveBytes;
+            return header.logEnd;
+        }
+
+        void open()
+        {
+            std::filesystem::create_directories(m_directory);
+
+            std::optional<std::uint64_t> checkpointEnd{ loadCheckpoint() };
+            if (!checkpointEnd)
+            {
+                // no (usable) checkpoint: replay the oldest log from the start. a newer one can
+                // only be the output of a compaction that never got to commit.
+                std::optional<std::uint64_t> oldest{};
+                for (const auto& entry : std::filesystem::directory_iterator{ m_directory })
+                {
+                    std::string name{ entry.path().filename().string() };
+                    if (name.starts_with("data.") && name.ends_with(".log"))
+                    {
+                        std::uint64_t id{ std::stoull(name.substr(5, name.size() - 9)) };
+                        oldest = std::min(oldest.value_or(id), id);
+                    }
+                }
+                m_logId = oldest.value_or(0);
+            }
+
+            m_logFd = openLog(logPath(m_logId), O_CREAT);
+            m_log = mapLog(m_logFd);
+
+            struct stat info{};
+            if (::fstat(m_logFd, &info) != 0)
+                detail::throwErrno("fstat");
+
+            if (checkpointEnd && *checkpointEnd > static_cast<std::uint64_t>(info.st_size))
+            {
+                // the checkpoint refers to log data that isn't there: don't trust it
+                checkpointEnd.reset();
+                m_index = Index{};
+                m_liveBytes = 0;
+            }
+
+            m_usedCheckpoint = checkpointEnd.has_value();
+            replay(checkpointEnd.value_or(0));
+            m_checkpointEnd = checkpointEnd.value_or(0);
+
+            // leftovers: logs from before the last compaction, or from one that didn't finish
+            for (const auto& entry : std::filesystem::directory_iterator{ m_directory })
+            {
+                std::string name{ entry.path().filename().string() };
+                if ((name.starts_with("data.") && entry.path() != logPath(m_logId)) || name == "index.tmp")
+                    std::filesystem::remove(entry.path());
+            }
+        }
+
+        // writes index.tmp and syncs it. renaming it over index is what makes it THE checkpoint.
+        void writeCheckpointFile(const CheckpointHeader& header, const Slot* slots)
+        {
+            std::filesystem::path temporary{ m_directory / "index.tmp" };
+            detail::RemoveUnlessKept partial{ temporary };
+            detail::FileDescriptor fd{ ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) };
+            if (fd.get() < 0)
+                detail::throwErrno("open " + temporary.string());
+
+            detail::writeAll(fd.get(), reinterpret_cast<const char*>(&header), sizeof(header));
+            detail::writeAll(fd.get(), reinterpret_cast<const char*>(slots), header.capacity * sizeof(Slot));
+            if (::fdatasync(fd.get()) != 0)
+                detail::throwErrno("fdatasync");
+            partial.keep();
+        }
+
+        void writeCheckpoint(const CheckpointHeader& header, const Slot* slots)
+        {
+            writeCheckpointFile(header, slots);
+            std::filesystem::rename(m_directory / "index.tmp", m_directory / "index");
+            detail::syncDirectory(m_directory);
+        }
+
+        static std::uint64_t slotsCrc(const Slot* slots, std::uint64_t capacity)
+        {
+            return detail::crc32c(reinterpret_cast<const char*>(slots), capacity * sizeof(Slot));
+        }
+
+        static CheckpointHeader makeHeader(std::uint64_t logId, std::uint64_t logEnd, std::uint64_t liveBytes,
+                                           const Slot* slots, std::uint64_t capacity, std::uint64_t count)
+        {
+            CheckpointHeader header{};
+            header.logId = logId;
+            header.logEnd = logEnd;
+            header.liveBytes = liveBytes;
+            header.capacity = capacity;
+            header.count = count;
+            header.slotsCrc = slotsCrc(slots, capacity);
+            header.crc = headerCrc(header);
+            return header;
+        }
+
+        // waits until record number [sequence] is on disk. the first waiter becomes the
+        // leader and syncs everything written so far; the others wait for it.
+        void waitDurable(std::uint64_t sequence)
+        {
+            std::unique_lock lock{ m_syncMutex };
+            if (m_backgroundError)
+                std::rethrow_exception(m_backgroundError);
+
+            while (m_synced < sequence)
+            {
+                if (m_syncing)
+                {
+                    m_syncDone.wait(lock);
+                    continue;
+                }
+
+                m_syncing = true;
+                int fd{ m_logFd };                          // can't change while m_syncing is set
+                std::uint64_t target{ m_written.load() };   // all of these are in the file already
+                lock.unlock();
+
+                int result{ ::fdatasync(fd) };
+
+                lock.lock();
+                m_syncing = false;
+                if (result == 0)
+                {
+                    m_synced = std::max(m_synced, target);
+                    ++m_syncCount;
+                }
+                m_syncDone.notify_all();
+                if (result != 0)
+                    detail::throwErrno("fdatasync");
+            }
+        }
+
+        void afterWrite(std::uint64_t sequence)
+        {
+            switch (m_options.durability)
+            {
+            case Durability::none:
+                break;
+            case Durability::batched:
+                if (sequence % m_options.syncEveryRecords == 0)
+                    m_backgroundWake.notify_one();
+                break;
+            case Durability::everyWrite:
+                waitDurable(sequence);
+                break;
+            }
+        }
+
+        // the background thread stops at its first error: batched syncs, checkpoints and
+        // compactions don't happen any more after that. so writes report it, instead of
+        // piling up records that will never be made durable.
+        void throwIfBackgroundFailed() const
+        {
+            if (m_backgroundFailed.load(std::memory_order_acquire))
+            {
+                std::lock_guard lock{ m_syncMutex };
+                std::rethrow_exception(m_backgroundError);
+            }
+        }
+
+        void append(detail::RecordKind kind, std::string_view key, const char* value, std::size_t valueLength)
+        {
+            throwIfBackgroundFailed();
+
+            std::uint64_t sequence;
+            {
+                std::unique_lock lock{ m_lock };
+                m_record.clear();
+                detail::appendRecord(m_record, kind, key, value, valueLength);
+                if (m_failed)
+                    throw std::runtime_error{ "kv_store: the log could not be repaired after a failed write" };
+                if (m_logEnd + m_record.size() > s_logReserve)
+                    throw std::runtime_error{ "kv_store: log is full" };
+
+                try
+                {
+                    detail::writeAll(m_logFd, m_record.data(), m_record.size());
+                }
+                catch (...)
+                {
+                    // part of the record may be in the file already. the records after it would
+                    // be appended behind that torn one, and replay stops at the first bad record,
+                    // so cut it off before anything else is appended
+                    if (::ftruncate(m_logFd, static_cast<off_t>(m_logEnd)) != 0
+                        || ::lseek(m_logFd, static_cast<off_t>(m_logEnd), SEEK_SET) < 0)
+                        m_failed = true;
+                    throw;
+                }
+                apply(m_index, m_liveBytes, m_log, m_logEnd, detail::viewRecord(m_log, m_logEnd));
+                m_logEnd += m_record.size();
+                sequence = ++m_written;
+            }
+            afterWrite(sequence);
+        }
+
+        void backgroundLoop()
+        {
+            std::unique_lock lock{ m_syncMutex };
+            while (!m_stop)
+            {
+                m_backgroundWake.wait_for(lock, m_options.syncInterval);
+                if (m_stop)
+                    break;
+
+                lock.unlock();
+                try
+                {
+                    if (m_options.durability == Durability::batched)
+                        sync();
+                    maintain();
+                }
+                catch (...)
+                {
+                    lock.lock();
+                    m_backgroundError = std::current_exception();
+                    m_backgroundFailed.store(true, std::memory_order_release);
+                    break;
+                }
+                lock.lock();
+            }
+        }
+
+        // compacts or checkpoints, if it's time to
+        void maintain()
+        {
+            std::uint64_t logEnd, liveBytes;
+            {
+                std::shared_lock lock{ m_lock };
+                logEnd = m_logEnd;
+                liveBytes = m_liveBytes;
+            }
+
+            double garbage{ logEnd == 0 ? 0.0 : 1.0 - static_cast<double>(liveBytes) / static_cast<double>(logEnd) };
+            if (logEnd >= m_options.compactMinBytes && garbage > m_options.compactWhenGarbageAbove)
+                compact();
+            else if (logEnd - m_checkpointEnd >= m_options.checkpointEveryBytes)
+                checkpoint();
+        }
+
+    public:
+        explicit Store(std::filesystem::path directory, Options options = {})
+            : m_directory{ std::move(directory) }
+            , m_options{ options }
+        {
+            open();
+            if (m_options.backgroundThread)
+                m_background = std::thread{ [this] { backgroundLoop(); } };
+        }
+
+        Store(const Store&) = delete;
+        Store& operator=(const Store&) = delete;
+
+        // syncs and checkpoints, so the next open doesn't have to replay anything
+        ~Store()
+        {
+            {
+                std::lock_guard lock{ m_syncMutex };
+                m_stop = true;
+            }
+            m_backgroundWake.notify_one();
+            if (m_background.joinable())
+                m_background.join();
+
+            try
+            {
+                checkpoint();
+            }
+            catch (const std::exception& error)
+            {
+                std::cerr << "kv_store: checkpoint on close failed: " << error.what() << '\n';
+            }
+
+            ::munmap(const_cast<char*>(m_log), s_logReserve);
+            ::close(m_logFd);
+        }
+
+        void put(std::string_view key, const T& value)
+        {
+            append(detail::RecordKind::put, key, Codec::data(value), Codec::size(value));
+        }
+
+        void put(const StringValuePair<T>& pair)
+        {
+            put(pair.first(), pair.second());
+        }
+
+        // returns whether the key was there
+        bool erase(std::string_view key)
+        {
+            {
+                std::shared_lock lock{ m_lock };
+                if (!m_index.find(detail::hashKey(key), [&](std::uint64_t offset) { return detail::viewRecord(m_log, offset).key == key; }))
+                    return false;
+            }
+            append(detail::RecordKind::erase, key, nullptr, 0);
+            return true;
+        }
+
+        std::optional<T> get(std::string_view key) const
+        {
+            std::shared_lock lock{ m_lock };
+            const Slot* slot{ m_index.find(detail::hashKey(key), [&](std::uint64_t offset) {
+                return detail::viewRecord(m_log, offset).key == key;
+            }) };
+
+            if (!slot)
+                return std::nullopt;
+
+            detail::RecordView record{ detail::viewRecord(m_log, slot->offset) };
+            return Codec::decode(record.value, record.valueLength);
+        }
+
+        // calls fn(StringValuePair<T>) for every key, in no particular order
+        template <typename Fn>
+        void forEach(Fn&& fn) const
+        {
+            std::shared_lock lock{ m_lock };
+            m_index.forEach([&](const Slot& slot) {
+                detail::RecordView record{ detail::viewRecord(m_log, slot.offset) };
+                fn(StringValuePair<T>{ std::string{ record.key }, Codec::decode(record.value, record.valueLength) });
+            });
+        }
+
+        // makes every put and erase that returned so far durable
+        void sync()
+        {
+            waitDurable(m_written.load());
+        }
+
+        // saves the index, so the next open only replays what is written after this
+        void checkpoint()
+        {
+            std::lock_guard maintenance{ m_maintenanceMutex };
+
+            std::vector<Slot> slots;
+            std::uint64_t logId, logEnd, liveBytes, count, sequence;
+            {
+                std::shared_lock lock{ m_lock };
+                logId = m_logId;
+                logEnd = m_logEnd;
+                liveBytes = m_liveBytes;
+                count = m_index.size();
+                slots.assign(m_index.slots(), m_index.slots() + m_index.capacity());
+                sequence = m_written.load();
+            }
+            CheckpointHeader header{ makeHeader(logId, logEnd, liveBytes, slots.data(), slots.size(), count) };
+
+            // the checkpoint may only point at log data that is on disk
+            waitDurable(sequence);
+            writeCheckpoint(header, slots.data());
+            m_checkpointEnd = header.logEnd;
+        }
+
+        // copies the live records into a new log, and switches over to it
+        void compact()
+        {
+            std::lock_guard maintenance{ m_maintenanceMutex };
+
+            // 1. copy what is live right now. the old log is append-only, so the records the
+            //    snapshot points at won't change under us, and writers can keep going.
+            std::vector<Slot> snapshot;
+            std::uint64_t snapshotEnd, oldId;
+            std::size_t capacity;
+            const char* oldLog;
+            {
+                std::shared_lock lock{ m_lock };
+                snapshot.reserve(m_index.size());
+                m_index.forEach([&snapshot](const Slot& slot) { snapshot.push_back(slot); });
+                snapshotEnd = m_logEnd;
+                oldId = m_logId;
+                capacity = m_index.capacity();
+                oldLog = m_log;
+            }
+
+            // until the switch-over, a throw anywhere below closes, unmaps and deletes the new log
+            std::uint64_t newId{ oldId + 1 };
+            detail::FileDescriptor newFd{ openLog(logPath(newId), O_CREAT | O_TRUNC) };
+            detail::RemoveUnlessKept partial{ logPath(newId) };
+            detail::Mapping newLog{ mapLog(newFd.get()), s_logReserve };
+            Index newIndex{ capacity };
+            std::uint64_t newEnd{ 0 };
+            std::uint64_t newLive{ 0 };
+
+            std::string buffer{};
+            auto copyRecord{ [&](std::uint64_t offset) {
+                detail::RecordView record{ detail::viewRecord(oldLog, offset) };
+                buffer.append(oldLog + offset, record.size);
+                if (buffer.size() >= (1 << 20))
+                {
+                    detail::writeAll(newFd.get(), buffer.data(), buffer.size());
+                    buffer.clear();
+                }
+                std::uint64_t newOffset{ newEnd };
+                newEnd += record.size;
+                return newOffset;
+            } };
+
+            // the copies are only readable in newLog once they are flushed, so the new index is
+            // filled from the slots directly (the keys are distinct, no lookups needed)
+            for (const Slot& slot : snapshot)
+            {
+                std::uint64_t size{ detail::viewRecord(oldLog, slot.offset).size };
+                auto [newSlot, added] { newIndex.findOrInsert(slot.hash, [](std::uint64_t) { return false; }) };
+                newSlot->offset = copyRecord(slot.offset);
+                newLive += size;
+            }
+            detail::writeAll(newFd.get(), buffer.data(), buffer.size());
+            buffer.clear();
+
+            // 2. stop the writers, and copy over what they wrote in the meantime
+            std::unique_lock lock{ m_lock };
+            for (std::uint64_t offset{ snapshotEnd }; offset < m_logEnd;)
+            {
+                detail::RecordView record{ detail::viewRecord(oldLog, offset) };
+                std::uint64_t newOffset{ copyRecord(offset) };
+                detail::writeAll(newFd.get(), buffer.data(), buffer.size());
+                buffer.clear();
+                apply(newIndex, newLive, newLog.get(), newOffset, detail::viewRecord(newLog.get(), newOffset));
+                offset += record.size;
+            }
+
+            if (::fdatasync(newFd.get()) != 0)
+                detail::throwErrno("fdatasync");
+            if (::lseek(newFd.get(), static_cast<off_t>(newEnd), SEEK_SET) < 0)
+                detail::throwErrno("lseek");
+            writeCheckpointFile(makeHeader(newId, newEnd, newLive, newIndex.slots(), newIndex.capacity(), newIndex.size()), newIndex.slots());
+
+            // 3. switch over. the rename of the new checkpoint is the moment the new log
+            //    becomes THE log: a crash before it recovers from the old log, after it from the new one.
+            //    nothing between the rename and the end of the switch can throw.
+            {
+                std::unique_lock syncLock{ m_syncMutex };
+                m_syncDone.wait(syncLock, [this] { return !m_syncing; });
+
+                std::filesystem::rename(m_directory / "index.tmp", m_directory / "index");
+                partial.keep();
+
+                int oldFd{ std::exchange(m_logFd, newFd.release()) };
+                m_log = newLog.release();
+                m_logId = newId;
+                m_logEnd = newEnd;
+                m_liveBytes = newLive;
+                m_index = std::move(newIndex);
+                m_synced = m_written.load();
+
+                ::munmap(const_cast<char*>(oldLog), s_logReserve);
+                ::close(oldFd);
+            }
+            detail::syncDirectory(m_directory);
+
+            std::filesystem::remove(logPath(oldId));
+            m_checkpointEnd = m_logEnd;
+            ++m_compactions;
+        }
+
+        Stats stats() const
+        {
+            Stats stats{};
+            {
+                std::shared_lock lock{ m_lock };
+                stats.keys = m_index.size();
+                stats.logBytes = m_logEnd;
+                stats.liveBytes = m_liveBytes;
+            }
+            {
+                std::lock_guard lock{ m_syncMutex };
+                stats.syncs = m_syncCount;
+            }
+            stats.compactions = m_compactions;
+            stats.replayedRecords = m_replayedRecords;
+            stats.usedCheckpoint = m_usedCheckpoint;
+            return stats;
+        }
+    };
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                    ============[ StringValuePair, on disk ]============
+---------------------------------------------------------------------------------------*/
+
+namespace quiz
+{
+    void main()
+    {
+        std::filesystem::path directory{ std::filesystem::temp_directory_path() / "kv_store_quiz" };
+        std::filesystem::remove_all(directory);
+
+        {
+            kv_store::Store<int> store{ directory };
+            store.put(StringValuePair<int>{ "Hello", 5 });
+            store.put(StringValuePair<int>{ "World", 7 });
+        }
+
+        {
+            // a different Store object, as if the program had been restarted
+            kv_store::Store<int> store{ directory };
+            store.forEach([](const StringValuePair<int>& svp) {
+                std::cout << "Pair: " << svp.first() << ' ' << svp.second() << '\n';
+            });
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                     ============[ crash recovery tests ]============
+---------------------------------------------------------------------------------------*/
+
+/*
+  - a crashed program is simulated with fork(): the child writes to the store and then dies
+    without running any destructors (SIGKILL, or _exit()), and the parent opens the store
+    again and checks what survived.
+
+  - this only tests the PROGRAM crashing. the data written before the crash is still in the
+    OS page cache, so it survives even if it was never synced. a machine crashing (losing
+    everything that wasn't synced) can't be simulated here, but what it leaves behind is a
+    log that ends early or ends in a torn record, and that is what tornTail() builds by hand.
+*/
+
+#include <map>
+#include <random>
+#include <csignal>          // kill, SIGKILL, signal, SIGXFSZ
+#include <sys/wait.h>       // waitpid
+#include <sys/resource.h>   // setrlimit, RLIMIT_FSIZE
+#include <fstream>          // for /proc/self/maps
+#include <iterator>         // std::distance
+
+namespace tests
+{
+    std::filesystem::path freshDirectory(std::string_view name)
+    {
+        std::filesystem::path directory{ std::filesystem::temp_directory_path() / ("kv_store_" + std::string{ name }) };
+        std::filesystem::remove_all(directory);
+        return directory;
+    }
+
+    // every put() that returned (in everyWrite mode) must be there after a SIGKILL
+    int killedWriter()
+    {
+        std::filesystem::path directory{ freshDirectory("killed") };
+
+        int pipeFds[2];
+        if (::pipe(pipeFds) != 0)
+            return 1;
+
+        std::cout.flush();      // or the child inherits (and may print) what is still buffered
+        pid_t child{ ::fork() };
+        if (child == 0)
+        {
+            ::close(pipeFds[0]);
+            kv_store::Store<std::int64_t> store{ directory, { .durability = kv_store::Durability::everyWrite } };
+            for (std::int64_t i{ 0 };; ++i)
+            {
+                store.put("key " + std::to_string(i), i * i);
+                if (::write(pipeFds[1], &i, sizeof(i)) != sizeof(i))        // acknowledge it
+                    ::_exit(1);
+            }
+        }
+
+        ::close(pipeFds[1]);
+        std::int64_t acknowledged{ -1 };
+        std::int64_t i{};
+        while (acknowledged < 500 && ::read(pipeFds[0], &i, sizeof(i)) == sizeof(i))
+            acknowledged = i;
+
+        ::kill(child, SIGKILL);
+        ::waitpid(child, nullptr, 0);
+        while (::read(pipeFds[0], &i, sizeof(i)) == sizeof(i))     // acknowledged just before it died
+            acknowledged = i;
+        ::close(pipeFds[0]);
+
+        kv_store::Store<std::int64_t> store{ directory };
+        int failures{ 0 };
+        for (i = 0; i <= acknowledged; ++i)
+        {
+            std::optional<std::int64_t> value{ store.get("key " + std::to_string(i)) };
+            failures += !value || *value != i * i;
+        }
+
+        std::cout << "killed writer    : " << acknowledged + 1 << " acknowledged, " << store.stats().replayedRecords
+                  << " records replayed, " << failures << " failures\n";
+        return failures;
+    }
+
+    // a log that ends in half a record and some garbage. everything before that survives.
+    int tornTail()
+    {
+        std::filesystem::path directory{ freshDirectory("torn") };
+
+        std::cout.flush();
+        pid_t child{ ::fork() };
+        if (child == 0)
+        {
+            kv_store::Store<std::int64_t> store{ directory, { .durability = kv_store::Durability::none, .backgroundThread = false } };
+            for (std::int64_t i{ 0 }; i < 1'000; ++i)
+                store.put("key " + std::to_string(i), i);
+            store.checkpoint();
+            for (std::int64_t i{ 1'000 }; i < 1'100; ++i)
+                store.put("key " + std::to_string(i), i);
+            ::_exit(0);
+        }
+        ::waitpid(child, nullptr, 0);
+
+        // tear the last record, and put garbage after it
+        std::filesystem::path log{ directory / "data.0.log" };
+        std::filesystem::resize_file(log, std::filesystem::file_size(log) - 5);
+        {
+            int fd{ ::open(log.c_str(), O_WRONLY | O_APPEND) };
+            std::mt19937 mt{ 3 };
+            char garbage[40];
+            for (char& ch : garbage)
+                ch = static_cast<char>(mt());
+            kv_store::detail::writeAll(fd, garbage, sizeof(garbage));
+            ::close(fd);
+        }
+
+        kv_store::Store<std::int64_t> store{ directory };
+        kv_store::Stats stats{ store.stats() };
+        int failures{ 0 };
+        for (std::int64_t i{ 0 }; i < 1'099; ++i)
+        {
+            std::optional<std::int64_t> value{ store.get("key " + std::to_string(i)) };
+            failures += !value || *value != i;
+        }
+        failures += store.get("key 1099").has_value();
+        failures += !stats.usedCheckpoint || stats.replayedRecords != 99;
+
+        std::cout << "torn tail        : " << stats.keys << " keys, " << stats.replayedRecords << " records replayed, "
+                  << failures << " failures\n";
+        return failures;
+    }
+
+    // a put() whose write fails halfway (here: the file size limit, like a full disk) must not
+    // take the puts after it down with it
+    int failedWrite()
+    {
+        std::filesystem::path directory{ freshDirectory("failed") };
+
+        std::cout.flush();
+        pid_t child{ ::fork() };
+        if (child == 0)
+        {
+            kv_store::Store<std::string> store{ directory, { .durability = kv_store::Durability::none, .backgroundThread = false } };
+            for (int i{ 0 }; i < 100; ++i)
+                store.put("key " + std::to_string(i), "before");
+
+            // room for 30 more bytes only, and EFBIG instead of SIGXFSZ past that
+            ::signal(SIGXFSZ, SIG_IGN);
+            rlimit limit{};
+            ::getrlimit(RLIMIT_FSIZE, &limit);
+            rlimit tight{ static_cast<rlim_t>(store.stats().logBytes + 30), limit.rlim_max };
+            ::setrlimit(RLIMIT_FSIZE, &tight);
+
+            bool threw{ false };
+            try
+            {
+                store.put("torn", std::string(200, 'x'));
+            }
+            catch (const std::system_error&)
+            {
+                threw = true;
+            }
+
+            ::setrlimit(RLIMIT_FSIZE, &limit);
+            for (int i{ 0 }; i < 100; ++i)
+                store.put("key " + std::to_string(i), "after");
+            ::_exit(threw ? 0 : 1);
+        }
+
+        int status{};
+        ::waitpid(child, &status, 0);
+        int failures{ !WIFEXITED(status) || WEXITSTATUS(status) != 0 };
+
+        kv_store::Store<std::string> store{ directory };
+        for (int i{ 0 }; i < 100; ++i)
+        {
+            std::optional<std::string> value{ store.get("key " + std::to_string(i)) };
+            failures += !value || *value != "after";
+        }
+        failures += store.get("torn").has_value();
+
+        std::cout << "failed write     : " << store.stats().replayedRecords << " records replayed, " << failures << " failures\n";
+        return failures;
+    }
+
+    // a compaction whose new log can't be written (the file size limit again): it must leave
+    // no descriptor, no mapping and no half-written log behind, and the store keeps working
+    int failedCompaction()
+    {
+        std::filesystem::path directory{ freshDirectory("failed_compaction") };
+
+        auto openFds{ [] {
+            auto fds{ std::distance(std::filesystem::directory_iterator{ "/proc/self/fd" }, std::filesystem::directory_iterator{}) };
+            return static_cast<int>(fds);
+        } };
+        // a mapping of a file shows up with its path (and " (deleted)" after it, once removed)
+        auto isMapped{ [](std::string_view name) {
+            std::ifstream maps{ "/proc/self/maps" };
+            for (std::string line{}; std::getline(maps, line);)
+            {
+                if (line.find(name) != std::string::npos)
+                    return true;
+            }
+            return false;
+        } };
+
+        std::cout.flush();
+        pid_t child{ ::fork() };
+        if (child == 0)
+        {
+            int failures{ 0 };
+            kv_store::Store<std::string> store{ directory, { .durability = kv_store::Durability::none, .backgroundThread = false } };
+            for (int i{ 0 }; i < 2'000; ++i)
+                store.put("key " + std::to_string(i % 500), std::string(100, static_cast<char>('a' + i % 26)));
+
+            ::signal(SIGXFSZ, SIG_IGN);
+            rlimit limit{};
+            ::getrlimit(RLIMIT_FSIZE, &limit);
+            rlimit tight{ 4096, limit.rlim_max };       // the old log is already bigger, but isn't written to
+
+            int fdsBefore{ openFds() };
+            ::setrlimit(RLIMIT_FSIZE, &tight);
+
+            bool threw{ false };
+            try
+            {
+                store.compact();
+            }
+            catch (const std::system_error&)
+            {
+                threw = true;
+            }
+            ::setrlimit(RLIMIT_FSIZE, &limit);
+
+            failures += !threw;
+            failures += openFds() != fdsBefore;
+            failures += isMapped("data.1.log");
+            failures += std::filesystem::exists(directory / "data.1.log");
+
+            // and it still works: the same compaction, now with room to write
+            store.put("key 0", "after");
+            store.compact();
+            failures += store.get("key 0") != "after" || store.stats().keys != 500;
+            ::_exit(std::min(failures, 100));
+        }
+
+        int status{};
+        ::waitpid(child, &status, 0);
+        int failures{ !WIFEXITED(status) ? 1 : WEXITSTATUS(status) };
+
+        std::cout << "failed compaction: " << failures << " failures\n";
+        return failures;
+    }
+
+    // a compaction that fails in the background thread: the puts after it must fail too,
+    // instead of being accepted by a store that no longer syncs in the background.
+    // a directory where the next log should go makes opening that log fail (even for root).
+    // closing the store reports the error once more, on std::cerr.
+    int maintenanceFailure()
+    {
+        std::filesystem::path directory{ freshDirectory("maintenance") };
+        kv_store::Options options{ .syncInterval = std::chrono::milliseconds{ 1 }, .compactMinBytes = 16 << 10 };
+        int failures{ 0 };
+
+        kv_store::Store<std::int64_t> store{ directory, options };
+        std::filesystem::create_directory(directory / "data.1.log");
+
+        // overwrite the same keys until the background thread tries to compact, and gives up
+        bool putFailed{ false };
+        auto deadline{ std::chrono::steady_clock::now() + std::chrono::seconds{ 10 } };
+        for (std::int64_t i{ 0 }; !putFailed && std::chrono::steady_clock::now() < deadline; ++i)
+        {
+            try
+            {
+                store.put("key " + std::to_string(i % 100), i);
+            }
+            catch (const std::system_error&)
+            {
+                putFailed = true;
+            }
+        }
+        failures += !putFailed;
+
+        bool syncFailed{ false };
+        try
+        {
+            store.sync();
+        }
+        catch (const std::system_error&)
+        {
+            syncFailed = true;
+        }
+        failures += !syncFailed;
+        failures += store.get("key 0").has_value() == false;      // reads still work
+
+        std::cout << "maintenance fails: put " << (putFailed ? "failed" : "succeeded") << ", sync "
+                  << (syncFailed ? "failed" : "succeeded") << ", " << failures << " failures\n";
+        std::filesystem::remove(directory / "data.1.log");
+        return failures;
+    }
+
+    int compare(const kv_store::Store<std::string>& store, const std::map<std::string, std::string>& expected)
+    {
+        int failures{ static_cast<int>(store.stats().keys != expected.size()) };
+        for (const auto& [key, value] : expected)
+        {
+            std::optional<std::string> found{ store.get(key) };
+            failures += !found || *found != value;
+        }
+        return failures;
+    }
+
+    // random puts and erases with compactions in between, then reopen, then reopen with a
+    // damaged checkpoint (which falls back to replaying the whole log)
+    int compactionAndReopen()
+    {
+        std::filesystem::path directory{ freshDirectory("compaction") };
+        std::map<std::string, std::string> expected{};
+        std::mt19937_64 mt{ 34 };
+        int failures{ 0 };
+
+        kv_store::Options options{ .durability = kv_store::Durability::none, .compactMinBytes = 64 << 10, .backgroundThread = false };
+        std::uint64_t bytesBefore{}, bytesAfter{};
+        {
+            kv_store::Store<std::string> store{ directory, options };
+            for (int i{ 0 }; i < 60'000; ++i)
+            {
+                std::string key{ "student " + std::to_string(mt() % 2'000) };
+                if (mt() % 4 == 0)
+                    failures += store.erase(key) != (expected.erase(key) == 1);
+                else
+                {
+                    std::string value(mt() % 64, static_cast<char>('a' + i % 26));
+                    store.put(key, value);
+                    expected[key] = value;
+                }
+
+                if (i % 20'000 == 19'999)
+                {
+                    bytesBefore = store.stats().logBytes;
+                    store.compact();
+                    bytesAfter = store.stats().logBytes;
+                    failures += compare(store, expected);
+                }
+            }
+        }
+
+        {
+            kv_store::Store<std::string> store{ directory, options };
+            failures += compare(store, expected) + !store.stats().usedCheckpoint + (store.stats().replayedRecords != 0);
+        }
+
+        // flip a byte in the checkpoint header: its checksum won't match any more
+        {
+            int fd{ ::open((directory / "index").c_str(), O_RDWR) };
+            char byte{};
+            failures += ::pread(fd, &byte, 1, 16) != 1;
+            byte = static_cast<char>(byte ^ 0x40);
+            failures += ::pwrite(fd, &byte, 1, 16) != 1;
+            ::close(fd);
+        }
+        {
+            kv_store::Store<std::string> store{ directory, options };
+            failures += compare(store, expected) + store.stats().usedCheckpoint;
+        }
+
+        // point a slot of the (new) checkpoint far past the end of the log: the header is fine,
+        // but the slots' checksum isn't, so this falls back to replaying the log too
+        {
+            int fd{ ::open((directory / "index").c_str(), O_RDWR) };
+            kv_store::Slot slot{};
+            off_t position{ 64 };
+            while (::pread(fd, &slot, sizeof(slot), position) == sizeof(slot) && slot.hash == 0)
+                position += sizeof(slot);
+            slot.offset = std::uint64_t{ 1 } << 40;
+            failures += ::pwrite(fd, &slot, sizeof(slot), position) != sizeof(slot);
+            ::close(fd);
+        }
+        {
+            kv_store::Store<std::string> store{ directory, options };
+            failures += compare(store, expected) + store.stats().usedCheckpoint;
+        }
+
+        std::cout << "compaction       : " << expected.size() << " keys, log " << bytesBefore << " -> " << bytesAfter
+                  << " bytes, " << failures << " failures\n";
+        return failures;
+    }
+
+    // the background thread compacting while other threads read and write
+    int backgroundCompaction()
+    {
+        std::filesystem::path directory{ freshDirectory("background") };
+        kv_store::Options options{ .syncInterval = std::chrono::milliseconds{ 1 }, .compactMinBytes = 64 << 10 };
+        int failures{ 0 };
+        std::uint64_t compactions{};
+
+        {
+            kv_store::Store<std::int64_t> store{ directory, options };
+            std::vector<std::thread> threads{};
+            std::atomic<int> threadFailures{ 0 };
+
+            // every thread owns its own keys, so it knows what it should read back
+            for (int t{ 0 }; t < 4; ++t)
+            {
+                threads.emplace_back([&store, &threadFailures, t] {
+                    for (std::int64_t i{ 0 }; i < 100'000; ++i)
+                    {
+                        std::string key{ std::to_string(t) + ':' + std::to_string(i % 500) };
+                        store.put(key, i);
+                        std::optional<std::int64_t> value{ store.get(key) };
+                        threadFailures += !value || *value != i;
+                    }
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+
+            failures += threadFailures;
+            compactions = store.stats().compactions;
+            failures += compactions == 0;
+        }
+
+        kv_store::Store<std::int64_t> store{ directory, options };
+        for (int t{ 0 }; t < 4; ++t)
+        {
+            for (std::int64_t i{ 100'000 - 500 }; i < 100'000; ++i)
+            {
+                std::optional<std::int64_t> value{ store.get(std::to_string(t) + ':' + std::to_string(i % 500)) };
+                failures += !value || *value != i;
+            }
+        }
+
+        std::cout << "background       : " << compactions << " compactions, " << failures << " failures\n";
+        return failures;
+    }
+
+    void main()
+    {
+        int failures{ killedWriter() + tornTail() + failedWrite() + failedCompaction() + maintenanceFailure()
+                      + compactionAndReopen() + backgroundCompaction() };
+        std::cout << (failures == 0 ? "all recovery tests passed\n" : "RECOVERY TESTS FAILED\n");
+
+        for (std::string_view name : { "killed", "torn", "failed", "failed_compaction", "maintenance", "compaction", "background" })
+            std::filesystem::remove_all(std::filesystem::temp_directory_path() / ("kv_store_" + std::string{ name }));
+    }
+}
+
+
+
+
+/*---------------------------------------------------------------------------------------
+                         ============[ benchmark ]============
+---------------------------------------------------------------------------------------*/
+
+// ops/sec and latency of put() for every durability setting, with 1 and 4 writer threads.
+// with everyWrite, 4 threads get much more done than 1, because they share their syncs.
+
+namespace benchmark
+{
+    class Timer
+    {
+    private:
+        using clock_type = std::chrono::steady_clock;
+        using second_type = std::chrono::duration<double, std::ratio<1>>;
+
+        std::chrono::time_point<clock_type> m_beg{ clock_type::now() };
+
+    public:
+        void reset()
+        {
+            m_beg = clock_type::now();
+        }
+
+        double elapsed() const
+        {
+            return std::chrono::duration_cast<second_type>(clock_type::now() - m_beg).count();
+        }
+    };
+
+    struct Reading
+    {
+        std::int64_t id{};
+        double values[6]{};
+    };
+
+    constexpr double g_secondsPerRun{ 0.5 };
+    constexpr std::size_t g_keys{ 100'000 };
+
+    void run(std::string_view name, kv_store::Options options, int threadCount)
+    {
+        std::filesystem::path directory{ std::filesystem::temp_directory_path() / "kv_store_benchmark" };
+        std::filesystem::remove_all(directory);
+
+        std::vector<std::vector<double>> latencies(static_cast<std::size_t>(threadCount));
+        kv_store::Stats stats{};
+        double seconds{};
+        {
+            kv_store::Store<Reading> store{ directory, options };
+            std::vector<std::thread> threads{};
+
+            Timer total;
+            for (int t{ 0 }; t < threadCount; ++t)
+            {
+                threads.emplace_back([&store, &latencies, t] {
+                    std::mt19937_64 mt{ static_cast<std::uint64_t>(t) };
+                    std::vector<double>& mine{ latencies[static_cast<std::size_t>(t)] };
+                    Timer running;
+                    Timer one;
+                    while (running.elapsed() < g_secondsPerRun)
+                    {
+                        std::int64_t id{ static_cast<std::int64_t>(mt() % g_keys) };
+                        one.reset();
+                        store.put("sensor " + std::to_string(id), Reading{ id, { 1.0, 2.0, 3.0 } });
+                        mine.push_back(one.elapsed());
+                    }
+                });
+            }
+            for (auto& thread : threads)
+                thread.join();
+            seconds = total.elapsed();
+            stats = store.stats();
+        }
+        std::filesystem::remove_all(directory);
+
+        std::vector<double> all{};
+        for (const auto& mine : latencies)
+            all.insert(all.end(), mine.begin(), mine.end());
+        std::sort(all.begin(), all.end());
+
+        auto percentile{ [&all](double p) { return all[static_cast<std::size_t>(p * static_cast<double>(all.size() - 1))] * 1e6; } };
+        std::cout << name << threadCount << " thread" << (threadCount > 1 ? "s: " : " : ")
+                  << static_cast<long long>(static_cast<double>(all.size()) / seconds) << " puts/s, p50 " << percentile(0.5)
+                  << " us, p99 " << percentile(0.99) << " us, " << stats.syncs << " syncs, " << stats.compactions << " compactions\n";
+    }
+
+    void reads()
+    {
+        std::filesystem::path directory{ std::filesystem::temp_directory_path() / "kv_store_benchmark" };
+        std::filesystem::remove_all(directory);
+        {
+            kv_store::Store<Reading> store{ directory, { .durability = kv_store::Durability::none } };
+            for (std::size_t i{ 0 }; i < g_keys; ++i)
+                store.put("sensor " + std::to_string(i), Reading{ static_cast<std::int64_t>(i) });
+        }
+
+        std::mt19937_64 mt{ 1 };
+        std::vector<std::string> keys(1'000'000);
+        for (auto& key : keys)
+            key = "sensor " + std::to_string(mt() % g_keys);
+
+        double openTime{}, readTime{};
+        std::int64_t sum{ 0 };
+        {
+            // reopened, so the reads go through the mapped checkpoint
+            Timer t;
+            kv_store::Store<Reading> store{ directory };
+            openTime = t.elapsed();
+
+            t.reset();
+            for (const auto& key : keys)
+                sum += store.get(key)->id;
+            readTime = t.elapsed();
+        }
+
+        std::cout << "get()                    : " << readTime * 1e9 / static_cast<double>(keys.size()) << " ns per get, reopening "
+                  << g_keys << " keys took " << openTime * 1e3 << " ms" << (sum == 0 ? " ?" : "") << '\n';
+        std::filesystem::remove_all(directory);
+    }
+
+    void main()
+    {
+        using kv_store::Durability;
+        for (int threads : { 1, 4 })
+        {
+            run("none       (no syncs)  , ", { .durability = Durability::none }, threads);
+            run("batched    (every 10ms), ", { .durability = Durability::batched }, threads);
+            run("everyWrite (group)     , ", { .durability = Durability::everyWrite }, threads);
+        }
+        reads();
+    }
+}
+
+
+
+
+//=======================================================================================
+
+int main()
+{
+    quiz::main();
+    tests::main();
+    benchmark::main();
+
+    return 0;
+}